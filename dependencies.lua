@@ -15,6 +15,8 @@ include_dirs = {}
 -- dev projects include directories
 include_dirs["crayon_lib"] = dev_path .. "/crayon-lib/include"
 include_dirs["crayon"] = dev_path .. "/crayon/include"
+include_dirs["crayon_bench"] = dev_path .. "/crayon-bench/include"
+include_dirs["crayon_alloc_tracking"] = dev_path .. "/crayon-alloc-tracking/include"
 
 -----------------------------
 -- source code directories --
@@ -24,6 +26,8 @@ src_dirs = {}
 -- dev projects source code directories
 src_dirs["crayon_lib"] = dev_path .. "/crayon-lib/src"
 src_dirs["crayon"] = dev_path .. "/crayon/src"
+src_dirs["crayon_bench"] = dev_path .. "/crayon-bench/src"
+src_dirs["crayon_alloc_tracking"] = dev_path .. "/crayon-alloc-tracking/src"
 
 -------------------------
 -- library directories --
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace crayon {
+
+	// Live heap memory of the whole process, maintained by the replacement of the global allocation
+	// functions in "AllocTracking.cpp". Unlike 'AllocStats', deallocations are tracked as well.
+	// Off by default: only the allocations made after 'EnableHeapUsageTracking' are counted.
+	struct HeapUsage {
+		uint64_t currentBytes{0};
+		uint64_t peakBytes{0};
+	};
+
+	void EnableHeapUsageTracking();
+	HeapUsage GetHeapUsage();
+	// Starts a new measurement: the peak drops to the current usage.
+	void ResetPeakHeapUsage();
+
+}
@@ -0,0 +1,37 @@
+project("crayon-alloc-tracking")
+    kind      ("StaticLib")
+    language  ("C++")
+    cppdialect("C++17")
+    location  (build_path .. "/crayon-alloc-tracking")
+    targetdir (build_path .. "/bin/" .. target_dir)
+    objdir    (build_path .. "/bin-int/" .. obj_dir)
+
+    includedirs {
+        "%{include_dirs.crayon_lib}",
+        "%{include_dirs.crayon_alloc_tracking}",
+    }
+
+    files {
+        "%{include_dirs.crayon_alloc_tracking}/**.h",
+        "%{src_dirs.crayon_alloc_tracking}/**.cpp",
+    }
+
+    filter("configurations:Debug")
+        defines({"DEBUG", "_DEBUG"})
+        runtime("Debug")
+        symbols("On")
+
+    filter("configurations:Release")
+        defines ({"NDEBUG", "_NDEBUG"})
+        runtime ("Release")
+        optimize("On")
+
+    filter({"system:windows", "action:vs*"})
+        vpaths {
+            ["Include/*"] = {
+                "%{include_dirs.crayon_alloc_tracking}/**.h",
+            },
+            ["Sources/*"] = {
+                "%{src_dirs.crayon_alloc_tracking}/**.cpp",
+            },
+        }
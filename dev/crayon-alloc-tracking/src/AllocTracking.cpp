@@ -0,0 +1,111 @@
+#include "AllocStats.h"
+#include "HeapUsage.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replacement of the global allocation functions. Opt-in: only the executables linking "crayon-alloc-tracking"
+// get it, the library itself never replaces the host's allocator.
+// Feeds both the per-thread allocation counters of the compile statistics and, once enabled,
+// the process-wide live heap usage (see "HeapUsage.h").
+// Every block is prefixed with a header holding its tracked size, so that deallocations can be accounted for.
+// The over-aligned allocation functions aren't replaced, they don't go through these.
+
+static constexpr std::size_t headerSize{alignof(std::max_align_t)};
+
+static std::atomic<bool> heapUsageTracked{false};
+static std::atomic<uint64_t> currentHeapBytes{0};
+static std::atomic<uint64_t> peakHeapBytes{0};
+
+static void* AllocateTracked(std::size_t size) {
+	crayon::AllocStats& allocStats = crayon::GetThreadAllocStats();
+	allocStats.allocatedBytes += size;
+	allocStats.allocationCount++;
+
+	void* block = std::malloc(headerSize + size);
+	if (!block) {
+		return nullptr;
+	}
+	// The shared counters are only touched when enabled, they would be contended by batch workers otherwise.
+	// Blocks allocated before are recorded as untracked, so that their deallocation isn't subtracted.
+	std::size_t trackedSize = heapUsageTracked.load(std::memory_order_relaxed) ? size : 0;
+	*static_cast<std::size_t*>(block) = trackedSize;
+	if (trackedSize != 0) {
+		uint64_t currentBytes = currentHeapBytes.fetch_add(trackedSize, std::memory_order_relaxed) + trackedSize;
+		uint64_t peakBytes = peakHeapBytes.load(std::memory_order_relaxed);
+		while (currentBytes > peakBytes &&
+		       !peakHeapBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed)) {
+		}
+	}
+	return static_cast<char*>(block) + headerSize;
+}
+static void DeallocateTracked(void* ptr) {
+	if (!ptr) {
+		return;
+	}
+	void* block = static_cast<char*>(ptr) - headerSize;
+	std::size_t trackedSize = *static_cast<std::size_t*>(block);
+	if (trackedSize != 0) {
+		currentHeapBytes.fetch_sub(trackedSize, std::memory_order_relaxed);
+	}
+	std::free(block);
+}
+
+namespace crayon {
+
+	void EnableHeapUsageTracking() {
+		heapUsageTracked.store(true, std::memory_order_relaxed);
+	}
+	HeapUsage GetHeapUsage() {
+		HeapUsage heapUsage{};
+		heapUsage.currentBytes = currentHeapBytes.load(std::memory_order_relaxed);
+		heapUsage.peakBytes = peakHeapBytes.load(std::memory_order_relaxed);
+		return heapUsage;
+	}
+	void ResetPeakHeapUsage() {
+		peakHeapBytes.store(currentHeapBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+}
+
+void* operator new(std::size_t size) {
+	void* ptr = AllocateTracked(size);
+	if (!ptr) {
+		throw std::bad_alloc{};
+	}
+	return ptr;
+}
+void* operator new[](std::size_t size) {
+	void* ptr = AllocateTracked(size);
+	if (!ptr) {
+		throw std::bad_alloc{};
+	}
+	return ptr;
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return AllocateTracked(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return AllocateTracked(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	DeallocateTracked(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+	DeallocateTracked(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+	DeallocateTracked(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+	DeallocateTracked(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+	DeallocateTracked(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+	DeallocateTracked(ptr);
+}
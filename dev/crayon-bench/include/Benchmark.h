@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace crayon {
+
+	struct BenchmarkConfig {
+		// Every benchmark is repeated until both limits are reached.
+		double minTimeMs{200.0};
+		uint32_t minIterations{10};
+	};
+
+	struct BenchmarkResult {
+		std::string name;
+		std::string input;
+		size_t inputSize{0};
+		size_t tokenCount{0};
+		uint32_t iterations{0};
+		double minNs{0.0};
+		double medianNs{0.0};
+		double meanNs{0.0};
+		// Both computed from the median, 1 MB = 10^6 bytes.
+		double mbPerSec{0.0};
+		double tokensPerSec{0.0};
+	};
+
+	// Runs 'body' once to warm up, then times every iteration separately.
+	// 'inputSize' and 'tokenCount' describe what a single iteration processes.
+	BenchmarkResult RunBenchmark(const std::string& name, const std::string& input,
+	                             size_t inputSize, size_t tokenCount,
+	                             const BenchmarkConfig& config, const std::function<void()>& body);
+
+	void WriteBenchmarkResultsJson(std::ostream& out, const BenchmarkConfig& config,
+	                               const std::vector<BenchmarkResult>& results);
+	void WriteBenchmarkResultsCsv(std::ostream& out, const std::vector<BenchmarkResult>& results);
+
+}
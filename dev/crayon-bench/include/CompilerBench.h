@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include "GLSL/Compiler.h"
+
+#include "Utility.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+
+	struct BenchInput {
+		// File path, or a description of a synthetic input.
+		std::string name;
+		std::string srcCode;
+	};
+
+	// Measures every stage of the compiler on its own:
+	// - "lexing"              Lexer::Scan
+	// - "relexing"            Lexer::Rescan of a space inserted in the middle of the input and then removed again
+	// - "parsing"             Parser::Parse over the tokens of the input (semantic analysis included)
+	// - "glslGeneration"      GlslExtWriter (GlslWriter for every shader stage) over the parsed AST
+	// - "spvGenerationAsm"    GlslToSpvGenerator::CompileToSpv emitting SPIR-V assembly text
+	// - "spvGenerationBinary" GlslToSpvGenerator::CompileToSpv emitting a SPIR-V binary
+	// - "compile"             Compiler::CompileFromMemory, all of the above (SPIR-V assembly)
+	// Every iteration creates the objects a compilation session would, so their setup is measured too.
+	class CompilerBench {
+	public:
+		// Only the benchmarks whose names contain 'filter' are run. Empty means "all of them".
+		CompilerBench(const BenchmarkConfig& config, std::string_view filter);
+		CLASS_NO_COPY(CompilerBench);
+		CLASS_NO_MOVE(CompilerBench);
+
+		// Returns 'false' (and measures nothing) if the input doesn't compile.
+		bool Run(const BenchInput& input, std::vector<BenchmarkResult>& results, std::string& errMsg);
+
+	private:
+		bool Selected(std::string_view name) const;
+
+		glsl::Compiler compiler;
+		BenchmarkConfig config;
+		std::string filter;
+		// Swallows the diagnostics (e.g. warnings) reported on every iteration, the input is known to compile by then.
+		std::ostream nullStream{nullptr};
+	};
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace crayon {
+
+	struct CorpusGeneratorConfig {
+		// Functions without parameters, split between the vertex and the fragment shader.
+		uint32_t functionCount{8};
+		// Nesting depth of the compound statements within a function body.
+		uint32_t stmtDepth{2};
+		// Statements per compound statement (the nested one included).
+		uint32_t stmtsPerBlock{4};
+		// Nesting depth of the initializer and assignment expressions.
+		uint32_t exprDepth{3};
+		// Global structure declarations of the vertex shader.
+		uint32_t structCount{4};
+		uint32_t matPropCount{4};
+		// The channels are reused once every one of them has been assigned.
+		uint32_t vertexAttribCount{3};
+		// Programs generated with the same configuration are identical.
+		uint32_t seed{1};
+	};
+
+	// Generates a ShaderProgram that uses only the constructs every stage of the compiler supports
+	// (no function calls, parameters, return or control flow statements yet).
+	std::string GenerateShaderProgram(const CorpusGeneratorConfig& config);
+
+	// Writes 'count' programs, "synthetic_0.csl", "synthetic_1.csl", etc., each with its own seed.
+	// Throws 'std::runtime_error' if a file can't be written.
+	std::vector<std::filesystem::path> GenerateCorpus(const std::filesystem::path& outDir, uint32_t count,
+	                                                  const CorpusGeneratorConfig& config);
+
+}
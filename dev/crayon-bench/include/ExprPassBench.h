@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace crayon {
+
+	struct ExprPassBenchConfig {
+		// Global variables of a generated header, each one initialized by a constant expression.
+		uint32_t exprCount{4096};
+		// Nesting depth of the expressions.
+		uint32_t exprDepth{6};
+		uint32_t seed{1};
+		BenchmarkConfig benchConfig{};
+	};
+
+	// Compares the recursive expression passes over the syntax tree with the single loop of their flat versions:
+	// - "exprEvalTree"  ExprEvalVisitor::Evaluate on every initializer
+	// - "exprEvalFlat"  FlatExprEvaluator::EvaluateAll over the flattened header
+	// - "exprTypesTree" ExprTypeInferenceVisitor on every initializer
+	// - "exprTypesFlat" FlatExprTypeInference::InferAll over the flattened header
+	// The expressions hold nothing but literals and operators, the only ones both versions fully handle.
+	// Throws 'std::runtime_error' if the generated header doesn't parse or the two versions disagree.
+	std::vector<BenchmarkResult> RunExprPassBench(const ExprPassBenchConfig& config);
+
+}
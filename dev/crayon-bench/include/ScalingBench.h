@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "CorpusGenerator.h"
+
+#include "GLSL/CompileStats.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace crayon {
+
+	struct ScalingBenchConfig {
+		// The function and structure counts are multiplied by 1, 2, 4, ... on every step.
+		CorpusGeneratorConfig generatorConfig{};
+		uint32_t stepCount{6};
+		BenchmarkConfig benchConfig{};
+	};
+
+	struct ScalingStepResult {
+		uint32_t scale{1};
+		// Time of the whole compilation ("compile" benchmark).
+		BenchmarkResult compile;
+		// Heap memory the compilation needed on top of what was already in use.
+		uint64_t peakHeapBytes{0};
+		// Statistics of the compilation the peak was measured on.
+		glsl::CompileStats stats;
+	};
+
+	// Compiles generated programs of growing size to reveal superlinear behavior.
+	// Throws 'std::runtime_error' if a generated program doesn't compile.
+	std::vector<ScalingStepResult> RunScalingBench(const ScalingBenchConfig& config);
+
+	void WriteScalingResultsJson(std::ostream& out, const std::vector<ScalingStepResult>& results);
+	void WriteScalingResultsCsv(std::ostream& out, const std::vector<ScalingStepResult>& results);
+
+}
@@ -0,0 +1,49 @@
+project ( "crayon-bench" )
+    kind       ( "ConsoleApp" )
+    language   ( "C++" )
+    cppdialect ( "C++17" )
+    location   ( build_path .. "/crayon-bench" )
+    targetdir  ( build_path .. "/bin/" .. target_dir )
+    objdir     ( build_path .. "/bin-int/" .. obj_dir )
+
+    includedirs {
+        "%{include_dirs.crayon_lib}",
+        "%{include_dirs.crayon_alloc_tracking}",
+        "%{include_dirs.crayon_bench}",
+    }
+    libdirs {
+        build_path .. "/bin/" .. target_dir
+    }
+
+    -- The allocation tracking replaces the global 'operator new', it must come before the library it reports to.
+    links {
+        "crayon-alloc-tracking",
+        "crayon-lib",
+    }
+
+    files {
+        "%{include_dirs.crayon_bench}/**.h",
+        "%{include_dirs.crayon_bench}/**.hpp",
+        "%{src_dirs.crayon_bench}/**.cpp",
+    }
+
+    filter ( "configurations:Debug" )
+        defines ( { "DEBUG", "_DEBUG" } )
+        runtime ( "Debug" )
+        symbols ( "On" )
+
+    filter ( "configurations:Release" )
+        defines  ( { "NDEBUG", "_NDEBUG" } )
+        runtime  ( "Release" )
+        optimize ( "On" )
+
+    filter ( { "system:windows", "action:vs*" } )
+        vpaths {
+            ["Include/*"] = {
+                "%{include_dirs.crayon_bench}/**.h",
+                "%{include_dirs.crayon_bench}/**.hpp"
+            },
+            ["Sources/*"] = {
+                "%{src_dirs.crayon_bench}/**.cpp",
+            },
+        }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+
+#include "Utility.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace crayon {
+
+	BenchmarkResult RunBenchmark(const std::string& name, const std::string& input,
+	                             size_t inputSize, size_t tokenCount,
+	                             const BenchmarkConfig& config, const std::function<void()>& body) {
+		// 1. Warm up the caches and the allocator.
+		body();
+
+		// 2. Time the iterations one by one, so that the median isn't skewed by the outliers.
+		std::vector<double> samplesNs;
+		double totalNs{0.0};
+		double minTimeNs = config.minTimeMs * 1000000.0;
+		while (samplesNs.size() < config.minIterations || totalNs < minTimeNs) {
+			auto start = std::chrono::steady_clock::now();
+			body();
+			auto end = std::chrono::steady_clock::now();
+			double sampleNs = std::chrono::duration<double, std::nano>(end - start).count();
+			samplesNs.push_back(sampleNs);
+			totalNs += sampleNs;
+		}
+
+		// 3. Summarize.
+		BenchmarkResult result{};
+		result.name = name;
+		result.input = input;
+		result.inputSize = inputSize;
+		result.tokenCount = tokenCount;
+		result.iterations = static_cast<uint32_t>(samplesNs.size());
+		std::sort(samplesNs.begin(), samplesNs.end());
+		size_t mid = samplesNs.size() / 2;
+		result.minNs = samplesNs.front();
+		result.medianNs = samplesNs.size() % 2 == 0 ? (samplesNs[mid - 1] + samplesNs[mid]) / 2.0 : samplesNs[mid];
+		result.meanNs = totalNs / static_cast<double>(samplesNs.size());
+		if (result.medianNs > 0.0) {
+			double medianSec = result.medianNs / 1000000000.0;
+			result.mbPerSec = static_cast<double>(inputSize) / 1000000.0 / medianSec;
+			result.tokensPerSec = static_cast<double>(tokenCount) / medianSec;
+		}
+		return result;
+	}
+
+	void WriteBenchmarkResultsJson(std::ostream& out, const BenchmarkConfig& config,
+	                               const std::vector<BenchmarkResult>& results) {
+		// Formatted separately, so that the stream's own flags are left untouched.
+		std::ostringstream json;
+		json << std::fixed << std::setprecision(3);
+		json << "{\"config\":{\"minTimeMs\":" << config.minTimeMs
+		     << ",\"minIterations\":" << config.minIterations << "},\n\"results\":[";
+		for (size_t i = 0; i < results.size(); i++) {
+			const BenchmarkResult& result = results[i];
+			json << (i == 0 ? "\n" : ",\n") << "{\"benchmark\":";
+			WriteJsonString(json, result.name);
+			json << ",\"input\":";
+			WriteJsonString(json, result.input);
+			json << ",\"inputSize\":" << result.inputSize
+			     << ",\"tokenCount\":" << result.tokenCount
+			     << ",\"iterations\":" << result.iterations
+			     << ",\"minNs\":" << result.minNs
+			     << ",\"medianNs\":" << result.medianNs
+			     << ",\"meanNs\":" << result.meanNs
+			     << ",\"mbPerSec\":" << result.mbPerSec
+			     << ",\"tokensPerSec\":" << result.tokensPerSec << "}";
+		}
+		json << "\n]}\n";
+		out << json.str();
+	}
+
+	void WriteBenchmarkResultsCsv(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+		std::ostringstream csv;
+		csv << std::fixed << std::setprecision(3);
+		csv << "benchmark,input,inputSize,tokenCount,iterations,minNs,medianNs,meanNs,mbPerSec,tokensPerSec\n";
+		for (const BenchmarkResult& result : results) {
+			// Input paths may contain commas.
+			std::string input = result.input;
+			for (size_t pos = input.find('"'); pos != std::string::npos; pos = input.find('"', pos + 2)) {
+				input.insert(pos, 1, '"');
+			}
+			csv << result.name << ",\"" << input << "\"," << result.inputSize << "," << result.tokenCount << ","
+			    << result.iterations << "," << result.minNs << "," << result.medianNs << "," << result.meanNs << ","
+			    << result.mbPerSec << "," << result.tokensPerSec << "\n";
+		}
+		out << csv.str();
+	}
+
+}
@@ -0,0 +1,123 @@
+#include "CompilerBench.h"
+
+#include "GLSL/CodeGen/GlslExtWriter.h"
+#include "GLSL/CompilationSession.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace crayon {
+
+	CompilerBench::CompilerBench(const BenchmarkConfig& config, std::string_view filter)
+		: config(config), filter(filter) {
+	}
+
+	bool CompilerBench::Run(const BenchInput& input, std::vector<BenchmarkResult>& results, std::string& errMsg) {
+		const char* srcCode = input.srcCode.data();
+		size_t srcCodeSize = input.srcCode.size();
+		glsl::CompileOptions options{};
+		GpuApiType gpuApiType = options.gpuApiType;
+
+		// 1. Make sure the whole pipeline accepts the input, the code generators throw on unsupported constructs.
+		glsl::CompileOptions spvBinaryOptions = options;
+		spvBinaryOptions.spvType = spirv::SpvType::BINARY;
+		for (const glsl::CompileOptions& checkedOptions : {spvBinaryOptions, options}) {
+			glsl::CompileResult checkResult = compiler.CompileFromMemory(input.srcCode, checkedOptions);
+			if (!checkResult.success) {
+				errMsg = checkResult.errMsg;
+				return false;
+			}
+		}
+
+		glsl::ErrorReporter errorReporter{};
+		errorReporter.SetSrcCodeLink(srcCode, srcCodeSize);
+		errorReporter.SetErrorStream(&nullStream);
+
+		// 2. The tokens, the constants and the AST shared by the later stages,
+		// neither the parser nor the code generators modify the constants or the AST.
+		glsl::ConstantTable constTable{};
+		glsl::LexerConfig lexConfig{};
+		lexConfig.errorReporter = &errorReporter;
+		lexConfig.gpuApiType = gpuApiType;
+		lexConfig.constTable = &constTable;
+
+		glsl::Lexer lexer{};
+		lexer.Scan(srcCode, srcCodeSize, lexConfig);
+		size_t tokenCount = lexer.GetTokenStream().GetSize();
+		glsl::TypeTable typeTable{};
+		glsl::AstArena astArena{};
+		glsl::ParserConfig parserConfig{};
+		parserConfig.errorReporter = &errorReporter;
+		parserConfig.typeTable = &typeTable;
+		parserConfig.constTable = &constTable;
+		parserConfig.astArena = &astArena;
+		parserConfig.gpuApiType = gpuApiType;
+		glsl::Parser parser{};
+		parser.Parse(lexer.GetTokenStream(), parserConfig);
+		glsl::ShaderProgramBlock* shaderProgramBlock = parser.GetShaderProgramBlock();
+
+		// 3. The benchmarks.
+		auto runBenchmark = [&](const std::string& name, const std::function<void()>& body) {
+			if (Selected(name)) {
+				results.push_back(RunBenchmark(name, input.name, srcCodeSize, tokenCount, config, body));
+			}
+		};
+		runBenchmark("lexing", [&]() {
+			glsl::ConstantTable benchConstTable{};
+			glsl::LexerConfig benchLexConfig = lexConfig;
+			benchLexConfig.constTable = &benchConstTable;
+			glsl::Lexer benchLexer{};
+			benchLexer.Scan(srcCode, srcCodeSize, benchLexConfig);
+		});
+		// The edit lands next to an existing space, so it can't split a token.
+		size_t editOffset = input.srcCode.find(' ', srcCodeSize / 2);
+		editOffset = editOffset == std::string::npos ? 0 : editOffset;
+		std::string editedSrcCode{input.srcCode};
+		editedSrcCode.insert(editOffset, 1, ' ');
+		glsl::Lexer relexer{};
+		relexer.Scan(srcCode, srcCodeSize, lexConfig);
+		runBenchmark("relexing", [&]() {
+			relexer.Rescan(editedSrcCode.data(), editedSrcCode.size(), glsl::SrcEdit{editOffset, 0, 1}, lexConfig);
+			relexer.Rescan(srcCode, srcCodeSize, glsl::SrcEdit{editOffset, 1, 0}, lexConfig);
+		});
+		runBenchmark("parsing", [&]() {
+			// The tree is freed along with the arena, that's part of the cost.
+			glsl::TypeTable benchTypeTable{};
+			glsl::AstArena benchAstArena{};
+			glsl::ParserConfig benchParserConfig = parserConfig;
+			benchParserConfig.typeTable = &benchTypeTable;
+			benchParserConfig.astArena = &benchAstArena;
+			glsl::Parser benchParser{};
+			benchParser.Parse(lexer.GetTokenStream(), benchParserConfig);
+		});
+		runBenchmark("glslGeneration", [&]() {
+			glsl::AstArena benchAstArena{};
+			glsl::GlslExtWriter glslExtWriter{options.glslWriterConfig, benchAstArena};
+			glslExtWriter.CompileToGlsl(shaderProgramBlock);
+		});
+		auto spvGeneration = [&](spirv::SpvType spvType) {
+			return [&, spvType]() {
+				glsl::AstArena benchAstArena{};
+				spirv::GlslToSpvGeneratorConfig spvGenConfig{};
+				spvGenConfig.type = spvType;
+				spvGenConfig.typeTable = &typeTable;
+				spvGenConfig.constTable = &constTable;
+				spvGenConfig.astArena = &benchAstArena;
+				spirv::GlslToSpvGenerator spvGenerator{spvGenConfig};
+				spvGenerator.CompileToSpv(shaderProgramBlock);
+			};
+		};
+		runBenchmark("spvGenerationAsm", spvGeneration(spirv::SpvType::ASM));
+		runBenchmark("spvGenerationBinary", spvGeneration(spirv::SpvType::BINARY));
+		runBenchmark("compile", [&]() {
+			compiler.CompileFromMemory(input.srcCode, options);
+		});
+		return true;
+	}
+
+	bool CompilerBench::Selected(std::string_view name) const {
+		return filter.empty() || name.find(filter) != std::string_view::npos;
+	}
+
+}
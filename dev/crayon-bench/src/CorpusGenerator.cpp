@@ -0,0 +1,229 @@
+#include "CorpusGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace crayon {
+
+	struct VertexAttribChannelDesc {
+		std::string_view type;
+		std::string_view channel;
+	};
+	static constexpr std::array<VertexAttribChannelDesc, 6> vertexAttribChannels{{
+		{"vec4", "POSITION"},
+		{"vec3", "NORMAL"  },
+		{"vec4", "TANGENT" },
+		{"vec4", "COLOR"   },
+		{"vec2", "UV0"     },
+		{"vec2", "UV1"     },
+	}};
+	static constexpr std::array<std::string_view, 7> matPropTypes{
+		"Integer", "Float", "Vector2", "Vector3", "Vector4", "Color", "Texture2D"
+	};
+	static constexpr std::array<std::string_view, 4> structMemberTypes{"vec3", "float", "vec4", "vec2"};
+	static constexpr std::array<std::string_view, 4> binaryOps{"+", "-", "*", "/"};
+	static constexpr std::array<std::string_view, 4> assignOps{"=", "+=", "-=", "*="};
+
+	class ShaderProgramGenerator {
+	public:
+		ShaderProgramGenerator(const CorpusGeneratorConfig& config)
+			: config(config), rng(config.seed) {
+		}
+
+		std::string Generate() {
+			out << "ShaderProgram \"Synthetic " << config.seed << "\" {\n\n";
+			GenerateVertexInputLayout();
+			GenerateMaterialProperties();
+			out << "    ColorAttachments {\n"
+			    << "        vec4 color : COLOR0;\n"
+			    << "    }\n\n";
+			// 1. Vertex shader: the structures and the even functions.
+			out << "    VertexShader {\n"
+			    << "        BEGIN\n";
+			for (uint32_t i = 0; i < config.structCount; i++) {
+				GenerateStruct(i);
+			}
+			GenerateFunctions(0);
+			out << "        void main() {\n"
+			    << "            gl_Position = position;\n"
+			    << "        }\n"
+			    << "        END\n"
+			    << "    }\n\n";
+			// 2. Fragment shader: the odd functions.
+			out << "    FragmentShader {\n"
+			    << "        BEGIN\n";
+			GenerateFunctions(1);
+			out << "        void main() {\n"
+			    << "            color = vec4(0.5, 0.5, 0.5, 1.0);\n"
+			    << "        }\n"
+			    << "        END\n"
+			    << "    }\n\n"
+			    << "}\n";
+			return out.str();
+		}
+
+	private:
+		void GenerateVertexInputLayout() {
+			out << "    VertexInputLayout {\n";
+			// The vertex shader's 'main' needs the position.
+			uint32_t vertexAttribCount = std::max(config.vertexAttribCount, 1u);
+			for (uint32_t i = 0; i < vertexAttribCount; i++) {
+				const VertexAttribChannelDesc& channel = vertexAttribChannels[i % vertexAttribChannels.size()];
+				out << "        " << channel.type << " ";
+				if (i == 0) {
+					out << "position";
+				} else {
+					out << "attrib" << i;
+				}
+				out << " : " << channel.channel << ";\n";
+			}
+			out << "    }\n\n";
+		}
+
+		void GenerateMaterialProperties() {
+			// An empty block isn't allowed.
+			if (config.matPropCount == 0) {
+				return;
+			}
+			out << "    MaterialProperties \"Material\" {\n";
+			for (uint32_t i = 0; i < config.matPropCount; i++) {
+				out << "        " << matPropTypes[i % matPropTypes.size()] << " prop" << i << ";\n";
+			}
+			out << "    }\n\n";
+		}
+
+		void GenerateStruct(uint32_t structIdx) {
+			uint32_t memberCount = 2 + structIdx % 3;
+			out << "        struct Struct" << structIdx << " {";
+			for (uint32_t i = 0; i < memberCount; i++) {
+				out << " " << structMemberTypes[(structIdx + i) % structMemberTypes.size()] << " member" << i << ";";
+			}
+			out << " } struct" << structIdx << ", structCopy" << structIdx << " = struct" << structIdx << ";\n";
+		}
+
+		void GenerateFunctions(uint32_t firstFunctionIdx) {
+			for (uint32_t i = firstFunctionIdx; i < config.functionCount; i += 2) {
+				localCount = 0;
+				scopes.clear();
+				out << "        void function" << i << "() {\n";
+				GenerateBlockStmts(1, 3);
+				out << "        }\n";
+			}
+		}
+
+		// Only 'float' variables are visible to the expressions, the vectors are never read.
+		void GenerateBlockStmts(uint32_t depth, uint32_t indentLevel) {
+			scopes.emplace_back();
+			std::string indent(indentLevel * 4, ' ');
+			uint32_t stmtsPerBlock = std::max(config.stmtsPerBlock, 1u);
+			for (uint32_t i = 0; i < stmtsPerBlock; i++) {
+				if (i == stmtsPerBlock / 2 && depth < config.stmtDepth) {
+					out << indent << "{\n";
+					GenerateBlockStmts(depth + 1, indentLevel + 1);
+					out << indent << "}\n";
+					continue;
+				}
+				std::string_view var = PickVariable();
+				uint32_t stmtKind = Random(4);
+				if (var.empty() || stmtKind == 0) {
+					std::string local = "local" + std::to_string(localCount++);
+					out << indent << "float " << local << " = " << GenerateExpr(config.exprDepth) << ";\n";
+					scopes.back().push_back(std::move(local));
+				} else if (stmtKind == 1) {
+					std::string local = "local" + std::to_string(localCount++);
+					out << indent << "vec4 " << local << " = vec4(" << GenerateExpr(config.exprDepth) << ", "
+					    << GenerateExpr(0) << ", " << GenerateExpr(0) << ", 1.0);\n";
+				} else {
+					out << indent << var << " " << assignOps[Random(assignOps.size())] << " "
+					    << GenerateExpr(config.exprDepth) << ";\n";
+				}
+			}
+			scopes.pop_back();
+		}
+
+		// Every level has a single nested operand, so the size grows linearly with the depth.
+		std::string GenerateExpr(uint32_t depth) {
+			if (depth == 0) {
+				return GenerateOperand();
+			}
+			std::string nested = "(" + GenerateExpr(depth - 1) + ")";
+			std::string operand = GenerateOperand();
+			std::string_view op = binaryOps[Random(binaryOps.size())];
+			if (Random(2) == 0) {
+				return nested + " " + std::string{op} + " " + operand;
+			}
+			return operand + " " + std::string{op} + " " + nested;
+		}
+
+		std::string GenerateOperand() {
+			std::string_view var = PickVariable();
+			if (!var.empty() && Random(2) == 0) {
+				return Random(4) == 0 ? "-" + std::string{var} : std::string{var};
+			}
+			return std::to_string(Random(100)) + "." + std::to_string(Random(10));
+		}
+
+		// Empty if no variable is in scope yet.
+		std::string_view PickVariable() {
+			size_t varCount{0};
+			for (const std::vector<std::string>& scope : scopes) {
+				varCount += scope.size();
+			}
+			if (varCount == 0) {
+				return {};
+			}
+			size_t varIdx = Random(static_cast<uint32_t>(varCount));
+			for (const std::vector<std::string>& scope : scopes) {
+				if (varIdx < scope.size()) {
+					return scope[varIdx];
+				}
+				varIdx -= scope.size();
+			}
+			return {};
+		}
+
+		uint32_t Random(size_t bound) {
+			// The raw engine output is the same on every platform, the standard distributions aren't.
+			return static_cast<uint32_t>(rng() % bound);
+		}
+
+		const CorpusGeneratorConfig& config;
+		std::mt19937 rng;
+		std::ostringstream out;
+		std::vector<std::vector<std::string>> scopes;
+		uint32_t localCount{0};
+	};
+
+	std::string GenerateShaderProgram(const CorpusGeneratorConfig& config) {
+		ShaderProgramGenerator generator{config};
+		return generator.Generate();
+	}
+
+	std::vector<std::filesystem::path> GenerateCorpus(const std::filesystem::path& outDir, uint32_t count,
+	                                                  const CorpusGeneratorConfig& config) {
+		std::error_code errCode;
+		std::filesystem::create_directories(outDir, errCode);
+		if (errCode) {
+			throw std::runtime_error{"Couldn't create the directory '" + outDir.string() + "': " + errCode.message()};
+		}
+		std::vector<std::filesystem::path> srcCodePaths;
+		for (uint32_t i = 0; i < count; i++) {
+			CorpusGeneratorConfig fileConfig = config;
+			fileConfig.seed = config.seed + i;
+			std::filesystem::path srcCodePath = outDir / ("synthetic_" + std::to_string(i) + ".csl");
+			std::ofstream srcCodeFile{srcCodePath, std::ofstream::out | std::ofstream::binary};
+			srcCodeFile << GenerateShaderProgram(fileConfig);
+			if (!srcCodeFile) {
+				throw std::runtime_error{"Couldn't write the source file: " + srcCodePath.string()};
+			}
+			srcCodePaths.push_back(std::move(srcCodePath));
+		}
+		return srcCodePaths;
+	}
+
+}
@@ -0,0 +1,236 @@
+#include "ExprPassBench.h"
+
+#include "GLSL/Error.h"
+#include "GLSL/Type.h"
+#include "GLSL/Value.h"
+
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/AST/ExprVisitors.h"
+#include "GLSL/AST/FlatAst.h"
+
+#include "GLSL/Analyzer/Lexer.h"
+#include "GLSL/Analyzer/Parser.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace crayon {
+
+	enum class ConstExprType {
+		INT,
+		UINT,
+		FLOAT,
+	};
+
+	static constexpr std::array<std::string_view, 3> constExprTypeNames{"int", "uint", "float"};
+	static constexpr std::array<std::string_view, 8> intBinaryOps{"+", "-", "*", "/", "%", "&", "|", "^"};
+	static constexpr std::array<std::string_view, 4> floatBinaryOps{"+", "-", "*", "/"};
+	static constexpr std::array<std::string_view, 4> comparisonOps{"<", ">", "<=", "=="};
+
+	// Constant expressions of a single type each, so that the initializers match their variables.
+	// The divisions by zero some of them end up with are part of the workload, both versions report them.
+	class ConstExprGenerator {
+	public:
+		explicit ConstExprGenerator(uint32_t seed)
+			: rng(seed) {
+		}
+
+		std::string GenerateHeader(uint32_t exprCount, uint32_t exprDepth) {
+			std::ostringstream out;
+			for (uint32_t i = 0; i < exprCount; i++) {
+				ConstExprType type = static_cast<ConstExprType>(i % constExprTypeNames.size());
+				out << constExprTypeNames[static_cast<size_t>(type)] << " c" << i << " = "
+				    << GenerateExpr(type, exprDepth) << ";\n";
+			}
+			return out.str();
+		}
+
+	private:
+		std::string GenerateExpr(ConstExprType type, uint32_t depth) {
+			if (depth == 0 || Random(4) == 0) {
+				return GenerateLiteral(type);
+			}
+			switch (Random(8)) {
+				case 0:
+					return "(" + GenerateExpr(type, depth - 1) + ")";
+				case 1:
+					return type != ConstExprType::FLOAT && Random(2) == 0 ? "~" + GenerateLiteral(type) : "-" + GenerateLiteral(type);
+				case 2: {
+					// The condition compares two expressions of a random type.
+					ConstExprType conditionType = static_cast<ConstExprType>(Random(constExprTypeNames.size()));
+					return "(" + GenerateExpr(conditionType, depth - 1) + " " + std::string{comparisonOps[Random(comparisonOps.size())]} +
+					       " " + GenerateExpr(conditionType, depth - 1) + ") ? " + GenerateExpr(type, depth - 1) + " : " +
+					       GenerateExpr(type, depth - 1);
+				}
+				case 3:
+					if (type != ConstExprType::FLOAT) {
+						// Shifts stay within the range the evaluator accepts.
+						return "(" + GenerateExpr(type, depth - 1) + ") " + (Random(2) == 0 ? "<< " : ">> ") + GenerateShift(type);
+					}
+					[[fallthrough]];
+				default: {
+					std::string_view op = type == ConstExprType::FLOAT ? floatBinaryOps[Random(floatBinaryOps.size())]
+					                                                   : intBinaryOps[Random(intBinaryOps.size())];
+					return "(" + GenerateExpr(type, depth - 1) + ") " + std::string{op} + " (" + GenerateExpr(type, depth - 1) + ")";
+				}
+			}
+		}
+		std::string GenerateLiteral(ConstExprType type) {
+			switch (type) {
+				case ConstExprType::INT: return std::to_string(Random(100));
+				case ConstExprType::UINT: return std::to_string(Random(100)) + "u";
+				default: return std::to_string(Random(100)) + "." + std::to_string(Random(10));
+			}
+		}
+		std::string GenerateShift(ConstExprType type) {
+			return std::to_string(Random(8)) + (type == ConstExprType::UINT ? "u" : "");
+		}
+
+		uint32_t Random(size_t bound) {
+			// The raw engine output is the same on every platform, the standard distributions aren't.
+			return static_cast<uint32_t>(rng() % bound);
+		}
+
+		std::mt19937 rng;
+	};
+
+	// Bitwise, so that the NaNs of the floating-point divisions by zero compare equal too.
+	static bool SameValue(const glsl::ExprEvalVisitor::ExprValue& a, const glsl::ExprEvalVisitor::ExprValue& b) {
+		return a.index() == b.index() && std::visit([&b](auto value) {
+			auto otherValue = std::get<decltype(value)>(b);
+			return std::memcmp(&value, &otherValue, sizeof(value)) == 0;
+		}, a);
+	}
+	static glsl::ExprEvalVisitor::ExprValue GetTreeResult(const glsl::ExprEvalVisitor& evalVisitor) {
+		if (evalVisitor.ResultBool()) return evalVisitor.GetBoolResult();
+		if (evalVisitor.ResultInt()) return evalVisitor.GetIntResult();
+		if (evalVisitor.ResultUint()) return evalVisitor.GetUintResult();
+		if (evalVisitor.ResultFloat()) return evalVisitor.GetFloatResult();
+		return evalVisitor.GetDoubleResult();
+	}
+
+	std::vector<BenchmarkResult> RunExprPassBench(const ExprPassBenchConfig& config) {
+		std::string header = ConstExprGenerator{config.seed}.GenerateHeader(config.exprCount, config.exprDepth);
+		std::string inputName = "exprs:" + std::to_string(config.exprCount) + "x" + std::to_string(config.exprDepth);
+		std::cerr << "Benchmarking " << inputName << " (" << header.size() << " bytes)" << std::endl;
+
+		// 1. The header's syntax tree, with the types inferred by the parser, and its flat version.
+		std::ostringstream diagnostics;
+		glsl::ErrorReporter errorReporter{};
+		errorReporter.SetSrcCodeLink(header.data(), header.size());
+		errorReporter.SetErrorStream(&diagnostics);
+		glsl::ConstantTable constTable{};
+		glsl::LexerConfig lexConfig{};
+		lexConfig.errorReporter = &errorReporter;
+		lexConfig.constTable = &constTable;
+		glsl::Lexer lexer{};
+		bool lexed = lexer.Scan(header.data(), header.size(), lexConfig);
+		glsl::TypeTable typeTable{};
+		glsl::AstArena astArena{};
+		glsl::ParserConfig parserConfig{};
+		parserConfig.errorReporter = &errorReporter;
+		parserConfig.typeTable = &typeTable;
+		parserConfig.constTable = &constTable;
+		parserConfig.astArena = &astArena;
+		glsl::Parser parser{};
+		parser.ParseHeader(lexer.GetTokenStream(), parserConfig);
+		if (!lexed || parser.HadSyntaxError() || parser.HadSemanticError()) {
+			throw std::runtime_error{"The generated expressions don't parse:\n" + diagnostics.str()};
+		}
+		std::vector<glsl::Expr*> rootExprs;
+		auto addRootExpr = [&rootExprs](glsl::VarDecl* varDecl) {
+			if (varDecl->HasInitializerExpr()) {
+				rootExprs.push_back(varDecl->GetInitializerExpr());
+			}
+		};
+		for (glsl::Decl* decl : parser.GetHeaderTransUnit()->GetDeclarations()) {
+			if (decl->GetKind() == glsl::DeclKind::VAR) {
+				addRootExpr(static_cast<glsl::VarDecl*>(decl));
+			} else if (decl->GetKind() == glsl::DeclKind::DECL_LIST) {
+				for (glsl::VarDecl* varDecl : static_cast<glsl::DeclList*>(decl)->GetDecls()) {
+					addRootExpr(varDecl);
+				}
+			}
+		}
+		glsl::FlatAst flatAst{};
+		glsl::FlatAstBuilder flatAstBuilder{flatAst, header};
+		for (glsl::Decl* decl : parser.GetHeaderTransUnit()->GetDeclarations()) {
+			flatAstBuilder.AddDecl(decl);
+		}
+		std::vector<glsl::FlatId> rootExprIds;
+		for (const glsl::FlatDecl& flatDecl : flatAst.decls) {
+			if (flatDecl.kind == glsl::FlatDeclKind::VAR && flatDecl.initExpr != glsl::noFlatId) {
+				rootExprIds.push_back(flatDecl.initExpr);
+			}
+		}
+		if (rootExprIds.size() != rootExprs.size()) {
+			throw std::runtime_error{"The flat syntax tree doesn't hold every initializer"};
+		}
+
+		// 2. Both versions must agree.
+		glsl::EnvironmentContext envCtx{};
+		envCtx.typeTable = &typeTable;
+		envCtx.constTable = &constTable;
+		glsl::ExprEvalVisitor evalVisitor{};
+		evalVisitor.SetEnvironmentContext(envCtx);
+		glsl::FlatExprEvaluator flatEvaluator{};
+		flatEvaluator.EvaluateAll(flatAst, constTable);
+		// The flat types start out as the tree's, they're cleared so that the flat pass has to infer them.
+		std::vector<uint32_t> treeTypeIds = flatAst.exprTypeIds;
+		std::fill(flatAst.exprTypeIds.begin(), flatAst.exprTypeIds.end(), 0);
+		for (glsl::FlatExpr& flatExpr : flatAst.exprs) {
+			flatExpr.isConst = 0;
+		}
+		glsl::FlatExprTypeInference flatTypeInference{};
+		flatTypeInference.InferAll(flatAst, typeTable);
+		for (size_t i = 0; i < rootExprs.size(); i++) {
+			glsl::FlatId rootExprId = rootExprIds[i];
+			bool evaluated = evalVisitor.Evaluate(rootExprs[i]);
+			bool sameEval = evaluated == flatEvaluator.IsDefined(rootExprId) &&
+			                (evaluated ? SameValue(GetTreeResult(evalVisitor), flatEvaluator.GetResult(rootExprId))
+			                           : evalVisitor.GetErrorMessage() == flatEvaluator.GetErrorMessage(rootExprId));
+			bool sameType = flatAst.exprTypeIds[rootExprId] == treeTypeIds[rootExprId] &&
+			                (flatAst.exprs[rootExprId].isConst != 0) == rootExprs[i]->IsConstExpr();
+			if (!sameEval || !sameType) {
+				throw std::runtime_error{"The flat expression passes disagree with the tree on the initializer of c" +
+				                         std::to_string(i)};
+			}
+		}
+
+		// 3. The benchmarks.
+		size_t tokenCount = lexer.GetTokenStream().GetSize();
+		std::vector<BenchmarkResult> results;
+		auto runBenchmark = [&](const std::string& name, const std::function<void()>& body) {
+			results.push_back(RunBenchmark(name, inputName, header.size(), tokenCount, config.benchConfig, body));
+		};
+		runBenchmark("exprEvalTree", [&]() {
+			for (glsl::Expr* rootExpr : rootExprs) {
+				evalVisitor.Evaluate(rootExpr);
+			}
+		});
+		runBenchmark("exprEvalFlat", [&]() {
+			flatEvaluator.EvaluateAll(flatAst, constTable);
+		});
+		glsl::ExprTypeInferenceVisitor typeInferenceVisitor{};
+		typeInferenceVisitor.SetEnvironmentContext(envCtx);
+		runBenchmark("exprTypesTree", [&]() {
+			for (glsl::Expr* rootExpr : rootExprs) {
+				typeInferenceVisitor.Visit(rootExpr);
+			}
+		});
+		runBenchmark("exprTypesFlat", [&]() {
+			flatTypeInference.InferAll(flatAst, typeTable);
+		});
+		return results;
+	}
+
+}
@@ -0,0 +1,96 @@
+#include "ScalingBench.h"
+#include "HeapUsage.h"
+
+#include "GLSL/Compiler.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace crayon {
+
+	std::vector<ScalingStepResult> RunScalingBench(const ScalingBenchConfig& config) {
+		EnableHeapUsageTracking();
+		glsl::Compiler compiler{};
+		std::vector<ScalingStepResult> results;
+		for (uint32_t step = 0; step < config.stepCount; step++) {
+			ScalingStepResult result{};
+			result.scale = 1u << step;
+			CorpusGeneratorConfig generatorConfig = config.generatorConfig;
+			generatorConfig.functionCount *= result.scale;
+			generatorConfig.structCount *= result.scale;
+			std::string srcCode = GenerateShaderProgram(generatorConfig);
+			std::cerr << "Scale " << result.scale << " (" << srcCode.size() << " bytes)" << std::endl;
+
+			// 1. Peak memory of a single compilation.
+			ResetPeakHeapUsage();
+			uint64_t heapBytesBefore = GetHeapUsage().currentBytes;
+			glsl::CompileResult compileResult = compiler.CompileFromMemory(srcCode);
+			result.peakHeapBytes = GetHeapUsage().peakBytes - heapBytesBefore;
+			if (!compileResult.success) {
+				throw std::runtime_error{"The generated program of scale " + std::to_string(result.scale) +
+				                         " doesn't compile:\n" + compileResult.errMsg};
+			}
+			result.stats = compileResult.stats;
+
+			// 2. Compile time.
+			result.compile = RunBenchmark("compile", "scale:" + std::to_string(result.scale),
+			                              srcCode.size(), result.stats.tokenCount, config.benchConfig,
+			                              [&]() { compiler.CompileFromMemory(srcCode); });
+			results.push_back(std::move(result));
+		}
+		return results;
+	}
+
+	void WriteScalingResultsJson(std::ostream& out, const std::vector<ScalingStepResult>& results) {
+		// Formatted separately, so that the stream's own flags are left untouched.
+		std::ostringstream json;
+		json << std::fixed << std::setprecision(3);
+		json << "{\"scaling\":[";
+		for (size_t i = 0; i < results.size(); i++) {
+			const ScalingStepResult& result = results[i];
+			json << (i == 0 ? "\n" : ",\n")
+			     << "{\"scale\":" << result.scale
+			     << ",\"inputSize\":" << result.compile.inputSize
+			     << ",\"tokenCount\":" << result.stats.tokenCount
+			     << ",\"astNodeCount\":" << result.stats.astNodeCount
+			     << ",\"iterations\":" << result.compile.iterations
+			     << ",\"minNs\":" << result.compile.minNs
+			     << ",\"medianNs\":" << result.compile.medianNs
+			     << ",\"mbPerSec\":" << result.compile.mbPerSec
+			     << ",\"peakHeapBytes\":" << result.peakHeapBytes
+			     << ",\"phaseWallTimeMs\":{";
+			for (size_t phaseIdx = 0; phaseIdx < result.stats.phases.size(); phaseIdx++) {
+				json << (phaseIdx == 0 ? "" : ",") << "\""
+				     << glsl::CompilePhaseToStr(static_cast<glsl::CompilePhase>(phaseIdx)) << "\":"
+				     << result.stats.phases[phaseIdx].wallTimeMs;
+			}
+			json << "}}";
+		}
+		json << "\n]}\n";
+		out << json.str();
+	}
+
+	void WriteScalingResultsCsv(std::ostream& out, const std::vector<ScalingStepResult>& results) {
+		std::ostringstream csv;
+		csv << std::fixed << std::setprecision(3);
+		csv << "scale,inputSize,tokenCount,astNodeCount,iterations,minNs,medianNs,mbPerSec,peakHeapBytes";
+		for (size_t phaseIdx = 0; phaseIdx < static_cast<size_t>(glsl::CompilePhase::COUNT); phaseIdx++) {
+			csv << "," << glsl::CompilePhaseToStr(static_cast<glsl::CompilePhase>(phaseIdx)) << "Ms";
+		}
+		csv << "\n";
+		for (const ScalingStepResult& result : results) {
+			csv << result.scale << "," << result.compile.inputSize << "," << result.stats.tokenCount << ","
+			    << result.stats.astNodeCount << "," << result.compile.iterations << "," << result.compile.minNs << ","
+			    << result.compile.medianNs << "," << result.compile.mbPerSec << "," << result.peakHeapBytes;
+			for (const glsl::PhaseStats& phaseStats : result.stats.phases) {
+				csv << "," << phaseStats.wallTimeMs;
+			}
+			csv << "\n";
+		}
+		out << csv.str();
+	}
+
+}
@@ -0,0 +1,224 @@
+#include "Benchmark.h"
+#include "CompilerBench.h"
+#include "CorpusGenerator.h"
+#include "ExprPassBench.h"
+#include "ScalingBench.h"
+
+#include "CmdLine/CmdLine.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace crayon;
+
+struct BenchCmdLineArgs {
+	// Source files, or directories to be searched (recursively) for ".csl" files.
+	std::vector<std::filesystem::path> inputs;
+	// Function counts of the synthetic inputs.
+	std::vector<uint32_t> syntheticFunctionCounts;
+	CorpusGeneratorConfig generatorConfig{};
+	// Write 'generateCount' programs to this directory instead of benchmarking.
+	std::filesystem::path generateDir;
+	uint32_t generateCount{1};
+	// Run the scaling benchmark with this many steps instead of the stage benchmarks.
+	uint32_t scalingStepCount{0};
+	// Run the expression pass benchmark on this many generated expressions instead of the stage benchmarks.
+	uint32_t exprPassCount{0};
+	BenchmarkConfig benchConfig{};
+	std::string filter;
+	bool csv{false};
+	bool help{false};
+};
+
+static uint32_t ParseUint(std::string_view arg, const std::string& value) {
+	if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+		throw std::invalid_argument{"Invalid value after '" + std::string{arg} + "': '" + value + "'"};
+	}
+	return static_cast<uint32_t>(std::stoul(value));
+}
+
+static BenchCmdLineArgs ParseBenchCmdLineArgs(int argc, char* argv[]) {
+	BenchCmdLineArgs cmdLineArgs{};
+	uint32_t minTimeMs = static_cast<uint32_t>(cmdLineArgs.benchConfig.minTimeMs);
+	CorpusGeneratorConfig& generatorConfig = cmdLineArgs.generatorConfig;
+	const std::unordered_map<std::string_view, uint32_t*> uintOptions{
+		{"--min-time",        &minTimeMs                            },
+		{"--min-iterations",  &cmdLineArgs.benchConfig.minIterations},
+		{"--count",           &cmdLineArgs.generateCount            },
+		{"--scaling",         &cmdLineArgs.scalingStepCount         },
+		{"--expr-passes",     &cmdLineArgs.exprPassCount            },
+		{"--functions",       &generatorConfig.functionCount        },
+		{"--stmt-depth",      &generatorConfig.stmtDepth            },
+		{"--stmts-per-block", &generatorConfig.stmtsPerBlock        },
+		{"--expr-depth",      &generatorConfig.exprDepth            },
+		{"--structs",         &generatorConfig.structCount          },
+		{"--mat-props",       &generatorConfig.matPropCount         },
+		{"--vertex-attribs",  &generatorConfig.vertexAttribCount    },
+		{"--seed",            &generatorConfig.seed                 },
+	};
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg{argv[i]};
+		auto uintOption = uintOptions.find(arg);
+		bool hasValue = uintOption != uintOptions.end() || arg == "--synthetic" || arg == "--generate" ||
+		                arg == "--filter" || arg == "--format";
+		if (hasValue && i + 1 >= argc) {
+			throw std::invalid_argument{"Missing a value after '" + std::string{arg} + "'"};
+		}
+		if (arg == "-h" || arg == "--help") {
+			cmdLineArgs.help = true;
+		} else if (uintOption != uintOptions.end()) {
+			*uintOption->second = ParseUint(arg, argv[++i]);
+		} else if (arg == "--synthetic") {
+			cmdLineArgs.syntheticFunctionCounts.push_back(ParseUint(arg, argv[++i]));
+		} else if (arg == "--generate") {
+			cmdLineArgs.generateDir = argv[++i];
+		} else if (arg == "--filter") {
+			cmdLineArgs.filter = argv[++i];
+		} else if (arg == "--format") {
+			std::string format{argv[++i]};
+			if (format != "json" && format != "csv") {
+				throw std::invalid_argument{"Unknown output format: '" + format + "'"};
+			}
+			cmdLineArgs.csv = format == "csv";
+		} else if (!arg.empty() && arg[0] == '-') {
+			throw std::invalid_argument{"Unknown option: '" + std::string{arg} + "'"};
+		} else {
+			cmdLineArgs.inputs.emplace_back(arg);
+		}
+	}
+	cmdLineArgs.benchConfig.minTimeMs = minTimeMs;
+	bool benchmarkInputs = cmdLineArgs.generateDir.empty() && cmdLineArgs.scalingStepCount == 0 && cmdLineArgs.exprPassCount == 0;
+	if (!cmdLineArgs.help && benchmarkInputs && cmdLineArgs.inputs.empty() && cmdLineArgs.syntheticFunctionCounts.empty()) {
+		throw std::invalid_argument{"No inputs provided"};
+	}
+	return cmdLineArgs;
+}
+
+static void PrintBenchUsage(std::ostream& out) {
+	CorpusGeneratorConfig defaults{};
+	out << "Usage: crayon-bench [options] [<file.csl | directory>...]\n"
+	    << "       crayon-bench --scaling <steps> [generator options]\n"
+	    << "       crayon-bench --expr-passes <count> [--expr-depth <depth>] [--seed <seed>]\n"
+	    << "       crayon-bench --generate <directory> [--count <count>] [generator options]\n"
+	    << "Measures the throughput of every compiler stage on the inputs,\n"
+	    << "the compile time and peak heap memory of growing generated programs (--scaling),\n"
+	    << "the expression passes over the syntax tree against their flat versions (--expr-passes),\n"
+	    << "or writes generated programs to a directory (--generate).\n"
+	    << "Options:\n"
+	    << "  --synthetic <count>       Add a generated input with <count> functions and structures (repeatable)\n"
+	    << "  --filter <text>           Only run the benchmarks whose names contain <text>\n"
+	    << "  --min-time <ms>           Minimum time spent on every benchmark (default: 200)\n"
+	    << "  --min-iterations <count>  Minimum number of iterations of every benchmark (default: 10)\n"
+	    << "  --format <json|csv>       Format of the results written to the standard output (default: json)\n"
+	    << "  -h, --help                Print this message\n"
+	    << "Generator options (the function and structure counts double on every scaling step):\n"
+	    << "  --functions <count>       Functions (default: " << defaults.functionCount << ")\n"
+	    << "  --stmt-depth <depth>      Nesting depth of the compound statements (default: " << defaults.stmtDepth << ")\n"
+	    << "  --stmts-per-block <count> Statements per compound statement (default: " << defaults.stmtsPerBlock << ")\n"
+	    << "  --expr-depth <depth>      Nesting depth of the expressions (default: " << defaults.exprDepth << ")\n"
+	    << "  --structs <count>         Structure declarations (default: " << defaults.structCount << ")\n"
+	    << "  --mat-props <count>       Material properties (default: " << defaults.matPropCount << ")\n"
+	    << "  --vertex-attribs <count>  Vertex attributes (default: " << defaults.vertexAttribCount << ")\n"
+	    << "  --seed <seed>             Seed of the first program (default: " << defaults.seed << ")\n";
+}
+
+static std::string ReadSrcFile(const std::filesystem::path& srcCodePath) {
+	std::ifstream srcCodeFile{srcCodePath, std::ifstream::in | std::ifstream::binary};
+	if (!srcCodeFile.is_open()) {
+		throw std::runtime_error{"Couldn't open the .csl source code file: " + srcCodePath.string()};
+	}
+	std::ostringstream srcCode;
+	srcCode << srcCodeFile.rdbuf();
+	return srcCode.str();
+}
+
+int main(int argc, char* argv[]) {
+	BenchCmdLineArgs cmdLineArgs{};
+	std::vector<BenchInput> inputs;
+	try {
+		cmdLineArgs = ParseBenchCmdLineArgs(argc, argv);
+		if (cmdLineArgs.help) {
+			PrintBenchUsage(std::cout);
+			return EXIT_SUCCESS;
+		}
+		if (!cmdLineArgs.generateDir.empty()) {
+			for (const std::filesystem::path& srcCodePath :
+			     GenerateCorpus(cmdLineArgs.generateDir, cmdLineArgs.generateCount, cmdLineArgs.generatorConfig)) {
+				std::cout << srcCodePath.generic_string() << "\n";
+			}
+			return EXIT_SUCCESS;
+		}
+		if (cmdLineArgs.scalingStepCount > 0) {
+			ScalingBenchConfig scalingConfig{};
+			scalingConfig.generatorConfig = cmdLineArgs.generatorConfig;
+			scalingConfig.stepCount = cmdLineArgs.scalingStepCount;
+			scalingConfig.benchConfig = cmdLineArgs.benchConfig;
+			std::vector<ScalingStepResult> results = RunScalingBench(scalingConfig);
+			if (cmdLineArgs.csv) {
+				WriteScalingResultsCsv(std::cout, results);
+			} else {
+				WriteScalingResultsJson(std::cout, results);
+			}
+			return EXIT_SUCCESS;
+		}
+		if (cmdLineArgs.exprPassCount > 0) {
+			ExprPassBenchConfig exprPassConfig{};
+			exprPassConfig.exprCount = cmdLineArgs.exprPassCount;
+			exprPassConfig.exprDepth = cmdLineArgs.generatorConfig.exprDepth;
+			exprPassConfig.seed = cmdLineArgs.generatorConfig.seed;
+			exprPassConfig.benchConfig = cmdLineArgs.benchConfig;
+			std::vector<BenchmarkResult> results = RunExprPassBench(exprPassConfig);
+			if (cmdLineArgs.csv) {
+				WriteBenchmarkResultsCsv(std::cout, results);
+			} else {
+				WriteBenchmarkResultsJson(std::cout, cmdLineArgs.benchConfig, results);
+			}
+			return EXIT_SUCCESS;
+		}
+		CmdLineArgs srcFileArgs{};
+		srcFileArgs.inputs = cmdLineArgs.inputs;
+		for (const std::filesystem::path& srcCodePath : CollectSrcFiles(srcFileArgs)) {
+			inputs.push_back(BenchInput{srcCodePath.generic_string(), ReadSrcFile(srcCodePath)});
+		}
+	}
+	catch (std::logic_error& le) {
+		std::cerr << le.what() << "\n";
+		PrintBenchUsage(std::cerr);
+		return EXIT_FAILURE;
+	}
+	catch (std::runtime_error& re) {
+		std::cerr << re.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	for (uint32_t functionCount : cmdLineArgs.syntheticFunctionCounts) {
+		CorpusGeneratorConfig generatorConfig = cmdLineArgs.generatorConfig;
+		generatorConfig.functionCount = functionCount;
+		generatorConfig.structCount = functionCount;
+		inputs.push_back(BenchInput{"synthetic:" + std::to_string(functionCount), GenerateShaderProgram(generatorConfig)});
+	}
+
+	// The results go to the standard output, the progress to the standard error.
+	CompilerBench compilerBench{cmdLineArgs.benchConfig, cmdLineArgs.filter};
+	std::vector<BenchmarkResult> results;
+	size_t skippedCount{0};
+	for (const BenchInput& input : inputs) {
+		std::cerr << "Benchmarking " << input.name << " (" << input.srcCode.size() << " bytes)" << std::endl;
+		std::string errMsg;
+		if (!compilerBench.Run(input, results, errMsg)) {
+			std::cerr << "Skipped " << input.name << ", it doesn't compile:\n" << errMsg << std::endl;
+			skippedCount++;
+		}
+	}
+	if (cmdLineArgs.csv) {
+		WriteBenchmarkResultsCsv(std::cout, results);
+	} else {
+		WriteBenchmarkResultsJson(std::cout, cmdLineArgs.benchConfig, results);
+	}
+	return skippedCount == inputs.size() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
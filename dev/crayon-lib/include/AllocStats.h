@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace crayon {
+
+	// Heap allocations made by the calling thread.
+	// Updated by the replacement of the global 'operator new' in "crayon-alloc-tracking",
+	// they stay at zero in the applications that don't link it.
+	struct AllocStats {
+		uint64_t allocatedBytes{0};
+		uint64_t allocationCount{0};
+	};
+
+	AllocStats& GetThreadAllocStats();
+
+}
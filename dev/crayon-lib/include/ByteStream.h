@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+
+	// Minimal helpers for host-endian binary formats (caches, local IPC, etc.).
+	// Strings are stored as a 32-bit length followed by the characters.
+
+	class ByteWriter {
+	public:
+		ByteWriter(std::vector<uint8_t>& data)
+			: data(data) {
+		}
+
+		void Write(const void* bytes, size_t size) {
+			const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+			data.insert(data.end(), begin, begin + size);
+		}
+		void WriteU32(uint32_t value) {
+			Write(&value, sizeof(value));
+		}
+		void WriteI32(int32_t value) {
+			Write(&value, sizeof(value));
+		}
+		void WriteString(std::string_view str) {
+			WriteU32(static_cast<uint32_t>(str.size()));
+			Write(str.data(), str.size());
+		}
+
+	private:
+		std::vector<uint8_t>& data;
+	};
+
+	// Every read method returns 'false' instead of reading past the end of the data.
+	class ByteReader {
+	public:
+		ByteReader(const uint8_t* data, size_t size)
+			: data(data), size(size) {
+		}
+
+		bool Read(void* bytes, size_t count) {
+			if (GetRemainingSize() < count) {
+				return false;
+			}
+			if (count > 0) {
+				std::memcpy(bytes, data + offset, count);
+			}
+			offset += count;
+			return true;
+		}
+		bool ReadU32(uint32_t& value) {
+			return Read(&value, sizeof(value));
+		}
+		bool ReadI32(int32_t& value) {
+			return Read(&value, sizeof(value));
+		}
+		bool ReadString(std::string& str) {
+			uint32_t strSize{0};
+			if (!ReadU32(strSize) || GetRemainingSize() < strSize) {
+				return false;
+			}
+			str.assign(reinterpret_cast<const char*>(data + offset), strSize);
+			offset += strSize;
+			return true;
+		}
+		template <typename Enum>
+		bool ReadEnum(Enum& value) {
+			int32_t enumValue{0};
+			if (!ReadI32(enumValue)) {
+				return false;
+			}
+			value = static_cast<Enum>(enumValue);
+			return true;
+		}
+
+		size_t GetRemainingSize() const {
+			return size - offset;
+		}
+		bool AtEnd() const {
+			return offset == size;
+		}
+
+	private:
+		const uint8_t* data{nullptr};
+		size_t size{0};
+		size_t offset{0};
+	};
+
+}
@@ -1,7 +1,53 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <vector>
+
 namespace crayon {
 
-	// TODO
+	struct CmdLineArgs {
+		// Source files, or directories to be searched (recursively) for ".csl" files.
+		std::vector<std::filesystem::path> inputs;
+		// Text files listing one input path per line.
+		std::vector<std::filesystem::path> manifests;
+		// Directories searched for '#include' directives, in order.
+		std::vector<std::filesystem::path> includeDirs;
+		// Header to precompile into "<header>.pch" instead of compiling any inputs.
+		std::filesystem::path precompileHeaderPath;
+		// Precompiled header whose declarations and macros precede every input. Empty means "none".
+		std::filesystem::path pchPath;
+		// Number of worker threads. 0 means "use all available hardware threads".
+		uint32_t jobs{0};
+		// Lex large files on a thread of their own while parsing them.
+		bool pipeline{false};
+		// Parse while lexing on demand, without keeping the tokens.
+		bool stream{false};
+		// Directory of the persistent compile cache. Empty means "no cache".
+		std::filesystem::path cacheDir;
+		// Unix domain socket to serve compile requests on. Empty means "compile the inputs and exit".
+		std::filesystem::path serveSocketPath;
+		// Seconds a client of the server has to send its next request. 0 means "never time out".
+		uint32_t idleTimeout{30};
+		// Print the per-phase compile statistics of every file as JSON to the standard output.
+		bool statsJson{false};
+		// Chrome trace event file to write. Empty means "no trace".
+		std::filesystem::path traceFile;
+		// Mask of the debug dump channels to write for every compiled file (see "GLSL/DebugDump.h").
+		uint32_t dumpChannels{0};
+		// Directory of the debug dumps. Empty means "next to every source file".
+		std::filesystem::path dumpDir;
+		bool verbose{false};
+		bool help{false};
+	};
+
+	// Throws 'std::invalid_argument' if the command line is ill-formed.
+	CmdLineArgs ParseCmdLineArgs(int argc, char* argv[]);
+	void PrintUsage(std::ostream& out);
+
+	// Expands directories and manifests into a sorted list of unique ".csl" files.
+	// Throws 'std::runtime_error' if an input or a manifest doesn't exist.
+	std::vector<std::filesystem::path> CollectSrcFiles(const CmdLineArgs& cmdLineArgs);
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Utility.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// Owns every node of a compilation's syntax trees, nodes link to each other with raw pointers.
+		// Nodes are bump allocated from large chunks and never freed one by one:
+		// the whole tree goes away at once along with the arena (usually at the end of the compilation session).
+		// Not thread-safe, an arena belongs to a single compilation.
+		class AstArena {
+		public:
+			AstArena() = default;
+			~AstArena();
+			CLASS_NO_COPY(AstArena);
+			CLASS_NO_MOVE(AstArena);
+
+			template<typename T, typename... Args>
+			T* New(Args&&... args) {
+				if constexpr (std::is_trivially_destructible_v<T>) {
+					return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+				} else {
+					// The nodes own vectors and such, their destructors run (in reverse order) when the arena goes away.
+					// The record precedes the node in the same allocation.
+					static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned nodes aren't supported!");
+					constexpr size_t recordSize = (sizeof(DtorRecord) + alignof(T) - 1) / alignof(T) * alignof(T);
+					std::byte* mem = static_cast<std::byte*>(Allocate(recordSize + sizeof(T), alignof(DtorRecord) > alignof(T) ? alignof(DtorRecord) : alignof(T)));
+					T* node = new (mem + recordSize) T(std::forward<Args>(args)...);
+					lastDtorRecord = new (mem) DtorRecord{lastDtorRecord, node, [](void* obj) { static_cast<T*>(obj)->~T(); }};
+					return node;
+				}
+			}
+
+			// Destroys every node, the first chunk is kept for reuse.
+			void Reset();
+			size_t GetAllocatedBytes() const;
+
+		private:
+			struct DtorRecord {
+				DtorRecord* prev{nullptr};
+				void* obj{nullptr};
+				void (*destroy)(void*){nullptr};
+			};
+			// Large enough for a few hundred nodes, small enough not to matter for tiny shaders.
+			static constexpr size_t chunkSize{64 * 1024};
+
+			void* Allocate(size_t size, size_t align);
+			void DestroyNodes();
+
+			std::vector<std::unique_ptr<std::byte[]>> chunks;
+			std::byte* chunkCurrent{nullptr};
+			std::byte* chunkEnd{nullptr};
+			DtorRecord* lastDtorRecord{nullptr};
+			size_t allocatedBytes{0};
+		};
+
+	}
+}
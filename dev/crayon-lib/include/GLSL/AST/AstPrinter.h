@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GLSL/AST/AstVisitor.h"
+#include "GLSL/AST/Block.h"
+#include "GLSL/AST/Decl.h"
+#include "GLSL/AST/Stmt.h"
+#include "GLSL/AST/Expr.h"
+
+#include <ostream>
+
+namespace crayon {
+	namespace glsl {
+
+		// Prints the syntax tree one node per line, children indented below their parent.
+		class AstPrinter : public AstVisitor<AstPrinter> {
+		public:
+			AstPrinter(std::ostream& out);
+
+			void Print(ShaderProgramBlock* program);
+
+		private:
+			friend class AstVisitor<AstPrinter>;
+
+			// Block visit methods
+			void VisitShaderProgramBlock(ShaderProgramBlock* programBlock);
+			void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock);
+			void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock);
+			void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock);
+			void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock);
+			void VisitShaderBlock(ShaderBlock* shaderBlock);
+
+			// Decl visit methods
+			void VisitTransUnit(TransUnit* transUnit);
+			void VisitInterfaceBlockDecl(InterfaceBlockDecl* interfaceBlockDecl);
+			void VisitDeclList(DeclList* declList);
+			void VisitStructDecl(StructDecl* structDecl);
+			void VisitVarDecl(VarDecl* varDecl);
+			void VisitFunDecl(FunDecl* funDecl);
+			void VisitQualDecl(QualDecl* qualDecl);
+
+			// Stmt visit methods
+			void VisitBlockStmt(BlockStmt* blockStmt);
+			void VisitDeclStmt(DeclStmt* declStmt);
+			void VisitExprStmt(ExprStmt* exprStmt);
+
+			// Expression visit methods
+			void VisitInitListExpr(InitListExpr* initListExpr);
+			void VisitAssignExpr(AssignExpr* assignExpr);
+			void VisitTernaryExpr(TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(VarExpr* varExpr);
+			void VisitIntConstExpr(IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(GroupExpr* groupExpr);
+
+			// Helper methods
+			// Starts the line of a new node.
+			std::ostream& BeginNode(std::string_view nodeName);
+			void PrintVarDecl(const VarDecl* varDecl);
+			void PrintChildExpr(Expr* expr);
+
+			std::ostream& out;
+			int indentLvl{0};
+		};
+
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "GLSL/AST/Block.h"
+#include "GLSL/AST/Decl.h"
+#include "GLSL/AST/Expr.h"
+#include "GLSL/AST/Stmt.h"
+
+#include <cassert>
+
+namespace crayon {
+	namespace glsl {
+
+		// Walks the syntax tree by switching on the node kinds and calling the visit methods of 'Derived'
+		// (i.e., 'VisitVarDecl(VarDecl* varDecl)') directly, so the compiler can inline them.
+		// Only the 'Visit' overloads in use are instantiated: a visitor of expressions only needs the expression visit methods.
+		// Private visit methods need 'friend class AstVisitor<Derived>;'.
+		template <typename Derived>
+		class AstVisitor {
+		public:
+			void Visit(Block* block) {
+				Derived& derived = static_cast<Derived&>(*this);
+				switch (block->GetKind()) {
+					case BlockKind::SHADER_PROGRAM: derived.VisitShaderProgramBlock(static_cast<ShaderProgramBlock*>(block)); break;
+					case BlockKind::FIXED_STAGES_CONFIG: derived.VisitFixedStagesConfigBlock(static_cast<FixedStagesConfigBlock*>(block)); break;
+					case BlockKind::MATERIAL_PROPERTIES: derived.VisitMaterialPropertiesBlock(static_cast<MaterialPropertiesBlock*>(block)); break;
+					case BlockKind::VERTEX_INPUT_LAYOUT: derived.VisitVertexInputLayoutBlock(static_cast<VertexInputLayoutBlock*>(block)); break;
+					case BlockKind::COLOR_ATTACHMENTS: derived.VisitColorAttachmentsBlock(static_cast<ColorAttachmentsBlock*>(block)); break;
+					case BlockKind::SHADER: derived.VisitShaderBlock(static_cast<ShaderBlock*>(block)); break;
+					default: assert(false && "Unknown block kind!"); break;
+				}
+			}
+			void Visit(Decl* decl) {
+				Derived& derived = static_cast<Derived&>(*this);
+				switch (decl->GetKind()) {
+					case DeclKind::TRANS_UNIT: derived.VisitTransUnit(static_cast<TransUnit*>(decl)); break;
+					case DeclKind::INTERFACE_BLOCK: derived.VisitInterfaceBlockDecl(static_cast<InterfaceBlockDecl*>(decl)); break;
+					case DeclKind::DECL_LIST: derived.VisitDeclList(static_cast<DeclList*>(decl)); break;
+					case DeclKind::STRUCT: derived.VisitStructDecl(static_cast<StructDecl*>(decl)); break;
+					// Parameters are visited as variables.
+					case DeclKind::VAR:
+					case DeclKind::FUN_PARAM: derived.VisitVarDecl(static_cast<VarDecl*>(decl)); break;
+					case DeclKind::FUN: derived.VisitFunDecl(static_cast<FunDecl*>(decl)); break;
+					case DeclKind::QUAL: derived.VisitQualDecl(static_cast<QualDecl*>(decl)); break;
+					default: assert(false && "Unknown declaration kind!"); break;
+				}
+			}
+			void Visit(Stmt* stmt) {
+				Derived& derived = static_cast<Derived&>(*this);
+				switch (stmt->GetKind()) {
+					case StmtKind::BLOCK: derived.VisitBlockStmt(static_cast<BlockStmt*>(stmt)); break;
+					case StmtKind::DECL: derived.VisitDeclStmt(static_cast<DeclStmt*>(stmt)); break;
+					case StmtKind::EXPR: derived.VisitExprStmt(static_cast<ExprStmt*>(stmt)); break;
+					default: assert(false && "Unknown statement kind!"); break;
+				}
+			}
+			void Visit(Expr* expr) {
+				Derived& derived = static_cast<Derived&>(*this);
+				switch (expr->GetKind()) {
+					case ExprKind::INIT_LIST: derived.VisitInitListExpr(static_cast<InitListExpr*>(expr)); break;
+					case ExprKind::ASSIGN: derived.VisitAssignExpr(static_cast<AssignExpr*>(expr)); break;
+					case ExprKind::TERNARY: derived.VisitTernaryExpr(static_cast<TernaryExpr*>(expr)); break;
+					case ExprKind::BINARY: derived.VisitBinaryExpr(static_cast<BinaryExpr*>(expr)); break;
+					case ExprKind::UNARY: derived.VisitUnaryExpr(static_cast<UnaryExpr*>(expr)); break;
+					case ExprKind::FIELD_SELECT: derived.VisitFieldSelectExpr(static_cast<FieldSelectExpr*>(expr)); break;
+					case ExprKind::FUN_CALL: derived.VisitFunCallExpr(static_cast<FunCallExpr*>(expr)); break;
+					case ExprKind::CTOR_CALL: derived.VisitCtorCallExpr(static_cast<CtorCallExpr*>(expr)); break;
+					case ExprKind::VAR: derived.VisitVarExpr(static_cast<VarExpr*>(expr)); break;
+					case ExprKind::INT_CONST: derived.VisitIntConstExpr(static_cast<IntConstExpr*>(expr)); break;
+					case ExprKind::UINT_CONST: derived.VisitUintConstExpr(static_cast<UintConstExpr*>(expr)); break;
+					case ExprKind::FLOAT_CONST: derived.VisitFloatConstExpr(static_cast<FloatConstExpr*>(expr)); break;
+					case ExprKind::DOUBLE_CONST: derived.VisitDoubleConstExpr(static_cast<DoubleConstExpr*>(expr)); break;
+					case ExprKind::GROUP: derived.VisitGroupExpr(static_cast<GroupExpr*>(expr)); break;
+					default: assert(false && "Unknown expression kind!"); break;
+				}
+			}
+
+		protected:
+			AstVisitor() = default;
+		};
+
+	}
+}
@@ -6,6 +6,7 @@
 
 #include "GLSL/Reflect/ReflectCommon.h"
 
+#include <cstdint>
 #include <memory>
 #include <string_view>
 #include <vector>
@@ -21,45 +22,49 @@ namespace crayon {
 		class ColorAttachmentsBlock;
 		class ShaderBlock;
 
-		class BlockVisitor {
-		public:
-			virtual void VisitShaderProgramBlock(ShaderProgramBlock* programBlock) = 0;
-			virtual void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock) = 0;
-			virtual void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock) = 0;
-			virtual void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock) = 0;
-			virtual void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock) = 0;
-			virtual void VisitShaderBlock(ShaderBlock* shaderBlock) = 0;
+		// Tells the concrete class of a block, see 'AstVisitor'.
+		enum class BlockKind : uint8_t {
+			SHADER_PROGRAM,
+			FIXED_STAGES_CONFIG,
+			MATERIAL_PROPERTIES,
+			VERTEX_INPUT_LAYOUT,
+			COLOR_ATTACHMENTS,
+			SHADER,
 		};
 
 		class Block {
 		public:
-			Block() = default;
 			virtual ~Block() = default;
-			virtual void Accept(BlockVisitor* blockVisitor) = 0;
+
+			BlockKind GetKind() const;
+
+		protected:
+			explicit Block(BlockKind kind);
+
+		private:
+			BlockKind kind;
 		};
 
 		class ShaderProgramBlock : public Block {
 		public:
-			ShaderProgramBlock() = default;
+			ShaderProgramBlock();
 			ShaderProgramBlock(const Token& programName);
 
-			void Accept(BlockVisitor* blockVisitor) override;
-
-			void AddBlock(std::shared_ptr<Block> block);
+			void AddBlock(Block* block);
 			bool BlockListEmpty() const;
-			const std::vector<std::shared_ptr<Block>> GetBlocks();
+			const std::vector<Block*> GetBlocks();
 
 			bool ShaderProgramNameEmpty() const;
 			std::string_view GetShaderProgramName() const;
 
 		private:
-			std::vector<std::shared_ptr<Block>> blocks;
+			std::vector<Block*> blocks;
 			Token programName;
 		};
 
 		class FixedStagesConfigBlock : public Block {
 		public:
-			void Accept(BlockVisitor* blockVisitor) override;
+			FixedStagesConfigBlock();
 		};
 
 		// Block declarations.
@@ -115,31 +120,29 @@ namespace crayon {
 		public:
 			MaterialPropertiesBlock(const Token& name);
 
-			void Accept(BlockVisitor* blockVisitor) override;
-
 			const Token& GetName() const;
 
 			bool HasMatPropDecl(std::string_view matPropName);
-			void AddMatPropDecl(std::shared_ptr<MatPropDecl> matPropDecl);
-			std::shared_ptr<MatPropDecl> GetMatPropDecl(std::string_view matPropName) const;
-			const std::vector<std::shared_ptr<MatPropDecl>>& GetMatPropDecls() const;
+			void AddMatPropDecl(MatPropDecl* matPropDecl);
+			MatPropDecl* GetMatPropDecl(std::string_view matPropName) const;
+			const std::vector<MatPropDecl*>& GetMatPropDecls() const;
 
 		private:
 			Token name;
-			std::vector<std::shared_ptr<MatPropDecl>> matProps;
+			std::vector<MatPropDecl*> matProps;
 		};
 
 		class VertexInputLayoutBlock : public Block {
 		public:
-			void Accept(BlockVisitor* blockVisitor) override;
+			VertexInputLayoutBlock();
 
 			bool HasVertexAttribDecl(std::string_view vertexAttribName);
-			void AddVertexAttribDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl);
-			std::shared_ptr<VertexAttribDecl> GetVertexAttribDecl(std::string_view vertexAttribName) const;
-			const std::vector<std::shared_ptr<VertexAttribDecl>>& GetAttribDecls() const;
+			void AddVertexAttribDecl(VertexAttribDecl* vertexAttribDecl);
+			VertexAttribDecl* GetVertexAttribDecl(std::string_view vertexAttribName) const;
+			const std::vector<VertexAttribDecl*>& GetAttribDecls() const;
 
 		private:
-			std::vector<std::shared_ptr<VertexAttribDecl>> vertexAttribs;
+			std::vector<VertexAttribDecl*> vertexAttribs;
 		};
 
 		VertexInputLayoutDesc GenerateVertexInputLayoutDesc(VertexInputLayoutBlock* vertexInputLayoutBlock);
@@ -147,15 +150,15 @@ namespace crayon {
 
 		class ColorAttachmentsBlock : public Block {
 		public:
-			void Accept(BlockVisitor* blockVisitor) override;
+			ColorAttachmentsBlock();
 
 			bool HasColorAttachmentDecl(std::string_view colorAttachmentName);
-			void AddColorAttachmentDecl(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl);
-			std::shared_ptr<ColorAttachmentDecl> GetColorAttachmentDecl(std::string_view colorAttachmentName) const;
-			const std::vector<std::shared_ptr<ColorAttachmentDecl>>& GetColorAttachments() const;
+			void AddColorAttachmentDecl(ColorAttachmentDecl* colorAttachmentDecl);
+			ColorAttachmentDecl* GetColorAttachmentDecl(std::string_view colorAttachmentName) const;
+			const std::vector<ColorAttachmentDecl*>& GetColorAttachments() const;
 
 		private:
-			std::vector<std::shared_ptr<ColorAttachmentDecl>> colorAttachments;
+			std::vector<ColorAttachmentDecl*> colorAttachments;
 		};
 
 		ColorAttachments GenerateColorAttachments(ColorAttachmentsBlock* colorAttachmentsBlock);
@@ -163,34 +166,31 @@ namespace crayon {
 
 		class ShaderBlock : public Block {
 		public:
-			ShaderBlock(std::shared_ptr<TransUnit> transUnit, ShaderType shaderType);
-
-			void Accept(BlockVisitor* blockVisitor) override;
+			ShaderBlock(TransUnit* transUnit, ShaderType shaderType);
 
-			std::shared_ptr<TransUnit> GetTranslationUnit() const;
+			TransUnit* GetTranslationUnit() const;
 			ShaderType GetShaderType() const;
 
 		private:
-			std::shared_ptr<TransUnit> transUnit;
+			TransUnit* transUnit{nullptr};
 			ShaderType shaderType;
 		};
 
 		// Block statements.
 		// Fixed stages config statements.
 
-		std::vector<std::shared_ptr<VarDecl>> CreateVertexAttribDecls(const VertexInputLayoutDesc& vertexInputLayout);
-		std::shared_ptr<VarDecl> CreateVertexAttribDecl(const VertexAttribDesc& vertexAttrib);
-		std::shared_ptr<InterfaceBlockDecl> CreateUniformInterfaceBlockDecl(const MaterialProps& matProps);
-		std::shared_ptr<VarDecl> CreateInterfaceBlockVarDecl(const MaterialPropDesc& matProp);
+		std::vector<VarDecl*> CreateVertexAttribDecls(AstArena& astArena, const VertexInputLayoutDesc& vertexInputLayout);
+		VarDecl* CreateVertexAttribDecl(AstArena& astArena, const VertexAttribDesc& vertexAttrib);
+		InterfaceBlockDecl* CreateUniformInterfaceBlockDecl(AstArena& astArena, const MaterialProps& matProps);
+		VarDecl* CreateInterfaceBlockVarDecl(AstArena& astArena, const MaterialPropDesc& matProp);
 
-		std::vector<std::shared_ptr<VarDecl>> CreateVertexAttribVarDecls(std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout);
-		std::shared_ptr<VarDecl> CreateVertexAttribVarDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl);
-		std::shared_ptr<InterfaceBlockDecl> CreateInterfaceBlockDecl(std::shared_ptr<MaterialPropertiesBlock> matPropBlock);
-		std::shared_ptr<VarDecl> CreateInterfaceBlockVarDecl(std::shared_ptr<MatPropDecl> matPropDecl);
+		std::vector<VarDecl*> CreateVertexAttribVarDecls(AstArena& astArena, VertexInputLayoutBlock* vertexInputLayout);
+		VarDecl* CreateVertexAttribVarDecl(AstArena& astArena, VertexAttribDecl* vertexAttribDecl);
+		InterfaceBlockDecl* CreateInterfaceBlockDecl(AstArena& astArena, MaterialPropertiesBlock* matPropBlock);
+		VarDecl* CreateInterfaceBlockVarDecl(AstArena& astArena, MatPropDecl* matPropDecl);
 
-		std::vector<std::shared_ptr<VarDecl>> CreateColorAttachmentVarDecls(std::shared_ptr<ColorAttachmentsBlock> colorAttachments);
-		std::vector<std::shared_ptr<VarDecl>> CreateColorAttachmentVarDecls(const ColorAttachments& colorAttachments);
-		std::shared_ptr<VarDecl> CreateColorAttachmentVarDecl(const ColorAttachmentDesc& colorAttachmentDesc);
+		std::vector<VarDecl*> CreateColorAttachmentVarDecls(AstArena& astArena, const ColorAttachments& colorAttachments);
+		VarDecl* CreateColorAttachmentVarDecl(AstArena& astArena, const ColorAttachmentDesc& colorAttachmentDesc);
 
 	}
 }
\ No newline at end of file
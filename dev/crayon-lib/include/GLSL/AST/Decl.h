@@ -5,12 +5,14 @@
 
 #include "GLSL/AST/Stmt.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 namespace crayon {
 	namespace glsl {
 
+		class AstArena;
 		class Expr;
         class TransUnit;
 		class InterfaceBlockDecl;
@@ -25,21 +27,29 @@ namespace crayon {
             BLOCK,
         };
 
-        class DeclVisitor {
-        public:
-            virtual void VisitTransUnit(TransUnit* transUnit) = 0;
-			virtual void VisitInterfaceBlockDecl(InterfaceBlockDecl* interfaceBlockDecl) = 0;
-			virtual void VisitDeclList(DeclList* declList) = 0;
-			virtual void VisitStructDecl(StructDecl* structDecl) = 0;
-			virtual void VisitVarDecl(VarDecl* varDecl) = 0;
-            virtual void VisitFunDecl(FunDecl* funDecl) = 0;
-            virtual void VisitQualDecl(QualDecl* qualDecl) = 0;
-        };
+		// Tells the concrete class of a declaration, see 'AstVisitor'.
+		enum class DeclKind : uint8_t {
+			TRANS_UNIT,
+			INTERFACE_BLOCK,
+			DECL_LIST,
+			STRUCT,
+			VAR,
+			FUN_PARAM,
+			FUN,
+			QUAL,
+		};
 
         class Decl {
         public:
 			virtual ~Decl() = default;
-            virtual void Accept(DeclVisitor* declVisitor) = 0;
+
+			DeclKind GetKind() const;
+
+		protected:
+			explicit Decl(DeclKind kind);
+
+		private:
+			DeclKind kind;
         };
 
 		class NamedEntity {
@@ -55,40 +65,40 @@ namespace crayon {
 
 		class AggregateEntity {
 		public:
-			void AddField(std::shared_ptr<VarDecl> fieldDecl);
+			void AddField(VarDecl* fieldDecl);
 			bool HasField(std::string_view fieldName) const;
-			std::shared_ptr<VarDecl> GetField(std::string_view fieldName);
-			std::shared_ptr<VarDecl> GetField(std::string_view fieldName, size_t& fieldIdx);
+			VarDecl* GetField(std::string_view fieldName);
+			VarDecl* GetField(std::string_view fieldName, size_t& fieldIdx);
 			size_t GetFieldCount() const;
-			const std::vector<std::shared_ptr<VarDecl>>& GetFields() const;
+			const std::vector<VarDecl*>& GetFields() const;
 
 		private:
-			std::vector<std::shared_ptr<VarDecl>> fields;
+			std::vector<VarDecl*> fields;
 		};
 
 		class ArrayEntity {
 		public:
-			void AddDimension(std::shared_ptr<Expr> dimSizeExpr);
+			void AddDimension(Expr* dimSizeExpr);
 			size_t GetDimensionCount() const;
 			bool IsArray() const;
-			const std::vector<std::shared_ptr<Expr>>& GetDimensions() const;
+			const std::vector<Expr*>& GetDimensions() const;
 		private:
-			std::vector<std::shared_ptr<Expr>> dimensions;
+			std::vector<Expr*> dimensions;
 		};
 
         class TransUnit : public Decl {
 		public:
-			void Accept(DeclVisitor* declVisitor) override;
+			TransUnit();
 
-			// void AddFunDecl(std::shared_ptr<FunDecl> funDecl);
-			// void AddQualDecl(std::shared_ptr<QualDecl> qualDecl);
-			// void AddVarDecl(std::shared_ptr<VarDecl> varDecl);
-			void AddDeclaration(std::shared_ptr<Decl> decl);
+			// void AddFunDecl(FunDecl* funDecl);
+			// void AddQualDecl(QualDecl* qualDecl);
+			// void AddVarDecl(VarDecl* varDecl);
+			void AddDeclaration(Decl* decl);
 
-			const std::vector<std::shared_ptr<Decl>>& GetDeclarations();
+			const std::vector<Decl*>& GetDeclarations();
 
 		private:
-			std::vector<std::shared_ptr<Decl>> decls;
+			std::vector<Decl*> decls;
 		};
 
 		class InterfaceBlockDecl : public Decl,
@@ -96,13 +106,11 @@ namespace crayon {
 								   public AggregateEntity,
 								   public ArrayEntity {
 		public:
-			InterfaceBlockDecl() = default;
+			InterfaceBlockDecl();
 			InterfaceBlockDecl(const Token& name);
 			InterfaceBlockDecl(const Token& name, const TypeQual& typeQual);
 			InterfaceBlockDecl(const Token& name, const TypeQual& typeQual, const Token& instanceName);
 
-			void Accept(DeclVisitor* declVisitor) override;
-
 			const TypeQual& GetTypeQualifier() const;
 
 			bool HasInstanceName() const;
@@ -117,27 +125,23 @@ namespace crayon {
 		public:
 			DeclList(const FullSpecType& fullSpecType);
 
-			void Accept(DeclVisitor* declVisitor) override;
-
-			void AddDecl(std::shared_ptr<VarDecl> decl);
-			const std::vector<std::shared_ptr<VarDecl>>& GetDecls() const;
+			void AddDecl(VarDecl* decl);
+			const std::vector<VarDecl*>& GetDecls() const;
 
 			const FullSpecType& GetFullSpecType() const;
 
 		private:
 			FullSpecType fullSpecType;
-			std::vector<std::shared_ptr<VarDecl>> decls;
+			std::vector<VarDecl*> decls;
 		};
 
 		class StructDecl : public Decl,
 						   public NamedEntity,
 						   public AggregateEntity {
 		public:
-			StructDecl() = default;
+			StructDecl();
 			StructDecl(const Token& structName);
 
-			void Accept(DeclVisitor* declVisitor) override;
-
 			bool IsStructDeclAnonymous() const;
 		};
 
@@ -146,8 +150,6 @@ namespace crayon {
 			VarDecl(const FullSpecType& varType, const Token& varName);
 			virtual ~VarDecl() = default;
 
-			void Accept(DeclVisitor* declVisitor) override;
-
 			bool IsVarTypeBasic() const;
 			bool IsVarTypeAggregate() const;
 			// i.e., int[] a; float[][] b;
@@ -164,8 +166,8 @@ namespace crayon {
 			const std::vector<ArrayDim>& GetDimensions() const;
 
 			bool HasInitializerExpr() const;
-			void SetInitializerExpr(std::shared_ptr<Expr> initExpr);
-			std::shared_ptr<Expr> GetInitializerExpr() const;
+			void SetInitializerExpr(Expr* initExpr);
+			Expr* GetInitializerExpr() const;
 
 			// Returns the type of an expression where the variable is used directly.
 			// i.e., if we have a variable declared as "int[3] a[2]",
@@ -176,11 +178,15 @@ namespace crayon {
 			FullSpecType& GetVarType();
 			const Token& GetVarName() const;
 
+		protected:
+			// For the parameters.
+			VarDecl(DeclKind kind, const FullSpecType& varType, const Token& varName);
+
 		private:
 			FullSpecType varType;
 			Token varName;
 			std::vector<ArrayDim> dimensions;
-			std::shared_ptr<Expr> initExpr;
+			Expr* initExpr{nullptr};
 		};
 
         class FunParam : public VarDecl {
@@ -199,33 +205,31 @@ namespace crayon {
 			const FullSpecType& GetReturnType() const;
 			const Token& GetFunctionName() const;
 
-			void AddFunParam(std::shared_ptr<FunParam> funParam);
+			void AddFunParam(FunParam* funParam);
 			bool FunParamListEmpty() const;
-			const std::vector<std::shared_ptr<FunParam>>& GetFunParamList() const;
+			const std::vector<FunParam*>& GetFunParamList() const;
 
 		private:
 			FullSpecType retType;
 			Token funName;
-			std::vector<std::shared_ptr<FunParam>> params;
+			std::vector<FunParam*> params;
 		};
 
         class FunDecl : public Decl {
 		public:
-			FunDecl(std::shared_ptr<FunProto> funProto);
-			FunDecl(std::shared_ptr<FunProto> funProto, std::shared_ptr<BlockStmt> stmts);
+			FunDecl(FunProto* funProto);
+			FunDecl(FunProto* funProto, BlockStmt* stmts);
 			virtual ~FunDecl() = default;
 
-			void Accept(DeclVisitor* declVisitor) override;
-
             bool IsFunDecl() const;
             bool IsFunDef() const;
 
-			std::shared_ptr<FunProto> GetFunProto() const;
-            std::shared_ptr<BlockStmt> GetBlockStmt() const;
+			FunProto* GetFunProto() const;
+            BlockStmt* GetBlockStmt() const;
 
 		private:
-			std::shared_ptr<FunProto> funProto;
-			std::shared_ptr<BlockStmt> stmts;
+			FunProto* funProto{nullptr};
+			BlockStmt* stmts{nullptr};
 		};
 
         class QualDecl : public Decl {
@@ -233,29 +237,27 @@ namespace crayon {
 			QualDecl(const TypeQual& qualifier);
 			virtual ~QualDecl() = default;
 
-			void Accept(DeclVisitor* declVisitor) override;
-
 			const TypeQual& GetTypeQualifier() const;
 
 		private:
 			TypeQual qualifier;
 		};
    
-		std::shared_ptr<InterfaceBlockDecl> CreatePerVertexIntBlockDecl();
-		std::shared_ptr<InterfaceBlockDecl> CreateInterfaceBlockDecl(TokenType storageQual, std::string_view interfaceName,
-			                                                         std::vector<std::shared_ptr<VarDecl>> fieldDecls,
-			                                                         std::string_view instanceName = std::string_view());
-
-		std::shared_ptr<VarDecl> CreateNonArrayTypeNonArrayVarDecl(TokenType varType, std::string_view varName);
-		std::shared_ptr<VarDecl> CreateNonArrayTypeNonArrayVarDecl(TokenType storageQual,
-			                                                       TokenType varType,
-			                                                       std::string_view varName);
-
-		std::shared_ptr<VarDecl> CreateNonArrayTypeArrayVarDecl(TokenType storageQual, TokenType varType,
-			                                                    std::string_view varName,
-			                                                    std::vector<ArrayDim> dimensions);
-		std::shared_ptr<VarDecl> CreateNonArrayTypeArrayVarDecl(TokenType varType, std::string_view varName,
-		                                                        std::vector<ArrayDim> dimensions);
+		InterfaceBlockDecl* CreatePerVertexIntBlockDecl(AstArena& astArena);
+		InterfaceBlockDecl* CreateInterfaceBlockDecl(AstArena& astArena, TokenType storageQual, std::string_view interfaceName,
+		                                             std::vector<VarDecl*> fieldDecls,
+		                                             std::string_view instanceName = std::string_view());
+
+		VarDecl* CreateNonArrayTypeNonArrayVarDecl(AstArena& astArena, TokenType varType, std::string_view varName);
+		VarDecl* CreateNonArrayTypeNonArrayVarDecl(AstArena& astArena, TokenType storageQual,
+		                                           TokenType varType,
+		                                           std::string_view varName);
+
+		VarDecl* CreateNonArrayTypeArrayVarDecl(AstArena& astArena, TokenType storageQual, TokenType varType,
+		                                        std::string_view varName,
+		                                        std::vector<ArrayDim> dimensions);
+		VarDecl* CreateNonArrayTypeArrayVarDecl(AstArena& astArena, TokenType varType, std::string_view varName,
+		                                        std::vector<ArrayDim> dimensions);
 
 	}
 }
\ No newline at end of file
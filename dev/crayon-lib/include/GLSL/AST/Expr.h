@@ -4,8 +4,6 @@
 #include "GLSL/Type.h"
 #include "GLSL/Value.h"
 
-#include "GLSL/Analyzer/Environment.h"
-
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -18,6 +16,7 @@ namespace crayon {
 
 		class InitListExpr;
 		class AssignExpr;
+		class TernaryExpr;
 		class BinaryExpr;
 		class UnaryExpr;
 		class FieldSelectExpr;
@@ -30,128 +29,70 @@ namespace crayon {
 		class DoubleConstExpr;
 		class GroupExpr;
 
-		class ExprVisitor {
-		public:
-			virtual void VisitInitListExpr(InitListExpr* initListExpr) = 0;
-			virtual void VisitAssignExpr(AssignExpr* assignExpr) = 0;
-			virtual void VisitBinaryExpr(BinaryExpr* binaryExpr) = 0;
-			virtual void VisitUnaryExpr(UnaryExpr* unaryExpr) = 0;
-			virtual void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) = 0;
-			virtual void VisitFunCallExpr(FunCallExpr* funCallExpr) = 0;
-			virtual void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) = 0;
-			virtual void VisitVarExpr(VarExpr* varExpr) = 0;
-			virtual void VisitIntConstExpr(IntConstExpr* intConstExpr) = 0;
-			virtual void VisitUintConstExpr(UintConstExpr* uintConstExpr) = 0;
-			virtual void VisitFloatConstExpr(FloatConstExpr* floatConstExpr) = 0;
-			virtual void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) = 0;
-			virtual void VisitGroupExpr(GroupExpr* groupExpr) = 0;
-		};
-
-		class ExprEvalVisitor : public ExprVisitor {
-		public:
-			using ExprValue = std::variant<bool, int, unsigned int, float, double>;
-
-			void VisitInitListExpr(InitListExpr* initListExpr) override;
-			void VisitAssignExpr(AssignExpr* assignExpr) override;
-			void VisitBinaryExpr(BinaryExpr* binaryExpr) override;
-			void VisitUnaryExpr(UnaryExpr* unaryExpr) override;
-			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) override;
-			void VisitFunCallExpr(FunCallExpr* funCallExpr) override;
-			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) override;
-			void VisitVarExpr(VarExpr* varExpr) override;
-			void VisitIntConstExpr(IntConstExpr* intConstExpr) override;
-			void VisitUintConstExpr(UintConstExpr* uintConstExpr) override;
-			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr) override;
-			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) override;
-			void VisitGroupExpr(GroupExpr* groupExpr) override;
-
-			bool ResultBool() const;
-			bool ResultInt() const;
-			bool ResultUint() const;
-			bool ResultFloat() const;
-			bool ResultDouble() const;
-			bool ResultUndefined() const;
-
-			bool GetBoolResult() const;
-			int GetIntResult() const;
-			unsigned int GetUintResult() const;
-			float GetFloatResult() const;
-			double GetDoubleResult() const;
-
-		private:
-			EnvironmentContext envCtx;
-			ExprValue result;
-			bool exprConstant{false};
-			bool resultUndefined{false};
-		};
-
-		class ExprTypeInferenceVisitor : public ExprVisitor {
-		public:
-			void VisitInitListExpr(InitListExpr* initListExpr) override;
-			void VisitAssignExpr(AssignExpr* assignExpr) override;
-			void VisitBinaryExpr(BinaryExpr* binaryExpr) override;
-			void VisitUnaryExpr(UnaryExpr* unaryExpr) override;
-			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) override;
-			void VisitFunCallExpr(FunCallExpr* funCallExpr) override;
-			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) override;
-			void VisitVarExpr(VarExpr* varExpr) override;
-			void VisitIntConstExpr(IntConstExpr* intConstExpr) override;
-			void VisitUintConstExpr(UintConstExpr* uintConstExpr) override;
-			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr) override;
-			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) override;
-			void VisitGroupExpr(GroupExpr* groupExpr) override;
-
-			void SetEnvironmentContext(const EnvironmentContext& envCtx);
-			void ResetEnvironmentContext();
-
-		private:
-			ExprEvalVisitor exprEvalVisitor;
-			EnvironmentContext envCtx;
+		// Tells the concrete class of an expression, see 'AstVisitor'.
+		enum class ExprKind : uint8_t {
+			INIT_LIST,
+			ASSIGN,
+			TERNARY,
+			BINARY,
+			UNARY,
+			FIELD_SELECT,
+			FUN_CALL,
+			CTOR_CALL,
+			VAR,
+			INT_CONST,
+			UINT_CONST,
+			FLOAT_CONST,
+			DOUBLE_CONST,
+			GROUP,
 		};
 
 		class Expr {
 		public:
-			Expr() = default;
 			virtual ~Expr() = default;
 
-			virtual void Accept(ExprVisitor* exprVisitor) = 0;
-			
+			ExprKind GetKind() const;
+
 			void SetExprTypeId(size_t typeId);
 			size_t GetExprTypeId() const;
 			void SetExprConstState(bool isConst);
 			bool IsConstExpr() const;
 
 			virtual std::string_view ToString() const {return std::string_view();}
-			virtual std::pair<size_t, size_t> GetExprColBounds() const {return std::pair<size_t, size_t>();}
+			// The source code the expression was parsed from, empty if unknown.
+			virtual std::string_view GetExprSrcText() const {return std::string_view();}
 
 		protected:
+			explicit Expr(ExprKind kind);
+
 			size_t typeId{0};
 			bool isConst{false};
+
+		private:
+			ExprKind kind;
 		};
 
 		class InitListExpr : public Expr {
 		public:
+			InitListExpr();
 			virtual ~InitListExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
-
-			void AddInitExpr(std::shared_ptr<Expr> initExpr);
+			void AddInitExpr(Expr* initExpr);
 
 			bool IsEmpty() const;
-			const std::vector<std::shared_ptr<Expr>>& GetInitExprs() const;
+			const std::vector<Expr*>& GetInitExprs() const;
 
 		private:
-			std::vector<std::shared_ptr<Expr>> initExprs;
+			std::vector<Expr*> initExprs;
 		};
 
 		class AssignExpr : public Expr {
 		public:
-			AssignExpr(std::shared_ptr<Expr> lvalue, std::shared_ptr<Expr> rvalue, const Token& assignOp);
+			AssignExpr(Expr* lvalue, Expr* rvalue, const Token& assignOp);
 			virtual ~AssignExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetAssignOp() const;
 
@@ -160,16 +101,34 @@ namespace crayon {
 
 		private:
 			Token assignOp;
-			std::shared_ptr<Expr> lvalue;
-			std::shared_ptr<Expr> rvalue;
+			Expr* lvalue{nullptr};
+			Expr* rvalue{nullptr};
+		};
+
+		// 'condition ? trueExpr : falseExpr', only one of the branches is evaluated.
+		class TernaryExpr : public Expr {
+		public:
+			TernaryExpr(Expr* condition, Expr* trueExpr, Expr* falseExpr);
+			virtual ~TernaryExpr() = default;
+
+			std::string_view GetExprSrcText() const override;
+
+			Expr* GetCondition() const;
+			Expr* GetTrueExpr() const;
+			Expr* GetFalseExpr() const;
+
+		private:
+			Expr* condition{nullptr};
+			Expr* trueExpr{nullptr};
+			Expr* falseExpr{nullptr};
 		};
 
 		class BinaryExpr : public Expr {
 		public:
-			BinaryExpr(std::shared_ptr<Expr> left, const Token& op, std::shared_ptr<Expr> right);
+			BinaryExpr(Expr* left, const Token& op, Expr* right);
 			virtual ~BinaryExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
+			std::string_view GetExprSrcText() const override;
 
 			Expr* GetLeftExpr() const;
 			Expr* GetRightExpr() const;
@@ -177,62 +136,59 @@ namespace crayon {
 			const Token& GetOperator() const;
 
 		private:
-			std::shared_ptr<Expr> left;
-			std::shared_ptr<Expr> right;
+			Expr* left{nullptr};
+			Expr* right{nullptr};
 			Token op;
 		};
 
 		class UnaryExpr : public Expr {
 		public:
-			UnaryExpr(const Token& op, std::shared_ptr<Expr> expr);
+			UnaryExpr(const Token& op, Expr* expr);
 			virtual ~UnaryExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
+			std::string_view GetExprSrcText() const override;
 
 			Expr* GetExpr() const;
 			const Token& GetOperator() const;
 
 		private:
 			Token op;
-			std::shared_ptr<Expr> expr;
+			Expr* expr{nullptr};
 		};
 
 		class FieldSelectExpr : public Expr {
 		public:
-			FieldSelectExpr(std::shared_ptr<Expr> target, const Token& field);
+			FieldSelectExpr(Expr* target, const Token& field);
 			virtual ~FieldSelectExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
-
 			Expr* GetTarget() const;
 			const Token& GetField() const;
 
 		private:
-			std::shared_ptr<Expr> target;
+			Expr* target{nullptr};
 			Token field;
 		};
 
 		class CallExpr {
 		public:
-			void AddArg(std::shared_ptr<Expr> arg);
+			void AddArg(Expr* arg);
 			bool HasArgs() const;
-			const std::vector<std::shared_ptr<Expr>>& GetArgs() const;
+			const std::vector<Expr*>& GetArgs() const;
 
 		private:
-			std::vector<std::shared_ptr<Expr>> args;
+			std::vector<Expr*> args;
 		};
 
 		class FunCallExpr : public Expr,
 		                    public CallExpr {
 		public:
-			FunCallExpr(std::shared_ptr<Expr> target);
+			FunCallExpr(Expr* target);
 			virtual ~FunCallExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			Expr* GetTarget() const;
 
 		private:
-			std::shared_ptr<Expr> target;
+			Expr* target{nullptr};
 		};
 
 		class CtorCallExpr : public Expr,
@@ -241,7 +197,6 @@ namespace crayon {
 			CtorCallExpr(const TypeSpec& typeSpec);
 			virtual ~CtorCallExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			const TypeSpec& GetType() const;
 
 		private:
@@ -253,9 +208,8 @@ namespace crayon {
 			VarExpr(const Token& variable);
 			virtual ~VarExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetVariable() const;
 
@@ -268,12 +222,10 @@ namespace crayon {
 			IntConstExpr(const Token& intConst, ConstId intConstId);
 			virtual ~IntConstExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetIntConst() const;
-			int GetValue() const;
 			ConstId GetConstId() const;
 
 		private:
@@ -285,12 +237,10 @@ namespace crayon {
 			UintConstExpr(const Token& uintConst, ConstId uintConstId);
 			virtual ~UintConstExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetUintConst() const;
-			unsigned int GetValue() const;
 			ConstId GetConstId() const;
 
 		private:
@@ -303,12 +253,10 @@ namespace crayon {
 			FloatConstExpr(const Token& floatConst, ConstId floatConstId);
 			virtual ~FloatConstExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetFloatConst() const;
-			float GetValue() const;
 			ConstId GetConstId() const;
 
 		private:
@@ -320,12 +268,10 @@ namespace crayon {
 			DoubleConstExpr(const Token& doubleConst, ConstId doubleConstId);
 			virtual ~DoubleConstExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			const Token& GetDoubleConst() const;
-			double GetValue() const;
 			ConstId GetConstId() const;
 
 		private:
@@ -335,17 +281,16 @@ namespace crayon {
 
 		class GroupExpr : public Expr {
 		public:
-			GroupExpr(std::shared_ptr<Expr> expr);
+			GroupExpr(Expr* expr);
 			virtual ~GroupExpr() = default;
 
-			void Accept(ExprVisitor* exprVisitor) override;
 			std::string_view ToString() const override;
-			std::pair<size_t, size_t> GetExprColBounds() const override;
+			std::string_view GetExprSrcText() const override;
 
 			Expr* GetExpr() const;
 
 		private:
-			std::shared_ptr<Expr> expr;
+			Expr* expr{nullptr};
 		};
 	
 	}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "GLSL/Token.h"
+#include "GLSL/Type.h"
+#include "GLSL/Value.h"
+
+#include "GLSL/AST/AstVisitor.h"
+#include "GLSL/AST/Expr.h"
+#include "GLSL/AST/FlatAst.h"
+
+#include "GLSL/Analyzer/Environment.h"
+
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		class ExprEvalVisitor : public AstVisitor<ExprEvalVisitor> {
+		public:
+			using ExprValue = std::variant<bool, int, unsigned int, float, double>;
+
+			void VisitInitListExpr(InitListExpr* initListExpr);
+			void VisitAssignExpr(AssignExpr* assignExpr);
+			void VisitTernaryExpr(TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(VarExpr* varExpr);
+			void VisitIntConstExpr(IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(GroupExpr* groupExpr);
+
+			bool ResultBool() const;
+			bool ResultInt() const;
+			bool ResultUint() const;
+			bool ResultFloat() const;
+			bool ResultDouble() const;
+			bool ResultUndefined() const;
+
+			bool GetBoolResult() const;
+			int GetIntResult() const;
+			unsigned int GetUintResult() const;
+			float GetFloatResult() const;
+			double GetDoubleResult() const;
+
+			// Evaluation stops at the first error instead of throwing, the result is then undefined
+			// and the message and the offending expression are kept for the caller to report.
+			bool Evaluate(Expr* expr);
+			std::string_view GetErrorMessage() const;
+			Expr* GetErrorExpr() const;
+
+			void SetEnvironmentContext(const EnvironmentContext& envCtx);
+			void ResetEnvironmentContext();
+
+		private:
+			void Fail(Expr* expr, std::string_view errMsg);
+
+			EnvironmentContext envCtx;
+			ExprValue result;
+			bool exprConstant{false};
+			bool resultUndefined{false};
+			std::string_view errMsg;
+			Expr* errExpr{nullptr};
+		};
+
+		class ExprTypeInferenceVisitor : public AstVisitor<ExprTypeInferenceVisitor> {
+		public:
+			void VisitInitListExpr(InitListExpr* initListExpr);
+			void VisitAssignExpr(AssignExpr* assignExpr);
+			void VisitTernaryExpr(TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(VarExpr* varExpr);
+			void VisitIntConstExpr(IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(GroupExpr* groupExpr);
+
+			void SetEnvironmentContext(const EnvironmentContext& envCtx);
+			void ResetEnvironmentContext();
+
+		private:
+			ExprEvalVisitor exprEvalVisitor;
+			EnvironmentContext envCtx;
+		};
+
+		// 'ExprEvalVisitor' over a flat syntax tree. The operands precede the expressions using them,
+		// so every expression of the tree is evaluated in a single pass over the array, without recursion.
+		// An expression gets the result (or the first error) 'ExprEvalVisitor::Evaluate' would give it,
+		// except that variables, field selections, calls, initializer lists and assignments are undefined.
+		class FlatExprEvaluator {
+		public:
+			using ExprValue = ExprEvalVisitor::ExprValue;
+
+			// The literals' constant ids are mapped through 'constIds' if provided (see 'FlatAstLoaderConfig').
+			void EvaluateAll(const FlatAst& flatAst, const ConstantTable& constTable,
+			                 const std::unordered_map<ConstId, ConstId>* constIds = nullptr);
+
+			bool IsDefined(FlatId exprId) const;
+			// The expression must be defined.
+			const ExprValue& GetResult(FlatId exprId) const;
+			// Empty for the expressions that aren't supported.
+			std::string_view GetErrorMessage(FlatId exprId) const;
+			// The operand the error comes from, 'noFlatId' for the expressions that aren't supported.
+			FlatId GetErrorExpr(FlatId exprId) const;
+
+		private:
+			struct Result {
+				ExprValue value;
+				bool defined{false};
+				// The expression the error comes from, its message is in 'errors'.
+				FlatId errExpr{noFlatId};
+			};
+			struct Error {
+				FlatId exprId{noFlatId};
+				std::string_view errMsg;
+			};
+
+			void Fail(Result& result, FlatId exprId, std::string_view errMsg);
+
+			std::vector<Result> results;
+			// Few and sorted, they're added in the order of the expressions.
+			std::vector<Error> errors;
+		};
+
+		// 'ExprTypeInferenceVisitor' over a flat syntax tree, in a single pass over the expression array.
+		// The types of variables, field selections, function calls and initializer lists come from declarations,
+		// the ones of constructor calls from their type specifier: they're kept as the tree holds them.
+		// The rest is inferred from the operands.
+		class FlatExprTypeInference {
+		public:
+			// The tree's type ids must be ids of the table.
+			void InferAll(FlatAst& flatAst, TypeTable& typeTable);
+		};
+
+	}
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "GLSL/Token.h"
+#include "GLSL/Type.h"
+#include "GLSL/Value.h"
+
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/AST/AstVisitor.h"
+#include "GLSL/AST/Decl.h"
+#include "GLSL/AST/Expr.h"
+#include "GLSL/AST/Stmt.h"
+
+#include "ByteStream.h"
+#include "Utility.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// Handles of the flat syntax tree's nodes, indices into its arrays.
+		using FlatId = uint32_t;
+		constexpr FlatId noFlatId{UINT32_MAX};
+
+		// Consecutive entries of one of the child arrays.
+		struct FlatRange {
+			uint32_t begin{0};
+			uint32_t count{0};
+		};
+
+		// A lexeme in the string data of the tree (see 'FlatAst::GetStr').
+		struct FlatStr {
+			uint32_t offset{0};
+			uint32_t length{0};
+		};
+
+		struct FlatToken {
+			FlatStr lexeme;
+			// 'TokenType::UNDEFINED' stands for a missing optional token.
+			int32_t tokenType{static_cast<int32_t>(TokenType::UNDEFINED)};
+		};
+
+		enum class FlatDeclKind : uint32_t {
+			TRANS_UNIT,
+			INTERFACE_BLOCK,
+			DECL_LIST,
+			STRUCT,
+			VAR,
+			FUN_PARAM,
+			FUN,
+			QUAL,
+			COUNT
+		};
+		enum class FlatStmtKind : uint32_t {
+			BLOCK,
+			DECL,
+			EXPR,
+			COUNT
+		};
+		enum class FlatExprKind : uint32_t {
+			INIT_LIST,
+			ASSIGN,
+			TERNARY,
+			BINARY,
+			UNARY,
+			FIELD_SELECT,
+			FUN_CALL,
+			CTOR_CALL,
+			VAR,
+			INT_CONST,
+			UINT_CONST,
+			FLOAT_CONST,
+			DOUBLE_CONST,
+			GROUP,
+			COUNT
+		};
+
+		struct FlatDecl {
+			FlatDeclKind kind{FlatDeclKind::COUNT};
+			// The name of an interface block, a structure, a variable, a parameter or a function.
+			FlatToken name;
+			FlatToken instanceName;
+			// Of an interface block or a qualifier declaration,
+			// with the type specifier: of a declaration list, a variable, a parameter or a function's return type.
+			FlatId typeQual{noFlatId};
+			FlatId typeSpec{noFlatId};
+			// Declarations, fields or parameters, in 'declChildren'.
+			FlatRange children;
+			// Of an interface block (expressions only), a variable or a parameter, in 'arrayDims'.
+			FlatRange dims;
+			// The initializer of a variable.
+			FlatId initExpr{noFlatId};
+			// The body of a function definition.
+			FlatId body{noFlatId};
+		};
+
+		struct FlatStmt {
+			FlatStmtKind kind{FlatStmtKind::COUNT};
+			// The declaration or the expression of a declaration or an expression statement.
+			FlatId child{noFlatId};
+			// The statements of a block, in 'stmtChildren'.
+			FlatRange children;
+		};
+
+		// The operands are listed in 'exprOperands', in the order of the source code:
+		// [lvalue, rvalue] of an assignment, [condition, true, false] of a ternary expression, [left, right] of a binary expression,
+		// [target, args...] of a function call, [args...] of a constructor call, and so on.
+		// An operand always precedes the expression using it, so passes that need the operands first
+		// (type inference, evaluation) go through the array from the front, without recursion.
+		struct FlatExpr {
+			FlatExprKind kind{FlatExprKind::COUNT};
+			uint32_t isConst{0};
+			// The operator, the variable, the field or the literal.
+			FlatToken token;
+			FlatRange operands;
+			// The type of a constructor call.
+			FlatId typeSpec{noFlatId};
+		};
+
+		struct FlatLayoutQual {
+			FlatToken name;
+			uint32_t hasValue{0};
+			int32_t value{0};
+		};
+
+		struct FlatTypeQual {
+			// In 'layoutQuals'.
+			FlatRange layout;
+			FlatToken storage;
+			FlatToken precision;
+			FlatToken interpolation;
+			FlatToken invariant;
+			FlatToken precise;
+		};
+
+		struct FlatTypeSpec {
+			FlatToken type;
+			FlatId structDecl{noFlatId};
+			// In 'arrayDims'.
+			FlatRange dims;
+		};
+
+		struct FlatArrayDim {
+			FlatId expr{noFlatId};
+			uint32_t dimSize{0};
+		};
+
+		// The syntax tree stored as arrays of plain structures, one per kind of node, linked by 32-bit indices.
+		// The children of a node are ranges of the child arrays, the expression types and the constant ids
+		// live in side tables. There are no pointers: the arrays are written and read as they are.
+		// The lexemes are offsets into the string data: the source code the tree was built from,
+		// followed by the lexemes made up by the parser.
+		class FlatAst {
+		public:
+			FlatAst() = default;
+			CLASS_NO_COPY(FlatAst);
+
+			// Also clears the string data, which starts with the source code (it must outlive the tree).
+			void Reset(std::string_view srcCode);
+
+			// Writes the arrays, the string data is up to the caller (see 'GetStrData' and 'Read').
+			void Write(ByteWriter& writer) const;
+			// Reads the arrays, their string data is the given one.
+			// Every index is checked, returns 'false' if any of them is out of range.
+			bool Read(ByteReader& reader, std::string_view strData);
+
+			// The source code followed by the made up lexemes, what 'Read' expects.
+			std::string GetStrData() const;
+			std::string_view GetStr(const FlatStr& str) const;
+			Token GetToken(const FlatToken& token) const;
+			// The expression must be a literal.
+			ConstId GetConstId(FlatId exprId) const;
+
+			std::vector<FlatDecl> decls;
+			std::vector<FlatStmt> stmts;
+			std::vector<FlatExpr> exprs;
+			std::vector<FlatId> declChildren;
+			std::vector<FlatId> stmtChildren;
+			std::vector<FlatId> exprOperands;
+			std::vector<FlatTypeQual> typeQuals;
+			std::vector<FlatTypeSpec> typeSpecs;
+			std::vector<FlatArrayDim> arrayDims;
+			std::vector<FlatLayoutQual> layoutQuals;
+			// Side tables, the type id of every expression and the constant id of every literal.
+			// The literals are sorted, like the expressions.
+			std::vector<uint32_t> exprTypeIds;
+			std::vector<FlatId> constExprIds;
+			std::vector<ConstId> constIds;
+
+		private:
+			friend class FlatAstBuilder;
+
+			bool CheckStr(const FlatStr& str) const;
+			bool CheckToken(const FlatToken& token) const;
+			bool CheckId(FlatId id, size_t count, bool optional = false) const;
+			bool CheckRange(const FlatRange& range, size_t count) const;
+
+			std::string_view srcCode;
+			std::string extraStrData;
+		};
+
+		// Flattens syntax trees, every node once: a node reachable from two places
+		// (i.e., a structure declared along with a variable and referred to by its type) keeps a single id.
+		class FlatAstBuilder : public AstVisitor<FlatAstBuilder> {
+		public:
+			// Resets the tree to the source code of the syntax trees.
+			FlatAstBuilder(FlatAst& flatAst, std::string_view srcCode);
+
+			FlatId AddDecl(Decl* decl);
+			FlatId AddTypeSpec(const TypeSpec& typeSpec);
+			// Lexemes outside of the source code are appended to the string data once.
+			FlatStr AddStr(std::string_view str);
+
+			void VisitTransUnit(TransUnit* transUnit);
+			void VisitInterfaceBlockDecl(InterfaceBlockDecl* interfaceBlockDecl);
+			void VisitDeclList(DeclList* declList);
+			void VisitStructDecl(StructDecl* structDecl);
+			void VisitVarDecl(VarDecl* varDecl);
+			void VisitFunDecl(FunDecl* funDecl);
+			void VisitQualDecl(QualDecl* qualDecl);
+
+			void VisitBlockStmt(BlockStmt* blockStmt);
+			void VisitDeclStmt(DeclStmt* declStmt);
+			void VisitExprStmt(ExprStmt* exprStmt);
+
+			void VisitInitListExpr(InitListExpr* initListExpr);
+			void VisitAssignExpr(AssignExpr* assignExpr);
+			void VisitTernaryExpr(TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(VarExpr* varExpr);
+			void VisitIntConstExpr(IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(GroupExpr* groupExpr);
+
+		private:
+			FlatId AddStmt(Stmt* stmt);
+			FlatId AddExpr(Expr* expr);
+			FlatId AddTypeQual(const TypeQual& typeQual);
+			FlatToken AddToken(const Token& token);
+			FlatToken AddOptionalToken(const std::optional<Token>& token);
+			FlatRange AddDeclChildren(const std::vector<FlatId>& children);
+			FlatRange AddArrayDims(const std::vector<ArrayDim>& dims);
+			FlatRange AddArrayDims(const std::vector<Expr*>& dimExprs);
+			void AddVarDeclBody(FlatDecl& flatDecl, VarDecl* varDecl);
+			void AddExprNode(FlatExprKind kind, Expr* expr, const Token& token, const std::vector<FlatId>& operands,
+			                 FlatId typeSpec = noFlatId);
+			void AddConstExprNode(FlatExprKind kind, Expr* expr, const Token& token, ConstId constId);
+
+			FlatAst& flatAst;
+			std::unordered_map<const Decl*, FlatId> declIds;
+			std::unordered_map<const Expr*, FlatId> exprIds;
+			std::unordered_map<std::string, uint32_t> extraStrOffsets;
+			// Set by the visit methods.
+			FlatId lastId{noFlatId};
+		};
+
+		struct FlatAstLoaderConfig {
+			AstArena* astArena{nullptr};
+			// Optional. Maps the constant ids of the tree to the ones of another constant table,
+			// every constant of the tree must be mapped.
+			const std::unordered_map<ConstId, ConstId>* constIds{nullptr};
+		};
+
+		// Recreates the nodes of a flat syntax tree, every node once, so the shared ones stay shared.
+		// Throws 'std::runtime_error' if a node contains itself or a constant id isn't mapped,
+		// 'FlatAst::Read' checks everything else.
+		class FlatAstLoader {
+		public:
+			FlatAstLoader(const FlatAst& flatAst, const FlatAstLoaderConfig& config);
+			CLASS_NO_COPY(FlatAstLoader);
+			CLASS_NO_MOVE(FlatAstLoader);
+
+			Decl* LoadDecl(FlatId declId);
+			TypeSpec LoadTypeSpec(FlatId typeSpecId);
+			// Sets the type ids of the loaded expressions, mapped through the table (indexed by the tree's type ids).
+			// Throws 'std::runtime_error' if a type id isn't mapped.
+			void SetExprTypeIds(const std::vector<size_t>& typeIds);
+
+		private:
+			// A node being loaded is marked, so that a node containing itself isn't loaded forever.
+			template <typename T>
+			struct LoadedNode {
+				T* node{nullptr};
+				bool loading{false};
+			};
+
+			Decl* LoadDeclNode(const FlatDecl& flatDecl);
+			Stmt* LoadStmt(FlatId stmtId);
+			Stmt* LoadStmtNode(const FlatStmt& flatStmt);
+			Expr* LoadExpr(FlatId exprId);
+			Expr* LoadExprNode(FlatId exprId, const FlatExpr& flatExpr);
+			// A loaded declaration of any other kind than 'kind' means a corrupted file.
+			template <typename T>
+			T* LoadDeclAs(FlatId declId, DeclKind kind);
+			void LoadVarDeclBody(VarDecl* varDecl, const FlatDecl& flatDecl);
+			std::vector<ArrayDim> LoadArrayDims(const FlatRange& dims);
+			TypeQual LoadTypeQual(FlatId typeQualId);
+			FullSpecType LoadFullSpecType(const FlatDecl& flatDecl);
+			std::optional<Token> LoadOptionalToken(const FlatToken& token) const;
+			ConstId LoadConstId(FlatId exprId) const;
+			const FlatId* GetOperands(const FlatExpr& flatExpr) const;
+
+			const FlatAst& flatAst;
+			FlatAstLoaderConfig config;
+			std::vector<LoadedNode<Decl>> decls;
+			std::vector<LoadedNode<Stmt>> stmts;
+			std::vector<LoadedNode<Expr>> exprs;
+		};
+
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "GLSL/Type.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -14,57 +15,58 @@ namespace crayon {
 		class DeclStmt;
 		class ExprStmt;
 
-		class StmtVisitor {
-		public:
-			virtual void VisitBlockStmt(BlockStmt* blockStmt) = 0;
-			virtual void VisitDeclStmt(DeclStmt* declStmt) = 0;
-			virtual void VisitExprStmt(ExprStmt* exprStmt) = 0;
+		// Tells the concrete class of a statement, see 'AstVisitor'.
+		enum class StmtKind : uint8_t {
+			BLOCK,
+			DECL,
+			EXPR,
 		};
 
 		class Stmt {
 		public:
-			Stmt() = default;
 			virtual ~Stmt() = default;
-			virtual void Accept(StmtVisitor* stmtVisitor) = 0;
+
+			StmtKind GetKind() const;
+
+		protected:
+			explicit Stmt(StmtKind kind);
+
+		private:
+			StmtKind kind;
 		};
 
 		class BlockStmt : public Stmt {
 		public:
+			BlockStmt();
 			virtual ~BlockStmt() = default;
 
-			void Accept(StmtVisitor* stmtVisitor) override;
-
-			void AddStmt(std::shared_ptr<Stmt> stmt);
+			void AddStmt(Stmt* stmt);
 
 			bool IsEmpty() const;
-			const std::vector<std::shared_ptr<Stmt>>& GetStatements() const;
+			const std::vector<Stmt*>& GetStatements() const;
 
 		private:
-			std::vector<std::shared_ptr<Stmt>> stmts;
+			std::vector<Stmt*> stmts;
 		};
 
 		class DeclStmt : public Stmt {
 		public:
-			DeclStmt(std::shared_ptr<Decl> decl);
+			DeclStmt(Decl* decl);
 			virtual ~DeclStmt() = default;
 
-			void Accept(StmtVisitor* stmtVisitor) override;
-
-			std::shared_ptr<Decl> GetDeclaration() const;
+			Decl* GetDeclaration() const;
 		private:
-			std::shared_ptr<Decl> decl;
+			Decl* decl{nullptr};
 		};
 	
 		class ExprStmt : public Stmt {
 		public:
-			ExprStmt(std::shared_ptr<Expr> expr);
+			ExprStmt(Expr* expr);
 			virtual ~ExprStmt() = default;
 
-			void Accept(StmtVisitor* stmtVisitor) override;
-
-			std::shared_ptr<Expr> GetExpression() const;
+			Expr* GetExpression() const;
 		private:
-			std::shared_ptr<Expr> expr;
+			Expr* expr{nullptr};
 		};
 	
 	}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace crayon {
+	namespace glsl {
+
+		// Character classes of the lexer. Every byte is classified with a single table lookup.
+		constexpr uint8_t charClassLetter {1 << 0}; // [A-Za-z]
+		constexpr uint8_t charClassDecimal{1 << 1}; // [0-9]
+		constexpr uint8_t charClassOctal  {1 << 2}; // [0-7]
+		constexpr uint8_t charClassHex    {1 << 3}; // [0-9A-Fa-f]
+		constexpr uint8_t charClassAlpha  {1 << 4}; // [A-Za-z_], the first character of an identifier
+		constexpr uint8_t charClassAlnum  {1 << 5}; // [A-Za-z_0-9], the rest of an identifier
+		constexpr uint8_t charClassSpace  {1 << 6}; // ' ', '\t', '\r', '\n'
+
+		constexpr std::array<uint8_t, 256> MakeCharClassTable() {
+			std::array<uint8_t, 256> table{};
+			for (int c = 'A'; c <= 'Z'; c++) {
+				table[c] |= charClassLetter | charClassAlpha | charClassAlnum;
+				table[c - 'A' + 'a'] |= charClassLetter | charClassAlpha | charClassAlnum;
+			}
+			for (int c = '0'; c <= '9'; c++) {
+				table[c] |= charClassDecimal | charClassHex | charClassAlnum;
+			}
+			for (int c = '0'; c <= '7'; c++) {
+				table[c] |= charClassOctal;
+			}
+			for (int c = 'A'; c <= 'F'; c++) {
+				table[c] |= charClassHex;
+				table[c - 'A' + 'a'] |= charClassHex;
+			}
+			table['_'] |= charClassAlpha | charClassAlnum;
+			table[' '] |= charClassSpace;
+			table['\t'] |= charClassSpace;
+			table['\r'] |= charClassSpace;
+			table['\n'] |= charClassSpace;
+			return table;
+		}
+		inline constexpr std::array<uint8_t, 256> charClassTable = MakeCharClassTable();
+
+		inline bool HasCharClass(char c, uint8_t charClass) {
+			return (charClassTable[static_cast<unsigned char>(c)] & charClass) != 0;
+		}
+
+		// The routines below process 32 (AVX2) or 16 (SSE2) bytes at a time when the target supports it,
+		// and fall back to the character class table otherwise (and for the last few bytes of the input).
+		// They only move the position forward, lines and columns are resolved later on demand (see "GLSL/SrcLocation.h").
+
+		// Skips spaces, tabs and line breaks.
+		void SkipWhitespace(const char* srcData, size_t srcSize, size_t& pos);
+		// Skips the body of a "//" comment, up to (not including) the line break.
+		void SkipLineComment(const char* srcData, size_t srcSize, size_t& pos);
+		// Skips the body of a "/* */" comment, including the closing "*/".
+		// Returns 'false' if the comment isn't terminated, the position is at the end of the input then.
+		bool SkipBlockComment(const char* srcData, size_t srcSize, size_t& pos);
+		// Skips the characters of an identifier after its first one.
+		void SkipIdentifierTail(const char* srcData, size_t srcSize, size_t& pos);
+
+	}
+}
@@ -25,13 +25,13 @@ namespace crayon {
 			bool IsExternalScope() const;
 			std::shared_ptr<NestedScopeEnvironment> GetEnclosingScope() const;
 
-			void AddVarDecl(std::shared_ptr<VarDecl> varDecl);
+			void AddVarDecl(VarDecl* varDecl);
 			void RemoveVarDecl(std::string_view varDeclName);
 			bool VarDeclExists(std::string_view varName) const;
-			std::shared_ptr<VarDecl> GetVarDecl(std::string_view varName) const;
+			VarDecl* GetVarDecl(std::string_view varName) const;
 
 		private:
-			std::unordered_map<std::string_view, std::shared_ptr<VarDecl>> variables;
+			std::unordered_map<std::string_view, VarDecl*> variables;
 			std::shared_ptr<NestedScopeEnvironment> enclosingScope;
 		};
 
@@ -47,23 +47,23 @@ namespace crayon {
 
 			// Extended GLSL block declarations.
 
-			void SetVertexInputLayoutBlock(std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout);
-			void SetMaterialPropertiesBlock(std::shared_ptr<MaterialPropertiesBlock> materialProperties);
-			void SetColorAttachmentsBlock(std::shared_ptr<ColorAttachmentsBlock> colorAttachments);
+			void SetVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayout);
+			void SetMaterialPropertiesBlock(MaterialPropertiesBlock* materialProperties);
+			void SetColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachments);
 
 			bool VertexInputLayoutFieldExists(std::string_view vertexAttribName) const;
 			bool MatPropsFieldExists(std::string_view matPropName) const;
 			bool ColorAttachmentFieldExists(std::string_view colorAttachmentName) const;
 
-			std::shared_ptr<VertexAttribDecl> GetVertexAttribDecl(std::string_view vertexAttribName) const;
-			std::shared_ptr<MatPropDecl> GetMatPropDecl(std::string_view matPropName) const;
-			std::shared_ptr<ColorAttachmentDecl> GetColorAttachmentDecl(std::string_view colorAttachmentName) const;
+			VertexAttribDecl* GetVertexAttribDecl(std::string_view vertexAttribName) const;
+			MatPropDecl* GetMatPropDecl(std::string_view matPropName) const;
+			ColorAttachmentDecl* GetColorAttachmentDecl(std::string_view colorAttachmentName) const;
 
 			// Core GLSL declarations.
 
-			void AddStructDecl(std::shared_ptr<StructDecl> structDecl);
-			void AddInterfaceBlockDecl(std::shared_ptr<InterfaceBlockDecl> intBlockDecl);
-			void AddFunDecl(std::shared_ptr<FunDecl> funDecl);
+			void AddStructDecl(StructDecl* structDecl);
+			void AddInterfaceBlockDecl(InterfaceBlockDecl* intBlockDecl);
+			void AddFunDecl(FunDecl* funDecl);
 
 			void RemoveStructDecl(std::string_view structDeclName);
 			void RemoveInterfaceBlockDecl(std::string_view intBlockName);
@@ -76,20 +76,20 @@ namespace crayon {
 			bool IntBlockFieldExists(std::string_view fieldName) const;
 			bool FunDeclExists(std::string_view funName) const;
 
-			std::shared_ptr<StructDecl> GetStructDecl(std::string_view structName) const;
-			std::shared_ptr<VarDecl> GetStructField(std::string_view structName, std::string_view fieldName) const;
-			std::shared_ptr<InterfaceBlockDecl> GetIntBlockDecl(std::string_view intBlockName) const;
-			std::shared_ptr<VarDecl> GetIntBlockField(std::string_view intBlockName, std::string_view fieldName) const;
-			std::shared_ptr<FunDecl> GetFunDecl(std::string_view funName) const;
+			StructDecl* GetStructDecl(std::string_view structName) const;
+			VarDecl* GetStructField(std::string_view structName, std::string_view fieldName) const;
+			InterfaceBlockDecl* GetIntBlockDecl(std::string_view intBlockName) const;
+			VarDecl* GetIntBlockField(std::string_view intBlockName, std::string_view fieldName) const;
+			FunDecl* GetFunDecl(std::string_view funName) const;
 
 		private:
-			std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout;
-			std::shared_ptr<MaterialPropertiesBlock> materialProperties;
-			std::shared_ptr<ColorAttachmentsBlock> colorAttachments;
+			VertexInputLayoutBlock* vertexInputLayout{nullptr};
+			MaterialPropertiesBlock* materialProperties{nullptr};
+			ColorAttachmentsBlock* colorAttachments{nullptr};
 
-			std::unordered_map<std::string_view, std::shared_ptr<StructDecl>> structs;
-			std::unordered_map<std::string_view, std::shared_ptr<InterfaceBlockDecl>> interfaceBlocks;
-			std::unordered_map<std::string_view, std::shared_ptr<FunDecl>> functions;
+			std::unordered_map<std::string_view, StructDecl*> structs;
+			std::unordered_map<std::string_view, InterfaceBlockDecl*> interfaceBlocks;
+			std::unordered_map<std::string_view, FunDecl*> functions;
 		};
 
 		struct EnvironmentContext {
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "GLSL/Token.h"
+
+#include <string_view>
+
+namespace crayon {
+	namespace glsl {
+
+		// Returns the keyword's token type, or 'TokenType::IDENTIFIER' if the lexeme isn't a keyword.
+		// The keywords are fixed at compile time, the lookup hashes a few characters of the lexeme
+		// into a collision-free table and compares a single candidate.
+		TokenType FindKeyword(std::string_view lexeme);
+
+	}
+}
@@ -1,29 +1,42 @@
 #pragma once
 
+#include "GLSL/Analyzer/CharScan.h"
+#include "GLSL/Analyzer/TokenRing.h"
+#include "GLSL/Analyzer/TokenStream.h"
+#include "GLSL/Error.h"
 #include "GLSL/Token.h"
 #include "GLSL/Value.h"
 
 #include "CmdLine/CmdLineCommon.h"
 
 #include <cstdint>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 
 namespace crayon {
 	namespace glsl {
 
 		struct LexerConfig {
-			// const ErrorReporter* errorReporter{nullptr};
-			const std::unordered_map<std::string_view, TokenType>* keywords{nullptr};
+			const ErrorReporter* errorReporter{nullptr};
 			GpuApiType gpuApiType{GpuApiType::NONE};
+			// Numeric literals are interned into it while scanning. Not needed with a token ring.
+			ConstantTable* constTable{nullptr};
+			// Optional. Tokens are pushed into the ring for a parser running on another thread
+			// instead of being stored in the token stream, which stays empty (see 'Parser::ParsePipelined').
+			// Nothing else is shared: literals aren't interned and errors are only recorded, the caller reports them.
+			// The ring is closed when the scan is over, even if it failed.
+			TokenRing* tokenRing{nullptr};
 		};
 
+		// A single edit of the source code: 'removedSize' bytes at 'offset' were replaced with 'insertedSize' bytes.
+		struct SrcEdit {
+			size_t offset{0};
+			size_t removedSize{0};
+			size_t insertedSize{0};
+		};
+
+		// Lines and columns aren't tracked while scanning, see 'SrcLineIndex'.
 		struct LexerState {
-			// Column state
-			uint32_t startCol{0};
-			uint32_t currentCol{0};
-			// Line state
-			uint32_t line{0};
 			// Position in the input
 			uint32_t start{0};
 			uint32_t current{0};
@@ -31,10 +44,28 @@ namespace crayon {
 
 		class Lexer {
 		public:
-			void Scan(const char* srcData, size_t srcSize, const LexerConfig& config);
-
-			const Token* GetTokenData() const;
-			size_t GetTokenSize() const;
+			// Returns false if there were lexical errors, including a source code or a token
+			// that doesn't fit the token stream's limits. Scanning goes on after an error:
+			// the offending token is dropped, or replaced by a zero if it's a numeric literal.
+			bool Scan(const char* srcData, size_t srcSize, const LexerConfig& config);
+			// Updates the tokens of the previously scanned source code after an edit, for editors and hot reloading.
+			// The source code is the edited one. Only the tokens around the edit are rescanned,
+			// the time spent doesn't depend on the size of the source code (apart from moving the token arrays).
+			// Only the rescanned tokens report errors, the errors of the previous scan outside of them are kept
+			// (and moved along with their tokens), so the result reflects the whole source code, like 'Scan'.
+			// Token rings aren't supported.
+			bool Rescan(const char* srcData, size_t srcSize, const SrcEdit& edit, const LexerConfig& config);
+			// Streaming mode: prepares the scan without scanning anything, the tokens are then scanned
+			// on demand into the window by 'ScanAhead', and nothing else is stored (see 'Parser::ParseStreaming').
+			// Errors are only recorded, like with a token ring, the caller reports them once the scan is over.
+			void BeginScan(const char* srcData, size_t srcSize, TokenWindow& tokenWindow, const LexerConfig& config);
+			// Scans up to 'maxTokenCount' more tokens into the window.
+			// Returns false once the whole source code is scanned (and the errors are final).
+			bool ScanAhead(size_t maxTokenCount);
+
+			const TokenStream& GetTokenStream() const;
+			// The errors of the last scan, already reported through the error reporter unless a token ring or a window was used.
+			const std::vector<LexicalError>& GetErrors() const;
 
 		private:
 			void ClearState();
@@ -42,11 +73,14 @@ namespace crayon {
 
 			void ScanToken();
 
-			Token CreateToken() const;
-			Token CreateToken(TokenType tokenType) const;
-
 			void AddToken(TokenType tokenType);
-			void AddToken(const Token& token);
+			void AddConstantToken(TokenType tokenType, const ConstVal& constVal);
+			bool CheckTokenLength();
+
+			// Records and reports an error about the current token.
+			void Error(std::string_view errMsg);
+			// Skips the rest of a malformed numeric literal and adds a zero constant in its place.
+			void InvalidNumber(std::string_view errMsg, TokenType tokenType);
 
 			char Advance();
 			void PutBack();
@@ -54,9 +88,10 @@ namespace crayon {
 			char PeekNext() const;
 			char Previous();
 			bool Match(char c);
-			char Consume(char c, std::string_view errMsg);
 
-			void HandleNewLine();
+			void Whitespace();
+			void LineComment();
+			void BlockComment();
 
 			void Number();
 			void DecimalNumber();
@@ -75,20 +110,18 @@ namespace crayon {
 			void AddUintConstant(IntConstType intConstType);
 			void AddFloatConstant();
 			void AddDoubleConstant();
+			std::string_view GetIntConstDigits(IntConstType intConstType, uint32_t suffixSize) const;
+			std::string_view GetFloatConstDigits() const;
 			
 			void AddIdOrKeyword();
 
-			bool Letter(char c) const;
-			bool Alpha(char c) const;
-			bool DecimalDigit(char c) const;
-			bool HexadecimalDigit(char c) const;
-			bool OctalDigit(char c) const;
-			bool AlphaNumeric(char c) const;
-
 			bool AtEnd() const;
 			bool AtEndNext() const;
 
-			std::vector<Token> tokens;
+			TokenStream tokens;
+			// Streaming mode only, replaces the token stream.
+			TokenWindow* tokenWindow{nullptr};
+			std::vector<LexicalError> errors;
 
 			LexerConfig config;
 			LexerState state;
@@ -6,10 +6,13 @@
 #include "GLSL/Value.h"
 
 #include "GLSL/Analyzer/Environment.h"
+#include "GLSL/Analyzer/TokenRing.h"
+#include "GLSL/Analyzer/TokenStream.h"
 #include "GLSL/Analyzer/SemanticAnalyzer.h"
 
 #include "GLSL/Reflect/ReflectCommon.h"
 
+#include "GLSL/AST/AstArena.h"
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/AST/Stmt.h"
@@ -19,27 +22,60 @@
 
 #include <cstdint>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace crayon {
 	namespace glsl {
 
+		class Lexer;
+
 		struct ParserConfig {
 			const ErrorReporter* errorReporter{nullptr};
+			// Owned by the compilation session, the parser only fills them.
+			TypeTable* typeTable{nullptr};
+			ConstantTable* constTable{nullptr};
+			AstArena* astArena{nullptr};
 			GpuApiType gpuApiType{GpuApiType::NONE};
+			// Optional. Declarations of a precompiled header, declared in the external scope
+			// and placed in front of the translation unit of every shader stage.
+			const std::vector<Decl*>* pchDecls{nullptr};
 		};
 
 		class Parser {
 		public:
-			void Parse(const Token* tokenStream, size_t tokenStreamSize, const ParserConfig& parserConfig);
+			// The lexemes in the syntax tree point into the source code, so it must outlive the tree.
+			void Parse(const TokenStream& tokenStream, const ParserConfig& parserConfig);
+			// Parses a header to be precompiled: external declarations only, outside of any shader stage.
+			void ParseHeader(const TokenStream& tokenStream, const ParserConfig& parserConfig);
+			// Parses the tokens a lexer pushes into the ring from another thread (see 'LexerConfig::tokenRing').
+			// They're appended to the token stream, which must be reset to the source code being scanned,
+			// and their literals are interned in token order. The ring is drained before returning,
+			// so the stream ends up holding every token, and the lexer's thread never waits forever.
+			void ParsePipelined(TokenRing& tokenRing, TokenStream& tokenStream, const ParserConfig& parserConfig);
+			// Pulls the tokens from the lexer on demand through the window, the lexer must have begun the scan
+			// (see 'Lexer::BeginScan'). Only the window's tokens exist at any time, the syntax tree keeps the lexemes,
+			// which point into the source code. The lexer is done once the call returns.
+			void ParseStreaming(Lexer& lexer, const TokenWindow& tokenWindow, const ParserConfig& parserConfig);
 			bool HadSyntaxError() const;
-			std::shared_ptr<ShaderProgramBlock> GetShaderProgramBlock() const;
+			// Semantic errors don't stop the parse, they're reported as they're found.
+			bool HadSemanticError() const;
+			// Every syntax error of the last parse, already reported through the error reporter.
+			const std::vector<SyntaxError>& GetSyntaxErrors() const;
+			ShaderProgramBlock* GetShaderProgramBlock() const;
+			TransUnit* GetHeaderTransUnit() const;
 
 			TypeTable* GetTypeTable() const;
 			ConstantTable* GetConstantTable() const;
 
 		private:
+			// Every parse starts from a plain token stream (none for the streaming mode), which also drops the ring
+			// or the window of an earlier parse that threw. The pipelined and streaming modes set theirs afterwards.
+			void SetTokenStream(const TokenStream* tokenStream);
+			// The token source must be set first.
+			void Reset(const ParserConfig& parserConfig);
 			void InitializeExternalScope();
+			void DeclarePrecompiledDecls();
 			void InitVertShaderExternalScopeCtx();
 			void ClearVertShaderExternalScopeCtx();
 			void InitFragShaderExternalScopeCtx();
@@ -55,12 +91,12 @@ namespace crayon {
 			void ComputePipeline();
 			void RayTracingPipeline();
 
-			std::shared_ptr<FixedStagesConfigBlock> FixedStagesConfiguration();
-			std::shared_ptr<MaterialPropertiesBlock> MaterialProperties();
-			std::shared_ptr<VertexInputLayoutBlock> VertexInputLayout();
-			std::shared_ptr<ColorAttachmentsBlock> ColorAttachments();
+			FixedStagesConfigBlock* FixedStagesConfiguration();
+			MaterialPropertiesBlock* MaterialProperties();
+			VertexInputLayoutBlock* VertexInputLayout();
+			ColorAttachmentsBlock* ColorAttachments();
 
-			std::shared_ptr<MatPropDecl> MaterialPropertyDeclaration();
+			MatPropDecl* MaterialPropertyDeclaration();
 
 			void VertexShader();
 			void TessellationShader();
@@ -69,40 +105,44 @@ namespace crayon {
 			void GeometryShader();
 			void FragmentShader();
 
-			std::shared_ptr<TransUnit> TranslationUnit();
+			TransUnit* TranslationUnit();
 
-			std::shared_ptr<Decl> ExternalDeclaration();
-			std::shared_ptr<Decl> DeclarationOrFunctionDefinition(DeclContext declContext);
-			std::shared_ptr<Decl> Declaration(DeclContext declContext);
-			void ParseVarDeclRest(std::shared_ptr<VarDecl> varDecl);
-			std::shared_ptr<StructDecl> StructDeclaration();
-			std::shared_ptr<VarDecl> StructFieldDecl();
+			Decl* ExternalDeclaration();
+			Decl* DeclarationOrFunctionDefinition(DeclContext declContext);
+			Decl* Declaration(DeclContext declContext);
+			void ParseVarDeclRest(VarDecl* varDecl);
+			StructDecl* StructDeclaration();
+			VarDecl* StructFieldDecl();
 
-			std::shared_ptr<FunProto> FunctionPrototype(const FullSpecType& fullSpecType, const Token& identifier);
-			void FunctionParameterList(std::shared_ptr<FunProto> funProto);
-			std::shared_ptr<FunParam> FunctionParameter();
+			FunProto* FunctionPrototype(const FullSpecType& fullSpecType, const Token& identifier);
+			void FunctionParameterList(FunProto* funProto);
+			FunParam* FunctionParameter();
 
-			std::shared_ptr<BlockStmt> BlockStatement();
-			std::shared_ptr<Stmt> Statement();
-			std::shared_ptr<Stmt> SimpleStatement();
+			BlockStmt* BlockStatement();
+			Stmt* Statement();
+			Stmt* SimpleStatement();
 
+			// Records and reports a syntax error and enters the panic mode: every production returns
+			// an empty result right away, until a recovery point ('ShaderProgram', 'ExternalDeclaration'
+			// or 'Statement') leaves it and synchronizes.
+			void Error(const Token& errToken, std::string_view errMsg);
+			void Error(const Token& errToken, TokenType expected, std::string_view errMsg);
 			void SynchronizeStmt();
 			void SynchronizeDecl();
 			void SynchronizeBlock();
 
-			std::shared_ptr<Expr> Expression();
-			std::shared_ptr<Expr> Initializer();
-			std::shared_ptr<Expr> InitializerList();
-			std::shared_ptr<Expr> AssignmentExpression();
-			std::shared_ptr<Expr> ConditionalExpression();
-			std::shared_ptr<Expr> AdditiveExpression();
-			std::shared_ptr<Expr> MultiplicativeExpression();
-			std::shared_ptr<Expr> UnaryExpression();
-			std::shared_ptr<Expr> PostfixExpression();
-			std::shared_ptr<Expr> PrimaryExpression();
+			Expr* Expression();
+			Expr* Initializer();
+			Expr* InitializerList();
+			Expr* AssignmentExpression();
+			Expr* ConditionalExpression();
+			Expr* BinaryExpression(int minPrecedence);
+			Expr* UnaryExpression();
+			Expr* PostfixExpression();
+			Expr* PrimaryExpression();
 
 			void FunCallArgs(CallExpr* callExpr);
-			std::vector<std::shared_ptr<Expr>> FunCallArgs();
+			std::vector<Expr*> FunCallArgs();
 
 			FullSpecType FullySpecifiedType();
 
@@ -133,30 +173,54 @@ namespace crayon {
 			bool IsComputePipeline(TokenType tokenType) const;
 			bool IsRayTracingPipeline(TokenType tokenType) const;
 
-			const Token* Advance();
-			const Token* Previous();
-			const Token* Peek() const;
+			// Tokens are assembled from the token stream's arrays and returned by value.
+			// Checks that only need the type should use 'PeekType' and 'Match', which don't touch the lexemes.
+			Token Advance();
+			Token Previous() const;
+			ConstId PreviousConstId() const;
+			Token Peek() const;
+			TokenType PeekType() const;
 			bool Match(TokenType tokenType);
-			const Token* Consume(TokenType tokenType, std::string_view msg);
+			// Returns an empty token after reporting the error, callers check 'panicking' before going on.
+			Token Consume(TokenType tokenType, std::string_view msg);
 
 			bool AtEnd() const;
-			const Token* Last() const;
-
-			std::shared_ptr<ShaderProgramBlock> shaderProgramBlock;
+			Token Last() const;
+
+			// Pipelined and streaming modes: keeps a token available at 'current' until the ring is drained
+			// or the lexer is done, called whenever 'current' moves so that lookahead and 'AtEnd' never see a partial stream.
+			void Fetch();
+			void PullTokens();
+			// The token source is either a stream or a window.
+			Token GetToken(size_t idx) const;
+			TokenType GetTokenType(size_t idx) const;
+			ConstId GetConstId(size_t idx) const;
+
+			ShaderProgramBlock* shaderProgramBlock{nullptr};
+			TransUnit* headerTransUnit{nullptr};
 			std::shared_ptr<ExternalScopeEnvironment> externalScope;
 			std::shared_ptr<NestedScopeEnvironment> currentScope;
 
-			std::unique_ptr<ConstantTable> constTable;
 			std::unique_ptr<SemanticAnalyzer> semanticAnalyzer;
-			std::unique_ptr<TypeTable> typeTable;
+			ConstantTable* constTable{nullptr};
+			AstArena* astArena{nullptr};
+			TypeTable* typeTable{nullptr};
 
-			const Token* tokenStream{nullptr};
+			const TokenStream* tokenStream{nullptr};
 			size_t tokenStreamSize{0};
 			uint32_t current{0};
+			// Pipelined mode only, the stream being filled from the ring. The ring is released once drained.
+			TokenRing* tokenRing{nullptr};
+			TokenStream* pipelinedTokens{nullptr};
+			// Streaming mode only. The lexer is released once the source code is scanned.
+			const TokenWindow* tokenWindow{nullptr};
+			Lexer* tokenLexer{nullptr};
 
 			ParserConfig parserConfig;
 			ShaderType shaderType{};
 			bool hadSyntaxError{false};
+			bool panicking{false};
+			std::vector<SyntaxError> syntaxErrors;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "GLSL/SrcLocation.h"
+
+#include "Utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		class PpFileCache;
+
+		enum class PpDirective : uint8_t {
+			NONE, // Not a directive, a line of source code.
+			EMPTY, // A lone '#'.
+			INCLUDE,
+			DEFINE,
+			UNDEF,
+			IF,
+			IFDEF,
+			IFNDEF,
+			ELIF,
+			ELSE,
+			ENDIF,
+			PRAGMA,
+			ERROR,
+			// Ignored, the code generators choose the GLSL version and the extensions themselves.
+			VERSION,
+			EXTENSION,
+			LINE,
+			UNKNOWN,
+		};
+
+		struct PpLine {
+			PpDirective directive{PpDirective::NONE};
+			// Source code lines only, the preprocessor needs it to skip comments while expanding macros.
+			bool startsInComment{false};
+			// Source code lines only. Nothing but whitespace and comments.
+			bool blank{false};
+			// Physical lines, more than one if a directive is continued with '\'.
+			uint32_t lineCount{1};
+			// The (first) physical line without the line break.
+			std::string_view text;
+			// Directives only: everything after the name, continuations joined, comments removed and whitespace trimmed.
+			std::string args;
+		};
+
+		// A source file split into lines, with the directives already recognized.
+		// Included files are scanned once and then shared through the 'PpFileCache'.
+		// '#pragma once' is handled while preprocessing, it may be excluded by a conditional.
+		struct PpFile {
+			std::filesystem::path path;
+			// Owned by included files only, the main source code belongs to the compilation session.
+			std::string content;
+			std::string_view text;
+			std::vector<PpLine> lines;
+			bool hasDirectives{false};
+			// Set if the whole file is wrapped in '#ifndef <guard> ... #endif',
+			// such a file is skipped without being scanned again once the guard is defined.
+			std::string guardMacro;
+		};
+
+		// Scans the text into lines and recognizes the directives, 'file.text' must be set.
+		void ScanPpFile(PpFile& file);
+
+		struct PreprocessorConfig {
+			// The main source file, relative includes are resolved against its directory.
+			// Empty for source code compiled from memory.
+			std::filesystem::path srcCodePath;
+			// Searched in order, after the including file's directory for "file" includes.
+			const std::vector<std::filesystem::path>* includeDirs{nullptr};
+			PpFileCache* ppFileCache{nullptr};
+			// Optional, the state left by a precompiled header: macro definitions (as they follow '#define'),
+			// and the files compiled into it, which are skipped like '#pragma once' files.
+			// The definitions must outlive the preprocessor's output.
+			const std::vector<std::string_view>* predefinedMacros{nullptr};
+			const std::vector<std::string>* precompiledFiles{nullptr};
+		};
+
+		// A C-style preprocessor working on the text ahead of the lexer:
+		// '#include' (with '#pragma once' and include guards), object-like and function-like macros
+		// (with '#' and '##'), '#undef', '#if'/'#ifdef'/'#ifndef'/'#elif'/'#else'/'#endif' and '#error'.
+		// '#version', '#extension' and '#line' are accepted and dropped.
+		// Directives and lines excluded by conditionals are replaced by empty lines,
+		// so the line numbers of a file without includes stay the same, the others are mapped back by 'GetLineMap'.
+		// The macros carry over from one shader stage to the next, like in any other single file,
+		// but every stage includes its headers again: the include guards and '#pragma once' files of a stage
+		// are reset at the next one. A stage starts at the 'BEGIN' token following its keyword and opening brace.
+		// Macro invocations must fit into a single line.
+		class Preprocessor {
+		public:
+			Preprocessor() = default;
+			CLASS_NO_COPY(Preprocessor);
+			CLASS_NO_MOVE(Preprocessor);
+
+			// Source code without a single '#' needs no preprocessing at all.
+			static bool HasDirectives(const char* srcData, size_t srcSize);
+
+			// Throws 'std::runtime_error' with the file and the line on preprocessing errors
+			// and if an included file can't be read.
+			void Process(const char* srcData, size_t srcSize, const PreprocessorConfig& config);
+			// Valid until the next call to 'Process'.
+			const std::string& GetOutput() const;
+			// Maps the lines of the output to the files they come from, valid until the next call to 'Process'.
+			const SrcLineMap& GetLineMap() const;
+			// The macros defined at the end, in the form accepted by 'PreprocessorConfig::predefinedMacros'.
+			std::vector<std::string> GetMacroDefinitions() const;
+			// The main file and every file it included, as canonical paths.
+			std::vector<std::string> GetProcessedFiles() const;
+
+		private:
+			struct Macro {
+				std::vector<std::string_view> params;
+				std::string_view body;
+				bool functionLike{false};
+				// Set while the macro's replacement is rescanned, so that it doesn't expand itself.
+				bool expanding{false};
+			};
+			// The state of an '#if' ... '#endif' chain.
+			struct Conditional {
+				bool parentActive{false};
+				bool active{false};
+				bool taken{false};
+				bool elseSeen{false};
+			};
+
+			void ProcessFile(const PpFile& file, uint32_t includeDepth);
+			void ProcessDirective(const PpFile& file, const PpLine& line, uint32_t includeDepth);
+			bool IsActive() const;
+			void BeginStage();
+			void Include(const PpFile& file, std::string_view args, uint32_t includeDepth);
+			std::filesystem::path ResolveInclude(const PpFile& file, std::string_view name, bool quoted) const;
+			void Define(std::string_view args);
+
+			void Expand(std::string_view text, bool startsInComment, std::string& out, uint32_t expansionDepth);
+			// Returns the position right after the macro's invocation.
+			size_t ExpandMacro(Macro& macro, std::string_view name, std::string_view text, size_t nameEnd,
+			                   std::string& out, uint32_t expansionDepth);
+			std::string Substitute(const Macro& macro, const std::vector<std::string_view>& args, uint32_t expansionDepth);
+
+			bool EvalCondition(std::string_view args);
+
+			[[noreturn]] void Error(std::string_view errMsg) const;
+
+			PreprocessorConfig config;
+			std::string output;
+			SrcLineMap lineMap;
+			// The number of lines written to the output so far.
+			uint32_t outputLineCount{0};
+
+			// Macro names and bodies point into the files below, which are kept alive until the next call.
+			std::unordered_map<std::string_view, Macro> macros;
+			std::vector<std::shared_ptr<const PpFile>> includedFiles;
+			std::unordered_set<std::string> onceFiles;
+			std::vector<Conditional> conditionals;
+			PpFile mainFile;
+			// The tokens of "<stage keyword> { BEGIN" seen so far in the main file.
+			uint32_t stageHeaderTokens{0};
+			// The '#pragma once' files at the first stage's 'BEGIN', restored at the next ones.
+			bool stageStateSaved{false};
+			std::unordered_set<std::string> stageOnceFiles;
+			// The include guards defined since the current stage began, undefined at the next one.
+			std::vector<std::string_view> stageGuardMacros;
+
+			// For error messages.
+			const PpFile* currentFile{nullptr};
+			uint32_t currentLineNum{0};
+		};
+
+	}
+}
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "GLSL/Error.h"
 #include "GLSL/Type.h"
 
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/AST/Stmt.h"
 #include "GLSL/AST/Expr.h"
+#include "GLSL/AST/ExprVisitors.h"
 
 #include "GLSL/Analyzer/Environment.h"
 
@@ -18,14 +20,17 @@ namespace crayon {
         public:
             void SetEnvironmentContext(const EnvironmentContext& envCtx);
             void ResetEnvironmentContext();
+            // Checks report their errors here, the parser carries on either way.
+            void SetErrorReporter(const ErrorReporter* errorReporter);
+            bool HadSemanticError() const;
 
-            bool CheckVertexAttribDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl);
-            bool CheckVertexAttribType(std::shared_ptr<VertexAttribDecl> vertexAttribDecl);
-            bool CheckVertexAttribChannel(std::shared_ptr<VertexAttribDecl> vertexAttribDecl);
+            bool CheckVertexAttribDecl(VertexAttribDecl* vertexAttribDecl);
+            bool CheckVertexAttribType(VertexAttribDecl* vertexAttribDecl);
+            bool CheckVertexAttribChannel(VertexAttribDecl* vertexAttribDecl);
 
-            bool CheckColorAttachmentDecl(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl);
-            bool CheckColorAttachmentType(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl);
-            bool CheckColorAttachmentChannel(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl);
+            bool CheckColorAttachmentDecl(ColorAttachmentDecl* colorAttachmentDecl);
+            bool CheckColorAttachmentType(ColorAttachmentDecl* colorAttachmentDecl);
+            bool CheckColorAttachmentChannel(ColorAttachmentDecl* colorAttachmentDecl);
 
             bool CheckVarDecl(VarDecl* varDecl,
                               DeclContext declContext,
@@ -37,6 +42,8 @@ namespace crayon {
 
         private:
             EnvironmentContext envCtx;
+            const ErrorReporter* errorReporter{nullptr};
+            bool hadSemanticError{false};
             ExprTypeInferenceVisitor exprTypeInferenceVisitor;
             ExprEvalVisitor exprEvalVisitor;
         };
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "GLSL/Token.h"
+#include "GLSL/Value.h"
+
+#include "Utility.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// A token on its way from the lexer thread to the parser thread.
+		// Numeric literals carry their value, the parser interns it so that the constant table stays single-threaded.
+		struct RingToken {
+			uint32_t offset{0};
+			uint16_t length{0};
+			TokenType tokenType{TokenType::UNDEFINED};
+			bool constant{false};
+			ConstVal constVal;
+		};
+
+		constexpr size_t defaultTokenRingCapacity{16384};
+
+		// A lock-free single-producer/single-consumer queue of tokens, it lets the parser
+		// start on the first tokens while the lexer is still scanning the rest.
+		// The capacity bounds how far the lexer may run ahead, the producer waits while the ring is full.
+		// Both sides keep a private copy of the other side's index and publish their own in batches,
+		// so the shared indices are touched once per batch rather than once per token.
+		class TokenRing {
+		public:
+			// The capacity is rounded up to a power of two.
+			explicit TokenRing(size_t capacity = defaultTokenRingCapacity);
+			CLASS_NO_COPY(TokenRing);
+			CLASS_NO_MOVE(TokenRing);
+
+			// Producer side.
+			void Push(const RingToken& token);
+			// Publishes the remaining tokens, 'Pop' returns 0 once they're consumed.
+			void Close();
+
+			// Consumer side. Waits until at least one token is available, returns 0 once the ring is closed and drained.
+			size_t Pop(RingToken* out, size_t maxCount);
+
+		private:
+			static constexpr size_t cacheLineSize{64};
+			static constexpr size_t publishBatchSize{32};
+
+			void Publish();
+
+			std::vector<RingToken> slots;
+			size_t mask{0};
+
+			// Shared, each on a line of its own so that the two threads don't invalidate each other's data.
+			alignas(cacheLineSize) std::atomic<size_t> head{0};
+			alignas(cacheLineSize) std::atomic<size_t> tail{0};
+			alignas(cacheLineSize) std::atomic<bool> closed{false};
+			// Producer only.
+			alignas(cacheLineSize) size_t producerHead{0};
+			size_t producerTail{0};
+			// Consumer only.
+			alignas(cacheLineSize) size_t consumerTail{0};
+			size_t consumerHead{0};
+		};
+
+	}
+}
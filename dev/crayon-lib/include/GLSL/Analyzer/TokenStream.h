@@ -0,0 +1,160 @@
+#pragma once
+
+#include "GLSL/Token.h"
+#include "GLSL/Value.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		constexpr size_t maxTokenStreamSrcSize{UINT32_MAX};
+		constexpr size_t maxTokenLength{UINT16_MAX};
+		static_assert(static_cast<size_t>(TokenType::TOKEN_NUM) <= UINT8_MAX, "Token types don't fit into a byte!");
+
+		// Tokens of a single source file, stored as parallel arrays: a 32-bit offset into the source code,
+		// a 16-bit length and an 8-bit type (7 bytes per token, instead of a 'Token' per token).
+		// Lookahead only touches the type array, lexemes are sliced out of the source code on demand.
+		// Lines and columns aren't stored at all, see 'SrcLineIndex'.
+		// Numeric literals are converted by the lexer, their constant ids live in a sparse side table.
+		class TokenStream {
+		public:
+			// The source code must outlive the stream.
+			void Reset(const char* srcData, size_t srcSize);
+			void Reserve(size_t tokenCount);
+
+			// The token must fit the limits above, the lexer checks them.
+			void Append(TokenType tokenType, size_t offset, size_t length) {
+				assert(tokenType != TokenType::UNDEFINED && offset + length <= srcSize && length <= maxTokenLength);
+				offsets.push_back(static_cast<uint32_t>(offset));
+				lengths.push_back(static_cast<uint16_t>(length));
+				tokenTypes.push_back(static_cast<uint8_t>(tokenType));
+			}
+			void AppendConstant(TokenType tokenType, size_t offset, size_t length, ConstId constId) {
+				constTokenIdxs.push_back(static_cast<uint32_t>(tokenTypes.size()));
+				constIds.push_back(constId);
+				Append(tokenType, offset, length);
+			}
+
+			size_t GetSize() const {
+				return tokenTypes.size();
+			}
+			TokenType GetTokenType(size_t idx) const {
+				return static_cast<TokenType>(tokenTypes[idx]);
+			}
+			size_t GetTokenOffset(size_t idx) const {
+				return offsets[idx];
+			}
+			size_t GetTokenEnd(size_t idx) const {
+				return static_cast<size_t>(offsets[idx]) + lengths[idx];
+			}
+			std::string_view GetLexeme(size_t idx) const {
+				return std::string_view{srcData + offsets[idx], lengths[idx]};
+			}
+			Token GetToken(size_t idx) const {
+				Token token{};
+				token.lexeme = GetLexeme(idx);
+				token.tokenType = GetTokenType(idx);
+				return token;
+			}
+			// The token must be a numeric literal.
+			ConstId GetConstId(size_t idx) const {
+				// Tokens are appended in order, so the side table is sorted.
+				auto constTokenIdx = std::lower_bound(constTokenIdxs.begin(), constTokenIdxs.end(), static_cast<uint32_t>(idx));
+				assert(constTokenIdx != constTokenIdxs.end() && *constTokenIdx == idx && "The token isn't a numeric literal!");
+				return constIds[constTokenIdx - constTokenIdxs.begin()];
+			}
+
+			// The index of the first token ending at or after the offset (tokens don't overlap, so their ends are sorted).
+			size_t FindFirstTokenEndingAtOrAfter(size_t offset) const;
+			// The index of the first token starting at or after the offset.
+			size_t FindFirstTokenStartingAtOrAfter(size_t offset) const;
+			// Replaces the tokens [first, last) with the tokens of another stream scanned from the edited source code,
+			// and shifts the offsets of the following tokens by the size difference of the edit.
+			// The stream points to the edited source code afterwards.
+			void Splice(size_t first, size_t last, const TokenStream& replacement, ptrdiff_t offsetShift);
+
+			const char* GetSrcData() const;
+			size_t GetSrcSize() const;
+
+		private:
+			std::vector<uint32_t> offsets;
+			std::vector<uint16_t> lengths;
+			std::vector<uint8_t> tokenTypes;
+
+			std::vector<uint32_t> constTokenIdxs;
+			std::vector<ConstId> constIds;
+
+			const char* srcData{nullptr};
+			size_t srcSize{0};
+		};
+
+		constexpr size_t tokenWindowSize{64};
+		static_assert((tokenWindowSize & (tokenWindowSize - 1)) == 0, "The token window size must be a power of two!");
+
+		// The most recent tokens of a source code scanned on demand (see 'Lexer::ScanAhead'), for parsing without a token stream.
+		// Tokens are indexed as in a 'TokenStream' of the whole source code, but only the last 'tokenWindowSize' can be accessed,
+		// so the memory used doesn't depend on the number of tokens.
+		class TokenWindow {
+		public:
+			// The source code must outlive the window.
+			void Reset(const char* srcData, size_t srcSize);
+
+			void Append(TokenType tokenType, size_t offset, size_t length) {
+				assert(tokenType != TokenType::UNDEFINED && offset + length <= srcSize && length <= maxTokenLength);
+				size_t slot = size & (tokenWindowSize - 1);
+				offsets[slot] = static_cast<uint32_t>(offset);
+				lengths[slot] = static_cast<uint16_t>(length);
+				tokenTypes[slot] = static_cast<uint8_t>(tokenType);
+				size++;
+			}
+			void AppendConstant(TokenType tokenType, size_t offset, size_t length, ConstId constId) {
+				constIds[size & (tokenWindowSize - 1)] = constId;
+				Append(tokenType, offset, length);
+			}
+
+			// The number of tokens appended so far, including those that already left the window.
+			size_t GetSize() const {
+				return size;
+			}
+			TokenType GetTokenType(size_t idx) const {
+				assert(Contains(idx) && "The token has left the window!");
+				return static_cast<TokenType>(tokenTypes[idx & (tokenWindowSize - 1)]);
+			}
+			Token GetToken(size_t idx) const {
+				assert(Contains(idx) && "The token has left the window!");
+				size_t slot = idx & (tokenWindowSize - 1);
+				Token token{};
+				token.lexeme = std::string_view{srcData + offsets[slot], lengths[slot]};
+				token.tokenType = static_cast<TokenType>(tokenTypes[slot]);
+				return token;
+			}
+			// The token must be a numeric literal.
+			ConstId GetConstId(size_t idx) const {
+				assert(Contains(idx) && "The token has left the window!");
+				return constIds[idx & (tokenWindowSize - 1)];
+			}
+
+		private:
+			bool Contains(size_t idx) const {
+				return idx < size && size - idx <= tokenWindowSize;
+			}
+
+			std::array<uint32_t, tokenWindowSize> offsets{};
+			std::array<uint16_t, tokenWindowSize> lengths{};
+			std::array<uint8_t, tokenWindowSize> tokenTypes{};
+			std::array<ConstId, tokenWindowSize> constIds{};
+			size_t size{0};
+
+			const char* srcData{nullptr};
+			size_t srcSize{0};
+		};
+
+	}
+}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/AST/AstVisitor.h"
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/CodeGen/GlslWriter.h"
 #include "GLSL/Reflect/ShaderProgram.h"
+#include "GLSL/CompileStats.h"
+
+#include "Trace.h"
 
 #include <memory>
 #include <string>
@@ -11,23 +16,31 @@
 namespace crayon {
 	namespace glsl {
 
-		class GlslExtWriter : public BlockVisitor {
+		class GlslExtWriter : public AstVisitor<GlslExtWriter> {
 		public:
-			GlslExtWriter(const GlslWriterConfig& config);
+			// The generated declarations are allocated from 'astArena'.
+			// 'stats' and 'trace' are optional, they receive the time spent on every shader stage.
+			GlslExtWriter(const GlslWriterConfig& config, AstArena& astArena,
+				          CompileStats* stats = nullptr, TraceRecorder* trace = nullptr);
 
 			std::shared_ptr<ShaderProgram> CompileToGlsl(ShaderProgramBlock* program);
 
 		private:
+			friend class AstVisitor<GlslExtWriter>;
+
 			// Block vist methods
-			void VisitShaderProgramBlock(ShaderProgramBlock* programBlock) override;
-			void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock) override;
-			void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock) override;
-			void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock) override;
-			void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock) override;
-			void VisitShaderBlock(ShaderBlock* shaderBlock) override;
+			void VisitShaderProgramBlock(ShaderProgramBlock* programBlock);
+			void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock);
+			void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock);
+			void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock);
+			void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock);
+			void VisitShaderBlock(ShaderBlock* shaderBlock);
 
 			std::shared_ptr<ShaderProgram> shaderProgram;
 			std::unique_ptr<GlslWriter> glslWriter;
+			AstArena& astArena;
+			CompileStats* stats{nullptr};
+			TraceRecorder* trace{nullptr};
 		};
 
 	}
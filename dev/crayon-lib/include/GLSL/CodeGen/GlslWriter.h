@@ -1,5 +1,6 @@
 #pragma once
 
+#include "GLSL/AST/AstVisitor.h"
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/AST/Stmt.h"
@@ -18,10 +19,7 @@ namespace crayon {
 			bool openingBraceOnSameLine{false};
 		};
 
-		class GlslWriter : public BlockVisitor,
-						   public DeclVisitor,
-						   public StmtVisitor,
-						   public ExprVisitor {
+		class GlslWriter : public AstVisitor<GlslWriter> {
 		public:
 			GlslWriter(const GlslWriterConfig& config);
 
@@ -33,42 +31,45 @@ namespace crayon {
 			void PrintNewLine();
 
 		private:
+			friend class AstVisitor<GlslWriter>;
+
 			// Block vist methods
-			void VisitShaderProgramBlock(ShaderProgramBlock* programBlock) override;
-			void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock) override;
-			void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock) override;
-			void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock) override;
-			void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock) override;
-			void VisitShaderBlock(ShaderBlock* shaderBlock) override;
+			void VisitShaderProgramBlock(ShaderProgramBlock* programBlock);
+			void VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock);
+			void VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock);
+			void VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock);
+			void VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock);
+			void VisitShaderBlock(ShaderBlock* shaderBlock);
 
 			// Decl visit methods
-			void VisitTransUnit(TransUnit* transUnit) override;
-			void VisitStructDecl(StructDecl* structDecl) override;
-			void VisitInterfaceBlockDecl(InterfaceBlockDecl* intBlockDecl) override;
-			void VisitDeclList(DeclList* declList) override;
-            void VisitFunDecl(FunDecl* funDecl) override;
-            void VisitQualDecl(QualDecl* qualDecl) override;
-			void VisitVarDecl(VarDecl* varDecl) override;
+			void VisitTransUnit(TransUnit* transUnit);
+			void VisitStructDecl(StructDecl* structDecl);
+			void VisitInterfaceBlockDecl(InterfaceBlockDecl* intBlockDecl);
+			void VisitDeclList(DeclList* declList);
+            void VisitFunDecl(FunDecl* funDecl);
+            void VisitQualDecl(QualDecl* qualDecl);
+			void VisitVarDecl(VarDecl* varDecl);
 
 			// Stmt visit methods
-			void VisitBlockStmt(BlockStmt* blockStmt) override;
-			void VisitDeclStmt(DeclStmt* declStmt) override;
-			void VisitExprStmt(ExprStmt* exprStmt) override;
+			void VisitBlockStmt(BlockStmt* blockStmt);
+			void VisitDeclStmt(DeclStmt* declStmt);
+			void VisitExprStmt(ExprStmt* exprStmt);
 
 			// Expression visit methods
-			void VisitInitListExpr(InitListExpr* initListExpr) override;
-			void VisitAssignExpr(AssignExpr* assignExpr) override;
-			void VisitBinaryExpr(BinaryExpr* binaryExpr) override;
-			void VisitUnaryExpr(UnaryExpr* unaryExpr) override;
-			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) override;
-			void VisitFunCallExpr(FunCallExpr* funCallExpr) override;
-			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) override;
-			void VisitVarExpr(VarExpr* varExpr) override;
-			void VisitIntConstExpr(IntConstExpr* intConstExpr) override;
-			void VisitUintConstExpr(UintConstExpr* uintConstExpr) override;
-			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr) override;
-			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) override;
-			void VisitGroupExpr(GroupExpr* groupExpr) override;
+			void VisitInitListExpr(InitListExpr* initListExpr);
+			void VisitAssignExpr(AssignExpr* assignExpr);
+			void VisitTernaryExpr(TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(VarExpr* varExpr);
+			void VisitIntConstExpr(IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(GroupExpr* groupExpr);
 
 			// Helper methods
 			void WriteFullySpecifiedType(const FullSpecType& fullSpecType);
@@ -82,10 +83,13 @@ namespace crayon {
 			void WriteInitListFirst(InitListExpr* initListExpr);
 			void WriteInitListRest(InitListExpr* initListExpr);
 
-			void WriteFunctionPrototype(std::shared_ptr<FunProto> funProto);
-			void WriteFunctionParameterList(const std::vector<std::shared_ptr<FunParam>>& funParamList);
+			void WriteFunctionPrototype(FunProto* funProto);
+			void WriteFunctionParameterList(const std::vector<FunParam*>& funParamList);
 			void WriteFunCallArgs(CallExpr* callExpr);
-			void WriteFunCallArgs(const std::vector<std::shared_ptr<Expr>>& callArgs);
+			void WriteFunCallArgs(const std::vector<Expr*>& callArgs);
+			// The parser drops the parentheses of the source, so an operand that binds looser
+			// than 'precedence' (see 'GetBinaryOpPrecedence') is written in parentheses.
+			void WriteOperand(Expr* operand, int precedence);
 
 			void WriteOpeningBlockBrace();
 			void WriteClosingBlockBrace();
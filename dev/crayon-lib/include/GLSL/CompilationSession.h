@@ -0,0 +1,107 @@
+#pragma once
+
+#include "GLSL/CompileOptions.h"
+#include "GLSL/CompileStats.h"
+#include "GLSL/DebugDump.h"
+
+#include "GLSL/Analyzer/Lexer.h"
+#include "GLSL/Analyzer/Parser.h"
+#include "GLSL/Analyzer/Preprocessor.h"
+#include "GLSL/PpFileCache.h"
+#include "GLSL/PrecompiledHeader.h"
+#include "GLSL/Token.h"
+#include "GLSL/Type.h"
+#include "GLSL/Value.h"
+#include "GLSL/Error.h"
+
+#include "GLSL/Reflect/ShaderProgram.h"
+
+#include "SPIRV/CodeGen/GlslToSpv.h"
+
+#include "SrcFile.h"
+#include "Utility.h"
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// Owns all the mutable state of a single compilation (one session per source file): the source code, the lexer, the parser,
+		// the type and constant tables, and the SPIR-V generator (along with its id generator).
+		// Sessions don't share any mutable state, so any number of them can run in parallel threads.
+		class CompilationSession {
+		public:
+			CompilationSession();
+			~CompilationSession() = default;
+			CLASS_NO_COPY(CompilationSession);
+			CLASS_NO_MOVE(CompilationSession);
+
+			// Returns 'false' if the source code couldn't be preprocessed, lexed, parsed or translated.
+			// I/O errors (wrong file extension, unreadable file, etc.) are reported via exceptions.
+			// Debug dumps are named after the source file, and go next to it unless a dump directory is set.
+			bool Compile(const std::filesystem::path& srcCodePath, const CompilerConfig& compilerConfig);
+			// Compiles source code already in memory. Nothing is written to the disk,
+			// except for the debug dumps if a dump directory is set ("memory_<hash>.<channel>.txt").
+			// The source code must stay alive until the call returns.
+			bool Compile(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig);
+			// Preprocesses and parses a header (any extension) and writes its declarations and macros to 'pchPath'.
+			// Returns 'false' on preprocessing, lexing or syntax errors, the file isn't written then.
+			bool PrecompileHeader(const std::filesystem::path& headerPath, const std::filesystem::path& pchPath,
+			                      const CompilerConfig& compilerConfig);
+
+			const ShaderProgram& GetShaderProgram() const;
+			const CompileStats& GetStats() const;
+
+		private:
+			void ReadSrcCode(const std::filesystem::path& srcCodePath);
+			bool CompileAndCollectStats(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig);
+			bool CompileOrLoadSrcCode(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig);
+			// The line map is only set for preprocessed source code.
+			bool CompileSrcCode(const char* srcCode, size_t srcCodeSize, const SrcLineMap* lineMap, const CompilerConfig& compilerConfig);
+			// Returns 'false' on lexical errors, the syntax errors are left to the parser.
+			bool LexAndParsePipelined(const char* srcCode, size_t srcCodeSize, LexerConfig lexConfig,
+			                          const ParserConfig& parserConfig, TraceRecorder* trace);
+			bool LexAndParseStreaming(const char* srcCode, size_t srcCodeSize, const LexerConfig& lexConfig,
+			                          const ParserConfig& parserConfig);
+			void CollectStageStats();
+			void WriteOutputFiles(const std::filesystem::path& srcCodePath);
+
+			// Debug dump channels
+			void DumpTokens(const TokenStream& tokens);
+			void DumpParseResults();
+			void DumpSpirv();
+
+			// Only used when the source code is read from a file. Kept open (mapped) until the next compilation,
+			// so that everything pointing into the source code stays valid along with the session.
+			SrcFile srcFile;
+			// Empty for source code compiled from memory, its includes are searched in the include directories only.
+			std::filesystem::path srcCodePath;
+
+			std::unique_ptr<Preprocessor> preprocessor;
+			// Used unless the compiler config provides a cache shared by a batch.
+			std::unique_ptr<PpFileCache> ppFileCache;
+			std::unique_ptr<Lexer> lexer;
+			std::unique_ptr<Parser> parser;
+			// The tokens of a pipelined compilation, filled by the parser as the lexer's thread produces them.
+			TokenStream pipelinedTokens;
+			std::unique_ptr<ErrorReporter> errorReporter;
+
+			std::unique_ptr<TypeTable> typeTable;
+			std::unique_ptr<ConstantTable> constTable;
+			// Owns the syntax trees of the session: the parsed program, the precompiled declarations and the generated ones.
+			std::unique_ptr<AstArena> astArena;
+			// Instantiated from the precompiled header, if any, before parsing.
+			std::vector<Decl*> pchDecls;
+
+			std::unique_ptr<spirv::GlslToSpvGenerator> spvGenerator;
+
+			ShaderProgram shaderProgram;
+			CompileStats stats;
+			DebugDump debugDump;
+		};
+
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GLSL/CompileOptions.h"
+#include "GLSL/Reflect/ShaderProgram.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace crayon {
+	namespace glsl {
+
+		// Persistent, content-addressed cache of compiled shader programs.
+		// An entry is keyed by the SHA-256 of the source code, the compile options, the compiler version
+		// and the precompiled header, so entries never have to be invalidated, a changed input simply produces a different key.
+		// The cache can be shared by several threads and processes: entries are written to a temporary file
+		// first and then atomically renamed.
+		class CompileCache {
+		public:
+			CompileCache(const std::filesystem::path& cacheDir);
+
+			// 'pchSrcCode' is the source code of the precompiled header the program is compiled with, if any.
+			static std::string ComputeKey(const char* srcCodeData, size_t srcCodeSize, const CompileOptions& options,
+			                              std::string_view pchSrcCode = {});
+
+			// Returns 'false' on a miss. Unreadable or corrupted entries are treated as misses.
+			bool Load(const std::string& key, ShaderProgram& shaderProgram);
+			// Failing to store an entry is not an error, the program will just be compiled again next time.
+			void Store(const std::string& key, const ShaderProgram& shaderProgram);
+
+			const std::filesystem::path& GetCacheDir() const;
+			uint32_t GetHitCount() const;
+			uint32_t GetMissCount() const;
+
+		private:
+			std::filesystem::path GetEntryPath(const std::string& key) const;
+
+			std::filesystem::path cacheDir;
+			std::atomic<uint32_t> hitCount{0};
+			std::atomic<uint32_t> missCount{0};
+		};
+
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GLSL/CodeGen/GlslWriter.h"
+#include "GLSL/DebugDump.h"
+
+#include "SPIRV/SpvInstruction.h"
+
+#include "CmdLine/CmdLineCommon.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+
+	class TraceRecorder;
+
+	namespace glsl {
+
+		// Part of the compile cache key and of precompiled headers. Bump it in every change that may alter
+		// the generated code for an existing source, or cached programs from older builds are served as they are.
+		constexpr std::string_view compilerVersion{"0.2.0"};
+		// Below this size, starting a thread costs more than lexing the whole source.
+		constexpr size_t minPipelinedSrcSize{64 * 1024};
+
+		class CompileCache;
+		class PpFileCache;
+		class PrecompiledHeader;
+		struct CompileStats;
+
+		// Everything that affects the generated code.
+		struct CompileOptions {
+			CompileOptions();
+
+			GpuApiType gpuApiType{GpuApiType::VULKAN};
+			spirv::SpvType spvType{spirv::SpvType::ASM};
+			GlslWriterConfig glslWriterConfig;
+		};
+
+		struct CompilerConfig {
+			CompileOptions options;
+			// Optional. Compiled programs are looked up in and stored to the cache if provided.
+			CompileCache* cache{nullptr};
+			// Optional. Shared by a batch, so that common includes are read and scanned only once.
+			// Every session keeps a cache of its own otherwise.
+			PpFileCache* ppFileCache{nullptr};
+			// Searched in order for '#include' directives, after the including file's directory for "file" includes.
+			std::vector<std::filesystem::path> includeDirs;
+			// Optional. An opened precompiled header, its declarations and macros precede the source code.
+			// Read-only, shared by a batch.
+			const PrecompiledHeader* pch{nullptr};
+			// Optional. Lexical, syntax and semantic errors go to the standard error stream otherwise.
+			std::ostream* errStream{nullptr};
+			// Optional. Receives the per-phase statistics of the compilation.
+			CompileStats* stats{nullptr};
+			// Optional. Receives a span for every phase and every shader stage.
+			TraceRecorder* trace{nullptr};
+			// Lex on a thread of its own while parsing, for large sources (see 'minPipelinedSrcSize').
+			// The results are the same as in the sequential mode. Ignored with a precompiled header,
+			// whose constants must be interned after the ones of the source code.
+			bool pipelined{false};
+			// Let the parser pull the tokens from the lexer on demand instead of lexing the whole source first,
+			// so that no token array is kept, whatever the size of the source. Takes precedence over 'pipelined'.
+			// The results are the same as in the sequential mode. Ignored with a precompiled header (see above)
+			// and when the tokens are dumped.
+			bool streaming{false};
+			// Debug dump channels to write for every compiled file. Cache hits have nothing to dump.
+			DebugDumpConfig debugDump;
+		};
+
+	}
+}
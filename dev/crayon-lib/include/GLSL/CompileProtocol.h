@@ -0,0 +1,64 @@
+#pragma once
+
+#include "GLSL/CompileOptions.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// Binary protocol spoken by the compile server ('crayon --serve').
+		// Every message is a frame: a 32-bit payload size followed by the payload.
+		// Integers are host-endian, strings are a 32-bit length followed by the characters,
+		// so the protocol is only meant for clients running on the same machine.
+		//
+		// A connection is closed if the next request doesn't arrive within the server's idle timeout.
+		//
+		// Request payload:  magic, version, request type, [compile options, source code].
+		// Response payload: magic, version, status, error message, [serialized ShaderProgram].
+		// The serialized program (see 'SerializeShaderProgram') takes the rest of the payload
+		// and is only present if the status is 'OK'.
+
+		constexpr uint32_t compileRequestMagic{0x51525343};  // "CSRQ"
+		constexpr uint32_t compileResponseMagic{0x53525343}; // "CSRS"
+		constexpr uint32_t compileProtocolVersion{1};
+		// Protects the server from allocating huge buffers because of a broken client.
+		constexpr uint32_t maxCompileFrameSize{64u * 1024u * 1024u};
+
+		enum class CompileRequestType {
+			COMPILE,
+			// Stops the server once every open connection has been served.
+			// Answered with 'BAD_REQUEST' unless the client runs as the same user as the server.
+			SHUTDOWN,
+		};
+
+		enum class CompileResponseStatus {
+			OK,
+			COMPILE_FAILED,
+			BAD_REQUEST,
+		};
+
+		struct CompileRequest {
+			CompileRequestType type{CompileRequestType::COMPILE};
+			CompileOptions options;
+			std::string srcCode;
+		};
+
+		struct CompileResponse {
+			CompileResponseStatus status{CompileResponseStatus::OK};
+			std::string errMsg;
+			// Serialized ShaderProgram, empty unless the status is 'OK'.
+			std::vector<uint8_t> shaderProgramData;
+		};
+
+		void SerializeCompileRequest(const CompileRequest& request, std::vector<uint8_t>& data);
+		// Returns 'false' if the payload is truncated, corrupted or was written by an incompatible version.
+		bool DeserializeCompileRequest(const uint8_t* data, size_t size, CompileRequest& request);
+
+		void SerializeCompileResponse(const CompileResponse& response, std::vector<uint8_t>& data);
+		bool DeserializeCompileResponse(const uint8_t* data, size_t size, CompileResponse& response);
+
+	}
+}
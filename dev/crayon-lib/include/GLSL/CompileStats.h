@@ -0,0 +1,87 @@
+#pragma once
+
+#include "AllocStats.h"
+
+#include "GLSL/Reflect/ReflectCommon.h"
+#include "GLSL/Reflect/ShaderProgram.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+namespace crayon {
+	namespace glsl {
+
+		enum class CompilePhase {
+			// Zero for source code without directives.
+			PREPROCESSING,
+			LEXING,
+			// Includes the semantic analysis.
+			PARSING,
+			GLSL_GENERATION,
+			SPIRV_GENERATION,
+			COUNT,
+		};
+
+		struct PhaseStats {
+			PhaseStats& operator+=(const PhaseStats& other);
+
+			double wallTimeMs{0.0};
+			// CPU time of the compiling thread only, so parallel compilations don't distort each other's numbers.
+			double cpuTimeMs{0.0};
+			// Allocations made by the compiling thread (see "AllocStats.h").
+			uint64_t allocatedBytes{0};
+			uint64_t allocationCount{0};
+		};
+
+		struct ShaderStageStats {
+			bool present{false};
+			PhaseStats glslGeneration;
+			PhaseStats spvGeneration;
+			size_t glslSize{0};
+			size_t spvInstructionCount{0};
+		};
+
+		struct CompileStats {
+			CompileStats& operator+=(const CompileStats& other);
+
+			// Whole program. The code generation phases are also broken down by stage below.
+			std::array<PhaseStats, static_cast<size_t>(CompilePhase::COUNT)> phases;
+			std::array<ShaderStageStats, static_cast<size_t>(ShaderType::COUNT)> stages;
+			size_t srcCodeSize{0};
+			size_t tokenCount{0};
+			size_t astNodeCount{0};
+			// The phases weren't run at all if the program came from the compile cache.
+			bool cacheHit{false};
+		};
+
+		// Measures a single phase. Construct it right before the phase begins.
+		class PhaseTimer {
+		public:
+			PhaseTimer();
+
+			PhaseStats Stop() const;
+
+		private:
+			std::chrono::steady_clock::time_point wallStart;
+			double cpuStartMs{0.0};
+			AllocStats allocStart;
+		};
+
+		// Every AST node constructor reports itself here. The counter is per thread,
+		// so the difference before and after parsing is the number of nodes the parser created.
+		void CountAstNode();
+		size_t GetThreadAstNodeCount();
+
+		size_t CountSpvInstructions(const ShaderModule& shaderModule);
+
+		std::string_view CompilePhaseToStr(CompilePhase phase);
+		std::string_view ShaderTypeToStr(ShaderType shaderType);
+
+		// Writes a single JSON object. Stages that weren't compiled are omitted.
+		void WriteCompileStatsJson(std::ostream& out, const CompileStats& stats);
+
+	}
+}
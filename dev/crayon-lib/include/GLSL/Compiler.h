@@ -1,39 +1,43 @@
 #pragma once
 
-#include "GLSL/Analyzer/Lexer.h"
-#include "GLSL/Analyzer/Parser.h"
-#include "GLSL/AST/Decl.h"
+#include "GLSL/CompilationSession.h"
 #include "GLSL/Token.h"
-#include "GLSL/Error.h"
 
-#include "SPIRV/CodeGen/GlslToSpv.h"
+#include "GLSL/Reflect/ShaderProgram.h"
 
 #include <filesystem>
-#include <memory>
+#include <string>
 #include <string_view>
-#include <unordered_map>
 
 namespace crayon {
 	namespace glsl {
 
+		struct CompileResult {
+			ShaderProgram shaderProgram;
+			// Error messages, one per line. Empty if the compilation succeeded.
+			std::string errMsg;
+			CompileStats stats;
+			bool success{false};
+		};
+
 		class Compiler {
 		public:
-			Compiler();
-
-			void Compile(const std::filesystem::path& srcCodePath);
-
-		private:
-			void InitializeKeywordMap();
-
-			void PrintTokens(const Token* tokenData, size_t tokenSize);
-
-			std::unique_ptr<Lexer> lexer;
-			std::unique_ptr<Parser> parser;
-			std::unique_ptr<ErrorReporter> errorReporter;
-
-			std::unique_ptr<spirv::GlslToSpvGenerator> spvGenerator;
-
-			std::unordered_map<std::string_view, TokenType> keywords;
+			// Every call runs in its own compilation session, so a single compiler
+			// can be shared by any number of threads.
+			// Returns 'false' if the source code couldn't be lexed, parsed or translated.
+			// I/O errors (wrong file extension, unreadable file, etc.) are reported via exceptions.
+			bool Compile(const std::filesystem::path& srcCodePath,
+			             const CompilerConfig& compilerConfig = CompilerConfig{}) const;
+			// Compiles source code the caller already holds in memory.
+			// Doesn't touch the file system or the console, errors are returned in the result instead.
+			CompileResult CompileFromMemory(std::string_view srcCode,
+			                                const CompileOptions& options = CompileOptions{}) const;
+			// Same as above, with the include directories, the scanned file cache, the precompiled header, etc. of 'compilerConfig'.
+			// Its error stream and statistics are replaced by the result's.
+			CompileResult CompileFromMemory(std::string_view srcCode, const CompilerConfig& compilerConfig) const;
+			// Writes the precompiled header of 'headerPath' to 'pchPath' (see 'CompilationSession::PrecompileHeader').
+			bool PrecompileHeader(const std::filesystem::path& headerPath, const std::filesystem::path& pchPath,
+			                      const CompilerConfig& compilerConfig = CompilerConfig{}) const;
 		};
 	}
-}
\ No newline at end of file
+}
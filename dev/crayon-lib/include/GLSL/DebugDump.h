@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Utility.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string_view>
+
+namespace crayon {
+	namespace glsl {
+
+		enum class DumpChannel {
+			TOKENS,
+			AST,
+			CONSTANTS,
+			TYPES,
+			SPIRV,
+			COUNT
+		};
+
+		std::string_view DumpChannelToStr(DumpChannel channel);
+		constexpr uint32_t DumpChannelBit(DumpChannel channel) {
+			return 1u << static_cast<uint32_t>(channel);
+		}
+		constexpr uint32_t allDumpChannels{(1u << static_cast<uint32_t>(DumpChannel::COUNT)) - 1};
+
+		// Parses a comma separated list of channel names ("tokens,ast") or "all" into a channel mask.
+		// Throws 'std::invalid_argument' if a channel is unknown.
+		uint32_t ParseDumpChannels(std::string_view channelList);
+
+		struct DebugDumpConfig {
+			// Mask of 'DumpChannelBit's. Nothing is dumped by default.
+			uint32_t channels{0};
+			// Directory the dump files are written to.
+			// Empty means "next to the source file" (compilations from memory aren't dumped then).
+			std::filesystem::path dumpDir;
+		};
+
+		// Debug output of a single compilation session, one buffer ("sink") per enabled channel.
+		// The compiler only formats anything for the channels that are enabled,
+		// and nothing touches the console, so parallel sessions don't contend on it.
+		class DebugDump {
+		public:
+			DebugDump() = default;
+			CLASS_NO_COPY(DebugDump);
+			CLASS_NO_MOVE(DebugDump);
+
+			void Reset(uint32_t channels);
+
+			bool IsEnabled(DumpChannel channel) const {
+				return (channels & DumpChannelBit(channel)) != 0;
+			}
+			// The channel must be enabled. The sink is created on first use.
+			std::ostream& GetSink(DumpChannel channel);
+
+			// Writes every non-empty sink to "<dir>/<baseName>.<channel>.txt".
+			// Throws 'std::runtime_error' if a file can't be written.
+			void WriteFiles(const std::filesystem::path& dir, std::string_view baseName) const;
+
+		private:
+			uint32_t channels{0};
+			std::array<std::unique_ptr<std::ostringstream>, static_cast<size_t>(DumpChannel::COUNT)> sinks;
+		};
+
+	}
+}
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "GLSL/SrcLocation.h"
 #include "GLSL/Token.h"
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/AST/Expr.h"
 
-#include <exception>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -13,43 +14,78 @@
 namespace crayon {
 	namespace glsl {
 
-        class SyntaxError : public std::exception {
+        // Diagnostics are plain values: the lexer and the parser report them as soon as they're found,
+        // keep them in a list and carry on, so a single pass collects every error.
+        // Messages are string literals, nothing is formatted until the error is reported.
+
+        struct LexicalError {
+            // The offending characters, empty if the error isn't about a single token.
+            std::string_view lexeme;
+            std::string_view errMsg;
+        };
+
+        struct SemanticError {
+            // The source text of the offending construct, empty if it isn't known.
+            std::string_view srcText;
+            std::string_view errMsg;
+        };
+
+        class SyntaxError {
         public:
             SyntaxError(const Token& errToken);
             SyntaxError(const Token& errToken, std::string_view errMsg);
             SyntaxError(const Token& errToken, TokenType expected);
             SyntaxError(const Token& errToken, TokenType expected, std::string_view errMsg);
 
-            const char* what() const noexcept override;
             const Token& GetErrorToken() const;
             TokenType GetExpectedTokenType() const;
+            // The message without the location, which is only known to the error reporter.
+            std::string_view GetErrorMessage() const;
 
         private:
-            void CreateErrMsg(std::string_view errMsg);
-
             Token errToken;
-            std::string errMsg;
+            std::string_view errMsg;
             TokenType expected{TokenType::UNDEFINED};
         };
 
         class ErrorReporter {
         public:
+            // Resets the line map.
             void SetSrcCodeLink(const char* srcCodeData, size_t srcCodeSize);
+            // For preprocessed source code, so that diagnostics point to the lines of the original files.
+            // The map must outlive the source code link.
+            void SetLineMap(const SrcLineMap* lineMap);
+            // Errors are written to the standard error stream unless another stream is provided.
+            void SetErrorStream(std::ostream* errStream);
+            std::ostream& GetErrorStream() const;
+
+            void ReportLexicalError(const LexicalError& lexicalError) const;
+            void ReportSyntaxError(const SyntaxError& syntaxError) const;
+            void ReportSemanticError(const SemanticError& semanticError) const;
+            void ReportError(std::string_view errMsg) const;
 
-            void ReportVarDeclInitExprTypeMismatch(std::shared_ptr<VarDecl> varDecl) const;
+            void ReportVarDeclInitExprTypeMismatch(VarDecl* varDecl) const;
 
-            void ReportVertexAttribDeclType(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) const;
-            void ReportVertexAttribDeclChannel(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) const;
+            void ReportVertexAttribDeclType(VertexAttribDecl* vertexAttribDecl) const;
+            void ReportVertexAttribDeclChannel(VertexAttribDecl* vertexAttribDecl) const;
 
-            void ReportMaterialPropertyType(std::shared_ptr<MatPropDecl> matPropDecl) const;
+            void ReportMaterialPropertyType(MatPropDecl* matPropDecl) const;
 
             void ReportStorageQualDeclCtxMismatch(const Token& storageQual, DeclContext declContext);
 
+            // Built on the first call, diagnostics are the only thing that needs lines and columns.
+            const SrcLineIndex& GetLineIndex() const;
+
         private:
-            std::string_view GetSrcCodeTokenLine(const Token& token) const;
+            // Prints " [file:line:col]", the file only if it isn't the main one.
+            void ReportLocation(std::string_view text) const;
 
             const char* srcCodeData{nullptr};
             size_t srcCodeSize{0};
+            const SrcLineMap* lineMap{nullptr};
+            mutable SrcLineIndex lineIndex;
+
+            std::ostream* errStream{&std::cerr};
         };
 
     }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "GLSL/Analyzer/Preprocessor.h"
+
+#include "Utility.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace crayon {
+	namespace glsl {
+
+		// Included files read and split into lines by 'ScanPpFile', keyed by their path and modification time.
+		// A batch shares one cache, so a header included by every program is only read and scanned once.
+		// A file modified since it was cached is scanned again. The cache can be shared by several threads.
+		// Tokens aren't cached: the preprocessor splices the included text into its output, which is lexed as a whole
+		// after the macros of the including file have been expanded. Precompiled headers skip the lexing instead.
+		class PpFileCache {
+		public:
+			PpFileCache() = default;
+			CLASS_NO_COPY(PpFileCache);
+			CLASS_NO_MOVE(PpFileCache);
+
+			// The path should be canonical, so that every file has a single entry.
+			// Throws 'std::runtime_error' if the file can't be read.
+			std::shared_ptr<const PpFile> Load(const std::filesystem::path& path);
+
+			uint32_t GetHitCount() const;
+			uint32_t GetMissCount() const;
+
+		private:
+			struct Entry {
+				std::filesystem::file_time_type lastWriteTime;
+				std::shared_ptr<const PpFile> file;
+			};
+
+			std::mutex entriesMutex;
+			std::unordered_map<std::string, Entry> entries;
+			std::atomic<uint32_t> hitCount{0};
+			std::atomic<uint32_t> missCount{0};
+		};
+
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "GLSL/Type.h"
+#include "GLSL/Value.h"
+
+#include "GLSL/AST/Decl.h"
+#include "GLSL/AST/FlatAst.h"
+
+#include "SrcFile.h"
+#include "Utility.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// File layout: magic, version, compiler version, string data, source code size, files, macros,
+		// constants, types, declarations, flat syntax tree.
+		// The string data is the preprocessed header followed by the lexemes that don't point into it,
+		// tokens are stored as offsets into it. The types and the declarations are ids of the flat tree's nodes.
+		// All numbers are host-endian.
+		constexpr uint32_t pchMagic{0x48505343};  // "CSPH"
+		constexpr uint32_t pchFormatVersion{3};
+
+		// Everything needed to write a precompiled header, produced by 'CompilationSession::PrecompileHeader'.
+		struct PchContents {
+			// The preprocessed header, every lexeme of the declarations should point into it.
+			std::string_view srcCode;
+			// Canonical paths of the header and of the files it included.
+			std::vector<std::string> files;
+			// Macros defined at the end of the header (see 'Preprocessor::GetMacroDefinitions').
+			std::vector<std::string> macros;
+			std::vector<Decl*> decls;
+			const TypeTable* typeTable{nullptr};
+			const ConstantTable* constTable{nullptr};
+		};
+
+		// A header's analyzed declarations, saved so that programs using it don't lex and parse it again.
+		// The file is memory mapped: the lexemes of the declarations point straight into the mapping,
+		// so it must stay open as long as any compilation using it.
+		// An opened header is read-only, one instance can be shared by all the sessions of a batch.
+		class PrecompiledHeader {
+		public:
+			PrecompiledHeader() = default;
+			CLASS_NO_COPY(PrecompiledHeader);
+			CLASS_NO_MOVE(PrecompiledHeader);
+
+			// Throws 'std::runtime_error' if the file can't be written.
+			static void Write(const std::filesystem::path& pchPath, const PchContents& contents);
+
+			// Throws 'std::runtime_error' if the file can't be read, is corrupted
+			// or was written by another version of the compiler.
+			void Open(const std::filesystem::path& pchPath);
+
+			const std::filesystem::path& GetPath() const;
+			// Part of the compile cache key of the programs using the header.
+			std::string_view GetSrcCode() const;
+			const std::vector<std::string>& GetFiles() const;
+			// Views into the mapping, ready for 'PreprocessorConfig::predefinedMacros'.
+			const std::vector<std::string_view>& GetMacros() const;
+
+			// Recreates the declarations in the arena, with their type and constant ids remapped to the given tables,
+			// which receive every type and constant of the header.
+			// Throws 'std::runtime_error' if the declarations are corrupted.
+			std::vector<Decl*> Instantiate(TypeTable& typeTable, ConstantTable& constTable, AstArena& astArena) const;
+
+		private:
+			std::filesystem::path path;
+			SrcFile file;
+			// The string data stays in the mapping, the tables are read once.
+			std::string_view strData;
+			size_t srcCodeSize{0};
+			std::vector<std::string> files;
+			std::vector<std::string_view> macros;
+			std::vector<ConstantValue> constants;
+			// The type specifiers of the type table's ids 1..n-1 (0 is the unknown type every table starts with).
+			std::vector<FlatId> typeSpecIds;
+			std::vector<FlatId> declIds;
+			FlatAst flatAst;
+		};
+
+	}
+}
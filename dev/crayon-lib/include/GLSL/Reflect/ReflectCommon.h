@@ -140,7 +140,7 @@ namespace crayon {
 	};
 
 	struct ColorAttachmentDesc {
-		std::string_view name;
+		std::string name;
 		ColorAttachmentChannel channel{ColorAttachmentChannel::UNDEFINED};
 		ColorAttachmentType type{ColorAttachmentType::UNDEFINED};
 	};
@@ -55,4 +55,10 @@ namespace crayon {
 		std::string name;
 	};
 
+	// Binary serialization of the whole program (modules and reflection data).
+	// The format is host-endian, it's meant for caches living on the same machine.
+	void SerializeShaderProgram(const ShaderProgram& shaderProgram, std::vector<uint8_t>& data);
+	// Returns 'false' if the data is truncated, corrupted or was written by an incompatible version.
+	bool DeserializeShaderProgram(const uint8_t* data, size_t size, ShaderProgram& shaderProgram);
+
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		// Lines and columns are indexed starting from 0, a tab is 4 columns wide.
+		struct SrcLocation {
+			uint32_t line{0};
+			uint32_t startCol{0};
+			uint32_t endCol{0};
+		};
+
+		// A line of one of the files that make up preprocessed source code.
+		struct SrcFileLine {
+			// Empty for the main source file.
+			std::string_view fileName;
+			uint32_t line{0};
+		};
+
+		// Maps the lines of preprocessed source code back to the files they come from.
+		// The preprocessor keeps the lines of a file together, so only the first line of every run is recorded.
+		class SrcLineMap {
+		public:
+			void Clear();
+			// From 'line' on, the lines come from the file's lines starting with 'fileLine'.
+			void Add(uint32_t line, std::string_view fileName, uint32_t fileLine);
+			SrcFileLine Resolve(uint32_t line) const;
+
+		private:
+			struct Run {
+				uint32_t line{0};
+				uint32_t fileIndex{0};
+				uint32_t fileLine{0};
+			};
+
+			std::vector<Run> runs;
+			std::vector<std::string> fileNames;
+		};
+
+		// Offsets of the line starts of a source file. Tokens only store their offset in the source code,
+		// lines and columns are resolved through the index when a diagnostic (or a debug dump) needs them.
+		class SrcLineIndex {
+		public:
+			// The source code must outlive the index.
+			void Build(const char* srcData, size_t srcSize);
+			void Clear();
+			bool IsBuilt() const;
+
+			// Checks whether the text points into the indexed source code
+			// (tokens generated by the compiler itself don't).
+			bool Contains(std::string_view text) const;
+			// The text must point into the indexed source code.
+			SrcLocation Locate(std::string_view text) const;
+			// The line's text without the line break.
+			std::string_view GetLineText(uint32_t line) const;
+			// Optional, set for preprocessed source code. The map must outlive the index.
+			void SetLineMap(const SrcLineMap* lineMap);
+			// The file and the line of the file a line of the source code comes from.
+			SrcFileLine ResolveLine(uint32_t line) const;
+
+		private:
+			uint32_t GetLine(size_t offset) const;
+			uint32_t GetCol(uint32_t line, size_t offset) const;
+
+			std::vector<uint32_t> lineStarts;
+			const char* srcData{nullptr};
+			size_t srcSize{0};
+			const SrcLineMap* lineMap{nullptr};
+		};
+
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GLSL/SrcLocation.h"
+
 #include <string_view>
 #include <iostream>
 
@@ -80,6 +82,7 @@ namespace crayon {
 			LEFT_BRACKET, RIGHT_BRACKET,
 			LEFT_BRACE, RIGHT_BRACE,
 			DOT, COMMA, SEMICOLON,
+			QUESTION, // ?
 
 			// GLSL language extension punctuation marks:
 			COLON,
@@ -104,23 +107,24 @@ namespace crayon {
 			TOKEN_NUM
 		};
 
+		// The lexeme points into the source code (or into static storage for generated tokens),
+		// its line and column are resolved through a 'SrcLineIndex' when needed.
 		struct Token {
-			bool HasSrcCodeRepresentation() const;
-
 			std::string_view lexeme;
 			TokenType tokenType{TokenType::UNDEFINED};
-			int line{-1};
-			int startCol{-1};
-			int endCol{-1};
 		};
 
 		Token GenerateToken(TokenType tokenType);
 
-		void PrintToken(std::ostream& out, const Token& token);
+		void PrintToken(std::ostream& out, const Token& token, const SrcLocation& location);
 
 		std::string_view TokenTypeToStr(TokenType tokenType);
 		std::string_view TokenTypeToLexeme(TokenType tokenType);
 
+		// How tightly a binary operator binds its operands, from 1 ('||') to 11 ('*', '/', '%').
+		// Zero for the tokens which aren't binary operators.
+		int GetBinaryOpPrecedence(TokenType tokenType);
+
 		std::string_view ExtractStringLiteral(const Token& token);
 	
 	}
@@ -74,6 +74,12 @@ namespace crayon {
 
 		TokenType InferExprType(TokenType lhs, TokenType rhs, TokenType op);
 		TokenType InferArithmeticBinaryExprType(TokenType lhs, TokenType rhs, TokenType op);
+		TokenType InferIntegerBinaryExprType(TokenType lhs, TokenType rhs, TokenType op);
+		TokenType InferShiftExprType(TokenType lhs, TokenType rhs);
+		TokenType InferRelationalExprType(TokenType lhs, TokenType rhs);
+		TokenType InferEqualityExprType(TokenType lhs, TokenType rhs);
+		TokenType InferLogicalExprType(TokenType lhs, TokenType rhs);
+		TokenType InferUnaryExprType(TokenType operand, TokenType op);
 		TokenType InferScalarOpScalarExprType(TokenType lhs, TokenType rhs, TokenType op);
 		TokenType InferScalarOpVectorExprType(TokenType lhs, TokenType rhs, TokenType op);
 		TokenType InferVectorOpScalarExprType(TokenType lhs, TokenType rhs, TokenType op);
@@ -106,7 +112,7 @@ namespace crayon {
 			bool IsValid() const;
 			bool IsImplicit() const;
 
-			std::shared_ptr<Expr> dimExpr;
+			Expr* dimExpr{nullptr};
 			size_t dimSize{0};
 		};
 
@@ -130,7 +136,7 @@ namespace crayon {
 			// 1) struct {...} s1, s2; // unnamed structure declaration.
 			// 2) struct S {...} s1, s2; // named structure declaration.
 			// Used only when the 'TypeSpec' instance is part of the declaration.
-			std::shared_ptr<StructDecl> typeDecl;
+			StructDecl* typeDecl{nullptr};
 			// Array dimensions (if it's an array type, i.e. int[]).
 			std::vector<ArrayDim> dimensions;
 		};
@@ -142,6 +148,9 @@ namespace crayon {
 		TypeSpec PromoteType(const TypeSpec& what, const TypeSpec& promoteTo);
 
 		TypeSpec InferArithmeticBinaryExprType(const TypeSpec& lhs, const TypeSpec& rhs, TokenType op);
+		TypeSpec InferExprType(const TypeSpec& lhs, const TypeSpec& rhs, TokenType op);
+		TypeSpec InferUnaryExprType(const TypeSpec& operand, TokenType op);
+		TypeSpec InferTernaryExprType(const TypeSpec& condition, const TypeSpec& trueType, const TypeSpec& falseType);
 
 		struct FullSpecType {
 			TypeQual qualifier;
@@ -156,7 +165,7 @@ namespace crayon {
 		public:
 			TypeTable();
 
-			const TypeSpec& GetType(size_t idx);
+			const TypeSpec& GetType(size_t idx) const;
 			const TypeSpec& GetType(const std::string& typeName);
 
 			bool HasType(const TypeSpec& type);
@@ -166,6 +175,8 @@ namespace crayon {
 
 			size_t GetTypeId(const TypeSpec& type);
 
+			size_t GetTypeCount() const;
+
 		private:
 			std::vector<TypeSpec> types;
 			std::unordered_map<std::string, size_t> typeMap;
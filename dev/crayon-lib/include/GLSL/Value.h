@@ -101,10 +101,15 @@ namespace crayon {
             SeqIdGenerator<ConstId> idGen;
         };
 
-        int ParseIntValue(std::string_view intVal);
-        unsigned int ParseUintValue(std::string_view uintVal);
-        float ParseFloatValue(std::string_view floatVal);
-        double ParseDoubleValue(std::string_view doubleVal);
+        // Literal conversions, locale independent. The lexer runs them once per literal.
+        // Return an error message (a string literal) if the literal is malformed or out of range,
+        // 'nullptr' otherwise.
+        // The digits of an integer literal, without the "0x" prefix and the suffix.
+        // The bits are reinterpreted as 'int' for signed literals, so they must fit into 32 bits.
+        const char* ParseIntConstBits(std::string_view digits, IntConstType intConstType, uint32_t& bits);
+        // A floating-point literal without the suffix.
+        const char* ParseFloatValue(std::string_view floatVal, float& value);
+        const char* ParseDoubleValue(std::string_view doubleVal, double& value);
 
         void PrintConstantValue(std::ostream& out, const ConstantValue& constVal);
 
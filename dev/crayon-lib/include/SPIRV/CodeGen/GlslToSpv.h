@@ -3,6 +3,8 @@
 #include "GLSL/Type.h"
 #include "GLSL/Value.h"
 
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/AST/AstVisitor.h"
 #include "GLSL/AST/Block.h"
 #include "GLSL/AST/Decl.h"
 #include "GLSL/AST/Stmt.h"
@@ -14,6 +16,10 @@
 
 #include "GLSL/Reflect/ShaderProgram.h"
 
+#include "GLSL/CompileStats.h"
+
+#include "Trace.h"
+
 #include <cstdint>
 #include <iostream>
 #include <unordered_map>
@@ -53,8 +59,8 @@ namespace crayon {
 			std::unordered_map<std::string_view, glsl::InterfaceBlockDecl*> intBlocks;
 			std::unordered_map<std::string_view, glsl::VarDecl*> variables;
 
-			std::vector<std::shared_ptr<glsl::VarDecl>> vertexInputVarDecls;
-			std::vector<std::shared_ptr<glsl::VarDecl>> colorAttachmentVarDecls;
+			std::vector<glsl::VarDecl*> vertexInputVarDecls;
+			std::vector<glsl::VarDecl*> colorAttachmentVarDecls;
 
 			// std::unordered_map<std::string_view, SpvInstruction> scalarTypes; // bool, int, uint, float, double
 			// std::unordered_map<std::string_view, SpvInstruction> compositeTypes; // vector, matrix, and array types
@@ -91,6 +97,11 @@ namespace crayon {
 			SpvType type{SpvType::BINARY};
 			glsl::TypeTable* typeTable{nullptr};
 			glsl::ConstantTable* constTable{nullptr};
+			// Owns the declarations generated for the vertex attributes, color attachments and such.
+			glsl::AstArena* astArena{nullptr};
+			// Optional. Receive the time spent on every shader stage.
+			glsl::CompileStats* stats{nullptr};
+			TraceRecorder* trace{nullptr};
 		};
 
 		// NEW
@@ -119,10 +130,7 @@ namespace crayon {
 		std::string MangleTypePointerName(glsl::MatPropDecl* matProp);
 		std::string MangleTypePointerName(glsl::ColorAttachmentDecl* colorAttachment);
 
-		class GlslToSpvGenerator : public glsl::BlockVisitor,
-			                       public glsl::DeclVisitor,
-			                       public glsl::StmtVisitor,
-			                       public glsl::ExprVisitor {
+		class GlslToSpvGenerator : public glsl::AstVisitor<GlslToSpvGenerator> {
 		public:
 			GlslToSpvGenerator(const GlslToSpvGeneratorConfig& config);
 
@@ -130,8 +138,11 @@ namespace crayon {
 			const ShaderProgram& GetShaderProgram() const;
 
 		private:
+			friend class glsl::AstVisitor<GlslToSpvGenerator>;
+
 			void GenerateTestProgram();
 			void ClearState();
+			void CreateModeInstructions();
 
 			std::vector<uint32_t> GenerateSpvBinary();
 			std::string GenerateSpvAsmText();
@@ -196,44 +207,46 @@ namespace crayon {
 			void PrintSpvInstructionBinary(std::ostream& out, const SpvInstruction& spvInstruction) const;
 
 			// Block vist methods
-			void VisitShaderProgramBlock(glsl::ShaderProgramBlock* programBlock) override;
-			void VisitFixedStagesConfigBlock(glsl::FixedStagesConfigBlock* fixedStagesConfigBlock) override;
-			void VisitMaterialPropertiesBlock(glsl::MaterialPropertiesBlock* materialPropertiesBlock) override;
-			void VisitVertexInputLayoutBlock(glsl::VertexInputLayoutBlock* vertexInputLayoutBlock) override;
-			void VisitColorAttachmentsBlock(glsl::ColorAttachmentsBlock* colorAttachmentsBlock) override;
-			void VisitShaderBlock(glsl::ShaderBlock* shaderBlock) override;
+			void VisitShaderProgramBlock(glsl::ShaderProgramBlock* programBlock);
+			void VisitFixedStagesConfigBlock(glsl::FixedStagesConfigBlock* fixedStagesConfigBlock);
+			void VisitMaterialPropertiesBlock(glsl::MaterialPropertiesBlock* materialPropertiesBlock);
+			void VisitVertexInputLayoutBlock(glsl::VertexInputLayoutBlock* vertexInputLayoutBlock);
+			void VisitColorAttachmentsBlock(glsl::ColorAttachmentsBlock* colorAttachmentsBlock);
+			void VisitShaderBlock(glsl::ShaderBlock* shaderBlock);
 
 			// Decl visit methods
-			void VisitTransUnit(glsl::TransUnit* transUnit) override;
-			void VisitStructDecl(glsl::StructDecl* structDecl) override;
-			void VisitInterfaceBlockDecl(glsl::InterfaceBlockDecl* intBlockDecl) override;
-			void VisitDeclList(glsl::DeclList* declList) override;
-			void VisitFunDecl(glsl::FunDecl* funDecl) override;
-			void VisitQualDecl(glsl::QualDecl* qualDecl) override;
-			void VisitVarDecl(glsl::VarDecl* varDecl) override;
+			void VisitTransUnit(glsl::TransUnit* transUnit);
+			void VisitStructDecl(glsl::StructDecl* structDecl);
+			void VisitInterfaceBlockDecl(glsl::InterfaceBlockDecl* intBlockDecl);
+			void VisitDeclList(glsl::DeclList* declList);
+			void VisitFunDecl(glsl::FunDecl* funDecl);
+			void VisitQualDecl(glsl::QualDecl* qualDecl);
+			void VisitVarDecl(glsl::VarDecl* varDecl);
 
 			// Stmt visit methods
-			void VisitBlockStmt(glsl::BlockStmt* blockStmt) override;
-			void VisitDeclStmt(glsl::DeclStmt* declStmt) override;
-			void VisitExprStmt(glsl::ExprStmt* exprStmt) override;
+			void VisitBlockStmt(glsl::BlockStmt* blockStmt);
+			void VisitDeclStmt(glsl::DeclStmt* declStmt);
+			void VisitExprStmt(glsl::ExprStmt* exprStmt);
 
 			// Expression visit methods
-			void VisitInitListExpr(glsl::InitListExpr* initListExpr) override;
-			void VisitAssignExpr(glsl::AssignExpr* assignExpr) override;
-			void VisitBinaryExpr(glsl::BinaryExpr* binaryExpr) override;
-			void VisitUnaryExpr(glsl::UnaryExpr* unaryExpr) override;
-			void VisitFieldSelectExpr(glsl::FieldSelectExpr* fieldSelectExpr) override;
-			void VisitFunCallExpr(glsl::FunCallExpr* funCallExpr) override;
-			void VisitCtorCallExpr(glsl::CtorCallExpr* ctorCallExpr) override;
-			void VisitVarExpr(glsl::VarExpr* varExpr) override;
-			void VisitIntConstExpr(glsl::IntConstExpr* intConstExpr) override;
-			void VisitUintConstExpr(glsl::UintConstExpr* uintConstExpr) override;
-			void VisitFloatConstExpr(glsl::FloatConstExpr* floatConstExpr) override;
-			void VisitDoubleConstExpr(glsl::DoubleConstExpr* doubleConstExpr) override;
-			void VisitGroupExpr(glsl::GroupExpr* groupExpr) override;
+			void VisitInitListExpr(glsl::InitListExpr* initListExpr);
+			void VisitAssignExpr(glsl::AssignExpr* assignExpr);
+			void VisitTernaryExpr(glsl::TernaryExpr* ternaryExpr);
+			void VisitBinaryExpr(glsl::BinaryExpr* binaryExpr);
+			void VisitUnaryExpr(glsl::UnaryExpr* unaryExpr);
+			void VisitFieldSelectExpr(glsl::FieldSelectExpr* fieldSelectExpr);
+			void VisitFunCallExpr(glsl::FunCallExpr* funCallExpr);
+			void VisitCtorCallExpr(glsl::CtorCallExpr* ctorCallExpr);
+			void VisitVarExpr(glsl::VarExpr* varExpr);
+			void VisitIntConstExpr(glsl::IntConstExpr* intConstExpr);
+			void VisitUintConstExpr(glsl::UintConstExpr* uintConstExpr);
+			void VisitFloatConstExpr(glsl::FloatConstExpr* floatConstExpr);
+			void VisitDoubleConstExpr(glsl::DoubleConstExpr* doubleConstExpr);
+			void VisitGroupExpr(glsl::GroupExpr* groupExpr);
 
 			ShaderProgram shaderProgram;
 			SpvEnvironment spvEnv;
+			SpvIdGenerator spvIdGenerator;
 			SpvInstruction entryPointInst;
 
 			SpvInstruction result;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Utility.h"
+
 #include <cstdint>
 #include <iostream>
 #include <optional>
@@ -99,6 +101,7 @@ namespace crayon {
 			OpLogicalOr         = 166,
 			OpLogicalAnd        = 167,
 			OpLogicalNot        = 168,
+			OpSelect            = 169,
 			OpIEqual            = 170,
 			OpINotEqual         = 171,
 			OpUGreaterThan      = 172,
@@ -246,7 +249,9 @@ namespace crayon {
 			SpvOpCode opCode{SpvOpCode::OpNop};
 		};
 
-		uint32_t GetLastGeneratedSpvId();
+		// Result ids are unique within a single SPIR-V module only.
+		// Every module being generated must have its own id generator.
+		using SpvIdGenerator = SeqIdGenerator<uint32_t>;
 
 		std::vector<uint32_t> GenerateLiteralStringWords(std::string_view str);
 
@@ -262,7 +267,7 @@ namespace crayon {
 			                        std::string_view entryPointName,
 			                        const std::vector<SpvInstruction>& interfaceVars);
 		SpvInstruction OpCapability(SpvCapability capability);
-		SpvInstruction OpExtInstImport(std::string_view extInstSetName);
+		SpvInstruction OpExtInstImport(SpvIdGenerator& idGenerator, std::string_view extInstSetName);
 
 		// Annotation instructions.
 
@@ -275,66 +280,60 @@ namespace crayon {
 
 		// Type-declaration instructions.
 
-		SpvInstruction OpTypeVoid();
-		SpvInstruction OpTypeBool();
-		SpvInstruction OpTypeInt(uint32_t width, SpvSignedness signedness);
-		SpvInstruction OpTypeFloat(uint32_t width);
+		SpvInstruction OpTypeVoid(SpvIdGenerator& idGenerator);
+		SpvInstruction OpTypeBool(SpvIdGenerator& idGenerator);
+		SpvInstruction OpTypeInt(SpvIdGenerator& idGenerator, uint32_t width, SpvSignedness signedness);
+		SpvInstruction OpTypeFloat(SpvIdGenerator& idGenerator, uint32_t width);
 
-		SpvInstruction OpTypeFunction(uint32_t retType);
-		SpvInstruction OpTypeFunction(const SpvInstruction& retTypeDeclInst);
-		SpvInstruction OpTypeFunction(uint32_t retType, const std::vector<uint32_t> params);
-		SpvInstruction OpTypeFunction(const SpvInstruction& typeDeclInst, const std::vector<uint32_t> params);
+		SpvInstruction OpTypeFunction(SpvIdGenerator& idGenerator, uint32_t retType);
+		SpvInstruction OpTypeFunction(SpvIdGenerator& idGenerator, const SpvInstruction& retTypeDeclInst);
 		
-		SpvInstruction OpTypeVector(uint32_t type, uint32_t count);
-		SpvInstruction OpTypeVector(const SpvInstruction& typeDeclInst, uint32_t count);
+		SpvInstruction OpTypeVector(SpvIdGenerator& idGenerator, uint32_t type, uint32_t count);
+		SpvInstruction OpTypeVector(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, uint32_t count);
 
-		SpvInstruction OpTypeArray(const SpvInstruction& elementType, const SpvInstruction& lengthConstInst);
-		SpvInstruction OpTypeStruct(const std::vector<SpvInstruction>& members);
+		SpvInstruction OpTypeArray(SpvIdGenerator& idGenerator, const SpvInstruction& elementType, const SpvInstruction& lengthConstInst);
+		SpvInstruction OpTypeStruct(SpvIdGenerator& idGenerator, const std::vector<SpvInstruction>& members);
 
-		SpvInstruction OpTypePointer(uint32_t type, SpvStorageClass storageClass);
-		SpvInstruction OpTypePointer(const SpvInstruction& typeDeclInst, SpvStorageClass storageClass);
+		SpvInstruction OpTypePointer(SpvIdGenerator& idGenerator, uint32_t type, SpvStorageClass storageClass);
+		SpvInstruction OpTypePointer(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, SpvStorageClass storageClass);
 
 		// Memory instructions.
 
-		SpvInstruction OpVariable(const SpvInstruction& typePointer, SpvStorageClass storageClass);
-		SpvInstruction OpVariable(const SpvInstruction& typePointer, SpvStorageClass storageClass,
+		SpvInstruction OpVariable(SpvIdGenerator& idGenerator, const SpvInstruction& typePointer, SpvStorageClass storageClass);
+		SpvInstruction OpVariable(SpvIdGenerator& idGenerator, const SpvInstruction& typePointer, SpvStorageClass storageClass,
 			                      const SpvInstruction& initializer);
 
-		SpvInstruction OpLoad(const SpvInstruction& type, const SpvInstruction& pointer);
+		SpvInstruction OpLoad(SpvIdGenerator& idGenerator, const SpvInstruction& type, const SpvInstruction& pointer);
 		SpvInstruction OpStore(const SpvInstruction& pointer, const SpvInstruction& object);
 
-		SpvInstruction OpAccessChain(const SpvInstruction& resultTypePtr,
+		SpvInstruction OpAccessChain(SpvIdGenerator& idGenerator, const SpvInstruction& resultTypePtr,
 			                         const SpvInstruction& baseType,
 			                         const SpvInstruction& fieldIdxConst);
 
 		// Constant instructions.
 
-		//SpvInstruction OpConstant(uint32_t type, int value);
-		//SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, int value);
-		//SpvInstruction OpConstant(uint32_t type, uint32_t value);
-		//SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, uint32_t value);
-		//SpvInstruction OpConstant(uint32_t type, float value);
-		//SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, float value);
-		//SpvInstruction OpConstant(uint32_t type, double value);
-		//SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, double value);
-
-		SpvInstruction OpConstant(uint32_t type, void* valPtr);
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, void* valPtr);
 		template <typename T>
-		SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, T value) {
-			return OpConstant(typeDeclInst.GetResultId(), &value);
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, T value) {
+			return OpConstant(idGenerator, typeDeclInst.GetResultId(), &value);
 		}
 
-		SpvInstruction OpConstantComposite(const SpvInstruction& typeDeclInst,
+		SpvInstruction OpConstantComposite(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst,
 			                               const std::vector<SpvInstruction>& constituents);
 
+		// Relational and logical instructions.
+
+		SpvInstruction OpSelect(SpvIdGenerator& idGenerator, const SpvInstruction& resultType, const SpvInstruction& condition,
+			                    const SpvInstruction& object1, const SpvInstruction& object2);
+
 		// Function instructions.
 
-		SpvInstruction OpFunction(const SpvInstruction& typeFunctionInst, SpvFunctionControl funCtrl);
+		SpvInstruction OpFunction(SpvIdGenerator& idGenerator, const SpvInstruction& typeFunctionInst, SpvFunctionControl funCtrl);
 		SpvInstruction OpFunctionEnd();
 
 		// Control-flow instructions.
 
-		SpvInstruction OpLabel();
+		SpvInstruction OpLabel(SpvIdGenerator& idGenerator);
 		SpvInstruction OpReturn();
 
 		std::string SpvInstructionToString(const SpvInstruction& spvInstruction);
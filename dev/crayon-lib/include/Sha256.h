@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace crayon {
+
+	// Incremental SHA-256 (FIPS 180-4).
+	class Sha256 {
+	public:
+		using Digest = std::array<uint8_t, 32>;
+
+		Sha256();
+
+		void Update(const void* data, size_t size);
+		void Update(std::string_view str);
+		template <typename T>
+		void UpdateValue(const T& value) {
+			Update(&value, sizeof(T));
+		}
+
+		// The hasher must not be updated after the digest has been computed.
+		Digest Finalize();
+
+	private:
+		void ProcessBlock(const uint8_t* block);
+
+		std::array<uint32_t, 8> state;
+		std::array<uint8_t, 64> buffer;
+		uint64_t totalSize{0};
+		size_t bufferSize{0};
+	};
+
+	std::string DigestToHexString(const Sha256::Digest& digest);
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Utility.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace crayon {
+
+	// Read-only contents of a source file. The file is memory mapped, so nothing is copied and the pages
+	// are only read once the lexer gets to them. Files that can't be mapped (pipes, empty files,
+	// some network file systems) are read into memory instead.
+	// The contents stay valid until the file is closed, reopened or the object is destroyed.
+	// A mapped file must not be truncated in the meantime.
+	class SrcFile {
+	public:
+		SrcFile() = default;
+		~SrcFile();
+		CLASS_NO_COPY(SrcFile);
+		CLASS_NO_MOVE(SrcFile);
+
+		// Throws 'std::runtime_error' if the file can't be opened or read.
+		void Open(const std::filesystem::path& path);
+		void Close();
+
+		const char* GetData() const;
+		size_t GetSize() const;
+		bool IsMapped() const;
+
+	private:
+		bool Map(const std::filesystem::path& path);
+		void Read(const std::filesystem::path& path);
+
+		const char* data{nullptr};
+		size_t size{0};
+
+		void* mappedData{nullptr};
+		// Only used when the file couldn't be mapped.
+		std::vector<char> readData;
+	};
+
+}
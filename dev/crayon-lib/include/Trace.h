@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Utility.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crayon {
+
+	// Collects spans in the Chrome trace event format (chrome://tracing, https://ui.perfetto.dev).
+	// Spans recorded by the same thread are nested by the viewer according to their time ranges.
+	// Any number of threads may record spans at the same time.
+	class TraceRecorder {
+	public:
+		TraceRecorder();
+		CLASS_NO_COPY(TraceRecorder);
+		CLASS_NO_MOVE(TraceRecorder);
+
+		void AddSpan(std::string_view name, std::string_view category,
+		             std::chrono::steady_clock::time_point start,
+		             std::chrono::steady_clock::time_point end);
+		// Shown instead of the numeric id of the calling thread.
+		void SetThreadName(std::string_view name);
+
+		// Writes the JSON object format: {"traceEvents":[...]}.
+		void Write(std::ostream& out) const;
+
+	private:
+		struct TraceEvent {
+			std::string name;
+			std::string category;
+			// Fractional, so that nested spans don't stick out of their parents due to rounding.
+			double timestampUs{0.0};
+			double durationUs{0.0};
+			uint32_t threadId{0};
+		};
+		struct ThreadName {
+			std::string name;
+			uint32_t threadId{0};
+		};
+
+		std::chrono::steady_clock::time_point origin;
+
+		mutable std::mutex eventsMutex;
+		std::vector<TraceEvent> events;
+		std::vector<ThreadName> threadNames;
+	};
+
+	// Records a span from its construction to its destruction. Does nothing if the recorder is null.
+	// The category must outlive the scope (it's meant to be a string literal).
+	class TraceScope {
+	public:
+		TraceScope(TraceRecorder* recorder, std::string_view name, std::string_view category);
+		~TraceScope();
+		CLASS_NO_COPY(TraceScope);
+		CLASS_NO_MOVE(TraceScope);
+
+		// Ends the span before the scope does. Subsequent calls do nothing.
+		void End();
+
+	private:
+		TraceRecorder* recorder{nullptr};
+		std::string name;
+		std::string_view category;
+		std::chrono::steady_clock::time_point start;
+	};
+
+}
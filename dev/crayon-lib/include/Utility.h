@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <iosfwd>
 #include <stack>
 #include <string_view>
 #include <type_traits>
@@ -60,4 +61,7 @@ namespace crayon {
 
 	size_t CalcDigitCount(size_t number);
 
+	// Writes a quoted and escaped JSON string.
+	void WriteJsonString(std::ostream& out, std::string_view str);
+
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "AllocStats.h"
+
+namespace crayon {
+
+	AllocStats& GetThreadAllocStats() {
+		// Trivially constructible, so it's safe to use from within 'operator new' at any time.
+		static thread_local AllocStats allocStats{};
+		return allocStats;
+	}
+
+}
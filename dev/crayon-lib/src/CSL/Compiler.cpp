@@ -1,9 +1,9 @@
 #include "CSL/Compiler.h"
 
+#include "SrcFile.h"
 #include "Utility.h"
 
 #include <iostream>
-#include <fstream>
 #include <stdexcept>
 
 namespace crayon
@@ -28,28 +28,15 @@ namespace crayon
 				throw std::runtime_error{ errMsg };
 			}
 
-			std::ifstream srcCodeFile(srcCodePath, std::ifstream::in | std::ifstream::ate | std::ifstream::binary);
-
-			if (!srcCodeFile.is_open())
-			{
-				std::string errMsg{ "Couldn't open the .csl source code file: " + srcCodePath.string() };
-				throw std::runtime_error{ errMsg };
-			}
-
-			size_t fileSize = srcCodeFile.tellg();
-			std::vector<char> srcCodeData(fileSize);
-
-			srcCodeFile.seekg(0);
-			srcCodeFile.read(srcCodeData.data(), fileSize);
-
-			srcCodeFile.close();
+			SrcFile srcFile{};
+			srcFile.Open(srcCodePath);
 
 			ScannerParams scannerParams{};
 			scannerParams.errorReporter = scannerErrorReporter.get();
 
 			try
 			{
-				scanner->ScanSrcCode(scannerParams, srcCodeData.data(), srcCodeData.size());
+				scanner->ScanSrcCode(scannerParams, srcFile.GetData(), srcFile.GetSize());
 			}
 			catch (std::runtime_error& err)
 			{
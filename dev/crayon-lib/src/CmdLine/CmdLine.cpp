@@ -1,7 +1,203 @@
 #include "CmdLine/CmdLine.h"
+#include "GLSL/DebugDump.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 namespace crayon {
 
+	static void CollectSrcFile(const std::filesystem::path& input, std::vector<std::filesystem::path>& srcFiles) {
+		if (std::filesystem::is_directory(input)) {
+			for (const std::filesystem::directory_entry& entry :
+				 std::filesystem::recursive_directory_iterator(input)) {
+				if (entry.is_regular_file() && FileExtCsl(entry.path().extension().generic_string())) {
+					srcFiles.push_back(entry.path().lexically_normal());
+				}
+			}
+		} else if (std::filesystem::exists(input)) {
+			// Explicitly listed files are passed on as they are,
+			// the compiler will complain about the wrong file extension itself.
+			srcFiles.push_back(input.lexically_normal());
+		} else {
+			throw std::runtime_error{"Input path doesn't exist: " + input.string()};
+		}
+	}
+	static void CollectManifestSrcFiles(const std::filesystem::path& manifest, std::vector<std::filesystem::path>& srcFiles) {
+		std::ifstream manifestFile{manifest};
+		if (!manifestFile.is_open()) {
+			throw std::runtime_error{"Couldn't open the manifest file: " + manifest.string()};
+		}
+		// Relative paths are resolved against the manifest's directory.
+		std::filesystem::path manifestDir = manifest.parent_path();
+		std::string line;
+		while (std::getline(manifestFile, line)) {
+			// Trim whitespace (including the '\r' of files with Windows line endings).
+			size_t first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos || line[first] == '#') {
+				continue;
+			}
+			size_t last = line.find_last_not_of(" \t\r");
+			std::filesystem::path input{line.substr(first, last - first + 1)};
+			if (input.is_relative()) {
+				input = manifestDir / input;
+			}
+			CollectSrcFile(input, srcFiles);
+		}
+	}
+
+	CmdLineArgs ParseCmdLineArgs(int argc, char* argv[]) {
+		CmdLineArgs cmdLineArgs{};
+		for (int i = 1; i < argc; i++) {
+			std::string_view arg{argv[i]};
+			if (arg == "-h" || arg == "--help") {
+				cmdLineArgs.help = true;
+			} else if (arg == "-v" || arg == "--verbose") {
+				cmdLineArgs.verbose = true;
+			} else if (arg == "-j" || arg == "--jobs") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the number of jobs after '" + std::string{arg} + "'"};
+				}
+				std::string jobs{argv[++i]};
+				if (jobs.empty() || jobs.find_first_not_of("0123456789") != std::string::npos) {
+					throw std::invalid_argument{"Invalid number of jobs: '" + jobs + "'"};
+				}
+				cmdLineArgs.jobs = static_cast<uint32_t>(std::stoul(jobs));
+			} else if (arg == "-m" || arg == "--manifest") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the manifest path after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.manifests.emplace_back(argv[++i]);
+			} else if (arg == "-I" || arg == "--include-dir") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the include directory after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.includeDirs.emplace_back(argv[++i]);
+			} else if (arg.size() > 2 && arg.substr(0, 2) == "-I") {
+				cmdLineArgs.includeDirs.emplace_back(arg.substr(2));
+			} else if (arg == "--precompile-header") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the header path after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.precompileHeaderPath = argv[++i];
+			} else if (arg == "--pch") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the precompiled header path after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.pchPath = argv[++i];
+			} else if (arg == "--pipeline") {
+				cmdLineArgs.pipeline = true;
+			} else if (arg == "--stream") {
+				cmdLineArgs.stream = true;
+			} else if (arg == "--cache-dir") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the cache directory after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.cacheDir = argv[++i];
+			} else if (arg.substr(0, 8) == "--stats=") {
+				std::string_view format = arg.substr(8);
+				if (format != "json") {
+					throw std::invalid_argument{"Unknown statistics format: '" + std::string{format} + "'"};
+				}
+				cmdLineArgs.statsJson = true;
+			} else if (arg.substr(0, 8) == "--trace=") {
+				if (arg.size() == 8) {
+					throw std::invalid_argument{"Missing the trace file path in '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.traceFile = arg.substr(8);
+			} else if (arg.substr(0, 7) == "--dump=") {
+				cmdLineArgs.dumpChannels = glsl::ParseDumpChannels(arg.substr(7));
+			} else if (arg.substr(0, 11) == "--dump-dir=") {
+				if (arg.size() == 11) {
+					throw std::invalid_argument{"Missing the dump directory in '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.dumpDir = arg.substr(11);
+			} else if (arg == "--serve") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the socket path after '" + std::string{arg} + "'"};
+				}
+				cmdLineArgs.serveSocketPath = argv[++i];
+			} else if (arg == "--idle-timeout") {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument{"Missing the number of seconds after '" + std::string{arg} + "'"};
+				}
+				std::string idleTimeout{argv[++i]};
+				if (idleTimeout.empty() || idleTimeout.find_first_not_of("0123456789") != std::string::npos) {
+					throw std::invalid_argument{"Invalid idle timeout: '" + idleTimeout + "'"};
+				}
+				cmdLineArgs.idleTimeout = static_cast<uint32_t>(std::stoul(idleTimeout));
+			} else if (arg.size() > 1 && arg[0] == '@') {
+				cmdLineArgs.manifests.emplace_back(arg.substr(1));
+			} else if (arg.size() > 1 && arg[0] == '-') {
+				throw std::invalid_argument{"Unknown option: '" + std::string{arg} + "'"};
+			} else {
+				cmdLineArgs.inputs.emplace_back(arg);
+			}
+		}
+		bool hasInputs = !cmdLineArgs.inputs.empty() || !cmdLineArgs.manifests.empty();
+		if (!cmdLineArgs.serveSocketPath.empty()) {
+			if (hasInputs || !cmdLineArgs.cacheDir.empty() || cmdLineArgs.dumpChannels != 0 ||
+				!cmdLineArgs.precompileHeaderPath.empty()) {
+				throw std::invalid_argument{"'--serve' can't be combined with input files, '--cache-dir', '--dump' or '--precompile-header'"};
+			}
+		} else if (!cmdLineArgs.precompileHeaderPath.empty()) {
+			if (hasInputs || !cmdLineArgs.pchPath.empty()) {
+				throw std::invalid_argument{"'--precompile-header' can't be combined with input files or '--pch'"};
+			}
+		} else if (!cmdLineArgs.help && !hasInputs) {
+			throw std::invalid_argument{"No input files"};
+		}
+		if (cmdLineArgs.pipeline && cmdLineArgs.stream) {
+			throw std::invalid_argument{"'--pipeline' can't be combined with '--stream'"};
+		}
+		if (!cmdLineArgs.dumpDir.empty() && cmdLineArgs.dumpChannels == 0) {
+			throw std::invalid_argument{"'--dump-dir' requires '--dump'"};
+		}
+		return cmdLineArgs;
+	}
+	void PrintUsage(std::ostream& out) {
+		out << "Usage: cslc [options] <source.csl | directory | @manifest>...\n"
+		    << "       cslc [-I <dir>]... --precompile-header <header>\n"
+		    << "       cslc [-v] [-j <N>] [-I <dir>]... [--pch <file>] [--idle-timeout <s>] --serve <socket>\n"
+		    << "Options:\n"
+		    << "  -j, --jobs <N>         Compile with N worker threads (default: all hardware threads)\n"
+		    << "  -m, --manifest <file>  Read input paths from a file, one per line ('#' starts a comment)\n"
+		    << "  -I, --include-dir <dir> Search a directory for '#include' files (after the including file's one)\n"
+		    << "      --precompile-header <header> Write the header's declarations and macros to \"<header>.pch\"\n"
+		    << "      --pch <file>       Compile every input as if it started by including a precompiled header\n"
+		    << "      --pipeline         Lex large files on a separate thread while parsing them (not with '--pch')\n"
+		    << "      --stream           Parse while lexing on demand, without keeping the tokens (not with '--pch')\n"
+		    << "      --cache-dir <dir>  Reuse the results of previous compilations stored in a directory\n"
+		    << "      --stats=json       Print per-phase timings, counts and allocations as JSON\n"
+		    << "                         (the compile report goes to the standard error stream then)\n"
+		    << "      --trace=<file>     Write Chrome trace events (chrome://tracing, Perfetto) of the compilation\n"
+		    << "      --dump=<channels>  Write debug dumps of every compiled file to \"<name>.<channel>.txt\" files,\n"
+		    << "                         channels: tokens, ast, constants, types, spirv (comma separated) or all\n"
+		    << "      --dump-dir=<dir>   Write the debug dumps to a directory instead of next to the source files\n"
+		    << "      --serve <socket>   Run as a compile server listening on a Unix domain socket,\n"
+		    << "                         serving up to N connections at a time ('-j')\n"
+		    << "                         (only the user running the server may shut it down)\n"
+		    << "      --idle-timeout <s> Close server connections that send no request for s seconds (default: 30, 0: never)\n"
+		    << "  -v, --verbose          Print every request when serving\n"
+		    << "  -h, --help             Print this message\n";
+	}
 
+	std::vector<std::filesystem::path> CollectSrcFiles(const CmdLineArgs& cmdLineArgs) {
+		std::vector<std::filesystem::path> srcFiles;
+		for (const std::filesystem::path& input : cmdLineArgs.inputs) {
+			CollectSrcFile(input, srcFiles);
+		}
+		for (const std::filesystem::path& manifest : cmdLineArgs.manifests) {
+			CollectManifestSrcFiles(manifest, srcFiles);
+		}
+		// The same file may be reachable through several inputs.
+		std::sort(srcFiles.begin(), srcFiles.end());
+		srcFiles.erase(std::unique(srcFiles.begin(), srcFiles.end()), srcFiles.end());
+		return srcFiles;
+	}
 
-}
\ No newline at end of file
+}
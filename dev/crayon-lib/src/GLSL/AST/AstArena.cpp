@@ -0,0 +1,58 @@
+#include "GLSL/AST/AstArena.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace crayon {
+	namespace glsl {
+
+		AstArena::~AstArena() {
+			DestroyNodes();
+		}
+
+		void AstArena::Reset() {
+			DestroyNodes();
+			if (chunks.size() > 1) {
+				chunks.resize(1);
+			}
+			if (!chunks.empty()) {
+				// An oversized first chunk is simply used up to the regular size.
+				chunkCurrent = chunks.front().get();
+				chunkEnd = chunkCurrent + chunkSize;
+			}
+			allocatedBytes = 0;
+		}
+		size_t AstArena::GetAllocatedBytes() const {
+			return allocatedBytes;
+		}
+
+		void* AstArena::Allocate(size_t size, size_t align) {
+			assert(align != 0 && (align & (align - 1)) == 0 && "The alignment must be a power of two!");
+			uintptr_t current = reinterpret_cast<uintptr_t>(chunkCurrent);
+			uintptr_t aligned = (current + align - 1) & ~static_cast<uintptr_t>(align - 1);
+			if (!chunkCurrent || aligned + size > reinterpret_cast<uintptr_t>(chunkEnd)) {
+				// The rest of the current chunk is wasted, nodes are much smaller than a chunk anyway.
+				// Oversized requests get a chunk of their own.
+				size_t newChunkSize = size + align > chunkSize ? size + align : chunkSize;
+				chunks.push_back(std::make_unique<std::byte[]>(newChunkSize));
+				chunkCurrent = chunks.back().get();
+				chunkEnd = chunkCurrent + newChunkSize;
+				current = reinterpret_cast<uintptr_t>(chunkCurrent);
+				aligned = (current + align - 1) & ~static_cast<uintptr_t>(align - 1);
+			}
+			chunkCurrent = reinterpret_cast<std::byte*>(aligned + size);
+			allocatedBytes += size;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		void AstArena::DestroyNodes() {
+			// In the reverse order of construction, like automatic objects.
+			while (lastDtorRecord) {
+				DtorRecord* record = lastDtorRecord;
+				lastDtorRecord = record->prev;
+				record->destroy(record->obj);
+			}
+		}
+
+	}
+}
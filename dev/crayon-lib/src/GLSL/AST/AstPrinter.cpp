@@ -0,0 +1,262 @@
+#include "GLSL/AST/AstPrinter.h"
+#include "GLSL/CompileStats.h"
+
+namespace crayon {
+	namespace glsl {
+
+		static void PrintType(std::ostream& out, const TypeQual& typeQual, const TypeSpec& typeSpec) {
+			if (typeQual.storage) {
+				out << typeQual.storage->lexeme << " ";
+			}
+			out << MangleTypeSpecName(typeSpec);
+		}
+		static void PrintFullSpecType(std::ostream& out, const FullSpecType& fullSpecType) {
+			PrintType(out, fullSpecType.qualifier, fullSpecType.specifier);
+		}
+
+		AstPrinter::AstPrinter(std::ostream& out)
+			: out(out) {}
+
+		void AstPrinter::Print(ShaderProgramBlock* program) {
+			indentLvl = 0;
+			Visit(program);
+		}
+
+		// Block visit methods
+		void AstPrinter::VisitShaderProgramBlock(ShaderProgramBlock* programBlock) {
+			BeginNode("ShaderProgram") << " \"" << programBlock->GetShaderProgramName() << "\"\n";
+			indentLvl++;
+			for (Block* block : programBlock->GetBlocks()) {
+				Visit(block);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitFixedStagesConfigBlock(FixedStagesConfigBlock*) {
+			// The block doesn't hold any declarations yet.
+			BeginNode("FixedStagesConfig") << "\n";
+		}
+		void AstPrinter::VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock) {
+			BeginNode("MaterialProperties") << " " << materialPropertiesBlock->GetName().lexeme << "\n";
+			indentLvl++;
+			for (MatPropDecl* matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
+				BeginNode("MatPropDecl") << " " << matPropDecl->GetType().lexeme << " " << matPropDecl->GetName().lexeme << "\n";
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayoutBlock) {
+			BeginNode("VertexInputLayout") << "\n";
+			indentLvl++;
+			for (VertexAttribDecl* vertexAttribDecl : vertexInputLayoutBlock->GetAttribDecls()) {
+				BeginNode("VertexAttribDecl") << " " << MangleTypeSpecName(vertexAttribDecl->GetTypeSpec()) << " "
+				                              << vertexAttribDecl->GetName().lexeme << " : "
+				                              << vertexAttribDecl->GetChannel().lexeme << "\n";
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachmentsBlock) {
+			BeginNode("ColorAttachments") << "\n";
+			indentLvl++;
+			for (ColorAttachmentDecl* colorAttachment : colorAttachmentsBlock->GetColorAttachments()) {
+				BeginNode("ColorAttachmentDecl") << " " << MangleTypeSpecName(colorAttachment->GetTypeSpec()) << " "
+				                                 << colorAttachment->GetName().lexeme << " : "
+				                                 << colorAttachment->GetChannel().lexeme << "\n";
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitShaderBlock(ShaderBlock* shaderBlock) {
+			BeginNode("Shader") << " " << ShaderTypeToStr(shaderBlock->GetShaderType()) << "\n";
+			indentLvl++;
+			if (TransUnit* transUnit = shaderBlock->GetTranslationUnit()) {
+				Visit(transUnit);
+			}
+			indentLvl--;
+		}
+
+		// Decl visit methods
+		void AstPrinter::VisitTransUnit(TransUnit* transUnit) {
+			BeginNode("TransUnit") << "\n";
+			indentLvl++;
+			for (Decl* decl : transUnit->GetDeclarations()) {
+				Visit(decl);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitInterfaceBlockDecl(InterfaceBlockDecl* interfaceBlockDecl) {
+			BeginNode("InterfaceBlockDecl") << " " << interfaceBlockDecl->GetName().lexeme;
+			if (interfaceBlockDecl->HasInstanceName()) {
+				out << " " << interfaceBlockDecl->GetInstanceName().lexeme;
+			}
+			out << "\n";
+			indentLvl++;
+			for (VarDecl* field : interfaceBlockDecl->GetFields()) {
+				PrintVarDecl(field);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitDeclList(DeclList* declList) {
+			BeginNode("DeclList") << " ";
+			PrintFullSpecType(out, declList->GetFullSpecType());
+			out << "\n";
+			indentLvl++;
+			if (StructDecl* structDecl = declList->GetFullSpecType().specifier.typeDecl) {
+				Visit(structDecl);
+			}
+			for (VarDecl* varDecl : declList->GetDecls()) {
+				PrintVarDecl(varDecl);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitStructDecl(StructDecl* structDecl) {
+			BeginNode("StructDecl");
+			if (!structDecl->IsStructDeclAnonymous()) {
+				out << " " << structDecl->GetName().lexeme;
+			}
+			out << "\n";
+			indentLvl++;
+			for (VarDecl* field : structDecl->GetFields()) {
+				PrintVarDecl(field);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitVarDecl(VarDecl* varDecl) {
+			PrintVarDecl(varDecl);
+		}
+		void AstPrinter::VisitFunDecl(FunDecl* funDecl) {
+			FunProto* funProto = funDecl->GetFunProto();
+			BeginNode(funDecl->IsFunDef() ? "FunDef" : "FunDecl") << " ";
+			PrintFullSpecType(out, funProto->GetReturnType());
+			out << " " << funProto->GetFunctionName().lexeme << "\n";
+			indentLvl++;
+			for (FunParam* funParam : funProto->GetFunParamList()) {
+				BeginNode("FunParam") << " ";
+				PrintFullSpecType(out, funParam->GetVarType());
+				if (funParam->HasName()) {
+					out << " " << funParam->GetVarName().lexeme;
+				}
+				out << "\n";
+			}
+			if (funDecl->IsFunDef()) {
+				VisitBlockStmt(funDecl->GetBlockStmt());
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitQualDecl(QualDecl* qualDecl) {
+			BeginNode("QualDecl");
+			const TypeQual& typeQual = qualDecl->GetTypeQualifier();
+			for (const std::optional<Token>& qualifier :
+			     {typeQual.storage, typeQual.precision, typeQual.interpolation, typeQual.invariant, typeQual.precise}) {
+				if (qualifier) {
+					out << " " << qualifier->lexeme;
+				}
+			}
+			out << "\n";
+		}
+
+		// Stmt visit methods
+		void AstPrinter::VisitBlockStmt(BlockStmt* blockStmt) {
+			BeginNode("BlockStmt") << "\n";
+			indentLvl++;
+			for (Stmt* stmt : blockStmt->GetStatements()) {
+				Visit(stmt);
+			}
+			indentLvl--;
+		}
+		void AstPrinter::VisitDeclStmt(DeclStmt* declStmt) {
+			BeginNode("DeclStmt") << "\n";
+			indentLvl++;
+			Visit(declStmt->GetDeclaration());
+			indentLvl--;
+		}
+		void AstPrinter::VisitExprStmt(ExprStmt* exprStmt) {
+			BeginNode("ExprStmt") << "\n";
+			PrintChildExpr(exprStmt->GetExpression());
+		}
+
+		// Expression visit methods
+		void AstPrinter::VisitInitListExpr(InitListExpr* initListExpr) {
+			BeginNode("InitListExpr") << "\n";
+			for (Expr* initExpr : initListExpr->GetInitExprs()) {
+				PrintChildExpr(initExpr);
+			}
+		}
+		void AstPrinter::VisitAssignExpr(AssignExpr* assignExpr) {
+			BeginNode("AssignExpr") << " " << assignExpr->GetAssignOp().lexeme << "\n";
+			PrintChildExpr(assignExpr->GetLvalue());
+			PrintChildExpr(assignExpr->GetRvalue());
+		}
+		void AstPrinter::VisitTernaryExpr(TernaryExpr* ternaryExpr) {
+			BeginNode("TernaryExpr") << "\n";
+			PrintChildExpr(ternaryExpr->GetCondition());
+			PrintChildExpr(ternaryExpr->GetTrueExpr());
+			PrintChildExpr(ternaryExpr->GetFalseExpr());
+		}
+		void AstPrinter::VisitBinaryExpr(BinaryExpr* binaryExpr) {
+			BeginNode("BinaryExpr") << " " << binaryExpr->GetOperator().lexeme << "\n";
+			PrintChildExpr(binaryExpr->GetLeftExpr());
+			PrintChildExpr(binaryExpr->GetRightExpr());
+		}
+		void AstPrinter::VisitUnaryExpr(UnaryExpr* unaryExpr) {
+			BeginNode("UnaryExpr") << " " << unaryExpr->GetOperator().lexeme << "\n";
+			PrintChildExpr(unaryExpr->GetExpr());
+		}
+		void AstPrinter::VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) {
+			BeginNode("FieldSelectExpr") << " ." << fieldSelectExpr->GetField().lexeme << "\n";
+			PrintChildExpr(fieldSelectExpr->GetTarget());
+		}
+		void AstPrinter::VisitFunCallExpr(FunCallExpr* funCallExpr) {
+			BeginNode("FunCallExpr") << "\n";
+			PrintChildExpr(funCallExpr->GetTarget());
+			for (Expr* arg : funCallExpr->GetArgs()) {
+				PrintChildExpr(arg);
+			}
+		}
+		void AstPrinter::VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) {
+			BeginNode("CtorCallExpr") << " " << MangleTypeSpecName(ctorCallExpr->GetType()) << "\n";
+			for (Expr* arg : ctorCallExpr->GetArgs()) {
+				PrintChildExpr(arg);
+			}
+		}
+		void AstPrinter::VisitVarExpr(VarExpr* varExpr) {
+			BeginNode("VarExpr") << " " << varExpr->GetVariable().lexeme << "\n";
+		}
+		void AstPrinter::VisitIntConstExpr(IntConstExpr* intConstExpr) {
+			BeginNode("IntConstExpr") << " " << intConstExpr->GetIntConst().lexeme << "\n";
+		}
+		void AstPrinter::VisitUintConstExpr(UintConstExpr* uintConstExpr) {
+			BeginNode("UintConstExpr") << " " << uintConstExpr->GetUintConst().lexeme << "\n";
+		}
+		void AstPrinter::VisitFloatConstExpr(FloatConstExpr* floatConstExpr) {
+			BeginNode("FloatConstExpr") << " " << floatConstExpr->GetFloatConst().lexeme << "\n";
+		}
+		void AstPrinter::VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) {
+			BeginNode("DoubleConstExpr") << " " << doubleConstExpr->GetDoubleConst().lexeme << "\n";
+		}
+		void AstPrinter::VisitGroupExpr(GroupExpr* groupExpr) {
+			BeginNode("GroupExpr") << "\n";
+			PrintChildExpr(groupExpr->GetExpr());
+		}
+
+		// Helper methods
+		std::ostream& AstPrinter::BeginNode(std::string_view nodeName) {
+			for (int i = 0; i < indentLvl; i++) {
+				out << "  ";
+			}
+			return out << nodeName;
+		}
+		void AstPrinter::PrintVarDecl(const VarDecl* varDecl) {
+			BeginNode("VarDecl") << " ";
+			// The variable's own array dimensions are merged into the type.
+			PrintType(out, varDecl->GetVarType().qualifier, varDecl->GetVarTypeSpec());
+			out << " " << varDecl->GetVarName().lexeme << "\n";
+			if (varDecl->HasInitializerExpr()) {
+				PrintChildExpr(varDecl->GetInitializerExpr());
+			}
+		}
+		void AstPrinter::PrintChildExpr(Expr* expr) {
+			indentLvl++;
+			Visit(expr);
+			indentLvl--;
+		}
+
+	}
+}
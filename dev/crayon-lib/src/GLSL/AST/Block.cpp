@@ -1,4 +1,6 @@
 #include "GLSL/AST/Block.h"
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/CompileStats.h"
 
 #include <algorithm>
 #include <cassert>
@@ -6,19 +8,27 @@
 namespace crayon {
 	namespace glsl {
 
-		ShaderProgramBlock::ShaderProgramBlock(const Token& programName)
-			:programName(programName) {
+		Block::Block(BlockKind kind)
+			: kind(kind) {
+			CountAstNode();
+		}
+		BlockKind Block::GetKind() const {
+			return kind;
+		}
+
+		ShaderProgramBlock::ShaderProgramBlock()
+			: Block(BlockKind::SHADER_PROGRAM) {
 		}
-		void ShaderProgramBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitShaderProgramBlock(this);
+		ShaderProgramBlock::ShaderProgramBlock(const Token& programName)
+			: Block(BlockKind::SHADER_PROGRAM), programName(programName) {
 		}
-		void ShaderProgramBlock::AddBlock(std::shared_ptr<Block> block) {
+		void ShaderProgramBlock::AddBlock(Block* block) {
 			blocks.push_back(block);
 		}
 		bool ShaderProgramBlock::BlockListEmpty() const {
 			return blocks.empty();
 		}
-		const std::vector<std::shared_ptr<Block>> ShaderProgramBlock::GetBlocks() {
+		const std::vector<Block*> ShaderProgramBlock::GetBlocks() {
 			return blocks;
 		}
 		bool ShaderProgramBlock::ShaderProgramNameEmpty() const {
@@ -31,8 +41,8 @@ namespace crayon {
 			return ExtractStringLiteral(programName);
 		}
 
-		void FixedStagesConfigBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitFixedStagesConfigBlock(this);
+		FixedStagesConfigBlock::FixedStagesConfigBlock()
+			: Block(BlockKind::FIXED_STAGES_CONFIG) {
 		}
 
 		VertexAttribDecl::VertexAttribDecl(const TypeSpec& typeSpec, const Token& name, const Token& channel)
@@ -72,16 +82,13 @@ namespace crayon {
 		}
 
 		MaterialPropertiesBlock::MaterialPropertiesBlock(const Token& name)
-			:name(name) {
-		}
-		void MaterialPropertiesBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitMaterialPropertiesBlock(this);
+			: Block(BlockKind::MATERIAL_PROPERTIES), name(name) {
 		}
 		const Token& MaterialPropertiesBlock::GetName() const {
 			return name;
 		}
 		bool MaterialPropertiesBlock::HasMatPropDecl(std::string_view matPropName) {
-			auto pred = [=](const std::shared_ptr<MatPropDecl>& matPropDecl) {
+			auto pred = [=](MatPropDecl* matPropDecl) {
 				return matPropName == matPropDecl->GetName().lexeme;
 			};
 			auto searchRes = std::find_if(matProps.begin(), matProps.end(), pred);
@@ -90,29 +97,29 @@ namespace crayon {
 			}
 			return true;
 		}
-		void MaterialPropertiesBlock::AddMatPropDecl(std::shared_ptr<MatPropDecl> matPropDecl) {
+		void MaterialPropertiesBlock::AddMatPropDecl(MatPropDecl* matPropDecl) {
 			matProps.push_back(matPropDecl);
 		}
-		std::shared_ptr<MatPropDecl> MaterialPropertiesBlock::GetMatPropDecl(std::string_view matPropName) const {
-			auto pred = [=](const std::shared_ptr<MatPropDecl>& matPropDecl) {
+		MatPropDecl* MaterialPropertiesBlock::GetMatPropDecl(std::string_view matPropName) const {
+			auto pred = [=](MatPropDecl* matPropDecl) {
 				return matPropName == matPropDecl->GetName().lexeme;
 			};
 			auto searchRes = std::find_if(matProps.begin(), matProps.end(), pred);
 			assert(searchRes != matProps.end() && "Check the existence of the material property declaration first!");
 			if (searchRes == matProps.end()) {
-				return std::shared_ptr<MatPropDecl>{};
+				return nullptr;
 			}
 			return *searchRes;
 		}
-		const std::vector<std::shared_ptr<MatPropDecl>>& MaterialPropertiesBlock::GetMatPropDecls() const {
+		const std::vector<MatPropDecl*>& MaterialPropertiesBlock::GetMatPropDecls() const {
 			return matProps;
 		}
 
-		void VertexInputLayoutBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitVertexInputLayoutBlock(this);
+		VertexInputLayoutBlock::VertexInputLayoutBlock()
+			: Block(BlockKind::VERTEX_INPUT_LAYOUT) {
 		}
 		bool VertexInputLayoutBlock::HasVertexAttribDecl(std::string_view vertexAttribName) {
-			auto pred = [=](const std::shared_ptr<VertexAttribDecl>& vertexAttribDecl) {
+			auto pred = [=](VertexAttribDecl* vertexAttribDecl) {
 				return vertexAttribName == vertexAttribDecl->GetName().lexeme;
 				};
 			auto searchRes = std::find_if(vertexAttribs.begin(), vertexAttribs.end(), pred);
@@ -121,29 +128,29 @@ namespace crayon {
 			}
 			return true;
 		}
-		void VertexInputLayoutBlock::AddVertexAttribDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) {
+		void VertexInputLayoutBlock::AddVertexAttribDecl(VertexAttribDecl* vertexAttribDecl) {
 			vertexAttribs.push_back(vertexAttribDecl);
 		}
-		std::shared_ptr<VertexAttribDecl> VertexInputLayoutBlock::GetVertexAttribDecl(std::string_view vertexAttribName) const {
-			auto pred = [=](const std::shared_ptr<VertexAttribDecl>& vertexAttribDecl) {
+		VertexAttribDecl* VertexInputLayoutBlock::GetVertexAttribDecl(std::string_view vertexAttribName) const {
+			auto pred = [=](VertexAttribDecl* vertexAttribDecl) {
 				return vertexAttribName == vertexAttribDecl->GetName().lexeme;
 			};
 			auto searchRes = std::find_if(vertexAttribs.begin(), vertexAttribs.end(), pred);
 			assert(searchRes != vertexAttribs.end() && "Check the existence of the vertex attribute declaration first!");
 			if (searchRes == vertexAttribs.end()) {
-				return std::shared_ptr<VertexAttribDecl>{};
+				return nullptr;
 			}
 			return *searchRes;
 		}
-		const std::vector<std::shared_ptr<VertexAttribDecl>>& VertexInputLayoutBlock::GetAttribDecls() const {
+		const std::vector<VertexAttribDecl*>& VertexInputLayoutBlock::GetAttribDecls() const {
 			return vertexAttribs;
 		}
 
-		void ColorAttachmentsBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitColorAttachmentsBlock(this);
+		ColorAttachmentsBlock::ColorAttachmentsBlock()
+			: Block(BlockKind::COLOR_ATTACHMENTS) {
 		}
 		bool ColorAttachmentsBlock::HasColorAttachmentDecl(std::string_view colorAttachmentName) {
-			auto pred = [=](const std::shared_ptr<ColorAttachmentDecl>& colorAttachmentDecl) {
+			auto pred = [=](ColorAttachmentDecl* colorAttachmentDecl) {
 				return colorAttachmentName == colorAttachmentDecl->GetName().lexeme;
 			};
 			auto searchRes = std::find_if(colorAttachments.begin(), colorAttachments.end(), pred);
@@ -152,31 +159,28 @@ namespace crayon {
 			}
 			return true;
 		}
-		void ColorAttachmentsBlock::AddColorAttachmentDecl(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl) {
+		void ColorAttachmentsBlock::AddColorAttachmentDecl(ColorAttachmentDecl* colorAttachmentDecl) {
 			colorAttachments.push_back(colorAttachmentDecl);
 		}
-		std::shared_ptr<ColorAttachmentDecl> ColorAttachmentsBlock::GetColorAttachmentDecl(std::string_view colorAttachmentName) const {
-			auto pred = [=](const std::shared_ptr<ColorAttachmentDecl>& colorAttachmentDecl) {
+		ColorAttachmentDecl* ColorAttachmentsBlock::GetColorAttachmentDecl(std::string_view colorAttachmentName) const {
+			auto pred = [=](ColorAttachmentDecl* colorAttachmentDecl) {
 				return colorAttachmentName == colorAttachmentDecl->GetName().lexeme;
 			};
 			auto searchRes = std::find_if(colorAttachments.begin(), colorAttachments.end(), pred);
 			assert(searchRes != colorAttachments.end() && "Check the existence of the color attachment declaration first!");
 			if (searchRes == colorAttachments.end()) {
-				return std::shared_ptr<ColorAttachmentDecl>{};
+				return nullptr;
 			}
 			return *searchRes;
 		}
-		const std::vector<std::shared_ptr<ColorAttachmentDecl>>& ColorAttachmentsBlock::GetColorAttachments() const {
+		const std::vector<ColorAttachmentDecl*>& ColorAttachmentsBlock::GetColorAttachments() const {
 			return colorAttachments;
 		}
 
-		ShaderBlock::ShaderBlock(std::shared_ptr<TransUnit> transUnit, ShaderType shaderType)
-			: transUnit(transUnit), shaderType(shaderType) {
+		ShaderBlock::ShaderBlock(TransUnit* transUnit, ShaderType shaderType)
+			: Block(BlockKind::SHADER), transUnit(transUnit), shaderType(shaderType) {
 		}
-		void ShaderBlock::Accept(BlockVisitor* blockVisitor) {
-			blockVisitor->VisitShaderBlock(this);
-		}
-		std::shared_ptr<TransUnit> ShaderBlock::GetTranslationUnit() const {
+		TransUnit* ShaderBlock::GetTranslationUnit() const {
 			return transUnit;
 		}
 		ShaderType ShaderBlock::GetShaderType() const {
@@ -186,8 +190,8 @@ namespace crayon {
 		VertexInputLayoutDesc GenerateVertexInputLayoutDesc(VertexInputLayoutBlock* vertexInputLayoutBlock) {
 			VertexInputLayoutDesc vertexInputLayout{};
 			uint32_t offset{0};
-			for (const std::shared_ptr<VertexAttribDecl>& vertexAttribDecl : vertexInputLayoutBlock->GetAttribDecls()) {
-				VertexAttribDesc vertexAttrib = GenerateVertexAttribDesc(vertexAttribDecl.get(), offset);
+			for (VertexAttribDecl* vertexAttribDecl : vertexInputLayoutBlock->GetAttribDecls()) {
+				VertexAttribDesc vertexAttrib = GenerateVertexAttribDesc(vertexAttribDecl, offset);
 				vertexInputLayout.AddVertexAttrib(vertexAttrib);
 				offset += vertexAttrib.GetVertexAttributeSize();
 			}
@@ -209,8 +213,8 @@ namespace crayon {
 
 		ColorAttachments GenerateColorAttachments(ColorAttachmentsBlock* colorAttachmentsBlock) {
 			ColorAttachments colorAttachments{};
-			for (const std::shared_ptr<ColorAttachmentDecl>& colorAttachment : colorAttachmentsBlock->GetColorAttachments()) {
-				ColorAttachmentDesc colorAttachmentDesc = GenerateColorAttachmentDesc(colorAttachment.get());
+			for (ColorAttachmentDecl* colorAttachment : colorAttachmentsBlock->GetColorAttachments()) {
+				ColorAttachmentDesc colorAttachmentDesc = GenerateColorAttachmentDesc(colorAttachment);
 				colorAttachments.AddColorAttachment(colorAttachmentDesc);
 			}
 			return colorAttachments;
@@ -227,14 +231,14 @@ namespace crayon {
 			return colorAttachmentDesc;
 		}
 
-		std::vector<std::shared_ptr<VarDecl>> CreateVertexAttribDecls(const VertexInputLayoutDesc& vertexInputLayout) {
-			std::vector<std::shared_ptr<VarDecl>> vertexAttribs(vertexInputLayout.GetVertexAttribCount());
+		std::vector<VarDecl*> CreateVertexAttribDecls(AstArena& astArena, const VertexInputLayoutDesc& vertexInputLayout) {
+			std::vector<VarDecl*> vertexAttribs(vertexInputLayout.GetVertexAttribCount());
 			for (size_t i = 0; i < vertexInputLayout.GetVertexAttribCount(); i++) {
-				vertexAttribs[i] = CreateVertexAttribDecl(vertexInputLayout.attributes[i]);
+				vertexAttribs[i] = CreateVertexAttribDecl(astArena, vertexInputLayout.attributes[i]);
 			}
 			return vertexAttribs;
 		}
-		std::shared_ptr<VarDecl> CreateVertexAttribDecl(const VertexAttribDesc& vertexAttrib) {
+		VarDecl* CreateVertexAttribDecl(AstArena& astArena, const VertexAttribDesc& vertexAttrib) {
 			Token inTok{};
 			inTok.tokenType = TokenType::IN;
 			inTok.lexeme = TokenTypeToLexeme(inTok.tokenType);
@@ -273,10 +277,10 @@ namespace crayon {
 			varName.tokenType = TokenType::IDENTIFIER;
 			varName.lexeme = vertexAttrib.name;
 
-			std::shared_ptr<VarDecl> attribVarDecl = std::make_shared<VarDecl>(varType, varName);
+			VarDecl* attribVarDecl = astArena.New<VarDecl>(varType, varName);
 			return attribVarDecl;
 		}
-		std::shared_ptr<InterfaceBlockDecl> CreateUniformInterfaceBlockDecl(const MaterialProps& matProps) {
+		InterfaceBlockDecl* CreateUniformInterfaceBlockDecl(AstArena& astArena, const MaterialProps& matProps) {
 			Token uniformTok{};
 			uniformTok.tokenType = TokenType::UNIFORM;
 			uniformTok.lexeme = TokenTypeToLexeme(uniformTok.tokenType);
@@ -287,15 +291,15 @@ namespace crayon {
 			interfaceBlockNameTok.tokenType = TokenType::IDENTIFIER;
 			interfaceBlockNameTok.lexeme = matProps.name;
 
-			std::shared_ptr<InterfaceBlockDecl> uniformInterfaceBlock =
-				std::make_shared<InterfaceBlockDecl>(interfaceBlockNameTok, uniformQual);
+			InterfaceBlockDecl* uniformInterfaceBlock =
+				astArena.New<InterfaceBlockDecl>(interfaceBlockNameTok, uniformQual);
 
 			for (size_t i = 0; i < matProps.GetMatPropCount(); i++) {
-				uniformInterfaceBlock->AddField(CreateInterfaceBlockVarDecl(matProps.matProps[i]));
+				uniformInterfaceBlock->AddField(CreateInterfaceBlockVarDecl(astArena, matProps.matProps[i]));
 			}
 			return uniformInterfaceBlock;
 		}
-		std::shared_ptr<VarDecl> CreateInterfaceBlockVarDecl(const MaterialPropDesc& matProp) {
+		VarDecl* CreateInterfaceBlockVarDecl(AstArena& astArena, const MaterialPropDesc& matProp) {
 			Token typeTok{};
 			typeTok.tokenType = MaterialPropertyTypeToTokenType(matProp.type);
 			typeTok.lexeme = TokenTypeToLexeme(typeTok.tokenType);
@@ -307,20 +311,20 @@ namespace crayon {
 			varName.tokenType = TokenType::IDENTIFIER;
 			varName.lexeme = matProp.name;
 
-			std::shared_ptr<VarDecl> attribVarDecl = std::make_shared<VarDecl>(varType, varName);
+			VarDecl* attribVarDecl = astArena.New<VarDecl>(varType, varName);
 			return attribVarDecl;
 		}
 
-		std::vector<std::shared_ptr<VarDecl>> CreateVertexAttribVarDecls(std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout) {
-			const std::vector<std::shared_ptr<VertexAttribDecl>> attribs = vertexInputLayout->GetAttribDecls();
+		std::vector<VarDecl*> CreateVertexAttribVarDecls(AstArena& astArena, VertexInputLayoutBlock* vertexInputLayout) {
+			const std::vector<VertexAttribDecl*> attribs = vertexInputLayout->GetAttribDecls();
 			size_t vertexAttribCount = attribs.size();
-			std::vector<std::shared_ptr<VarDecl>> vertexAttribs(vertexAttribCount);
+			std::vector<VarDecl*> vertexAttribs(vertexAttribCount);
 			for (size_t i = 0; i < vertexAttribCount; i++) {
-				vertexAttribs[i] = CreateVertexAttribVarDecl(attribs[i]);
+				vertexAttribs[i] = CreateVertexAttribVarDecl(astArena, attribs[i]);
 			}
 			return vertexAttribs;
 		}
-		std::shared_ptr<VarDecl> CreateVertexAttribVarDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) {
+		VarDecl* CreateVertexAttribVarDecl(AstArena& astArena, VertexAttribDecl* vertexAttribDecl) {
 			Token inTok{};
 			inTok.tokenType = TokenType::IN;
 			inTok.lexeme = TokenTypeToLexeme(inTok.tokenType);
@@ -363,10 +367,10 @@ namespace crayon {
 			varName.tokenType = TokenType::IDENTIFIER;
 			varName.lexeme = nameTok.lexeme;
 
-			std::shared_ptr<VarDecl> attribVarDecl = std::make_shared<VarDecl>(varType, varName);
+			VarDecl* attribVarDecl = astArena.New<VarDecl>(varType, varName);
 			return attribVarDecl;
 		}
-		std::shared_ptr<InterfaceBlockDecl> CreateInterfaceBlockDecl(std::shared_ptr<MaterialPropertiesBlock> matPropBlock) {
+		InterfaceBlockDecl* CreateInterfaceBlockDecl(AstArena& astArena, MaterialPropertiesBlock* matPropBlock) {
 			Token uniformTok{};
 			uniformTok.tokenType = TokenType::UNIFORM;
 			uniformTok.lexeme = TokenTypeToLexeme(uniformTok.tokenType);
@@ -377,15 +381,15 @@ namespace crayon {
 			interfaceBlockNameTok.tokenType = TokenType::IDENTIFIER;
 			interfaceBlockNameTok.lexeme = matPropBlock->GetName().lexeme;
 
-			std::shared_ptr<InterfaceBlockDecl> uniformInterfaceBlock =
-				std::make_shared<InterfaceBlockDecl>(interfaceBlockNameTok, uniformQual);
+			InterfaceBlockDecl* uniformInterfaceBlock =
+				astArena.New<InterfaceBlockDecl>(interfaceBlockNameTok, uniformQual);
 
-			for (const std::shared_ptr<MatPropDecl>& matPropDecl : matPropBlock->GetMatPropDecls()) {
-				uniformInterfaceBlock->AddField(CreateInterfaceBlockVarDecl(matPropDecl));
+			for (MatPropDecl* matPropDecl : matPropBlock->GetMatPropDecls()) {
+				uniformInterfaceBlock->AddField(CreateInterfaceBlockVarDecl(astArena, matPropDecl));
 			}
 			return uniformInterfaceBlock;
 		}
-		std::shared_ptr<VarDecl> CreateInterfaceBlockVarDecl(std::shared_ptr<MatPropDecl> matPropDecl) {
+		VarDecl* CreateInterfaceBlockVarDecl(AstArena& astArena, MatPropDecl* matPropDecl) {
 			Token typeTok{};
 			typeTok.tokenType = MapMaterialPropertyType(matPropDecl->GetType().tokenType);
 			typeTok.lexeme = TokenTypeToLexeme(typeTok.tokenType);
@@ -397,38 +401,23 @@ namespace crayon {
 			varName.tokenType = TokenType::IDENTIFIER;
 			varName.lexeme = matPropDecl->GetName().lexeme;
 
-			std::shared_ptr<VarDecl> attribVarDecl = std::make_shared<VarDecl>(varType, varName);
+			VarDecl* attribVarDecl = astArena.New<VarDecl>(varType, varName);
 			return attribVarDecl;
 		}
 
-		std::vector<std::shared_ptr<VarDecl>> CreateColorAttachmentVarDecls(std::shared_ptr<ColorAttachmentsBlock> colorAttachments) {
-			const std::vector<std::shared_ptr<ColorAttachmentDecl>> colorAttachmentDescs = colorAttachments->GetColorAttachments();
-			std::vector<std::shared_ptr<VarDecl>> varDecls(colorAttachmentDescs.size());
-			size_t i{0};
-			for (const std::shared_ptr<ColorAttachmentDecl> colorAttachment : colorAttachmentDescs) {
-				const TypeSpec& typeSpec = colorAttachment->GetTypeSpec();
-				const Token& name = colorAttachment->GetName();
-				const Token& channel = colorAttachment->GetChannel();
-				
-				ColorAttachmentDesc colorAttachmentDesc{};
-				colorAttachmentDesc.name = name.lexeme;
-				colorAttachmentDesc.channel = IdentifierTokenToColorAttachmentChannel(channel);
-				colorAttachmentDesc.type = TokenTypeToColorAttachmentType(typeSpec.type.tokenType);
-
-				varDecls[i] = CreateColorAttachmentVarDecl(colorAttachmentDesc);
-			}
-			return varDecls;
-		}
-		std::vector<std::shared_ptr<VarDecl>> CreateColorAttachmentVarDecls(const ColorAttachments& colorAttachments) {
-			size_t colorAttachmentCount = colorAttachments.GetColorAttachmentCount();
-			std::vector<std::shared_ptr<VarDecl>> attachments(colorAttachmentCount);
-			std::vector<ColorAttachmentDesc> colorAttachmentDescs = colorAttachments.GetColorAttachments();
-			for (size_t i = 0; i < colorAttachmentCount; i++) {
-				attachments[i] = CreateColorAttachmentVarDecl(colorAttachmentDescs[i]);
+		std::vector<VarDecl*> CreateColorAttachmentVarDecls(AstArena& astArena, const ColorAttachments& colorAttachments) {
+			// The variable names refer to the descriptions' strings,
+			// so we must use the descriptions stored in 'colorAttachments' and not their copies.
+			std::vector<VarDecl*> attachments;
+			attachments.reserve(colorAttachments.GetColorAttachmentCount());
+			for (const ColorAttachmentDesc& colorAttachmentDesc : colorAttachments.attachments) {
+				if (colorAttachmentDesc.channel != ColorAttachmentChannel::UNDEFINED) {
+					attachments.push_back(CreateColorAttachmentVarDecl(astArena, colorAttachmentDesc));
+				}
 			}
 			return attachments;
 		}
-		std::shared_ptr<VarDecl> CreateColorAttachmentVarDecl(const ColorAttachmentDesc& colorAttachmentDesc) {
+		VarDecl* CreateColorAttachmentVarDecl(AstArena& astArena, const ColorAttachmentDesc& colorAttachmentDesc) {
 			Token outTok{};
 			outTok.tokenType = TokenType::OUT;
 			outTok.lexeme = TokenTypeToLexeme(outTok.tokenType);
@@ -456,7 +445,7 @@ namespace crayon {
 			varName.tokenType = TokenType::IDENTIFIER;
 			varName.lexeme = colorAttachmentDesc.name;
 
-			std::shared_ptr<VarDecl> attribVarDecl = std::make_shared<VarDecl>(varType, varName);
+			VarDecl* attribVarDecl = astArena.New<VarDecl>(varType, varName);
 			return attribVarDecl;
 		}
 
@@ -1,4 +1,6 @@
 #include "GLSL/AST/Decl.h"
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/CompileStats.h"
 
 #include <algorithm>
 #include <cassert>
@@ -6,6 +8,14 @@
 namespace crayon {
     namespace glsl {
 
+		Decl::Decl(DeclKind kind)
+			: kind(kind) {
+			CountAstNode();
+		}
+		DeclKind Decl::GetKind() const {
+			return kind;
+		}
+
 		NamedEntity::NamedEntity(const Token& name)
 			: name(name) {
 		}
@@ -17,41 +27,41 @@ namespace crayon {
 			return name;
 		}
 
-		void AggregateEntity::AddField(std::shared_ptr<VarDecl> fieldDecl) {
+		void AggregateEntity::AddField(VarDecl* fieldDecl) {
 			fields.push_back(fieldDecl);
 		}
 		bool AggregateEntity::HasField(std::string_view fieldName) const {
-			auto predicate = [=](const std::shared_ptr<VarDecl>& field) {
+			auto predicate = [=](VarDecl* field) {
 				return fieldName == field->GetVarName().lexeme;
 			};
 			auto searchRes = std::find_if(fields.begin(), fields.end(), predicate);
 			return searchRes != fields.end();
 		}
-		std::shared_ptr<VarDecl> AggregateEntity::GetField(std::string_view fieldName) {
-			auto predicate = [=](const std::shared_ptr<VarDecl>& field) {
+		VarDecl* AggregateEntity::GetField(std::string_view fieldName) {
+			auto predicate = [=](VarDecl* field) {
 				return fieldName == field->GetVarName().lexeme;
 			};
 			auto searchRes = std::find_if(fields.begin(), fields.end(), predicate);
 			assert(searchRes != fields.end() && "Check the existence of the field first!");
 			return *searchRes;
 		}
-		std::shared_ptr<VarDecl> AggregateEntity::GetField(std::string_view fieldName, size_t& fieldIdx) {
+		VarDecl* AggregateEntity::GetField(std::string_view fieldName, size_t& fieldIdx) {
 			for (size_t i = 0; i < fields.size(); i++) {
 				if (fields[i]->GetVarName().lexeme == fieldName) {
 					fieldIdx = i;
 					return fields[i];
 				}
 			}
-			return std::shared_ptr<VarDecl>();
+			return nullptr;
 		}
 		size_t AggregateEntity::GetFieldCount() const {
 			return fields.size();
 		}
-		const std::vector<std::shared_ptr<VarDecl>>& AggregateEntity::GetFields() const {
+		const std::vector<VarDecl*>& AggregateEntity::GetFields() const {
 			return fields;
 		}
 
-		void ArrayEntity::AddDimension(std::shared_ptr<Expr> dimExpr) {
+		void ArrayEntity::AddDimension(Expr* dimExpr) {
 			this->dimensions.push_back(dimExpr);
 		}
 		size_t ArrayEntity::GetDimensionCount() const {
@@ -60,31 +70,31 @@ namespace crayon {
 		bool ArrayEntity::IsArray() const {
 			return GetDimensionCount() > 0;
 		}
-		const std::vector<std::shared_ptr<Expr>>& ArrayEntity::GetDimensions() const {
+		const std::vector<Expr*>& ArrayEntity::GetDimensions() const {
 			return dimensions;
 		}
 
-        void TransUnit::AddDeclaration(std::shared_ptr<Decl> decl) {
-			decls.push_back(decl);
+		TransUnit::TransUnit()
+			: Decl(DeclKind::TRANS_UNIT) {
 		}
-		void TransUnit::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitTransUnit(this);
+        void TransUnit::AddDeclaration(Decl* decl) {
+			decls.push_back(decl);
 		}
-		const std::vector<std::shared_ptr<Decl>>& TransUnit::GetDeclarations() {
+		const std::vector<Decl*>& TransUnit::GetDeclarations() {
 			return decls;
 		}
 
+		InterfaceBlockDecl::InterfaceBlockDecl()
+			: Decl(DeclKind::INTERFACE_BLOCK) {
+		}
 		InterfaceBlockDecl::InterfaceBlockDecl(const Token& name)
-			: NamedEntity(name) {
+			: Decl(DeclKind::INTERFACE_BLOCK), NamedEntity(name) {
 		}
 		InterfaceBlockDecl::InterfaceBlockDecl(const Token& name, const TypeQual& typeQual)
-			: NamedEntity(name), typeQual(typeQual) {
+			: Decl(DeclKind::INTERFACE_BLOCK), NamedEntity(name), typeQual(typeQual) {
 		}
 		InterfaceBlockDecl::InterfaceBlockDecl(const Token& name, const TypeQual& typeQual, const Token& instanceName)
-			: NamedEntity(name), typeQual(typeQual), instanceName(instanceName) {
-		}
-		void InterfaceBlockDecl::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitInterfaceBlockDecl(this);
+			: Decl(DeclKind::INTERFACE_BLOCK), NamedEntity(name), typeQual(typeQual), instanceName(instanceName) {
 		}
 		const TypeQual& InterfaceBlockDecl::GetTypeQualifier() const {
 			return typeQual;
@@ -99,36 +109,33 @@ namespace crayon {
 		}
 
 		DeclList::DeclList(const FullSpecType& fullSpecType)
-			: fullSpecType(fullSpecType) {
-		}
-		void DeclList::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitDeclList(this);
+			: Decl(DeclKind::DECL_LIST), fullSpecType(fullSpecType) {
 		}
-		void DeclList::AddDecl(std::shared_ptr<VarDecl> decl) {
+		void DeclList::AddDecl(VarDecl* decl) {
 			decls.push_back(decl);
 		}
-		const std::vector<std::shared_ptr<VarDecl>>& DeclList::GetDecls() const {
+		const std::vector<VarDecl*>& DeclList::GetDecls() const {
 			return decls;
 		}
 		const FullSpecType& DeclList::GetFullSpecType() const {
 			return fullSpecType;
 		}
 
-		StructDecl::StructDecl(const Token& structName)
-			: NamedEntity(structName) {
+		StructDecl::StructDecl()
+			: Decl(DeclKind::STRUCT) {
 		}
-		void StructDecl::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitStructDecl(this);
+		StructDecl::StructDecl(const Token& structName)
+			: Decl(DeclKind::STRUCT), NamedEntity(structName) {
 		}
 		bool StructDecl::IsStructDeclAnonymous() const {
 			return !HasName();
 		}
 
         VarDecl::VarDecl(const FullSpecType& varType, const Token& varName)
-			: varType(varType), varName(varName) {
+			: Decl(DeclKind::VAR), varType(varType), varName(varName) {
 		}
-		void VarDecl::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitVarDecl(this);
+		VarDecl::VarDecl(DeclKind kind, const FullSpecType& varType, const Token& varName)
+			: Decl(kind), varType(varType), varName(varName) {
 		}
 		bool VarDecl::IsVarTypeBasic() const {
 			return varType.specifier.IsBasic();
@@ -161,10 +168,10 @@ namespace crayon {
 			if (initExpr) return true;
 			else return false;
 		}
-		void VarDecl::SetInitializerExpr(std::shared_ptr<Expr> initExpr) {
+		void VarDecl::SetInitializerExpr(Expr* initExpr) {
 			this->initExpr = initExpr;
 		}
-		std::shared_ptr<Expr> VarDecl::GetInitializerExpr() const {
+		Expr* VarDecl::GetInitializerExpr() const {
 			return initExpr;
 		}
 		TypeSpec VarDecl::GetVarTypeSpec() const {
@@ -196,10 +203,10 @@ namespace crayon {
 		}
 
         FunParam::FunParam(const FullSpecType& paramType)
-			: VarDecl(paramType, Token{}) {
+			: VarDecl(DeclKind::FUN_PARAM, paramType, Token{}) {
 		}
 		FunParam::FunParam(const FullSpecType& paramType, const Token& paramName)
-			: VarDecl(paramType, paramName) {
+			: VarDecl(DeclKind::FUN_PARAM, paramType, paramName) {
 		}
 		bool FunParam::HasName() const {
 			return GetVarName().tokenType == TokenType::IDENTIFIER;
@@ -214,24 +221,21 @@ namespace crayon {
 		const Token& FunProto::GetFunctionName() const {
 			return funName;
 		}
-		void FunProto::AddFunParam(std::shared_ptr<FunParam> funParam) {
+		void FunProto::AddFunParam(FunParam* funParam) {
 			params.push_back(funParam);
 		}
 		bool FunProto::FunParamListEmpty() const {
 			return params.size() == 0;
 		}
-		const std::vector<std::shared_ptr<FunParam>>& FunProto::GetFunParamList() const {
+		const std::vector<FunParam*>& FunProto::GetFunParamList() const {
 			return params;
 		}
 
-		FunDecl::FunDecl(std::shared_ptr<FunProto> funProto)
-			: funProto(funProto) {
-		}
-		FunDecl::FunDecl(std::shared_ptr<FunProto> funProto, std::shared_ptr<BlockStmt> stmts)
-			: funProto(funProto), stmts(stmts) {
+		FunDecl::FunDecl(FunProto* funProto)
+			: Decl(DeclKind::FUN), funProto(funProto) {
 		}
-        void FunDecl::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitFunDecl(this);
+		FunDecl::FunDecl(FunProto* funProto, BlockStmt* stmts)
+			: Decl(DeclKind::FUN), funProto(funProto), stmts(stmts) {
 		}
 		bool FunDecl::IsFunDecl() const {
 			if (stmts) return false;
@@ -240,18 +244,15 @@ namespace crayon {
         bool FunDecl::IsFunDef() const {
 			return !IsFunDecl();
 		}
-		std::shared_ptr<FunProto> FunDecl::GetFunProto() const {
+		FunProto* FunDecl::GetFunProto() const {
 			return funProto;
 		}
-		std::shared_ptr<BlockStmt> FunDecl::GetBlockStmt() const {
+		BlockStmt* FunDecl::GetBlockStmt() const {
 			return stmts;
 		}
 
         QualDecl::QualDecl(const TypeQual& qualifier)
-			: qualifier(qualifier) {
-		}
-		void QualDecl::Accept(DeclVisitor* declVisitor) {
-			declVisitor->VisitQualDecl(this);
+			: Decl(DeclKind::QUAL), qualifier(qualifier) {
 		}
 		const TypeQual& QualDecl::GetTypeQualifier() const {
 			return qualifier;
@@ -263,10 +264,10 @@ namespace crayon {
 		static constexpr std::string_view glCullDistance_varName{"gl_CullDistance"};
 		static constexpr std::string_view glPerVertex_intBlockName{"gl_PerVertex"};
 
-		std::shared_ptr<InterfaceBlockDecl> CreatePerVertexIntBlockDecl() {
-			std::vector<std::shared_ptr<VarDecl>> perVertexFields(4);
-			perVertexFields[0] = CreateNonArrayTypeNonArrayVarDecl(TokenType::VEC4, glPosition_varName);
-			perVertexFields[1] = CreateNonArrayTypeNonArrayVarDecl(TokenType::FLOAT, glPointSize_varName);
+		InterfaceBlockDecl* CreatePerVertexIntBlockDecl(AstArena& astArena) {
+			std::vector<VarDecl*> perVertexFields(4);
+			perVertexFields[0] = CreateNonArrayTypeNonArrayVarDecl(astArena, TokenType::VEC4, glPosition_varName);
+			perVertexFields[1] = CreateNonArrayTypeNonArrayVarDecl(astArena, TokenType::FLOAT, glPointSize_varName);
 
 			// Dimensions of the gl_ClipDistance and gl_CullDistance variables vary per user's request/choice.
 			// In case we don't access the varriables at all,
@@ -274,17 +275,17 @@ namespace crayon {
 			std::vector<ArrayDim> dimensions(1);
 			dimensions[0].dimSize = 1;
 
-			perVertexFields[2] = CreateNonArrayTypeArrayVarDecl(TokenType::FLOAT, glClipDistance_varName, dimensions);
-			perVertexFields[3] = CreateNonArrayTypeArrayVarDecl(TokenType::FLOAT, glCullDistance_varName, dimensions);
+			perVertexFields[2] = CreateNonArrayTypeArrayVarDecl(astArena, TokenType::FLOAT, glClipDistance_varName, dimensions);
+			perVertexFields[3] = CreateNonArrayTypeArrayVarDecl(astArena, TokenType::FLOAT, glCullDistance_varName, dimensions);
 
-			std::shared_ptr<InterfaceBlockDecl> glPerVertex = CreateInterfaceBlockDecl(TokenType::OUT,
-					                                                                   glPerVertex_intBlockName,
-					                                                                   perVertexFields);
+			InterfaceBlockDecl* glPerVertex = CreateInterfaceBlockDecl(astArena, TokenType::OUT,
+			                                                           glPerVertex_intBlockName,
+			                                                           perVertexFields);
 			return glPerVertex;
 		}
-		std::shared_ptr<InterfaceBlockDecl> CreateInterfaceBlockDecl(TokenType storageQual, std::string_view interfaceName,
-			                                                         std::vector<std::shared_ptr<VarDecl>> fieldDecls,
-			                                                         std::string_view instanceName) {
+		InterfaceBlockDecl* CreateInterfaceBlockDecl(AstArena& astArena, TokenType storageQual, std::string_view interfaceName,
+		                                             std::vector<VarDecl*> fieldDecls,
+		                                             std::string_view instanceName) {
 			Token storageQualTok{};
 			storageQualTok.tokenType = storageQual;
 			storageQualTok.lexeme = TokenTypeToLexeme(storageQualTok.tokenType);
@@ -296,25 +297,25 @@ namespace crayon {
 			intNameTok.tokenType = TokenType::IDENTIFIER;
 			intNameTok.lexeme = interfaceName;
 
-			std::shared_ptr<InterfaceBlockDecl> intBlock;
+			InterfaceBlockDecl* intBlock{nullptr};
 			if (!instanceName.empty()) {
 				Token instanceNameTok{};
 				instanceNameTok.tokenType = TokenType::IDENTIFIER;
 				instanceNameTok.lexeme = instanceName;
 
-				intBlock = std::make_shared<InterfaceBlockDecl>(intNameTok, typeQual, instanceNameTok);
+				intBlock = astArena.New<InterfaceBlockDecl>(intNameTok, typeQual, instanceNameTok);
 			} else {
-				intBlock = std::make_shared<InterfaceBlockDecl>(intNameTok, typeQual);
+				intBlock = astArena.New<InterfaceBlockDecl>(intNameTok, typeQual);
 			}
 
-			for (const std::shared_ptr<VarDecl>& fieldDecl : fieldDecls) {
+			for (VarDecl* fieldDecl : fieldDecls) {
 				intBlock->AddField(fieldDecl);
 			}
 
 			return intBlock;
 		}
 
-		std::shared_ptr<VarDecl> CreateNonArrayTypeNonArrayVarDecl(TokenType varType, std::string_view varName) {
+		VarDecl* CreateNonArrayTypeNonArrayVarDecl(AstArena& astArena, TokenType varType, std::string_view varName) {
 			Token typeTok{};
 			typeTok.tokenType = varType;
 			typeTok.lexeme = TokenTypeToLexeme(typeTok.tokenType);
@@ -326,12 +327,12 @@ namespace crayon {
 			varNameTok.tokenType = TokenType::IDENTIFIER;
 			varNameTok.lexeme = varName;
 
-			std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, varNameTok);
+			VarDecl* varDecl = astArena.New<VarDecl>(fullSpecType, varNameTok);
 			return varDecl;
 		}
-		std::shared_ptr<VarDecl> CreateNonArrayTypeNonArrayVarDecl(TokenType storageQual,
-			                                                       TokenType varType,
-			                                                       std::string_view varName) {
+		VarDecl* CreateNonArrayTypeNonArrayVarDecl(AstArena& astArena, TokenType storageQual,
+		                                           TokenType varType,
+		                                           std::string_view varName) {
 			Token storageQualTok{};
 			storageQualTok.tokenType = storageQual;
 			storageQualTok.lexeme = TokenTypeToLexeme(storageQualTok.tokenType);
@@ -348,13 +349,13 @@ namespace crayon {
 			varNameTok.tokenType = TokenType::IDENTIFIER;
 			varNameTok.lexeme = varName;
 
-			std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, varNameTok);
+			VarDecl* varDecl = astArena.New<VarDecl>(fullSpecType, varNameTok);
 			return varDecl;
 		}
 
-		std::shared_ptr<VarDecl> CreateNonArrayTypeArrayVarDecl(TokenType storageQual, TokenType varType,
-			                                                    std::string_view varName,
-			                                                    std::vector<ArrayDim> dimensions) {
+		VarDecl* CreateNonArrayTypeArrayVarDecl(AstArena& astArena, TokenType storageQual, TokenType varType,
+		                                        std::string_view varName,
+		                                        std::vector<ArrayDim> dimensions) {
 			Token storageQualTok{};
 			storageQualTok.tokenType = storageQual;
 			storageQualTok.lexeme = TokenTypeToLexeme(storageQualTok.tokenType);
@@ -371,15 +372,15 @@ namespace crayon {
 			varNameTok.tokenType = TokenType::IDENTIFIER;
 			varNameTok.lexeme = varName;
 
-			std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, varNameTok);
+			VarDecl* varDecl = astArena.New<VarDecl>(fullSpecType, varNameTok);
 			for (const ArrayDim& dimension : dimensions) {
 				varDecl->AddDimension(dimension);
 			}
 
 			return varDecl;
 		}
-		std::shared_ptr<VarDecl> CreateNonArrayTypeArrayVarDecl(TokenType varType, std::string_view varName,
-			                                                    std::vector<ArrayDim> dimensions) {
+		VarDecl* CreateNonArrayTypeArrayVarDecl(AstArena& astArena, TokenType varType, std::string_view varName,
+		                                        std::vector<ArrayDim> dimensions) {
 			Token typeTok{};
 			typeTok.tokenType = varType;
 			typeTok.lexeme = TokenTypeToLexeme(typeTok.tokenType);
@@ -391,7 +392,7 @@ namespace crayon {
 			varNameTok.tokenType = TokenType::IDENTIFIER;
 			varNameTok.lexeme = varName;
 
-			std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, varNameTok);
+			VarDecl* varDecl = astArena.New<VarDecl>(fullSpecType, varNameTok);
 			for (const ArrayDim& dimension : dimensions) {
 				varDecl->AddDimension(dimension);
 			}
@@ -1,102 +1,149 @@
 #include "GLSL/AST/Expr.h"
+#include "GLSL/AST/ExprVisitors.h"
+#include "GLSL/CompileStats.h"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
 #include <functional>
+#include <type_traits>
 
 namespace crayon {
 	namespace glsl {
 		
 		using ExprValue = ExprEvalVisitor::ExprValue;
-		using ExprFun = std::function<ExprValue(const ExprValue&, const ExprValue&, TokenType op)>;
+		// The computations return an error message, which is empty if the operation succeeded.
+		using ExprFun = std::function<std::string_view(const ExprValue&, const ExprValue&, TokenType op, ExprValue& result)>;
+
+		static constexpr std::string_view divisionByZeroMsg{"Division by zero in a constant expression!"};
+		static constexpr std::string_view shiftOutOfRangeMsg{"Shift out of range in a constant expression!"};
+		static constexpr std::string_view unknownBinaryOpMsg{"The binary operator can't be used in a constant expression!"};
+		static constexpr std::string_view ternaryConditionMsg{"The condition of a ternary expression must be a boolean!"};
 
 		template <typename T, typename U>
-		static ExprValue ComputeExpr(const ExprValue& a, const ExprValue& b, TokenType op) {
-			if (op == TokenType::PLUS) {
-				return ExprValue{std::get<T>(a) + std::get<U>(b)};
-			} else if (op == TokenType::DASH) {
-				return ExprValue{std::get<T>(a) - std::get<U>(b)};
-			} else if (op == TokenType::STAR) {
-				return ExprValue{std::get<T>(a) * std::get<U>(b)};
-			} else if (op == TokenType::SLASH) {
-				return ExprValue{std::get<T>(a) / std::get<U>(b)};
-			} else {
-				throw std::runtime_error{"Unknown binary operator!"};
-				return ExprValue{};
+		static std::string_view ComputeExpr(const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			// The operands are converted to a common type, like the implicit conversions of GLSL do.
+			using R = decltype(std::get<T>(a) + std::get<U>(b));
+			R x = static_cast<R>(std::get<T>(a));
+			R y = static_cast<R>(std::get<U>(b));
+			constexpr bool integers = std::is_integral_v<T> && std::is_integral_v<U>;
+			switch (op) {
+				case TokenType::PLUS: result = x + y; return {};
+				case TokenType::DASH: result = x - y; return {};
+				case TokenType::STAR: result = x * y; return {};
+				case TokenType::SLASH:
+					if (integers && y == 0) {
+						return divisionByZeroMsg;
+					}
+					result = x / y;
+					return {};
+				case TokenType::LEFT_ANGLE: result = x < y; return {};
+				case TokenType::RIGHT_ANGLE: result = x > y; return {};
+				case TokenType::LE_OP: result = x <= y; return {};
+				case TokenType::GE_OP: result = x >= y; return {};
+				case TokenType::EQ_OP: result = x == y; return {};
+				case TokenType::NE_OP: result = x != y; return {};
+				default: break;
+			}
+			if constexpr (integers) {
+				switch (op) {
+					case TokenType::PERCENT:
+						if (y == 0) {
+							return divisionByZeroMsg;
+						}
+						result = x % y;
+						return {};
+					case TokenType::AMPERSAND: result = x & y; return {};
+					case TokenType::CARET: result = x ^ y; return {};
+					case TokenType::VERTICAL_BAR: result = x | y; return {};
+					case TokenType::LEFT_OP:
+					case TokenType::RIGHT_OP: {
+						// The result is of the left operand's type, without converting the operands.
+						T value = std::get<T>(a);
+						long long shift = static_cast<long long>(std::get<U>(b));
+						if (shift < 0 || shift >= 32) {
+							return shiftOutOfRangeMsg;
+						}
+						if (op == TokenType::LEFT_OP) {
+							result = static_cast<T>(static_cast<unsigned int>(value) << shift);
+						} else {
+							result = static_cast<T>(value >> shift);
+						}
+						return {};
+					}
+					default: break;
+				}
+			}
+			return unknownBinaryOpMsg;
+		}
+		static std::string_view ComputeBoolExpr(bool x, bool y, TokenType op, ExprValue& result) {
+			switch (op) {
+				case TokenType::AND_OP: result = x && y; return {};
+				case TokenType::XOR_OP: result = x != y; return {};
+				case TokenType::OR_OP: result = x || y; return {};
+				case TokenType::EQ_OP: result = x == y; return {};
+				case TokenType::NE_OP: result = x != y; return {};
+				default: return unknownBinaryOpMsg;
 			}
 		}
 
-		static constexpr auto intInt = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<int, int>(a, b, op);
-			return result;
+		static constexpr auto intInt = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<int, int>(a, b, op, result);
+		};
+		static constexpr auto intUint = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<int, unsigned int>(a, b, op, result);
+		};
+		static constexpr auto intFloat = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<int, float>(a, b, op, result);
+		};
+		static constexpr auto intDouble = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<int, double>(a, b, op, result);
 		};
-		static constexpr auto intUint = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<int, unsigned int>(a, b, op);
-			return result;
-			};
-		static constexpr auto intFloat = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<int, float>(a, b, op);
-			return result;
-			};
-		static constexpr auto intDouble = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<int, double>(a, b, op);
-			return result;
-			};
 
-		static constexpr auto uintInt = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<unsigned int, int>(a, b, op);
-			return result;
+		static constexpr auto uintInt = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<unsigned int, int>(a, b, op, result);
+		};
+		static constexpr auto uintUint = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<unsigned int, unsigned int>(a, b, op, result);
+		};
+		static constexpr auto uintFloat = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<unsigned int, float>(a, b, op, result);
+		};
+		static constexpr auto uintDouble = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<unsigned int, double>(a, b, op, result);
 		};
-		static constexpr auto uintUint = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<unsigned int, unsigned int>(a, b, op);
-			return result;
-			};
-		static constexpr auto uintFloat = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<unsigned int, float>(a, b, op);
-			return result;
-			};
-		static constexpr auto uintDouble = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<unsigned int, double>(a, b, op);
-			return result;
-			};
 
-		static constexpr auto floatInt = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<float, int>(a, b, op);
-			return result;
+		static constexpr auto floatInt = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<float, int>(a, b, op, result);
 		};
-		static constexpr auto floatUint = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<float, unsigned int>(a, b, op);
-			return result;
+		static constexpr auto floatUint = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<float, unsigned int>(a, b, op, result);
+		};
+		static constexpr auto floatFloat = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<float, float>(a, b, op, result);
+		};
+		static constexpr auto floatDouble = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<float, double>(a, b, op, result);
 		};
-		static constexpr auto floatFloat = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<float, float>(a, b, op);
-			return result;
-			};
-		static constexpr auto floatDouble = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<float, double>(a, b, op);
-			return result;
-			};
 
-		static constexpr auto doubleInt = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<double, int>(a, b, op);
-			return result;
+		static constexpr auto doubleInt = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<double, int>(a, b, op, result);
 		};
-		static constexpr auto doubleUint = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<double, unsigned int>(a, b, op);
-			return result;
+		static constexpr auto doubleUint = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<double, unsigned int>(a, b, op, result);
 		};
-		static constexpr auto doubleFloat = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<double, float>(a, b, op);
-			return result;
+		static constexpr auto doubleFloat = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<double, float>(a, b, op, result);
 		};
-		static constexpr auto doubleDouble = [](const ExprValue& a, const ExprValue& b, TokenType op) {
-			ExprValue result = ComputeExpr<double, double>(a, b, op);
-			return result;
+		static constexpr auto doubleDouble = [](const ExprValue& a, const ExprValue& b, TokenType op, ExprValue& result) {
+			return ComputeExpr<double, double>(a, b, op, result);
 		};
 
-		static constexpr int intFundTypeOffset = 2;
-		static std::function<ExprValue(const ExprValue&, const ExprValue&, TokenType)> exprEvalFuns[4][4] = {
+		// The numeric alternatives of 'ExprValue' follow 'bool', in the order of the table.
+		static constexpr size_t intExprValueIndex = 1;
+		static ExprFun exprEvalFuns[4][4] = {
 			// INT,     UINT,       FLOAT,       DOUBLE
 			{intInt,    intUint,    intFloat,    intDouble   }, // INT, UINT, FLOAT, DOUBLE
 			{uintInt,   uintUint,   uintFloat,   uintDouble  }, // INT, UINT, FLOAT, DOUBLE
@@ -110,39 +157,77 @@ namespace crayon {
 		void ExprEvalVisitor::VisitAssignExpr(AssignExpr* assignExpr) {
 			// [TODO]: implement environments first!
 		}
+		void ExprEvalVisitor::VisitTernaryExpr(TernaryExpr* ternaryExpr) {
+			// Only the selected branch is evaluated.
+			Visit(ternaryExpr->GetCondition());
+			if (resultUndefined) return;
+			if (!ResultBool()) {
+				Fail(ternaryExpr->GetCondition(), ternaryConditionMsg);
+				return;
+			}
+			Visit(GetBoolResult() ? ternaryExpr->GetTrueExpr() : ternaryExpr->GetFalseExpr());
+		}
 		void ExprEvalVisitor::VisitBinaryExpr(BinaryExpr* binaryExpr) {
-			binaryExpr->GetLeftExpr()->Accept(this);
+			Visit(binaryExpr->GetLeftExpr());
+			if (resultUndefined) return;
 			ExprValue left = result;
-			binaryExpr->GetRightExpr()->Accept(this);
+			Visit(binaryExpr->GetRightExpr());
+			if (resultUndefined) return;
 			ExprValue right = result;
 
-			size_t leftTypeId = binaryExpr->GetLeftExpr()->GetExprTypeId();
-			size_t rightTypeId = binaryExpr->GetRightExpr()->GetExprTypeId();
-			const TypeSpec& leftType = envCtx.typeTable->GetType(leftTypeId);
-			const TypeSpec& rightType = envCtx.typeTable->GetType(rightTypeId);
-			int leftRank = GetFundamentalTypeRank(leftType.type.tokenType);
-			int rightRank = GetFundamentalTypeRank(rightType.type.tokenType);
-
-			const auto& exprEvalFun = exprEvalFuns[leftRank - intFundTypeOffset][rightRank - intFundTypeOffset];
-			result = exprEvalFun(left, right, binaryExpr->GetOperator().tokenType);
+			TokenType op = binaryExpr->GetOperator().tokenType;
+			std::string_view opErrMsg;
+			if (std::holds_alternative<bool>(left) || std::holds_alternative<bool>(right)) {
+				// Booleans aren't converted to anything.
+				if (!std::holds_alternative<bool>(left) || !std::holds_alternative<bool>(right)) {
+					Fail(binaryExpr, "Mismatched operand types in a constant expression!");
+					return;
+				}
+				opErrMsg = ComputeBoolExpr(std::get<bool>(left), std::get<bool>(right), op, result);
+			} else {
+				const auto& exprEvalFun = exprEvalFuns[left.index() - intExprValueIndex][right.index() - intExprValueIndex];
+				opErrMsg = exprEvalFun(left, right, op, result);
+			}
+			if (!opErrMsg.empty()) {
+				Fail(binaryExpr, opErrMsg);
+			}
 		}
 		void ExprEvalVisitor::VisitUnaryExpr(UnaryExpr* unaryExpr) {
-			// TODO
-			/*
-			unaryExpr->GetExpr()->Accept(this);
-			int exprRes = result;
-
-			switch (unaryExpr->GetOperator().tokenType) {
-				case TokenType::PLUS: {
-					result = +exprRes;
-				}
-				break;
-				case TokenType::DASH: {
-					result = -exprRes;
+			Visit(unaryExpr->GetExpr());
+			if (resultUndefined) return;
+			TokenType op = unaryExpr->GetOperator().tokenType;
+			bool computed = std::visit([this, op](auto value) {
+				using T = decltype(value);
+				if constexpr (std::is_same_v<T, bool>) {
+					if (op == TokenType::BANG) {
+						result = !value;
+						return true;
+					}
+				} else {
+					if (op == TokenType::PLUS) {
+						result = value;
+						return true;
+					} else if (op == TokenType::DASH) {
+						if constexpr (std::is_unsigned_v<T>) {
+							// Unsigned integers wrap around.
+							result = T{0} - value;
+						} else {
+							result = -value;
+						}
+						return true;
+					}
+					if constexpr (std::is_integral_v<T>) {
+						if (op == TokenType::TILDE) {
+							result = static_cast<T>(~value);
+							return true;
+						}
+					}
 				}
-				break;
+				return false;
+			}, result);
+			if (!computed) {
+				Fail(unaryExpr, "The unary operator can't be used in a constant expression!");
 			}
-			*/
 		}
 		void ExprEvalVisitor::VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) {
 			// TODO: implement environments first!
@@ -157,43 +242,23 @@ namespace crayon {
 			// TODO: implement environments first!
 		}
 		void ExprEvalVisitor::VisitIntConstExpr(IntConstExpr* intConstExpr) {
-			// 1.
-			// const Token& intConst = intConstExpr->GetIntConst();
-			// int value = static_cast<int>(std::strtol(intConst.lexeme.data(), nullptr, 10));
-			// result = value;
-			// 2.
 			ConstVal intVal = envCtx.constTable->GetConstVal(intConstExpr->GetConstId());
 			result = std::get<int>(intVal);
 		}
 		void ExprEvalVisitor::VisitUintConstExpr(UintConstExpr* uintConstExpr) {
-			// 1.
-			// const Token& uintConst = uintConstExpr->GetUintConst();
-			// unsigned int value = static_cast<unsigned int>(std::strtoul(uintConst.lexeme.data(), nullptr, 10));
-			// result = value;
-			// 2.
 			ConstVal uintVal = envCtx.constTable->GetConstVal(uintConstExpr->GetConstId());
 			result = std::get<unsigned int>(uintVal);
 		}
 		void ExprEvalVisitor::VisitFloatConstExpr(FloatConstExpr* floatConstExpr) {
-			// 1.
-			// const Token& floatConst = floatConstExpr->GetFloatConst();
-			// float value = std::strtof(floatConst.lexeme.data(), nullptr);
-			// result = value;
-			// 2.
 			ConstVal floatVal = envCtx.constTable->GetConstVal(floatConstExpr->GetConstId());
 			result = std::get<float>(floatVal);
 		}
 		void ExprEvalVisitor::VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) {
-			// 1.
-			// const Token& doubleConst = doubleConstExpr->GetDoubleConst();
-			// double value = std::strtod(doubleConst.lexeme.data(), nullptr);
-			// result = value;
-			// 2.
 			ConstVal doubleVal = envCtx.constTable->GetConstVal(doubleConstExpr->GetConstId());
 			result = std::get<double>(doubleVal);
 		}
 		void ExprEvalVisitor::VisitGroupExpr(GroupExpr* groupExpr) {
-			groupExpr->GetExpr()->Accept(this);
+			Visit(groupExpr->GetExpr());
 		}
 
 		bool ExprEvalVisitor::ResultBool() const {
@@ -231,6 +296,33 @@ namespace crayon {
 			return std::get<double>(result);
 		}
 
+		bool ExprEvalVisitor::Evaluate(Expr* expr) {
+			resultUndefined = false;
+			errMsg = std::string_view();
+			errExpr = nullptr;
+			Visit(expr);
+			return !resultUndefined;
+		}
+		std::string_view ExprEvalVisitor::GetErrorMessage() const {
+			return errMsg;
+		}
+		Expr* ExprEvalVisitor::GetErrorExpr() const {
+			return errExpr;
+		}
+		void ExprEvalVisitor::Fail(Expr* expr, std::string_view errMsg) {
+			// The visit methods return as soon as the result is undefined, so only the first error is kept.
+			resultUndefined = true;
+			this->errMsg = errMsg;
+			errExpr = expr;
+		}
+
+		void ExprEvalVisitor::SetEnvironmentContext(const EnvironmentContext& envCtx) {
+			this->envCtx = envCtx;
+		}
+		void ExprEvalVisitor::ResetEnvironmentContext() {
+			this->envCtx = EnvironmentContext();
+		}
+
 		void ExprTypeInferenceVisitor::VisitInitListExpr(InitListExpr* InitListExpr) {
 			// Not supported yet!
 		}
@@ -241,11 +333,12 @@ namespace crayon {
 			// The type of this expression is evaluated and set .
 
 			Expr* rvalue = assignExpr->GetRvalue();
-			rvalue->Accept(this);
-			const TypeSpec& rvalueTypeSpec = envCtx.typeTable->GetType(rvalue->GetExprTypeId());
-
+			Visit(rvalue);
 			Expr* lvalue = assignExpr->GetLvalue();
-			lvalue->Accept(this);
+			Visit(lvalue);
+
+			// Visiting may add types to the table, the references are taken afterwards.
+			const TypeSpec& rvalueTypeSpec = envCtx.typeTable->GetType(rvalue->GetExprTypeId());
 			const TypeSpec& lvalueTypeSpec = envCtx.typeTable->GetType(lvalue->GetExprTypeId());
 
 			if (IsTypePromotable(rvalueTypeSpec, lvalueTypeSpec)) {
@@ -257,17 +350,36 @@ namespace crayon {
 				std::runtime_error{"Can't assign the 'rvalue' to the specified 'lvalue'!"};
 			}
 		}
+		void ExprTypeInferenceVisitor::VisitTernaryExpr(TernaryExpr* ternaryExpr) {
+			Expr* condition = ternaryExpr->GetCondition();
+			Visit(condition);
+			Expr* trueExpr = ternaryExpr->GetTrueExpr();
+			Visit(trueExpr);
+			Expr* falseExpr = ternaryExpr->GetFalseExpr();
+			Visit(falseExpr);
+
+			// Visiting may add types to the table, the references are taken afterwards.
+			const TypeSpec& conditionTypeSpec = envCtx.typeTable->GetType(condition->GetExprTypeId());
+			const TypeSpec& trueTypeSpec = envCtx.typeTable->GetType(trueExpr->GetExprTypeId());
+			const TypeSpec& falseTypeSpec = envCtx.typeTable->GetType(falseExpr->GetExprTypeId());
+
+			TypeSpec resTypeSpec = InferTernaryExprType(conditionTypeSpec, trueTypeSpec, falseTypeSpec);
+			size_t resTypeId = envCtx.typeTable->GetTypeId(resTypeSpec);
+			ternaryExpr->SetExprTypeId(resTypeId);
+			ternaryExpr->SetExprConstState(condition->IsConstExpr() && trueExpr->IsConstExpr() && falseExpr->IsConstExpr());
+		}
 		void ExprTypeInferenceVisitor::VisitBinaryExpr(BinaryExpr* binaryExpr) {
 			Expr* lhs = binaryExpr->GetLeftExpr();
-			lhs->Accept(this);
-			const TypeSpec& lhsTypeSpec = envCtx.typeTable->GetType(lhs->GetExprTypeId());
-
+			Visit(lhs);
 			Expr* rhs = binaryExpr->GetRightExpr();
-			rhs->Accept(this);
+			Visit(rhs);
+
+			// Visiting may add types to the table, the references are taken afterwards.
+			const TypeSpec& lhsTypeSpec = envCtx.typeTable->GetType(lhs->GetExprTypeId());
 			const TypeSpec& rhsTypeSpec = envCtx.typeTable->GetType(rhs->GetExprTypeId());
 
 			const Token& binaryOp = binaryExpr->GetOperator();
-			TypeSpec resTypeSpec = InferArithmeticBinaryExprType(lhsTypeSpec, rhsTypeSpec, binaryOp.tokenType);
+			TypeSpec resTypeSpec = InferExprType(lhsTypeSpec, rhsTypeSpec, binaryOp.tokenType);
 			if (resTypeSpec.type.tokenType == TokenType::UNDEFINED) {
 				// The binary operation is not defined for the types provided!
 				// Should I throw an exception?
@@ -279,11 +391,14 @@ namespace crayon {
 			binaryExpr->SetExprConstState(lhs->IsConstExpr() && rhs->IsConstExpr());
 		}
 		void ExprTypeInferenceVisitor::VisitUnaryExpr(UnaryExpr* unaryExpr) {
-			// Not fully supported yet!
 			const Token& unaryOp = unaryExpr->GetOperator();
 			Expr* exprOperand = unaryExpr->GetExpr();
-			// TODO: do I need to do anything else here?
-			unaryExpr->SetExprTypeId(exprOperand->GetExprTypeId());
+			Visit(exprOperand);
+			const TypeSpec& operandTypeSpec = envCtx.typeTable->GetType(exprOperand->GetExprTypeId());
+
+			TypeSpec resTypeSpec = InferUnaryExprType(operandTypeSpec, unaryOp.tokenType);
+			size_t resTypeId = envCtx.typeTable->GetTypeId(resTypeSpec);
+			unaryExpr->SetExprTypeId(resTypeId);
 			unaryExpr->SetExprConstState(exprOperand->IsConstExpr());
 		}
 		void ExprTypeInferenceVisitor::VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) {
@@ -297,20 +412,17 @@ namespace crayon {
 			size_t typeId = envCtx.typeTable->GetTypeId(ctorTypeSpec);
 			ctorCallExpr->SetExprTypeId(typeId);
 			bool isCtorCallConstExpr{true};
-			for (const std::shared_ptr<Expr>& arg : ctorCallExpr->GetArgs()) {
+			for (Expr* arg : ctorCallExpr->GetArgs()) {
 				if (!arg->IsConstExpr()) {
 					isCtorCallConstExpr = false;
-					std::cout << "One of the Ctor's arguments is not constant!\n";
 					break;
-				} else {
-					std::cout << "Ctor's argument is constant!\n";
 				}
 			}
 			ctorCallExpr->SetExprConstState(isCtorCallConstExpr);
 		}
 		void ExprTypeInferenceVisitor::VisitVarExpr(VarExpr* varExpr) {
 			std::string_view varName = varExpr->GetVariable().lexeme;
-			std::shared_ptr<VarDecl> varDecl = envCtx.currentScope->GetVarDecl(varName);
+			VarDecl* varDecl = envCtx.currentScope->GetVarDecl(varName);
 			TypeSpec varExprTypeSpec = varDecl->GetVarTypeSpec();
 			size_t typeId = envCtx.typeTable->GetTypeId(varExprTypeSpec);
 			varExpr->SetExprTypeId(typeId);
@@ -347,7 +459,7 @@ namespace crayon {
 			doubleConstExpr->SetExprConstState(true);
 		}
 		void ExprTypeInferenceVisitor::VisitGroupExpr(GroupExpr* groupExpr) {
-			groupExpr->Accept(this);
+			Visit(groupExpr->GetExpr());
 			size_t groupExprTypeId = groupExpr->GetExpr()->GetExprTypeId();
 			groupExpr->SetExprTypeId(groupExprTypeId);
 			groupExpr->SetExprConstState(groupExpr->GetExpr()->IsConstExpr());
@@ -360,6 +472,255 @@ namespace crayon {
 			this->envCtx = EnvironmentContext();
 		}
 
+		void FlatExprEvaluator::EvaluateAll(const FlatAst& flatAst, const ConstantTable& constTable,
+		                                    const std::unordered_map<ConstId, ConstId>* constIds) {
+			// Every result is written below, the previous ones needn't be cleared.
+			results.resize(flatAst.exprs.size());
+			errors.clear();
+			// The literals are sorted like the expressions, so they're found by walking along.
+			size_t constIdx{0};
+			for (FlatId exprId = 0; exprId < flatAst.exprs.size(); exprId++) {
+				const FlatExpr& flatExpr = flatAst.exprs[exprId];
+				const FlatId* operands = flatAst.exprOperands.data() + flatExpr.operands.begin;
+				Result& result = results[exprId];
+				result.defined = false;
+				result.errExpr = noFlatId;
+				// Takes the operand's result, its error included.
+				auto propagate = [this, &result](FlatId operandId) {
+					result = results[operandId];
+					return result.defined;
+				};
+				switch (flatExpr.kind) {
+					case FlatExprKind::INT_CONST:
+					case FlatExprKind::UINT_CONST:
+					case FlatExprKind::FLOAT_CONST:
+					case FlatExprKind::DOUBLE_CONST: {
+						while (constIdx < flatAst.constExprIds.size() && flatAst.constExprIds[constIdx] < exprId) {
+							constIdx++;
+						}
+						if (constIdx == flatAst.constExprIds.size() || flatAst.constExprIds[constIdx] != exprId) {
+							break;
+						}
+						ConstId constId = flatAst.constIds[constIdx];
+						if (constIds) {
+							auto searchRes = constIds->find(constId);
+							if (searchRes == constIds->end()) {
+								break;
+							}
+							constId = searchRes->second;
+						}
+						result.value = std::visit([](auto value) {
+							return ExprValue{value};
+						}, constTable.GetConstVal(constId));
+						result.defined = true;
+						break;
+					}
+					case FlatExprKind::GROUP:
+						propagate(operands[0]);
+						break;
+					case FlatExprKind::UNARY: {
+						if (!propagate(operands[0])) {
+							break;
+						}
+						TokenType op = static_cast<TokenType>(flatExpr.token.tokenType);
+						bool computed = std::visit([&result, op](auto value) {
+							using T = decltype(value);
+							if constexpr (std::is_same_v<T, bool>) {
+								if (op == TokenType::BANG) {
+									result.value = !value;
+									return true;
+								}
+							} else {
+								if (op == TokenType::PLUS) {
+									result.value = value;
+									return true;
+								} else if (op == TokenType::DASH) {
+									if constexpr (std::is_unsigned_v<T>) {
+										// Unsigned integers wrap around.
+										result.value = T{0} - value;
+									} else {
+										result.value = -value;
+									}
+									return true;
+								}
+								if constexpr (std::is_integral_v<T>) {
+									if (op == TokenType::TILDE) {
+										result.value = static_cast<T>(~value);
+										return true;
+									}
+								}
+							}
+							return false;
+						}, result.value);
+						if (!computed) {
+							Fail(result, exprId, "The unary operator can't be used in a constant expression!");
+						}
+						break;
+					}
+					case FlatExprKind::BINARY: {
+						// The left operand's error comes first, like in the recursive evaluation.
+						if (!propagate(operands[0]) || !propagate(operands[1])) {
+							break;
+						}
+						const ExprValue& left = results[operands[0]].value;
+						const ExprValue& right = results[operands[1]].value;
+						TokenType op = static_cast<TokenType>(flatExpr.token.tokenType);
+						std::string_view opErrMsg;
+						if (std::holds_alternative<bool>(left) || std::holds_alternative<bool>(right)) {
+							// Booleans aren't converted to anything.
+							if (!std::holds_alternative<bool>(left) || !std::holds_alternative<bool>(right)) {
+								Fail(result, exprId, "Mismatched operand types in a constant expression!");
+								break;
+							}
+							opErrMsg = ComputeBoolExpr(std::get<bool>(left), std::get<bool>(right), op, result.value);
+						} else {
+							const auto& exprEvalFun = exprEvalFuns[left.index() - intExprValueIndex][right.index() - intExprValueIndex];
+							opErrMsg = exprEvalFun(left, right, op, result.value);
+						}
+						if (!opErrMsg.empty()) {
+							Fail(result, exprId, opErrMsg);
+						}
+						break;
+					}
+					case FlatExprKind::TERNARY: {
+						// Both branches are evaluated along with the rest, only the selected one is taken.
+						if (!propagate(operands[0])) {
+							break;
+						}
+						if (!std::holds_alternative<bool>(result.value)) {
+							Fail(result, operands[0], ternaryConditionMsg);
+							break;
+						}
+						propagate(std::get<bool>(result.value) ? operands[1] : operands[2]);
+						break;
+					}
+					default:
+						// Not supported yet, like in 'ExprEvalVisitor'.
+						break;
+				}
+			}
+		}
+		bool FlatExprEvaluator::IsDefined(FlatId exprId) const {
+			return results[exprId].defined;
+		}
+		const FlatExprEvaluator::ExprValue& FlatExprEvaluator::GetResult(FlatId exprId) const {
+			assert(results[exprId].defined && "Check if the expression is defined first!");
+			return results[exprId].value;
+		}
+		std::string_view FlatExprEvaluator::GetErrorMessage(FlatId exprId) const {
+			FlatId errExpr = results[exprId].errExpr;
+			auto searchRes = std::lower_bound(errors.begin(), errors.end(), errExpr, [](const Error& error, FlatId exprId) {
+				return error.exprId < exprId;
+			});
+			return searchRes != errors.end() && searchRes->exprId == errExpr ? searchRes->errMsg : std::string_view{};
+		}
+		FlatId FlatExprEvaluator::GetErrorExpr(FlatId exprId) const {
+			return results[exprId].errExpr;
+		}
+		void FlatExprEvaluator::Fail(Result& result, FlatId exprId, std::string_view errMsg) {
+			result.defined = false;
+			result.errExpr = exprId;
+			if (errors.empty() || errors.back().exprId < exprId) {
+				errors.push_back(Error{exprId, errMsg});
+				return;
+			}
+			// A ternary expression's condition fails after the errors of its branches.
+			auto searchRes = std::lower_bound(errors.begin(), errors.end(), exprId, [](const Error& error, FlatId exprId) {
+				return error.exprId < exprId;
+			});
+			if (searchRes == errors.end() || searchRes->exprId != exprId) {
+				errors.insert(searchRes, Error{exprId, errMsg});
+			}
+		}
+
+		void FlatExprTypeInference::InferAll(FlatAst& flatAst, TypeTable& typeTable) {
+			auto literalTypeId = [&typeTable](TokenType tokenType) {
+				TypeSpec literalTypeSpec{};
+				literalTypeSpec.type = GenerateToken(tokenType);
+				return static_cast<uint32_t>(typeTable.GetTypeId(literalTypeSpec));
+			};
+			const uint32_t intTypeId = literalTypeId(TokenType::INT);
+			const uint32_t uintTypeId = literalTypeId(TokenType::UINT);
+			const uint32_t floatTypeId = literalTypeId(TokenType::FLOAT);
+			const uint32_t doubleTypeId = literalTypeId(TokenType::DOUBLE);
+			std::vector<uint32_t>& typeIds = flatAst.exprTypeIds;
+			for (FlatId exprId = 0; exprId < flatAst.exprs.size(); exprId++) {
+				FlatExpr& flatExpr = flatAst.exprs[exprId];
+				const FlatId* operands = flatAst.exprOperands.data() + flatExpr.operands.begin;
+				TokenType op = static_cast<TokenType>(flatExpr.token.tokenType);
+				switch (flatExpr.kind) {
+					case FlatExprKind::INT_CONST:
+						typeIds[exprId] = intTypeId;
+						flatExpr.isConst = 1;
+						break;
+					case FlatExprKind::UINT_CONST:
+						typeIds[exprId] = uintTypeId;
+						flatExpr.isConst = 1;
+						break;
+					case FlatExprKind::FLOAT_CONST:
+						typeIds[exprId] = floatTypeId;
+						flatExpr.isConst = 1;
+						break;
+					case FlatExprKind::DOUBLE_CONST:
+						typeIds[exprId] = doubleTypeId;
+						flatExpr.isConst = 1;
+						break;
+					case FlatExprKind::GROUP:
+						typeIds[exprId] = typeIds[operands[0]];
+						flatExpr.isConst = flatAst.exprs[operands[0]].isConst;
+						break;
+					case FlatExprKind::UNARY: {
+						TypeSpec resTypeSpec = InferUnaryExprType(typeTable.GetType(typeIds[operands[0]]), op);
+						typeIds[exprId] = static_cast<uint32_t>(typeTable.GetTypeId(resTypeSpec));
+						flatExpr.isConst = flatAst.exprs[operands[0]].isConst;
+						break;
+					}
+					case FlatExprKind::BINARY: {
+						TypeSpec resTypeSpec = InferExprType(typeTable.GetType(typeIds[operands[0]]),
+						                                     typeTable.GetType(typeIds[operands[1]]), op);
+						typeIds[exprId] = static_cast<uint32_t>(typeTable.GetTypeId(resTypeSpec));
+						flatExpr.isConst = flatAst.exprs[operands[0]].isConst & flatAst.exprs[operands[1]].isConst;
+						break;
+					}
+					case FlatExprKind::TERNARY: {
+						TypeSpec resTypeSpec = InferTernaryExprType(typeTable.GetType(typeIds[operands[0]]),
+						                                            typeTable.GetType(typeIds[operands[1]]),
+						                                            typeTable.GetType(typeIds[operands[2]]));
+						typeIds[exprId] = static_cast<uint32_t>(typeTable.GetTypeId(resTypeSpec));
+						flatExpr.isConst = flatAst.exprs[operands[0]].isConst & flatAst.exprs[operands[1]].isConst &
+						                   flatAst.exprs[operands[2]].isConst;
+						break;
+					}
+					case FlatExprKind::ASSIGN:
+						// The lvalue's type, never a constant expression.
+						if (IsTypePromotable(typeTable.GetType(typeIds[operands[1]]), typeTable.GetType(typeIds[operands[0]]))) {
+							typeIds[exprId] = typeIds[operands[0]];
+							flatExpr.isConst = 0;
+						}
+						break;
+					case FlatExprKind::CTOR_CALL: {
+						uint32_t isConst{1};
+						for (uint32_t i = 0; i < flatExpr.operands.count; i++) {
+							isConst &= flatAst.exprs[operands[i]].isConst;
+						}
+						flatExpr.isConst = isConst;
+						break;
+					}
+					default:
+						// The rest depends on the declarations, see above.
+						break;
+				}
+			}
+		}
+
+		Expr::Expr(ExprKind kind)
+			: kind(kind) {
+			CountAstNode();
+		}
+		ExprKind Expr::GetKind() const {
+			return kind;
+		}
+
 		void Expr::SetExprTypeId(size_t typeId) {
 			this->typeId = typeId;
 		}
@@ -373,24 +734,29 @@ namespace crayon {
 			return isConst;
 		}
 
-		void InitListExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitInitListExpr(this);
+		InitListExpr::InitListExpr()
+			: Expr(ExprKind::INIT_LIST) {
 		}
-		void InitListExpr::AddInitExpr(std::shared_ptr<Expr> initExpr) {
+		void InitListExpr::AddInitExpr(Expr* initExpr) {
 			initExprs.push_back(initExpr);
 		}
 		bool InitListExpr::IsEmpty() const {
 			return initExprs.empty();
 		}
-		const std::vector<std::shared_ptr<Expr>>& InitListExpr::GetInitExprs() const {
+		const std::vector<Expr*>& InitListExpr::GetInitExprs() const {
 			return initExprs;
 		}
 
-		AssignExpr::AssignExpr(std::shared_ptr<Expr> lvalue, std::shared_ptr<Expr> rvalue, const Token& assignOp)
-			: lvalue(lvalue), rvalue(rvalue), assignOp(assignOp) {
+		// The source text from the start of 'first' to the end of 'last', if both are known.
+		static std::string_view SpanSrcText(std::string_view first, std::string_view last) {
+			if (first.empty() || last.empty() || last.data() < first.data()) {
+				return std::string_view{};
+			}
+			return std::string_view(first.data(), last.data() + last.size() - first.data());
 		}
-		void AssignExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitAssignExpr(this);
+
+		AssignExpr::AssignExpr(Expr* lvalue, Expr* rvalue, const Token& assignOp)
+			: Expr(ExprKind::ASSIGN), lvalue(lvalue), rvalue(rvalue), assignOp(assignOp) {
 		}
 		std::string_view AssignExpr::ToString() const {
 			std::string_view lvalueStr = lvalue->ToString();
@@ -398,88 +764,93 @@ namespace crayon {
 			size_t exprStrSize = rvalueStr.end() - lvalueStr.begin();
 			return std::string_view(lvalueStr.data(), exprStrSize);
 		}
-		std::pair<size_t, size_t> AssignExpr::GetExprColBounds() const {
-			std::pair<size_t, size_t> lvalueColBounds = lvalue->GetExprColBounds();
-			std::pair<size_t, size_t> rvalueColBounds = rvalue->GetExprColBounds();
-			return std::pair<size_t, size_t>(lvalueColBounds.first, rvalueColBounds.second);
+		std::string_view AssignExpr::GetExprSrcText() const {
+			return SpanSrcText(lvalue->GetExprSrcText(), rvalue->GetExprSrcText());
 		}
 		const Token& AssignExpr::GetAssignOp() const {
 			return assignOp;
 		}
 		Expr* AssignExpr::GetLvalue() const {
-			return lvalue.get();
+			return lvalue;
 		}
 		Expr* AssignExpr::GetRvalue() const {
-			return rvalue.get();
+			return rvalue;
+		}
+
+		TernaryExpr::TernaryExpr(Expr* condition, Expr* trueExpr, Expr* falseExpr)
+			: Expr(ExprKind::TERNARY), condition(condition), trueExpr(trueExpr), falseExpr(falseExpr) {
+		}
+		std::string_view TernaryExpr::GetExprSrcText() const {
+			return SpanSrcText(condition->GetExprSrcText(), falseExpr->GetExprSrcText());
+		}
+		Expr* TernaryExpr::GetCondition() const {
+			return condition;
+		}
+		Expr* TernaryExpr::GetTrueExpr() const {
+			return trueExpr;
+		}
+		Expr* TernaryExpr::GetFalseExpr() const {
+			return falseExpr;
 		}
 
-		BinaryExpr::BinaryExpr(std::shared_ptr<Expr> left, const Token& op, std::shared_ptr<Expr> right)
-			: left(left), op(op), right(right) {
+		BinaryExpr::BinaryExpr(Expr* left, const Token& op, Expr* right)
+			: Expr(ExprKind::BINARY), left(left), op(op), right(right) {
 		}
-		void BinaryExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitBinaryExpr(this);
+		std::string_view BinaryExpr::GetExprSrcText() const {
+			return SpanSrcText(left->GetExprSrcText(), right->GetExprSrcText());
 		}
 		Expr* BinaryExpr::GetLeftExpr() const {
-			return left.get();
+			return left;
 		}
 		Expr* BinaryExpr::GetRightExpr() const {
-			return right.get();
+			return right;
 		}
 		const Token& BinaryExpr::GetOperator() const {
 			return op;
 		}
 
-		UnaryExpr::UnaryExpr(const Token& op, std::shared_ptr<Expr> expr)
-							 : op(op), expr(expr) {
+		UnaryExpr::UnaryExpr(const Token& op, Expr* expr)
+							 : Expr(ExprKind::UNARY), op(op), expr(expr) {
 		}
-		void UnaryExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitUnaryExpr(this);
+		std::string_view UnaryExpr::GetExprSrcText() const {
+			return SpanSrcText(op.lexeme, expr->GetExprSrcText());
 		}
 		Expr* UnaryExpr::GetExpr() const {
-			return expr.get();
+			return expr;
 		}
 		const Token& UnaryExpr::GetOperator() const {
 			return op;
 		}
 
-		FieldSelectExpr::FieldSelectExpr(std::shared_ptr<Expr> target, const Token& field)
-			: target(target), field(field) {
-		}
-		void FieldSelectExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitFieldSelectExpr(this);
+		FieldSelectExpr::FieldSelectExpr(Expr* target, const Token& field)
+			: Expr(ExprKind::FIELD_SELECT), target(target), field(field) {
 		}
 		Expr* FieldSelectExpr::GetTarget() const {
-			return target.get();
+			return target;
 		}
 		const Token& FieldSelectExpr::GetField() const {
 			return field;
 		}
 
-		void CallExpr::AddArg(std::shared_ptr<Expr> arg) {
+		void CallExpr::AddArg(Expr* arg) {
 			args.push_back(arg);
 		}
 		bool CallExpr::HasArgs() const {
 			return args.empty();
 		}
-		const std::vector<std::shared_ptr<Expr>>& CallExpr::GetArgs() const {
+		const std::vector<Expr*>& CallExpr::GetArgs() const {
 			return args;
 		}
 
-		FunCallExpr::FunCallExpr(std::shared_ptr<Expr> target)
-			: target(target) {
-		}
-		void FunCallExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitFunCallExpr(this);
+		FunCallExpr::FunCallExpr(Expr* target)
+			: Expr(ExprKind::FUN_CALL), target(target) {
 		}
 		Expr* FunCallExpr::GetTarget() const {
-			return target.get();
+			return target;
 		}
 
 		CtorCallExpr::CtorCallExpr(const TypeSpec& typeSpec)
-			: typeSpec(typeSpec) {
-		}
-		void CtorCallExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitCtorCallExpr(this);
+			: Expr(ExprKind::CTOR_CALL), typeSpec(typeSpec) {
 		}
 		const TypeSpec& CtorCallExpr::GetType() const {
 			return typeSpec;
@@ -487,116 +858,86 @@ namespace crayon {
 
 
 		VarExpr::VarExpr(const Token& variable)
-			: variable(variable) {
-		}
-		void VarExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitVarExpr(this);
+			: Expr(ExprKind::VAR), variable(variable) {
 		}
 		std::string_view VarExpr::ToString() const {
 			// TODO: add array specifier.
 			return variable.lexeme;
 		}
-		std::pair<size_t, size_t> VarExpr::GetExprColBounds() const {
+		std::string_view VarExpr::GetExprSrcText() const {
 			// TODO: add array specifier.
-			return std::pair<size_t, size_t>(variable.startCol, variable.endCol);
+			return variable.lexeme;
 		}
 		const Token& VarExpr::GetVariable() const {
 			return variable;
 		}
 
 		IntConstExpr::IntConstExpr(const Token& intConst, ConstId intConstId)
-			: intConst(intConst), intConstId(intConstId) {
-		}
-		void IntConstExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitIntConstExpr(this);
+			: Expr(ExprKind::INT_CONST), intConst(intConst), intConstId(intConstId) {
 		}
 		std::string_view IntConstExpr::ToString() const {
 			return intConst.lexeme;
 		}
-		std::pair<size_t, size_t> IntConstExpr::GetExprColBounds() const {
-			return std::pair<size_t, size_t>(intConst.startCol, intConst.endCol);
+		std::string_view IntConstExpr::GetExprSrcText() const {
+			return intConst.lexeme;
 		}
 		const Token& IntConstExpr::GetIntConst() const {
 			return intConst;
 		}
-		int IntConstExpr::GetValue() const {
-			return ParseIntValue(intConst.lexeme);
-		}
 		ConstId IntConstExpr::GetConstId() const {
 			return intConstId;
 		}
 
 		UintConstExpr::UintConstExpr(const Token& uintConst, ConstId uintConstId)
-			: uintConst(uintConst), uintConstId(uintConstId) {
-		}
-		void UintConstExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitUintConstExpr(this);
+			: Expr(ExprKind::UINT_CONST), uintConst(uintConst), uintConstId(uintConstId) {
 		}
 		std::string_view UintConstExpr::ToString() const {
 			return uintConst.lexeme;
 		}
-		std::pair<size_t, size_t> UintConstExpr::GetExprColBounds() const {
-			return std::pair<size_t, size_t>(uintConst.startCol, uintConst.endCol);
+		std::string_view UintConstExpr::GetExprSrcText() const {
+			return uintConst.lexeme;
 		}
 		const Token& UintConstExpr::GetUintConst() const {
 			return uintConst;
 		}
-		unsigned int UintConstExpr::GetValue() const {
-			return ParseUintValue(uintConst.lexeme);
-		}
 		ConstId UintConstExpr::GetConstId() const {
 			return uintConstId;
 		}
 
 		FloatConstExpr::FloatConstExpr(const Token& floatConst, ConstId floatConstId)
-			: floatConst(floatConst), floatConstId(floatConstId) {
-		}
-		void FloatConstExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitFloatConstExpr(this);
+			: Expr(ExprKind::FLOAT_CONST), floatConst(floatConst), floatConstId(floatConstId) {
 		}
 		std::string_view FloatConstExpr::ToString() const {
 			return floatConst.lexeme;
 		}
-		std::pair<size_t, size_t> FloatConstExpr::GetExprColBounds() const {
-			return std::pair<size_t, size_t>(floatConst.startCol, floatConst.endCol);
+		std::string_view FloatConstExpr::GetExprSrcText() const {
+			return floatConst.lexeme;
 		}
 		const Token& FloatConstExpr::GetFloatConst() const {
 			return floatConst;
 		}
-		float FloatConstExpr::GetValue() const {
-			return ParseFloatValue(floatConst.lexeme);
-		}
 		ConstId FloatConstExpr::GetConstId() const {
 			return floatConstId;
 		}
 
 		DoubleConstExpr::DoubleConstExpr(const Token& doubleConst, ConstId doubleConstId)
-			: doubleConst(doubleConst), doubleConstId(doubleConstId) {
-		}
-		void DoubleConstExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitDoubleConstExpr(this);
+			: Expr(ExprKind::DOUBLE_CONST), doubleConst(doubleConst), doubleConstId(doubleConstId) {
 		}
 		std::string_view DoubleConstExpr::ToString() const {
 			return doubleConst.lexeme;
 		}
-		std::pair<size_t, size_t> DoubleConstExpr::GetExprColBounds() const {
-			return std::pair<size_t, size_t>(doubleConst.startCol, doubleConst.endCol);
+		std::string_view DoubleConstExpr::GetExprSrcText() const {
+			return doubleConst.lexeme;
 		}
 		const Token& DoubleConstExpr::GetDoubleConst() const {
 			return doubleConst;
 		}
-		double DoubleConstExpr::GetValue() const {
-			return ParseDoubleValue(doubleConst.lexeme);
-		}
 		ConstId DoubleConstExpr::GetConstId() const {
 			return doubleConstId;
 		}
 
-		GroupExpr::GroupExpr(std::shared_ptr<Expr> expr)
-			: expr(expr) {
-		}
-		void GroupExpr::Accept(ExprVisitor* exprVisitor) {
-			exprVisitor->VisitGroupExpr(this);
+		GroupExpr::GroupExpr(Expr* expr)
+			: Expr(ExprKind::GROUP), expr(expr) {
 		}
 		std::string_view GroupExpr::ToString() const {
 			std::string_view exprStr = expr->ToString();
@@ -604,12 +945,16 @@ namespace crayon {
 			// Include the openning parenthesis "(" and the closing parenthesis ")".
 			return std::string_view(exprStr.data() - 1, exprSize + 2);
 		}
-		std::pair<size_t, size_t> GroupExpr::GetExprColBounds() const {
-			std::pair<size_t, size_t> exprColBounds = expr->GetExprColBounds();
-			return std::pair<size_t, size_t>(exprColBounds.first - 1, exprColBounds.second + 1);
+		std::string_view GroupExpr::GetExprSrcText() const {
+			// Along with the parentheses (assuming they're right next to the expression).
+			std::string_view exprSrcText = expr->GetExprSrcText();
+			if (exprSrcText.empty()) {
+				return std::string_view{};
+			}
+			return std::string_view(exprSrcText.data() - 1, exprSrcText.size() + 2);
 		}
 		Expr* GroupExpr::GetExpr() const {
-			return expr.get();
+			return expr;
 		}
 	
 	}
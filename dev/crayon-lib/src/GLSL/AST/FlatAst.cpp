@@ -0,0 +1,881 @@
+#include "GLSL/AST/FlatAst.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+
+namespace crayon {
+	namespace glsl {
+
+		// The arrays are written as they are, padding would put garbage into the files.
+		static_assert(std::has_unique_object_representations_v<FlatDecl> &&
+		              std::has_unique_object_representations_v<FlatStmt> &&
+		              std::has_unique_object_representations_v<FlatExpr> &&
+		              std::has_unique_object_representations_v<FlatTypeQual> &&
+		              std::has_unique_object_representations_v<FlatTypeSpec> &&
+		              std::has_unique_object_representations_v<FlatArrayDim> &&
+		              std::has_unique_object_representations_v<FlatLayoutQual>,
+		              "The flat nodes must not have padding!");
+
+		template <typename T>
+		static void WriteArray(ByteWriter& writer, const std::vector<T>& array) {
+			writer.WriteU32(static_cast<uint32_t>(array.size()));
+			writer.Write(array.data(), array.size() * sizeof(T));
+		}
+		template <typename T>
+		static bool ReadArray(ByteReader& reader, std::vector<T>& array) {
+			uint32_t count{0};
+			if (!reader.ReadU32(count) || reader.GetRemainingSize() / sizeof(T) < count) {
+				return false;
+			}
+			array.resize(count);
+			return reader.Read(array.data(), count * sizeof(T));
+		}
+
+		static bool IsLiteral(FlatExprKind kind) {
+			return kind == FlatExprKind::INT_CONST || kind == FlatExprKind::UINT_CONST ||
+			       kind == FlatExprKind::FLOAT_CONST || kind == FlatExprKind::DOUBLE_CONST;
+		}
+
+		void FlatAst::Reset(std::string_view srcCode) {
+			decls.clear();
+			stmts.clear();
+			exprs.clear();
+			declChildren.clear();
+			stmtChildren.clear();
+			exprOperands.clear();
+			typeQuals.clear();
+			typeSpecs.clear();
+			arrayDims.clear();
+			layoutQuals.clear();
+			exprTypeIds.clear();
+			constExprIds.clear();
+			constIds.clear();
+			this->srcCode = srcCode;
+			extraStrData.clear();
+		}
+
+		void FlatAst::Write(ByteWriter& writer) const {
+			WriteArray(writer, decls);
+			WriteArray(writer, stmts);
+			WriteArray(writer, exprs);
+			WriteArray(writer, declChildren);
+			WriteArray(writer, stmtChildren);
+			WriteArray(writer, exprOperands);
+			WriteArray(writer, typeQuals);
+			WriteArray(writer, typeSpecs);
+			WriteArray(writer, arrayDims);
+			WriteArray(writer, layoutQuals);
+			WriteArray(writer, exprTypeIds);
+			WriteArray(writer, constExprIds);
+			WriteArray(writer, constIds);
+		}
+
+		bool FlatAst::Read(ByteReader& reader, std::string_view strData) {
+			Reset(strData);
+			if (!ReadArray(reader, decls) || !ReadArray(reader, stmts) || !ReadArray(reader, exprs) ||
+				!ReadArray(reader, declChildren) || !ReadArray(reader, stmtChildren) || !ReadArray(reader, exprOperands) ||
+				!ReadArray(reader, typeQuals) || !ReadArray(reader, typeSpecs) || !ReadArray(reader, arrayDims) ||
+				!ReadArray(reader, layoutQuals) || !ReadArray(reader, exprTypeIds) ||
+				!ReadArray(reader, constExprIds) || !ReadArray(reader, constIds)) {
+				return false;
+			}
+
+			// 1. The declarations.
+			for (const FlatDecl& decl : decls) {
+				if (decl.kind >= FlatDeclKind::COUNT || !CheckToken(decl.name) || !CheckToken(decl.instanceName) ||
+					!CheckId(decl.typeQual, typeQuals.size(), true) || !CheckId(decl.typeSpec, typeSpecs.size(), true) ||
+					!CheckRange(decl.children, declChildren.size()) || !CheckRange(decl.dims, arrayDims.size()) ||
+					!CheckId(decl.initExpr, exprs.size(), true) || !CheckId(decl.body, stmts.size(), true)) {
+					return false;
+				}
+			}
+			for (FlatId child : declChildren) {
+				if (!CheckId(child, decls.size())) {
+					return false;
+				}
+			}
+
+			// 2. The statements.
+			for (const FlatStmt& stmt : stmts) {
+				switch (stmt.kind) {
+					case FlatStmtKind::BLOCK:
+						if (!CheckRange(stmt.children, stmtChildren.size())) {
+							return false;
+						}
+						break;
+					case FlatStmtKind::DECL:
+						if (!CheckId(stmt.child, decls.size())) {
+							return false;
+						}
+						break;
+					case FlatStmtKind::EXPR:
+						if (!CheckId(stmt.child, exprs.size())) {
+							return false;
+						}
+						break;
+					default:
+						return false;
+				}
+			}
+			for (FlatId child : stmtChildren) {
+				if (!CheckId(child, stmts.size())) {
+					return false;
+				}
+			}
+
+			// 3. The expressions, the operands must precede them.
+			size_t literalCount{0};
+			for (FlatId exprId = 0; exprId < exprs.size(); exprId++) {
+				const FlatExpr& expr = exprs[exprId];
+				if (!CheckToken(expr.token) || !CheckRange(expr.operands, exprOperands.size()) ||
+					!CheckId(expr.typeSpec, typeSpecs.size(), true)) {
+					return false;
+				}
+				for (uint32_t i = 0; i < expr.operands.count; i++) {
+					if (exprOperands[expr.operands.begin + i] >= exprId) {
+						return false;
+					}
+				}
+				uint32_t operandCount = expr.operands.count;
+				switch (expr.kind) {
+					case FlatExprKind::INIT_LIST:
+						break;
+					case FlatExprKind::ASSIGN:
+					case FlatExprKind::BINARY:
+						if (operandCount != 2) {
+							return false;
+						}
+						break;
+					case FlatExprKind::TERNARY:
+						if (operandCount != 3) {
+							return false;
+						}
+						break;
+					case FlatExprKind::UNARY:
+					case FlatExprKind::FIELD_SELECT:
+					case FlatExprKind::GROUP:
+						if (operandCount != 1) {
+							return false;
+						}
+						break;
+					case FlatExprKind::FUN_CALL:
+						if (operandCount == 0) {
+							return false;
+						}
+						break;
+					case FlatExprKind::CTOR_CALL:
+						if (expr.typeSpec == noFlatId) {
+							return false;
+						}
+						break;
+					case FlatExprKind::VAR:
+					case FlatExprKind::INT_CONST:
+					case FlatExprKind::UINT_CONST:
+					case FlatExprKind::FLOAT_CONST:
+					case FlatExprKind::DOUBLE_CONST:
+						if (operandCount != 0) {
+							return false;
+						}
+						literalCount += IsLiteral(expr.kind) ? 1 : 0;
+						break;
+					default:
+						return false;
+				}
+			}
+
+			// 4. The rest of the nodes.
+			for (const FlatTypeQual& typeQual : typeQuals) {
+				if (!CheckRange(typeQual.layout, layoutQuals.size()) || !CheckToken(typeQual.storage) ||
+					!CheckToken(typeQual.precision) || !CheckToken(typeQual.interpolation) ||
+					!CheckToken(typeQual.invariant) || !CheckToken(typeQual.precise)) {
+					return false;
+				}
+			}
+			for (const FlatTypeSpec& typeSpec : typeSpecs) {
+				if (!CheckToken(typeSpec.type) || !CheckId(typeSpec.structDecl, decls.size(), true) ||
+					!CheckRange(typeSpec.dims, arrayDims.size())) {
+					return false;
+				}
+			}
+			for (const FlatArrayDim& dim : arrayDims) {
+				if (!CheckId(dim.expr, exprs.size(), true)) {
+					return false;
+				}
+			}
+			for (const FlatLayoutQual& layoutQual : layoutQuals) {
+				if (!CheckToken(layoutQual.name)) {
+					return false;
+				}
+			}
+
+			// 5. The side tables, every literal has exactly one constant id.
+			if (exprTypeIds.size() != exprs.size() || constExprIds.size() != constIds.size() ||
+				constExprIds.size() != literalCount) {
+				return false;
+			}
+			for (size_t i = 0; i < constExprIds.size(); i++) {
+				if (!CheckId(constExprIds[i], exprs.size()) || !IsLiteral(exprs[constExprIds[i]].kind) ||
+					(i > 0 && constExprIds[i - 1] >= constExprIds[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::string FlatAst::GetStrData() const {
+			std::string strData{srcCode};
+			strData.append(extraStrData);
+			return strData;
+		}
+		std::string_view FlatAst::GetStr(const FlatStr& str) const {
+			if (str.length == 0) {
+				return std::string_view{};
+			}
+			if (str.offset < srcCode.size()) {
+				return srcCode.substr(str.offset, str.length);
+			}
+			return std::string_view{extraStrData}.substr(str.offset - srcCode.size(), str.length);
+		}
+		Token FlatAst::GetToken(const FlatToken& token) const {
+			Token result{};
+			result.lexeme = GetStr(token.lexeme);
+			result.tokenType = static_cast<TokenType>(token.tokenType);
+			return result;
+		}
+		ConstId FlatAst::GetConstId(FlatId exprId) const {
+			auto searchRes = std::lower_bound(constExprIds.begin(), constExprIds.end(), exprId);
+			if (searchRes == constExprIds.end() || *searchRes != exprId) {
+				throw std::runtime_error{"The expression isn't a literal"};
+			}
+			return constIds[searchRes - constExprIds.begin()];
+		}
+
+		bool FlatAst::CheckStr(const FlatStr& str) const {
+			// Within the source code or within the made up lexemes, not across both.
+			if (str.offset < srcCode.size()) {
+				return str.length <= srcCode.size() - str.offset;
+			}
+			size_t extraOffset = str.offset - srcCode.size();
+			return extraOffset <= extraStrData.size() && str.length <= extraStrData.size() - extraOffset;
+		}
+		bool FlatAst::CheckToken(const FlatToken& token) const {
+			return token.tokenType >= static_cast<int32_t>(TokenType::UNDEFINED) &&
+			       token.tokenType < static_cast<int32_t>(TokenType::TOKEN_NUM) && CheckStr(token.lexeme);
+		}
+		bool FlatAst::CheckId(FlatId id, size_t count, bool optional) const {
+			return id < count || (optional && id == noFlatId);
+		}
+		bool FlatAst::CheckRange(const FlatRange& range, size_t count) const {
+			return range.begin <= count && range.count <= count - range.begin;
+		}
+
+		FlatAstBuilder::FlatAstBuilder(FlatAst& flatAst, std::string_view srcCode)
+			: flatAst(flatAst) {
+			flatAst.Reset(srcCode);
+		}
+
+		FlatId FlatAstBuilder::AddDecl(Decl* decl) {
+			if (!decl) {
+				return noFlatId;
+			}
+			if (auto searchRes = declIds.find(decl); searchRes != declIds.end()) {
+				return searchRes->second;
+			}
+			Visit(decl);
+			declIds[decl] = lastId;
+			return lastId;
+		}
+		FlatId FlatAstBuilder::AddTypeSpec(const TypeSpec& typeSpec) {
+			FlatTypeSpec flatTypeSpec{};
+			flatTypeSpec.type = AddToken(typeSpec.type);
+			flatTypeSpec.structDecl = AddDecl(typeSpec.typeDecl);
+			flatTypeSpec.dims = AddArrayDims(typeSpec.dimensions);
+			flatAst.typeSpecs.push_back(flatTypeSpec);
+			return static_cast<FlatId>(flatAst.typeSpecs.size() - 1);
+		}
+		FlatStr FlatAstBuilder::AddStr(std::string_view str) {
+			FlatStr flatStr{};
+			flatStr.length = static_cast<uint32_t>(str.size());
+			std::string_view srcCode = flatAst.srcCode;
+			if (str.empty()) {
+				// Nothing to point at.
+			} else if (str.data() >= srcCode.data() && str.data() + str.size() <= srcCode.data() + srcCode.size()) {
+				flatStr.offset = static_cast<uint32_t>(str.data() - srcCode.data());
+			} else {
+				// A lexeme made up by the parser (or a macro definition), appended once.
+				uint32_t offset = static_cast<uint32_t>(srcCode.size() + flatAst.extraStrData.size());
+				auto [searchRes, inserted] = extraStrOffsets.insert({std::string(str), offset});
+				if (inserted) {
+					flatAst.extraStrData.append(str);
+				}
+				flatStr.offset = searchRes->second;
+			}
+			return flatStr;
+		}
+
+		void FlatAstBuilder::VisitTransUnit(TransUnit* transUnit) {
+			std::vector<FlatId> children;
+			for (Decl* decl : transUnit->GetDeclarations()) {
+				children.push_back(AddDecl(decl));
+			}
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::TRANS_UNIT;
+			flatDecl.children = AddDeclChildren(children);
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitInterfaceBlockDecl(InterfaceBlockDecl* interfaceBlockDecl) {
+			std::vector<FlatId> fields;
+			for (VarDecl* field : interfaceBlockDecl->GetFields()) {
+				fields.push_back(AddDecl(field));
+			}
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::INTERFACE_BLOCK;
+			flatDecl.name = AddToken(interfaceBlockDecl->GetName());
+			flatDecl.instanceName = AddToken(interfaceBlockDecl->GetInstanceName());
+			flatDecl.typeQual = AddTypeQual(interfaceBlockDecl->GetTypeQualifier());
+			flatDecl.children = AddDeclChildren(fields);
+			flatDecl.dims = AddArrayDims(interfaceBlockDecl->GetDimensions());
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitDeclList(DeclList* declList) {
+			const FullSpecType& fullSpecType = declList->GetFullSpecType();
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::DECL_LIST;
+			flatDecl.typeQual = AddTypeQual(fullSpecType.qualifier);
+			flatDecl.typeSpec = AddTypeSpec(fullSpecType.specifier);
+			std::vector<FlatId> decls;
+			for (VarDecl* decl : declList->GetDecls()) {
+				decls.push_back(AddDecl(decl));
+			}
+			flatDecl.children = AddDeclChildren(decls);
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitStructDecl(StructDecl* structDecl) {
+			std::vector<FlatId> fields;
+			for (VarDecl* field : structDecl->GetFields()) {
+				fields.push_back(AddDecl(field));
+			}
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::STRUCT;
+			flatDecl.name = AddToken(structDecl->GetName());
+			flatDecl.children = AddDeclChildren(fields);
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitVarDecl(VarDecl* varDecl) {
+			// Parameters don't have a visit method of their own.
+			FlatDecl flatDecl{};
+			flatDecl.kind = varDecl->GetKind() == DeclKind::FUN_PARAM ? FlatDeclKind::FUN_PARAM : FlatDeclKind::VAR;
+			AddVarDeclBody(flatDecl, varDecl);
+			flatDecl.initExpr = AddExpr(varDecl->GetInitializerExpr());
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitFunDecl(FunDecl* funDecl) {
+			FunProto* funProto = funDecl->GetFunProto();
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::FUN;
+			flatDecl.name = AddToken(funProto->GetFunctionName());
+			flatDecl.typeQual = AddTypeQual(funProto->GetReturnType().qualifier);
+			flatDecl.typeSpec = AddTypeSpec(funProto->GetReturnType().specifier);
+			std::vector<FlatId> params;
+			for (FunParam* funParam : funProto->GetFunParamList()) {
+				params.push_back(AddDecl(funParam));
+			}
+			flatDecl.children = AddDeclChildren(params);
+			if (funDecl->IsFunDef()) {
+				flatDecl.body = AddStmt(funDecl->GetBlockStmt());
+			}
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+		void FlatAstBuilder::VisitQualDecl(QualDecl* qualDecl) {
+			FlatDecl flatDecl{};
+			flatDecl.kind = FlatDeclKind::QUAL;
+			flatDecl.typeQual = AddTypeQual(qualDecl->GetTypeQualifier());
+			flatAst.decls.push_back(flatDecl);
+			lastId = static_cast<FlatId>(flatAst.decls.size() - 1);
+		}
+
+		void FlatAstBuilder::VisitBlockStmt(BlockStmt* blockStmt) {
+			std::vector<FlatId> children;
+			for (Stmt* stmt : blockStmt->GetStatements()) {
+				children.push_back(AddStmt(stmt));
+			}
+			FlatStmt flatStmt{};
+			flatStmt.kind = FlatStmtKind::BLOCK;
+			flatStmt.children.begin = static_cast<uint32_t>(flatAst.stmtChildren.size());
+			flatStmt.children.count = static_cast<uint32_t>(children.size());
+			flatAst.stmtChildren.insert(flatAst.stmtChildren.end(), children.begin(), children.end());
+			flatAst.stmts.push_back(flatStmt);
+			lastId = static_cast<FlatId>(flatAst.stmts.size() - 1);
+		}
+		void FlatAstBuilder::VisitDeclStmt(DeclStmt* declStmt) {
+			FlatStmt flatStmt{};
+			flatStmt.kind = FlatStmtKind::DECL;
+			flatStmt.child = AddDecl(declStmt->GetDeclaration());
+			flatAst.stmts.push_back(flatStmt);
+			lastId = static_cast<FlatId>(flatAst.stmts.size() - 1);
+		}
+		void FlatAstBuilder::VisitExprStmt(ExprStmt* exprStmt) {
+			FlatStmt flatStmt{};
+			flatStmt.kind = FlatStmtKind::EXPR;
+			flatStmt.child = AddExpr(exprStmt->GetExpression());
+			flatAst.stmts.push_back(flatStmt);
+			lastId = static_cast<FlatId>(flatAst.stmts.size() - 1);
+		}
+
+		void FlatAstBuilder::VisitInitListExpr(InitListExpr* initListExpr) {
+			std::vector<FlatId> operands;
+			for (Expr* initExpr : initListExpr->GetInitExprs()) {
+				operands.push_back(AddExpr(initExpr));
+			}
+			AddExprNode(FlatExprKind::INIT_LIST, initListExpr, Token{}, operands);
+		}
+		void FlatAstBuilder::VisitAssignExpr(AssignExpr* assignExpr) {
+			FlatId lvalue = AddExpr(assignExpr->GetLvalue());
+			FlatId rvalue = AddExpr(assignExpr->GetRvalue());
+			AddExprNode(FlatExprKind::ASSIGN, assignExpr, assignExpr->GetAssignOp(), {lvalue, rvalue});
+		}
+		void FlatAstBuilder::VisitTernaryExpr(TernaryExpr* ternaryExpr) {
+			FlatId condition = AddExpr(ternaryExpr->GetCondition());
+			FlatId trueExpr = AddExpr(ternaryExpr->GetTrueExpr());
+			FlatId falseExpr = AddExpr(ternaryExpr->GetFalseExpr());
+			AddExprNode(FlatExprKind::TERNARY, ternaryExpr, Token{}, {condition, trueExpr, falseExpr});
+		}
+		void FlatAstBuilder::VisitBinaryExpr(BinaryExpr* binaryExpr) {
+			FlatId left = AddExpr(binaryExpr->GetLeftExpr());
+			FlatId right = AddExpr(binaryExpr->GetRightExpr());
+			AddExprNode(FlatExprKind::BINARY, binaryExpr, binaryExpr->GetOperator(), {left, right});
+		}
+		void FlatAstBuilder::VisitUnaryExpr(UnaryExpr* unaryExpr) {
+			FlatId expr = AddExpr(unaryExpr->GetExpr());
+			AddExprNode(FlatExprKind::UNARY, unaryExpr, unaryExpr->GetOperator(), {expr});
+		}
+		void FlatAstBuilder::VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) {
+			FlatId target = AddExpr(fieldSelectExpr->GetTarget());
+			AddExprNode(FlatExprKind::FIELD_SELECT, fieldSelectExpr, fieldSelectExpr->GetField(), {target});
+		}
+		void FlatAstBuilder::VisitFunCallExpr(FunCallExpr* funCallExpr) {
+			std::vector<FlatId> operands{AddExpr(funCallExpr->GetTarget())};
+			for (Expr* arg : funCallExpr->GetArgs()) {
+				operands.push_back(AddExpr(arg));
+			}
+			AddExprNode(FlatExprKind::FUN_CALL, funCallExpr, Token{}, operands);
+		}
+		void FlatAstBuilder::VisitCtorCallExpr(CtorCallExpr* ctorCallExpr) {
+			FlatId typeSpec = AddTypeSpec(ctorCallExpr->GetType());
+			std::vector<FlatId> operands;
+			for (Expr* arg : ctorCallExpr->GetArgs()) {
+				operands.push_back(AddExpr(arg));
+			}
+			AddExprNode(FlatExprKind::CTOR_CALL, ctorCallExpr, Token{}, operands, typeSpec);
+		}
+		void FlatAstBuilder::VisitVarExpr(VarExpr* varExpr) {
+			AddExprNode(FlatExprKind::VAR, varExpr, varExpr->GetVariable(), {});
+		}
+		void FlatAstBuilder::VisitIntConstExpr(IntConstExpr* intConstExpr) {
+			AddConstExprNode(FlatExprKind::INT_CONST, intConstExpr, intConstExpr->GetIntConst(), intConstExpr->GetConstId());
+		}
+		void FlatAstBuilder::VisitUintConstExpr(UintConstExpr* uintConstExpr) {
+			AddConstExprNode(FlatExprKind::UINT_CONST, uintConstExpr, uintConstExpr->GetUintConst(), uintConstExpr->GetConstId());
+		}
+		void FlatAstBuilder::VisitFloatConstExpr(FloatConstExpr* floatConstExpr) {
+			AddConstExprNode(FlatExprKind::FLOAT_CONST, floatConstExpr, floatConstExpr->GetFloatConst(), floatConstExpr->GetConstId());
+		}
+		void FlatAstBuilder::VisitDoubleConstExpr(DoubleConstExpr* doubleConstExpr) {
+			AddConstExprNode(FlatExprKind::DOUBLE_CONST, doubleConstExpr, doubleConstExpr->GetDoubleConst(), doubleConstExpr->GetConstId());
+		}
+		void FlatAstBuilder::VisitGroupExpr(GroupExpr* groupExpr) {
+			FlatId expr = AddExpr(groupExpr->GetExpr());
+			AddExprNode(FlatExprKind::GROUP, groupExpr, Token{}, {expr});
+		}
+
+		FlatId FlatAstBuilder::AddStmt(Stmt* stmt) {
+			Visit(stmt);
+			return lastId;
+		}
+		FlatId FlatAstBuilder::AddExpr(Expr* expr) {
+			if (!expr) {
+				return noFlatId;
+			}
+			if (auto searchRes = exprIds.find(expr); searchRes != exprIds.end()) {
+				return searchRes->second;
+			}
+			Visit(expr);
+			exprIds[expr] = lastId;
+			return lastId;
+		}
+		FlatId FlatAstBuilder::AddTypeQual(const TypeQual& typeQual) {
+			FlatTypeQual flatTypeQual{};
+			flatTypeQual.layout.begin = static_cast<uint32_t>(flatAst.layoutQuals.size());
+			flatTypeQual.layout.count = static_cast<uint32_t>(typeQual.layout.size());
+			for (const LayoutQualifier& layoutQual : typeQual.layout) {
+				FlatLayoutQual flatLayoutQual{};
+				flatLayoutQual.name = AddToken(layoutQual.name);
+				flatLayoutQual.hasValue = layoutQual.value ? 1 : 0;
+				flatLayoutQual.value = layoutQual.value.value_or(0);
+				flatAst.layoutQuals.push_back(flatLayoutQual);
+			}
+			flatTypeQual.storage = AddOptionalToken(typeQual.storage);
+			flatTypeQual.precision = AddOptionalToken(typeQual.precision);
+			flatTypeQual.interpolation = AddOptionalToken(typeQual.interpolation);
+			flatTypeQual.invariant = AddOptionalToken(typeQual.invariant);
+			flatTypeQual.precise = AddOptionalToken(typeQual.precise);
+			flatAst.typeQuals.push_back(flatTypeQual);
+			return static_cast<FlatId>(flatAst.typeQuals.size() - 1);
+		}
+		FlatToken FlatAstBuilder::AddToken(const Token& token) {
+			FlatToken flatToken{};
+			flatToken.lexeme = AddStr(token.lexeme);
+			flatToken.tokenType = static_cast<int32_t>(token.tokenType);
+			return flatToken;
+		}
+		FlatToken FlatAstBuilder::AddOptionalToken(const std::optional<Token>& token) {
+			return token ? AddToken(*token) : FlatToken{};
+		}
+		FlatRange FlatAstBuilder::AddDeclChildren(const std::vector<FlatId>& children) {
+			FlatRange range{};
+			range.begin = static_cast<uint32_t>(flatAst.declChildren.size());
+			range.count = static_cast<uint32_t>(children.size());
+			flatAst.declChildren.insert(flatAst.declChildren.end(), children.begin(), children.end());
+			return range;
+		}
+		FlatRange FlatAstBuilder::AddArrayDims(const std::vector<ArrayDim>& dims) {
+			std::vector<FlatArrayDim> flatDims;
+			for (const ArrayDim& dim : dims) {
+				flatDims.push_back(FlatArrayDim{AddExpr(dim.dimExpr), static_cast<uint32_t>(dim.dimSize)});
+			}
+			FlatRange range{};
+			range.begin = static_cast<uint32_t>(flatAst.arrayDims.size());
+			range.count = static_cast<uint32_t>(flatDims.size());
+			flatAst.arrayDims.insert(flatAst.arrayDims.end(), flatDims.begin(), flatDims.end());
+			return range;
+		}
+		FlatRange FlatAstBuilder::AddArrayDims(const std::vector<Expr*>& dimExprs) {
+			std::vector<ArrayDim> dims;
+			for (Expr* dimExpr : dimExprs) {
+				dims.push_back(ArrayDim{dimExpr, 0});
+			}
+			return AddArrayDims(dims);
+		}
+		void FlatAstBuilder::AddVarDeclBody(FlatDecl& flatDecl, VarDecl* varDecl) {
+			flatDecl.name = AddToken(varDecl->GetVarName());
+			flatDecl.typeQual = AddTypeQual(varDecl->GetVarType().qualifier);
+			flatDecl.typeSpec = AddTypeSpec(varDecl->GetVarType().specifier);
+			flatDecl.dims = AddArrayDims(varDecl->GetDimensions());
+		}
+		void FlatAstBuilder::AddExprNode(FlatExprKind kind, Expr* expr, const Token& token, const std::vector<FlatId>& operands,
+		                                 FlatId typeSpec) {
+			FlatExpr flatExpr{};
+			flatExpr.kind = kind;
+			flatExpr.isConst = expr->IsConstExpr() ? 1 : 0;
+			flatExpr.token = AddToken(token);
+			flatExpr.operands.begin = static_cast<uint32_t>(flatAst.exprOperands.size());
+			flatExpr.operands.count = static_cast<uint32_t>(operands.size());
+			flatExpr.typeSpec = typeSpec;
+			flatAst.exprOperands.insert(flatAst.exprOperands.end(), operands.begin(), operands.end());
+			flatAst.exprs.push_back(flatExpr);
+			flatAst.exprTypeIds.push_back(static_cast<uint32_t>(expr->GetExprTypeId()));
+			lastId = static_cast<FlatId>(flatAst.exprs.size() - 1);
+		}
+		void FlatAstBuilder::AddConstExprNode(FlatExprKind kind, Expr* expr, const Token& token, ConstId constId) {
+			AddExprNode(kind, expr, token, {});
+			// The ids only grow, the side table stays sorted.
+			flatAst.constExprIds.push_back(lastId);
+			flatAst.constIds.push_back(constId);
+		}
+
+		FlatAstLoader::FlatAstLoader(const FlatAst& flatAst, const FlatAstLoaderConfig& config)
+			: flatAst(flatAst), config(config), decls(flatAst.decls.size()), stmts(flatAst.stmts.size()),
+			  exprs(flatAst.exprs.size()) {
+			assert(config.astArena && "The loader needs an arena!");
+		}
+
+		Decl* FlatAstLoader::LoadDecl(FlatId declId) {
+			if (declId >= decls.size()) {
+				throw std::runtime_error{"Invalid declaration id"};
+			}
+			LoadedNode<Decl>& loaded = decls[declId];
+			if (!loaded.node) {
+				if (loaded.loading) {
+					throw std::runtime_error{"The declaration contains itself"};
+				}
+				loaded.loading = true;
+				loaded.node = LoadDeclNode(flatAst.decls[declId]);
+				loaded.loading = false;
+			}
+			return loaded.node;
+		}
+		TypeSpec FlatAstLoader::LoadTypeSpec(FlatId typeSpecId) {
+			if (typeSpecId >= flatAst.typeSpecs.size()) {
+				throw std::runtime_error{"Invalid type specifier id"};
+			}
+			const FlatTypeSpec& flatTypeSpec = flatAst.typeSpecs[typeSpecId];
+			TypeSpec typeSpec{};
+			typeSpec.type = flatAst.GetToken(flatTypeSpec.type);
+			if (flatTypeSpec.structDecl != noFlatId) {
+				typeSpec.typeDecl = LoadDeclAs<StructDecl>(flatTypeSpec.structDecl, DeclKind::STRUCT);
+			}
+			typeSpec.dimensions = LoadArrayDims(flatTypeSpec.dims);
+			return typeSpec;
+		}
+		void FlatAstLoader::SetExprTypeIds(const std::vector<size_t>& typeIds) {
+			for (size_t exprId = 0; exprId < exprs.size(); exprId++) {
+				if (!exprs[exprId].node) {
+					continue;
+				}
+				uint32_t typeId = flatAst.exprTypeIds[exprId];
+				if (typeId >= typeIds.size()) {
+					throw std::runtime_error{"Invalid type id"};
+				}
+				exprs[exprId].node->SetExprTypeId(typeIds[typeId]);
+			}
+		}
+
+		Decl* FlatAstLoader::LoadDeclNode(const FlatDecl& flatDecl) {
+			AstArena& astArena = *config.astArena;
+			const FlatId* children = flatAst.declChildren.data() + flatDecl.children.begin;
+			switch (flatDecl.kind) {
+				case FlatDeclKind::TRANS_UNIT: {
+					auto transUnit = astArena.New<TransUnit>();
+					for (uint32_t i = 0; i < flatDecl.children.count; i++) {
+						transUnit->AddDeclaration(LoadDecl(children[i]));
+					}
+					return transUnit;
+				}
+				case FlatDeclKind::INTERFACE_BLOCK: {
+					auto interfaceBlockDecl = astArena.New<InterfaceBlockDecl>(flatAst.GetToken(flatDecl.name), LoadTypeQual(flatDecl.typeQual),
+					                                                           flatAst.GetToken(flatDecl.instanceName));
+					for (uint32_t i = 0; i < flatDecl.children.count; i++) {
+						interfaceBlockDecl->AddField(LoadDeclAs<VarDecl>(children[i], DeclKind::VAR));
+					}
+					for (const ArrayDim& dim : LoadArrayDims(flatDecl.dims)) {
+						interfaceBlockDecl->AddDimension(dim.dimExpr);
+					}
+					return interfaceBlockDecl;
+				}
+				case FlatDeclKind::DECL_LIST: {
+					auto declList = astArena.New<DeclList>(LoadFullSpecType(flatDecl));
+					for (uint32_t i = 0; i < flatDecl.children.count; i++) {
+						declList->AddDecl(LoadDeclAs<VarDecl>(children[i], DeclKind::VAR));
+					}
+					return declList;
+				}
+				case FlatDeclKind::STRUCT: {
+					auto structDecl = astArena.New<StructDecl>(flatAst.GetToken(flatDecl.name));
+					for (uint32_t i = 0; i < flatDecl.children.count; i++) {
+						structDecl->AddField(LoadDeclAs<VarDecl>(children[i], DeclKind::VAR));
+					}
+					return structDecl;
+				}
+				case FlatDeclKind::VAR: {
+					auto varDecl = astArena.New<VarDecl>(LoadFullSpecType(flatDecl), flatAst.GetToken(flatDecl.name));
+					LoadVarDeclBody(varDecl, flatDecl);
+					return varDecl;
+				}
+				case FlatDeclKind::FUN_PARAM: {
+					auto funParam = astArena.New<FunParam>(LoadFullSpecType(flatDecl), flatAst.GetToken(flatDecl.name));
+					LoadVarDeclBody(funParam, flatDecl);
+					return funParam;
+				}
+				case FlatDeclKind::FUN: {
+					auto funProto = astArena.New<FunProto>(LoadFullSpecType(flatDecl), flatAst.GetToken(flatDecl.name));
+					for (uint32_t i = 0; i < flatDecl.children.count; i++) {
+						funProto->AddFunParam(LoadDeclAs<FunParam>(children[i], DeclKind::FUN_PARAM));
+					}
+					if (flatDecl.body == noFlatId) {
+						return astArena.New<FunDecl>(funProto);
+					}
+					Stmt* body = LoadStmt(flatDecl.body);
+					if (!body || body->GetKind() != StmtKind::BLOCK) {
+						throw std::runtime_error{"The function body isn't a block"};
+					}
+					return astArena.New<FunDecl>(funProto, static_cast<BlockStmt*>(body));
+				}
+				case FlatDeclKind::QUAL:
+					return astArena.New<QualDecl>(LoadTypeQual(flatDecl.typeQual));
+				default:
+					throw std::runtime_error{"Invalid declaration kind"};
+			}
+		}
+		Stmt* FlatAstLoader::LoadStmt(FlatId stmtId) {
+			LoadedNode<Stmt>& loaded = stmts[stmtId];
+			if (!loaded.node) {
+				if (loaded.loading) {
+					throw std::runtime_error{"The statement contains itself"};
+				}
+				loaded.loading = true;
+				loaded.node = LoadStmtNode(flatAst.stmts[stmtId]);
+				loaded.loading = false;
+			}
+			return loaded.node;
+		}
+		Stmt* FlatAstLoader::LoadStmtNode(const FlatStmt& flatStmt) {
+			AstArena& astArena = *config.astArena;
+			switch (flatStmt.kind) {
+				case FlatStmtKind::BLOCK: {
+					auto blockStmt = astArena.New<BlockStmt>();
+					const FlatId* children = flatAst.stmtChildren.data() + flatStmt.children.begin;
+					for (uint32_t i = 0; i < flatStmt.children.count; i++) {
+						blockStmt->AddStmt(LoadStmt(children[i]));
+					}
+					return blockStmt;
+				}
+				case FlatStmtKind::DECL:
+					return astArena.New<DeclStmt>(LoadDecl(flatStmt.child));
+				case FlatStmtKind::EXPR:
+					return astArena.New<ExprStmt>(LoadExpr(flatStmt.child));
+				default:
+					throw std::runtime_error{"Invalid statement kind"};
+			}
+		}
+		Expr* FlatAstLoader::LoadExpr(FlatId exprId) {
+			if (exprId == noFlatId) {
+				return nullptr;
+			}
+			LoadedNode<Expr>& loaded = exprs[exprId];
+			if (!loaded.node) {
+				// The operands precede the expression, only a constructor's type can lead back to it.
+				if (loaded.loading) {
+					throw std::runtime_error{"The expression contains itself"};
+				}
+				loaded.loading = true;
+				loaded.node = LoadExprNode(exprId, flatAst.exprs[exprId]);
+				loaded.node->SetExprConstState(flatAst.exprs[exprId].isConst != 0);
+				loaded.loading = false;
+			}
+			return loaded.node;
+		}
+		Expr* FlatAstLoader::LoadExprNode(FlatId exprId, const FlatExpr& flatExpr) {
+			AstArena& astArena = *config.astArena;
+			const FlatId* operands = GetOperands(flatExpr);
+			switch (flatExpr.kind) {
+				case FlatExprKind::INIT_LIST: {
+					auto initListExpr = astArena.New<InitListExpr>();
+					for (uint32_t i = 0; i < flatExpr.operands.count; i++) {
+						initListExpr->AddInitExpr(LoadExpr(operands[i]));
+					}
+					return initListExpr;
+				}
+				case FlatExprKind::ASSIGN:
+					return astArena.New<AssignExpr>(LoadExpr(operands[0]), LoadExpr(operands[1]), flatAst.GetToken(flatExpr.token));
+				case FlatExprKind::TERNARY:
+					return astArena.New<TernaryExpr>(LoadExpr(operands[0]), LoadExpr(operands[1]), LoadExpr(operands[2]));
+				case FlatExprKind::BINARY:
+					return astArena.New<BinaryExpr>(LoadExpr(operands[0]), flatAst.GetToken(flatExpr.token), LoadExpr(operands[1]));
+				case FlatExprKind::UNARY:
+					return astArena.New<UnaryExpr>(flatAst.GetToken(flatExpr.token), LoadExpr(operands[0]));
+				case FlatExprKind::FIELD_SELECT:
+					return astArena.New<FieldSelectExpr>(LoadExpr(operands[0]), flatAst.GetToken(flatExpr.token));
+				case FlatExprKind::FUN_CALL: {
+					auto funCallExpr = astArena.New<FunCallExpr>(LoadExpr(operands[0]));
+					for (uint32_t i = 1; i < flatExpr.operands.count; i++) {
+						funCallExpr->AddArg(LoadExpr(operands[i]));
+					}
+					return funCallExpr;
+				}
+				case FlatExprKind::CTOR_CALL: {
+					auto ctorCallExpr = astArena.New<CtorCallExpr>(LoadTypeSpec(flatExpr.typeSpec));
+					for (uint32_t i = 0; i < flatExpr.operands.count; i++) {
+						ctorCallExpr->AddArg(LoadExpr(operands[i]));
+					}
+					return ctorCallExpr;
+				}
+				case FlatExprKind::VAR:
+					return astArena.New<VarExpr>(flatAst.GetToken(flatExpr.token));
+				case FlatExprKind::INT_CONST:
+					return astArena.New<IntConstExpr>(flatAst.GetToken(flatExpr.token), LoadConstId(exprId));
+				case FlatExprKind::UINT_CONST:
+					return astArena.New<UintConstExpr>(flatAst.GetToken(flatExpr.token), LoadConstId(exprId));
+				case FlatExprKind::FLOAT_CONST:
+					return astArena.New<FloatConstExpr>(flatAst.GetToken(flatExpr.token), LoadConstId(exprId));
+				case FlatExprKind::DOUBLE_CONST:
+					return astArena.New<DoubleConstExpr>(flatAst.GetToken(flatExpr.token), LoadConstId(exprId));
+				case FlatExprKind::GROUP:
+					return astArena.New<GroupExpr>(LoadExpr(operands[0]));
+				default:
+					throw std::runtime_error{"Invalid expression kind"};
+			}
+		}
+		template <typename T>
+		T* FlatAstLoader::LoadDeclAs(FlatId declId, DeclKind kind) {
+			Decl* decl = LoadDecl(declId);
+			if (!decl || decl->GetKind() != kind) {
+				throw std::runtime_error{"Unexpected declaration kind"};
+			}
+			return static_cast<T*>(decl);
+		}
+		void FlatAstLoader::LoadVarDeclBody(VarDecl* varDecl, const FlatDecl& flatDecl) {
+			for (const ArrayDim& dim : LoadArrayDims(flatDecl.dims)) {
+				varDecl->AddDimension(dim);
+			}
+			if (Expr* initExpr = LoadExpr(flatDecl.initExpr)) {
+				varDecl->SetInitializerExpr(initExpr);
+			}
+		}
+		std::vector<ArrayDim> FlatAstLoader::LoadArrayDims(const FlatRange& dims) {
+			std::vector<ArrayDim> arrayDims(dims.count);
+			for (uint32_t i = 0; i < dims.count; i++) {
+				const FlatArrayDim& flatDim = flatAst.arrayDims[dims.begin + i];
+				arrayDims[i].dimExpr = LoadExpr(flatDim.expr);
+				arrayDims[i].dimSize = flatDim.dimSize;
+			}
+			return arrayDims;
+		}
+		TypeQual FlatAstLoader::LoadTypeQual(FlatId typeQualId) {
+			TypeQual typeQual{};
+			if (typeQualId == noFlatId) {
+				return typeQual;
+			}
+			const FlatTypeQual& flatTypeQual = flatAst.typeQuals[typeQualId];
+			for (uint32_t i = 0; i < flatTypeQual.layout.count; i++) {
+				const FlatLayoutQual& flatLayoutQual = flatAst.layoutQuals[flatTypeQual.layout.begin + i];
+				LayoutQualifier layoutQual{};
+				layoutQual.name = flatAst.GetToken(flatLayoutQual.name);
+				if (flatLayoutQual.hasValue) {
+					layoutQual.value = flatLayoutQual.value;
+				}
+				typeQual.layout.push_back(layoutQual);
+			}
+			typeQual.storage = LoadOptionalToken(flatTypeQual.storage);
+			typeQual.precision = LoadOptionalToken(flatTypeQual.precision);
+			typeQual.interpolation = LoadOptionalToken(flatTypeQual.interpolation);
+			typeQual.invariant = LoadOptionalToken(flatTypeQual.invariant);
+			typeQual.precise = LoadOptionalToken(flatTypeQual.precise);
+			return typeQual;
+		}
+		FullSpecType FlatAstLoader::LoadFullSpecType(const FlatDecl& flatDecl) {
+			FullSpecType fullSpecType{};
+			fullSpecType.qualifier = LoadTypeQual(flatDecl.typeQual);
+			fullSpecType.specifier = LoadTypeSpec(flatDecl.typeSpec);
+			return fullSpecType;
+		}
+		std::optional<Token> FlatAstLoader::LoadOptionalToken(const FlatToken& token) const {
+			if (token.tokenType == static_cast<int32_t>(TokenType::UNDEFINED)) {
+				return std::nullopt;
+			}
+			return flatAst.GetToken(token);
+		}
+		ConstId FlatAstLoader::LoadConstId(FlatId exprId) const {
+			ConstId constId = flatAst.GetConstId(exprId);
+			if (!config.constIds) {
+				return constId;
+			}
+			auto searchRes = config.constIds->find(constId);
+			if (searchRes == config.constIds->end()) {
+				throw std::runtime_error{"Unknown constant id"};
+			}
+			return searchRes->second;
+		}
+		const FlatId* FlatAstLoader::GetOperands(const FlatExpr& flatExpr) const {
+			return flatAst.exprOperands.data() + flatExpr.operands.begin;
+		}
+
+	}
+}
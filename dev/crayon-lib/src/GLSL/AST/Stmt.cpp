@@ -1,39 +1,42 @@
 #include "GLSL/AST/Stmt.h"
+#include "GLSL/CompileStats.h"
 
 namespace crayon {
 	namespace glsl {
 
-		void BlockStmt::Accept(StmtVisitor* stmtVisitor) {
-			stmtVisitor->VisitBlockStmt(this);
+		Stmt::Stmt(StmtKind kind)
+			: kind(kind) {
+			CountAstNode();
 		}
-		void BlockStmt::AddStmt(std::shared_ptr<Stmt> stmt) {
+		StmtKind Stmt::GetKind() const {
+			return kind;
+		}
+
+		BlockStmt::BlockStmt()
+			: Stmt(StmtKind::BLOCK) {
+		}
+		void BlockStmt::AddStmt(Stmt* stmt) {
 			stmts.push_back(stmt);
 		}
 		
 		bool BlockStmt::IsEmpty() const {
 			return stmts.empty();
 		}
-		const std::vector<std::shared_ptr<Stmt>>& BlockStmt::GetStatements() const {
+		const std::vector<Stmt*>& BlockStmt::GetStatements() const {
 			return stmts;
 		}
 
-		DeclStmt::DeclStmt(std::shared_ptr<Decl> decl)
-			: decl(decl) {
+		DeclStmt::DeclStmt(Decl* decl)
+			: Stmt(StmtKind::DECL), decl(decl) {
 		}
-		void DeclStmt::Accept(StmtVisitor* stmtVisitor) {
-			stmtVisitor->VisitDeclStmt(this);
-		}
-		std::shared_ptr<Decl> DeclStmt::GetDeclaration() const {
+		Decl* DeclStmt::GetDeclaration() const {
 			return decl;
 		}
 
-		ExprStmt::ExprStmt(std::shared_ptr<Expr> expr)
-			: expr(expr) {
-		}
-		void ExprStmt::Accept(StmtVisitor* stmtVisitor) {
-			stmtVisitor->VisitExprStmt(this);
+		ExprStmt::ExprStmt(Expr* expr)
+			: Stmt(StmtKind::EXPR), expr(expr) {
 		}
-		std::shared_ptr<Expr> ExprStmt::GetExpression() const {
+		Expr* ExprStmt::GetExpression() const {
 			return expr;
 		}
 	
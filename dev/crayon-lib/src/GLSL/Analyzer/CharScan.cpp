@@ -0,0 +1,138 @@
+#include "GLSL/Analyzer/CharScan.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define CRAYON_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define CRAYON_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace crayon {
+	namespace glsl {
+
+		// Bit masks have one bit per byte of a block, the lowest bit belongs to the first byte.
+
+		// The mask must not be 0.
+		static uint32_t LowestBitIdx(uint32_t mask) {
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward(&idx, mask);
+			return static_cast<uint32_t>(idx);
+#else
+			return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+		}
+		// Mask of the first 'count' bytes of a block.
+		static uint32_t PrefixMask(size_t count) {
+			return count >= 32 ? ~0u : (1u << count) - 1;
+		}
+
+#if defined(CRAYON_SCAN_AVX2)
+		using Block = __m256i;
+		constexpr size_t blockSize{32};
+
+		static Block LoadBlock(const char* data) {
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+		}
+		static uint32_t EqualMask(Block block, char c) {
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+		}
+		// Bytes in [lo, hi]. Both bounds must be in [1, 126], the compares are signed.
+		static uint32_t RangeMask(Block block, char lo, char hi) {
+			__m256i aboveLo = _mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(lo - 1)));
+			__m256i belowHi = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), block);
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(aboveLo, belowHi)));
+		}
+#elif defined(CRAYON_SCAN_SSE2)
+		using Block = __m128i;
+		constexpr size_t blockSize{16};
+
+		static Block LoadBlock(const char* data) {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		}
+		static uint32_t EqualMask(Block block, char c) {
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+		}
+		// Bytes in [lo, hi]. Both bounds must be in [1, 126], the compares are signed.
+		static uint32_t RangeMask(Block block, char lo, char hi) {
+			__m128i aboveLo = _mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lo - 1)));
+			__m128i belowHi = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), block);
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(aboveLo, belowHi)));
+		}
+#endif
+
+		void SkipWhitespace(const char* srcData, size_t srcSize, size_t& pos) {
+#if defined(CRAYON_SCAN_AVX2) || defined(CRAYON_SCAN_SSE2)
+			while (pos + blockSize <= srcSize) {
+				Block block = LoadBlock(srcData + pos);
+				uint32_t spaces = EqualMask(block, ' ') | EqualMask(block, '\t') |
+				                  EqualMask(block, '\n') | EqualMask(block, '\r');
+				if (spaces != PrefixMask(blockSize)) {
+					pos += LowestBitIdx(~spaces);
+					return;
+				}
+				pos += blockSize;
+			}
+#endif
+			while (pos < srcSize && HasCharClass(srcData[pos], charClassSpace)) {
+				pos++;
+			}
+		}
+
+		void SkipLineComment(const char* srcData, size_t srcSize, size_t& pos) {
+			// 'memchr' is already vectorized by every standard library worth using.
+			const void* lineEnd = std::memchr(srcData + pos, '\n', srcSize - pos);
+			pos = lineEnd ? static_cast<const char*>(lineEnd) - srcData : srcSize;
+		}
+
+		bool SkipBlockComment(const char* srcData, size_t srcSize, size_t& pos) {
+#if defined(CRAYON_SCAN_AVX2) || defined(CRAYON_SCAN_SSE2)
+			// The second load is one byte ahead, so that a "*/" split between two blocks is found as well.
+			while (pos + blockSize + 1 <= srcSize) {
+				Block block = LoadBlock(srcData + pos);
+				Block nextBlock = LoadBlock(srcData + pos + 1);
+				uint32_t commentEnds = EqualMask(block, '*') & EqualMask(nextBlock, '/');
+				if (commentEnds != 0) {
+					pos += LowestBitIdx(commentEnds) + 2;
+					return true;
+				}
+				pos += blockSize;
+			}
+#endif
+			while (pos < srcSize) {
+				char c = srcData[pos++];
+				if (c == '*' && pos < srcSize && srcData[pos] == '/') {
+					pos++;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void SkipIdentifierTail(const char* srcData, size_t srcSize, size_t& pos) {
+#if defined(CRAYON_SCAN_AVX2) || defined(CRAYON_SCAN_SSE2)
+			while (pos + blockSize <= srcSize) {
+				Block block = LoadBlock(srcData + pos);
+				uint32_t alnum = RangeMask(block, 'a', 'z') | RangeMask(block, 'A', 'Z') |
+				                 RangeMask(block, '0', '9') | EqualMask(block, '_');
+				if (alnum != PrefixMask(blockSize)) {
+					pos += LowestBitIdx(~alnum);
+					return;
+				}
+				pos += blockSize;
+			}
+#endif
+			while (pos < srcSize && HasCharClass(srcData[pos], charClassAlnum)) {
+				pos++;
+			}
+		}
+
+	}
+}
@@ -31,7 +31,7 @@ namespace crayon {
 			return enclosingScope;
 		}
 		
-		void NestedScopeEnvironment::AddVarDecl(std::shared_ptr<VarDecl> varDecl) {
+		void NestedScopeEnvironment::AddVarDecl(VarDecl* varDecl) {
 			variables.insert({varDecl->GetVarName().lexeme, varDecl});
 		}
 		void NestedScopeEnvironment::RemoveVarDecl(std::string_view varDeclName) {
@@ -49,8 +49,8 @@ namespace crayon {
 			}
 			return true;
 		}
-		std::shared_ptr<VarDecl> NestedScopeEnvironment::GetVarDecl(std::string_view varName) const {
-			std::shared_ptr<VarDecl> varDecl;
+		VarDecl* NestedScopeEnvironment::GetVarDecl(std::string_view varName) const {
+			VarDecl* varDecl{nullptr};
 			auto searchRes = variables.find(varName);
 			if (searchRes == variables.end()) {
 				if (enclosingScope) {
@@ -93,18 +93,18 @@ namespace crayon {
 			return false;
 		}
 
-		void ExternalScopeEnvironment::SetVertexInputLayoutBlock(std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout) {
+		void ExternalScopeEnvironment::SetVertexInputLayoutBlock(VertexInputLayoutBlock* vertexInputLayout) {
 			this->vertexInputLayout = vertexInputLayout;
-			//for (const std::shared_ptr<VarDecl>& varDecl : CreateVertexAttribVarDecls(vertexInputLayout)) {
+			//for (VarDecl* varDecl : CreateVertexAttribVarDecls(vertexInputLayout)) {
 			//	AddVarDecl(varDecl);
 			//}
 		}
-		void ExternalScopeEnvironment::SetMaterialPropertiesBlock(std::shared_ptr<MaterialPropertiesBlock> materialProperties) {
+		void ExternalScopeEnvironment::SetMaterialPropertiesBlock(MaterialPropertiesBlock* materialProperties) {
 			this->materialProperties = materialProperties;
-			// std::shared_ptr<InterfaceBlockDecl> uniformInterfaceBlock = CreateInterfaceBlockDecl(materialProperties);
+			// InterfaceBlockDecl* uniformInterfaceBlock = CreateInterfaceBlockDecl(materialProperties);
 			// AddInterfaceBlockDecl(uniformInterfaceBlock);
 		}
-		void ExternalScopeEnvironment::SetColorAttachmentsBlock(std::shared_ptr<ColorAttachmentsBlock> colorAttachments) {
+		void ExternalScopeEnvironment::SetColorAttachmentsBlock(ColorAttachmentsBlock* colorAttachments) {
 			this->colorAttachments = colorAttachments;
 		}
 
@@ -124,26 +124,26 @@ namespace crayon {
 			return colorAttachments->HasColorAttachmentDecl(colorAttachmentName);
 		}
 
-		std::shared_ptr<VertexAttribDecl> ExternalScopeEnvironment::GetVertexAttribDecl(std::string_view vertexAttribName) const {
+		VertexAttribDecl* ExternalScopeEnvironment::GetVertexAttribDecl(std::string_view vertexAttribName) const {
 			assert(vertexInputLayout && "Vertex Input Layout block doesn't exist!");
 			return vertexInputLayout->GetVertexAttribDecl(vertexAttribName);
 		}
-		std::shared_ptr<MatPropDecl> ExternalScopeEnvironment::GetMatPropDecl(std::string_view matPropName) const {
+		MatPropDecl* ExternalScopeEnvironment::GetMatPropDecl(std::string_view matPropName) const {
 			assert(materialProperties && "Material Properties block doesn't exist!");
 			return materialProperties->GetMatPropDecl(matPropName);
 		}
-		std::shared_ptr<ColorAttachmentDecl> ExternalScopeEnvironment::GetColorAttachmentDecl(std::string_view colorAttachmentName) const {
+		ColorAttachmentDecl* ExternalScopeEnvironment::GetColorAttachmentDecl(std::string_view colorAttachmentName) const {
 			assert(colorAttachments && "Color Attachments block doesn't exist!");
 			return colorAttachments->GetColorAttachmentDecl(colorAttachmentName);
 		}
 
-		void ExternalScopeEnvironment::AddStructDecl(std::shared_ptr<StructDecl> structDecl) {
+		void ExternalScopeEnvironment::AddStructDecl(StructDecl* structDecl) {
 			structs.insert({structDecl->GetName().lexeme, structDecl});
 		}
-		void ExternalScopeEnvironment::AddInterfaceBlockDecl(std::shared_ptr<InterfaceBlockDecl> intBlockDecl) {
+		void ExternalScopeEnvironment::AddInterfaceBlockDecl(InterfaceBlockDecl* intBlockDecl) {
 			interfaceBlocks.insert({ intBlockDecl->GetName().lexeme, intBlockDecl });
 		}
-		void ExternalScopeEnvironment::AddFunDecl(std::shared_ptr<FunDecl> funDecl) {
+		void ExternalScopeEnvironment::AddFunDecl(FunDecl* funDecl) {
 			functions.insert({funDecl->GetFunProto()->GetFunctionName().lexeme, funDecl});
 		}
 
@@ -187,8 +187,8 @@ namespace crayon {
 			return searchRes != functions.end();
 		}
 
-		std::shared_ptr<StructDecl> ExternalScopeEnvironment::GetStructDecl(std::string_view structName) const {
-			std::shared_ptr<StructDecl> structDecl;
+		StructDecl* ExternalScopeEnvironment::GetStructDecl(std::string_view structName) const {
+			StructDecl* structDecl{nullptr};
 			auto searchRes = structs.find(structName);
 			if (searchRes != structs.end()) {
 				structDecl = searchRes->second;
@@ -196,16 +196,16 @@ namespace crayon {
 			assert(searchRes != structs.end() && "Check the existence of the struct declaration first!");
 			return structDecl;
 		}
-		std::shared_ptr<VarDecl> ExternalScopeEnvironment::GetStructField(std::string_view structName, std::string_view fieldName) const {
-			std::shared_ptr<VarDecl> field;
-			std::shared_ptr<StructDecl> structDecl = GetStructDecl(structName);
+		VarDecl* ExternalScopeEnvironment::GetStructField(std::string_view structName, std::string_view fieldName) const {
+			VarDecl* field{nullptr};
+			StructDecl* structDecl = GetStructDecl(structName);
 			if (structDecl) {
 				field = structDecl->GetField(fieldName);
 			}
 			return field;
 		}
-		std::shared_ptr<InterfaceBlockDecl> ExternalScopeEnvironment::GetIntBlockDecl(std::string_view intBlockName) const {
-			std::shared_ptr<InterfaceBlockDecl> intBlockDecl;
+		InterfaceBlockDecl* ExternalScopeEnvironment::GetIntBlockDecl(std::string_view intBlockName) const {
+			InterfaceBlockDecl* intBlockDecl{nullptr};
 			auto searchRes = interfaceBlocks.find(intBlockName);
 			if (searchRes != interfaceBlocks.end()) {
 				intBlockDecl = searchRes->second;
@@ -213,16 +213,16 @@ namespace crayon {
 			assert(searchRes != interfaceBlocks.end() && "Check the existence of the interface block declaration first!");
 			return intBlockDecl;
 		}
-		std::shared_ptr<VarDecl> ExternalScopeEnvironment::GetIntBlockField(std::string_view intBlockName, std::string_view fieldName) const {
-			std::shared_ptr<VarDecl> field;
-			std::shared_ptr<InterfaceBlockDecl> intBlockDecl = GetIntBlockDecl(intBlockName);
+		VarDecl* ExternalScopeEnvironment::GetIntBlockField(std::string_view intBlockName, std::string_view fieldName) const {
+			VarDecl* field{nullptr};
+			InterfaceBlockDecl* intBlockDecl = GetIntBlockDecl(intBlockName);
 			if (intBlockDecl) {
 				field = intBlockDecl->GetField(fieldName);
 			}
 			return field;
 		}
-		std::shared_ptr<FunDecl> ExternalScopeEnvironment::GetFunDecl(std::string_view funName) const {
-			std::shared_ptr<FunDecl> funDecl;
+		FunDecl* ExternalScopeEnvironment::GetFunDecl(std::string_view funName) const {
+			FunDecl* funDecl{nullptr};
 			auto searchRes = functions.find(funName);
 			if (searchRes != functions.end()) {
 				funDecl = searchRes->second;
@@ -0,0 +1,194 @@
+#include "GLSL/Analyzer/Keywords.h"
+
+#include <array>
+#include <cstdint>
+
+namespace crayon {
+	namespace glsl {
+
+		struct Keyword {
+			std::string_view name;
+			TokenType tokenType;
+		};
+
+		constexpr Keyword keywords[]{
+			// Type qualifier keywords
+
+			// Layout qualifier keywords
+
+			{"layout", TokenType::LAYOUT},
+
+			// Storage qualifier keywords
+
+			{"const",   TokenType::CONST  },
+			{"in",      TokenType::IN     },
+			{"out",     TokenType::OUT    },
+			{"uniform", TokenType::UNIFORM},
+			{"buffer",  TokenType::BUFFER },
+
+			// Interpolation qualifier keywords
+
+			{"smooth",        TokenType::SMOOTH       },
+			{"flat",          TokenType::FLAT         },
+			{"noperspective", TokenType::NOPERSPECTIVE},
+
+			// Type keywords
+
+			{"struct", TokenType::STRUCT},
+			{"void",   TokenType::VOID  },
+
+			{"bool",   TokenType::BOOL  },
+			{"int",    TokenType::INT   },
+			{"uint",   TokenType::UINT  },
+			{"float",  TokenType::FLOAT },
+			{"double", TokenType::DOUBLE},
+
+			{"bvec2", TokenType::BVEC2},
+			{"ivec2", TokenType::IVEC2},
+			{"uvec2", TokenType::UVEC2},
+			{"vec2",  TokenType::VEC2 },
+			{"dvec2", TokenType::DVEC2},
+
+			{"bvec3", TokenType::BVEC3},
+			{"ivec3", TokenType::IVEC3},
+			{"uvec3", TokenType::UVEC3},
+			{"vec3",  TokenType::VEC3 },
+			{"dvec3", TokenType::DVEC3},
+
+			{"bvec4", TokenType::BVEC4},
+			{"ivec4", TokenType::IVEC4},
+			{"uvec4", TokenType::UVEC4},
+			{"vec4",  TokenType::VEC4 },
+			{"dvec4", TokenType::DVEC4},
+
+			{"mat2",  TokenType::MAT2 },
+			{"mat3",  TokenType::MAT3 },
+			{"mat4",  TokenType::MAT4 },
+			{"dmat2", TokenType::DMAT2},
+			{"dmat3", TokenType::DMAT3},
+			{"dmat4", TokenType::DMAT4},
+
+			{"mat2x2",  TokenType::MAT2X2 },
+			{"dmat2x2", TokenType::DMAT2X2},
+			{"mat2x3",  TokenType::MAT2X3 },
+			{"dmat2x3", TokenType::DMAT2X3},
+			{"mat2x4",  TokenType::MAT2X4 },
+			{"dmat2x4", TokenType::DMAT2X4},
+
+			{"mat3x2",  TokenType::MAT3X2 },
+			{"dmat3x2", TokenType::DMAT3X2},
+			{"mat3x3",  TokenType::MAT3X3 },
+			{"dmat3x3", TokenType::DMAT3X3},
+			{"mat3x4",  TokenType::MAT3X4 },
+			{"dmat3x4", TokenType::DMAT3X4},
+
+			{"mat4x2",  TokenType::MAT4X2 },
+			{"dmat4x2", TokenType::DMAT4X2},
+			{"mat4x3",  TokenType::MAT4X3 },
+			{"dmat4x3", TokenType::DMAT4X3},
+			{"mat4x4",  TokenType::MAT4X4 },
+			{"dmat4x4", TokenType::DMAT4X4},
+
+			// ... add more types later ...
+			// opaque types, more specifically
+
+			{"uimage2DMSArray", TokenType::UIMAGE2DMSARRAY},
+
+			// GLSL language extension keywords:
+
+			{"ShaderProgram", TokenType::SHADER_PROGRAM_KW},
+			{"BEGIN",         TokenType::BEGIN            },
+			{"END",           TokenType::END              },
+			// Graphics pipeline blocks:
+			{"FixedStagesConfig",  TokenType::FIXED_STAGES_CONFIG_KW},
+			{"MaterialProperties", TokenType::MATERIAL_PROPERTIES_KW},
+			{"VertexInputLayout",  TokenType::VERTEX_INPUT_LAYOUT_KW},
+			{"ColorAttachments",   TokenType::COLOR_ATTACHMENTS_KW  },
+			// Material property type keywords:
+			{"Integer",   TokenType::MAT_PROP_TYPE_INT  },
+			{"Float",     TokenType::MAT_PROP_TYPE_FLOAT},
+			{"Vector2",   TokenType::MAT_PROP_TYPE_VEC2 },
+			{"Vector3",   TokenType::MAT_PROP_TYPE_VEC3 },
+			{"Vector4",   TokenType::MAT_PROP_TYPE_VEC4 },
+			{"Color",     TokenType::MAT_PROP_TYPE_COLOR},
+			{"Texture2D", TokenType::MAT_PROP_TYPE_TEX2D},
+			// Graphics pipeline shader stages:
+			{"VertexShader",                 TokenType::VS_KW },
+			{"TessellationControlShader",    TokenType::TCS_KW},
+			{"TessellationEvaluationShader", TokenType::TES_KW},
+			{"GeometryShader",               TokenType::GS_KW },
+			{"FragmentShader",               TokenType::FS_KW },
+		};
+		constexpr size_t keywordCount{sizeof(keywords) / sizeof(keywords[0])};
+
+		constexpr size_t MinKeywordSize() {
+			size_t minSize{keywords[0].name.size()};
+			for (const Keyword& keyword : keywords) {
+				minSize = keyword.name.size() < minSize ? keyword.name.size() : minSize;
+			}
+			return minSize;
+		}
+		constexpr size_t MaxKeywordSize() {
+			size_t maxSize{0};
+			for (const Keyword& keyword : keywords) {
+				maxSize = keyword.name.size() > maxSize ? keyword.name.size() : maxSize;
+			}
+			return maxSize;
+		}
+		constexpr size_t minKeywordSize{MinKeywordSize()};
+		constexpr size_t maxKeywordSize{MaxKeywordSize()};
+		static_assert(minKeywordSize >= 1 && maxKeywordSize <= 255, "The slot hash packs the size into a single byte!");
+
+		// The first, the last and the third to last character along with the size tell every keyword apart
+		// (e.g. "mat2x3" from "mat3x3" and "dmat2x3"), a multiplicative hash spreads them over the slots.
+		// The seed was found by trying odd multipliers until none of the keywords shared a slot,
+		// it has to be searched again if the static assert below fires after adding a keyword.
+		constexpr uint32_t keywordSlotBits{8};
+		constexpr uint32_t keywordSlotCount{1u << keywordSlotBits};
+		constexpr uint32_t keywordHashSeed{0x9e37c205u};
+
+		constexpr uint32_t KeywordSlot(std::string_view lexeme) {
+			size_t size = lexeme.size();
+			uint32_t key = static_cast<uint32_t>(static_cast<unsigned char>(lexeme[0])) |
+			               static_cast<uint32_t>(static_cast<unsigned char>(lexeme[size - 1])) << 8 |
+			               static_cast<uint32_t>(static_cast<unsigned char>(lexeme[size >= 3 ? size - 3 : 0])) << 16 |
+			               static_cast<uint32_t>(size) << 24;
+			return (key * keywordHashSeed) >> (32 - keywordSlotBits);
+		}
+
+		// Every slot holds the index of its keyword plus one, 0 marks an empty slot.
+		using KeywordSlotTable = std::array<uint8_t, keywordSlotCount>;
+		static_assert(keywordCount < 256, "The keyword indices don't fit into the slots!");
+
+		constexpr KeywordSlotTable MakeKeywordSlotTable() {
+			KeywordSlotTable slots{};
+			for (size_t i = 0; i < keywordCount; i++) {
+				slots[KeywordSlot(keywords[i].name)] = static_cast<uint8_t>(i + 1);
+			}
+			return slots;
+		}
+		constexpr KeywordSlotTable keywordSlots{MakeKeywordSlotTable()};
+
+		constexpr bool KeywordSlotsCollisionFree() {
+			for (size_t i = 0; i < keywordCount; i++) {
+				if (keywordSlots[KeywordSlot(keywords[i].name)] != i + 1) {
+					return false;
+				}
+			}
+			return true;
+		}
+		static_assert(KeywordSlotsCollisionFree(), "Two keywords share a slot, search for a new hash seed!");
+
+		TokenType FindKeyword(std::string_view lexeme) {
+			if (lexeme.size() < minKeywordSize || lexeme.size() > maxKeywordSize) {
+				return TokenType::IDENTIFIER;
+			}
+			uint8_t slot = keywordSlots[KeywordSlot(lexeme)];
+			if (slot == 0 || keywords[slot - 1].name != lexeme) {
+				return TokenType::IDENTIFIER;
+			}
+			return keywords[slot - 1].tokenType;
+		}
+
+	}
+}
@@ -1,4 +1,6 @@
 #include "GLSL/Analyzer/Lexer.h"
+#include "GLSL/Analyzer/Keywords.h"
+#include "GLSL/Error.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -6,32 +8,177 @@
 namespace crayon {
 	namespace glsl {
 
-		void Lexer::Scan(const char* srcData, size_t srcSize, const LexerConfig& config) {
+		bool Lexer::Scan(const char* srcData, size_t srcSize, const LexerConfig& config) {
 			this->srcData = srcData;
 			this->srcSize = srcSize;
 			this->config = config;
+			assert(config.errorReporter && "Check if the error reporter is provided first!");
+			assert((config.constTable || config.tokenRing) && "Check if the constant table is provided first!");
 			ClearState();
-			tokens.clear();
-			while (!AtEnd()) {
+			if (srcSize > maxTokenStreamSrcSize) {
+				tokens.Reset(nullptr, 0);
+				Error("The source code is too large!");
+				if (config.tokenRing) {
+					config.tokenRing->Close();
+				}
+				this->config = LexerConfig{};
+				return false;
+			}
+			tokens.Reset(srcData, srcSize);
+			// Growing the token arrays dominated the lexing time of large inputs.
+			// Real shaders average more than 4 bytes per token, so this is usually the only allocation.
+			if (!config.tokenRing) {
+				tokens.Reserve(srcSize / 4 + 1);
+			}
+			while (true) {
+				// Tokens never start with whitespace, so it's skipped here rather than by 'ScanToken'.
+				Whitespace();
+				if (AtEnd()) {
+					break;
+				}
+				state.start = state.current;
+				ScanToken();
+			}
+			if (config.tokenRing) {
+				config.tokenRing->Close();
+			}
+			this->config = LexerConfig{};
+			this->srcSize = 0;
+			this->srcData = nullptr;
+			return errors.empty();
+		}
+
+		bool Lexer::Rescan(const char* srcData, size_t srcSize, const SrcEdit& edit, const LexerConfig& config) {
+			assert(edit.offset + edit.removedSize <= tokens.GetSrcSize() && "The edit is out of the scanned source code!");
+			assert(tokens.GetSrcSize() - edit.removedSize + edit.insertedSize == srcSize && "The edit doesn't match the source code!");
+			this->srcData = srcData;
+			this->srcSize = srcSize;
+			this->config = config;
+			assert(config.errorReporter && "Check if the error reporter is provided first!");
+			assert(config.constTable && "Check if the constant table is provided first!");
+			assert(!config.tokenRing && "Rescanning into a token ring isn't supported!");
+			std::vector<LexicalError> prevErrors{std::move(errors)};
+			ClearState();
+			if (srcSize > maxTokenStreamSrcSize) {
+				tokens.Reset(nullptr, 0);
+				Error("The source code is too large!");
+				return false;
+			}
+			// 1. A token never looks further than one character past its end (e.g. "-" before "="),
+			// so the tokens ending before the edit are kept. The end of the last one is a safe restart point,
+			// scanning never starts inside a comment there.
+			TokenStream prevTokens{std::move(tokens)};
+			size_t keptCount = prevTokens.FindFirstTokenEndingAtOrAfter(edit.offset);
+			if (keptCount > 0) {
+				state.current = static_cast<uint32_t>(prevTokens.GetTokenEnd(keptCount - 1));
+			}
+			// 2. Scanning from a token start only depends on the following characters. Once a token starts
+			// past the edit where a previous token started, all the following tokens are the same, only shifted.
+			// Opening or closing a block comment simply delays the resynchronization.
+			ptrdiff_t offsetShift = static_cast<ptrdiff_t>(edit.insertedSize) - static_cast<ptrdiff_t>(edit.removedSize);
+			size_t editEnd = edit.offset + edit.insertedSize;
+			size_t prevIdx = prevTokens.FindFirstTokenStartingAtOrAfter(edit.offset + edit.removedSize);
+			size_t resyncIdx = prevTokens.GetSize();
+			tokens.Reset(srcData, srcSize);
+			while (true) {
+				Whitespace();
+				if (AtEnd()) {
+					break;
+				}
+				if (state.current >= editEnd) {
+					size_t prevOffset = state.current - offsetShift;
+					while (prevIdx < prevTokens.GetSize() && prevTokens.GetTokenOffset(prevIdx) < prevOffset) {
+						prevIdx++;
+					}
+					if (prevIdx < prevTokens.GetSize() && prevTokens.GetTokenOffset(prevIdx) == prevOffset) {
+						resyncIdx = prevIdx;
+						break;
+					}
+				}
 				state.start = state.current;
-				state.startCol = state.currentCol;
 				ScanToken();
 			}
+			// 3. Only the rescanned tokens are inserted, the rest of the stream just moves.
+			// The same goes for the errors: the ones of the rescanned range were just reported again,
+			// the others are kept, those past the edit are moved into place in the edited source code.
+			size_t rescanStart = keptCount > 0 ? prevTokens.GetTokenEnd(keptCount - 1) : 0;
+			size_t rescanEnd = resyncIdx < prevTokens.GetSize() ? prevTokens.GetTokenOffset(resyncIdx) : prevTokens.GetSrcSize();
+			std::vector<LexicalError> rescanErrors{std::move(errors)};
+			errors.clear();
+			auto keepPrevErrors = [&](bool afterEdit) {
+				for (const LexicalError& prevError : prevErrors) {
+					// Errors without a lexeme can't be placed, they're found again if they still apply.
+					if (prevError.lexeme.empty()) {
+						continue;
+					}
+					size_t prevOffset = prevError.lexeme.data() - prevTokens.GetSrcData();
+					if (!afterEdit && prevOffset < rescanStart) {
+						errors.push_back(LexicalError{std::string_view{srcData + prevOffset, prevError.lexeme.size()}, prevError.errMsg});
+					} else if (afterEdit && prevOffset >= rescanEnd) {
+						errors.push_back(LexicalError{std::string_view{srcData + prevOffset + offsetShift, prevError.lexeme.size()}, prevError.errMsg});
+					}
+				}
+			};
+			keepPrevErrors(false);
+			errors.insert(errors.end(), rescanErrors.begin(), rescanErrors.end());
+			keepPrevErrors(true);
+			prevTokens.Splice(keptCount, resyncIdx, tokens, offsetShift);
+			tokens = std::move(prevTokens);
 			this->config = LexerConfig{};
 			this->srcSize = 0;
 			this->srcData = nullptr;
+			return errors.empty();
 		}
 
-		const Token* Lexer::GetTokenData() const {
-			return tokens.data();
+		void Lexer::BeginScan(const char* srcData, size_t srcSize, TokenWindow& tokenWindow, const LexerConfig& config) {
+			this->srcData = srcData;
+			this->srcSize = srcSize;
+			this->config = config;
+			assert(config.errorReporter && "Check if the error reporter is provided first!");
+			assert(config.constTable && "Check if the constant table is provided first!");
+			assert(!config.tokenRing && "A token ring can't be combined with a token window!");
+			ClearState();
+			this->tokenWindow = &tokenWindow;
+			// Nothing stays from a previous scan.
+			tokens.Reset(nullptr, 0);
+			if (srcSize > maxTokenStreamSrcSize) {
+				tokenWindow.Reset(nullptr, 0);
+				Error("The source code is too large!");
+				// Nothing to scan, the first 'ScanAhead' ends the scan.
+				this->srcSize = 0;
+				return;
+			}
+			tokenWindow.Reset(srcData, srcSize);
+		}
+		bool Lexer::ScanAhead(size_t maxTokenCount) {
+			assert(tokenWindow && "Call 'BeginScan' first!");
+			size_t endSize = tokenWindow->GetSize() + maxTokenCount;
+			while (tokenWindow->GetSize() < endSize) {
+				Whitespace();
+				if (AtEnd()) {
+					this->tokenWindow = nullptr;
+					this->config = LexerConfig{};
+					this->srcSize = 0;
+					this->srcData = nullptr;
+					return false;
+				}
+				state.start = state.current;
+				ScanToken();
+			}
+			return true;
 		}
-		size_t Lexer::GetTokenSize() const {
-			return tokens.size();
+
+		const TokenStream& Lexer::GetTokenStream() const {
+			return tokens;
+		}
+		const std::vector<LexicalError>& Lexer::GetErrors() const {
+			return errors;
 		}
 
 		void Lexer::ClearState() {
-			state.line = state.currentCol = state.startCol;
 			state.current = state.start = 0;
+			tokenWindow = nullptr;
+			errors.clear();
 		}
 		LexerState Lexer::GetState() const {
 			return state;
@@ -49,21 +196,9 @@ namespace crayon {
 					break;
 				case '/': {
 					if (Match('/')) {
-						while (!AtEnd() && Peek() != '\n')
-							Advance();
+						LineComment();
 					} else if (Match('*')) {
-						while (!AtEnd()) {
-							char c = Advance();
-							if (c == '\n') {
-								HandleNewLine();
-							} else if (c == '*' && Peek() == '/') {
-								Advance();
-								break;
-							}
-						}
-						if (AtEnd()) {
-							// Report the lexical error: unterminated multiline comment!
-						}
+						BlockComment();
 					} else if (Match('=')) {
 						AddToken(TokenType::DIV_ASSIGN);
 					} else {
@@ -94,18 +229,26 @@ namespace crayon {
 					break;
 				case '<':
 					if (Match('<')) {
-						AddToken(TokenType::LEFT_OP);
+						if (Match('=')) {
+							AddToken(TokenType::LEFT_ASSIGN);
+						} else {
+							AddToken(TokenType::LEFT_OP);
+						}
 					} else if (Match('=')) {
-						AddToken(TokenType::LEFT_ASSIGN);
+						AddToken(TokenType::LE_OP);
 					} else {
 						AddToken(TokenType::LEFT_ANGLE);
 					}
 					break;
 				case '>':
 					if (Match('>')) {
-						AddToken(TokenType::RIGHT_OP);
+						if (Match('=')) {
+							AddToken(TokenType::RIGHT_ASSIGN);
+						} else {
+							AddToken(TokenType::RIGHT_OP);
+						}
 					} else if (Match('=')) {
-						AddToken(TokenType::RIGHT_ASSIGN);
+						AddToken(TokenType::GE_OP);
 					} else {
 						AddToken(TokenType::RIGHT_ANGLE);
 					}
@@ -173,7 +316,7 @@ namespace crayon {
 					AddToken(TokenType::RIGHT_BRACE);
 					break;
 				case '.':
-					if (DecimalDigit(Peek())) {
+					if (HasCharClass(Peek(), charClassDecimal)) {
 						FloatingPointNumber();
 					} else {
 						AddToken(TokenType::DOT);
@@ -185,6 +328,9 @@ namespace crayon {
 				case ';':
 					AddToken(TokenType::SEMICOLON);
 					break;
+				case '?':
+					AddToken(TokenType::QUESTION);
+					break;
 
 				case '\'':
 					String('\'');
@@ -197,64 +343,100 @@ namespace crayon {
 					AddToken(TokenType::COLON);
 					break;
 
-				case '\n':
-					HandleNewLine();
-					break;
-				case ' ':
-					// state.column++;
-					break;
-				case '\r':
-					state.currentCol = 0;
-					break;
-				case '\t':
-					// That should depend on the editor's configuration somehow, right?
-					// state.currentCol += 4;
-					state.currentCol += 3; // +3 because the Advance call has already move 1 character forward.
-					break;
-
 				default: {
-					if (DecimalDigit(c)) {
+					if (HasCharClass(c, charClassDecimal)) {
 						Number();
-					} else if (Alpha(c)) {
+					} else if (HasCharClass(c, charClassAlpha)) {
 						Identifier();
 					} else {
-						// Report the lexical error: unidentified token encountered!
-						Token unidentified = CreateToken();
-						std::cerr << "Unidentified token encountered: '" << c << "'\n";
+						Error("Unidentified token encountered!");
 					}
 					break;
 				}
 			}
 		}
 
-		Token Lexer::CreateToken() const {
-			Token token{};
-			token.tokenType = TokenType::UNDEFINED;
-			token.lexeme = std::string_view{srcData + state.start, state.current - state.start};
-			token.line = state.line;
-			token.startCol = state.startCol;
-			token.endCol = state.currentCol;
-			return token;
-		}
-		Token Lexer::CreateToken(TokenType tokenType) const {
-			Token token{};
-			token.tokenType = tokenType;
-			token.lexeme = std::string_view{srcData + state.start, state.current - state.start};
-			token.line = state.line;
-			token.startCol = state.startCol;
-			token.endCol = state.currentCol;
-			return token;
+		void Lexer::AddToken(TokenType tokenType) {
+			if (!CheckTokenLength()) {
+				return;
+			}
+			if (tokenWindow) {
+				tokenWindow->Append(tokenType, state.start, state.current - state.start);
+			} else if (config.tokenRing) {
+				RingToken ringToken{};
+				ringToken.offset = state.start;
+				ringToken.length = static_cast<uint16_t>(state.current - state.start);
+				ringToken.tokenType = tokenType;
+				config.tokenRing->Push(ringToken);
+			} else {
+				tokens.Append(tokenType, state.start, state.current - state.start);
+			}
+		}
+		void Lexer::AddConstantToken(TokenType tokenType, const ConstVal& constVal) {
+			if (!CheckTokenLength()) {
+				return;
+			}
+			if (tokenWindow) {
+				tokenWindow->AppendConstant(tokenType, state.start, state.current - state.start, config.constTable->AddConstant(constVal));
+			} else if (config.tokenRing) {
+				RingToken ringToken{};
+				ringToken.offset = state.start;
+				ringToken.length = static_cast<uint16_t>(state.current - state.start);
+				ringToken.tokenType = tokenType;
+				ringToken.constant = true;
+				ringToken.constVal = constVal;
+				config.tokenRing->Push(ringToken);
+			} else {
+				tokens.AppendConstant(tokenType, state.start, state.current - state.start, config.constTable->AddConstant(constVal));
+			}
+		}
+		bool Lexer::CheckTokenLength() {
+			if (state.current - state.start > maxTokenLength) {
+				Error("Token is too long!");
+				return false;
+			}
+			return true;
 		}
 
-		void Lexer::AddToken(TokenType tokenType) {
-			tokens.push_back(CreateToken(tokenType));
+		void Lexer::Error(std::string_view errMsg) {
+			LexicalError lexicalError{};
+			if (state.current > state.start) {
+				lexicalError.lexeme = std::string_view{srcData + state.start, state.current - state.start};
+			}
+			lexicalError.errMsg = errMsg;
+			errors.push_back(lexicalError);
+			// The error reporter belongs to the parser's thread in the pipelined mode,
+			// and to the parser in the streaming mode, whose diagnostics would be interleaved.
+			if (!config.tokenRing && !tokenWindow) {
+				config.errorReporter->ReportLexicalError(lexicalError);
+			}
 		}
-		void Lexer::AddToken(const Token& token) {
-			tokens.push_back(token);
+		void Lexer::InvalidNumber(std::string_view errMsg, TokenType tokenType) {
+			// The whole literal is reported, e.g. "0x1.5" or "1.0lx", rather than just the part scanned so far.
+			while (HasCharClass(Peek(), charClassAlnum) || Peek() == '.') {
+				Advance();
+			}
+			Error(errMsg);
+			// A zero keeps the parser from reporting a missing expression on top of the lexical error.
+			ConstVal zero{};
+			switch (tokenType) {
+				case TokenType::UINTCONSTANT:
+					zero = 0u;
+				break;
+				case TokenType::FLOATCONSTANT:
+					zero = 0.0f;
+				break;
+				case TokenType::DOUBLECONSTANT:
+					zero = 0.0;
+				break;
+				default:
+					zero = 0;
+				break;
+			}
+			AddConstantToken(tokenType, zero);
 		}
 
 		char Lexer::Advance() {
-			state.currentCol++;
 			return srcData[state.current++];
 		}
 		void Lexer::PutBack() {
@@ -284,17 +466,32 @@ namespace crayon {
 			}
 			return false;
 		}
-		char Lexer::Consume(char c, std::string_view errMsg) {
-			if (Match(c))
-				return Previous();
-			else
-				throw std::runtime_error{errMsg.data()};
-		}
 
-        void Lexer::HandleNewLine() {
-			state.currentCol = 0;
-			state.line++;
-        }
+		void Lexer::Whitespace() {
+			// Tokens are mostly separated by a single space or by nothing at all,
+			// neither is worth a call to the block scanner.
+			if (!AtEnd() && srcData[state.current] == ' ') {
+				Advance();
+			}
+			if (AtEnd() || !HasCharClass(srcData[state.current], charClassSpace)) {
+				return;
+			}
+			size_t pos = state.current;
+			SkipWhitespace(srcData, srcSize, pos);
+			state.current = static_cast<uint32_t>(pos);
+		}
+		void Lexer::LineComment() {
+			size_t pos = state.current;
+			SkipLineComment(srcData, srcSize, pos);
+			state.current = static_cast<uint32_t>(pos);
+		}
+		void Lexer::BlockComment() {
+			size_t pos = state.current;
+			if (!SkipBlockComment(srcData, srcSize, pos)) {
+				// Report the lexical error: unterminated multiline comment!
+			}
+			state.current = static_cast<uint32_t>(pos);
+		}
 
         void Lexer::Number() {
 			char firstDigit = Previous();
@@ -305,7 +502,7 @@ namespace crayon {
 					intConstType = IntConstType::HEX;
 					HexadecimalNumber();
 					return;
-				} else if (DecimalDigit(Peek())) {
+				} else if (HasCharClass(Peek(), charClassDecimal)) {
 					// At this point we don't check if the next digit after '0'
 					// is a valid octal digit or not. This is because the resulting constant
 					// might actually be a floating-point constant, such as '0000.5'.
@@ -319,7 +516,7 @@ namespace crayon {
 			// 3) Floating-point number.
 			// The loop works with decimal digits so if the constant
 			// is an octal integer, we would have to check its validity later.
-			while (DecimalDigit(Peek())) {
+			while (HasCharClass(Peek(), charClassDecimal)) {
 				Advance();
 			}
 			if (Match('.') || Match('e')) {
@@ -343,14 +540,13 @@ namespace crayon {
 		void Lexer::OctalNumber() {
 			// Check if the octal number we've scanned is valid.
 			uint32_t currentSaved = state.current;
-			uint32_t currentColSaved = state.currentCol;
 			state.current = state.start;
-			state.currentCol = state.startCol;
-			while (OctalDigit(Peek())) {
+			while (HasCharClass(Peek(), charClassOctal)) {
 				Advance();
 			}
 			if (state.current != currentSaved) {
-				throw std::runtime_error{"Octal integer constant contains invalid digits!"};
+				InvalidNumber("Octal integer constant contains invalid digits!", TokenType::INTCONSTANT);
+				return;
 			}
 			FinishIntegerNumber(IntConstType::OCT);
 		}
@@ -358,17 +554,19 @@ namespace crayon {
 			// We assume that the current input pointer is pointing at
 			// the next digit after '0x' or '0X'. If the first character after
 			// that sequence is not a hexadecimal number, then that's a syntax error.
-			if (!HexadecimalDigit(Peek())) {
-				throw std::runtime_error{"At least one hexadecimal digit must be present after '0x' or '0X'!"};
+			if (!HasCharClass(Peek(), charClassHex)) {
+				InvalidNumber("At least one hexadecimal digit must be present after '0x' or '0X'!", TokenType::INTCONSTANT);
+				return;
 			}
 			Advance();
-			while (HexadecimalDigit(Peek())) {
+			while (HasCharClass(Peek(), charClassHex)) {
 				Advance();
 			}
 			// We can improve error reporting by handling the case when
 			// a floating-point number has a hexadecimal integer part.
 			if (Peek() == '.') {
-				throw std::runtime_error{"Floating-point number can't have a hexadecimal integer part!"};
+				InvalidNumber("Floating-point number can't have a hexadecimal integer part!", TokenType::FLOATCONSTANT);
+				return;
 			}
 			FinishIntegerNumber(IntConstType::HEX);
 		}
@@ -382,6 +580,9 @@ namespace crayon {
 				case TokenType::INTCONSTANT:
 					AddIntConstant(intConstType);
 				break;
+				case TokenType::UNDEFINED:
+					// An invalid suffix, already replaced by 'InvalidNumber'.
+				break;
 				default:
 					assert(false && "Unrecognized integer constant type!");
 				break;
@@ -394,19 +595,21 @@ namespace crayon {
 			char c = Previous();
 			if (c == '.') {
 				// Finish the fractional part if any.
-				while (DecimalDigit(Peek())) {
+				while (HasCharClass(Peek(), charClassDecimal)) {
 					Advance();
 				}
-				c = Peek();
+				// Unlike the 'e' we may have got here by, this one is not consumed yet.
+				if (Match('e')) {
+					c = 'e';
+				}
 			}
 			if (c == 'e') {
 				// Handle the exponent.
-				Advance();
 				if (Match('-') || Match('+')) {
 					// Handle the positive or negative sign when present.
 				}
 				// Handle the exponent number.
-				while (DecimalDigit(Peek())) {
+				while (HasCharClass(Peek(), charClassDecimal)) {
 					Advance();
 				}
 			}
@@ -419,6 +622,9 @@ namespace crayon {
 				case TokenType::FLOATCONSTANT:
 					AddFloatConstant();
 				break;
+				case TokenType::UNDEFINED:
+					// An invalid suffix, already replaced by 'InvalidNumber'.
+				break;
 				default:
 					assert(false && "Unrecognized floating-point constant type!");
 				break;
@@ -427,11 +633,12 @@ namespace crayon {
 
 		TokenType Lexer::HandleIntSuffix() {
 			// Handle integer suffix.
-			if (Letter(Peek())) {
+			if (HasCharClass(Peek(), charClassLetter)) {
 				if (Match('u') || Match('U')) {
 					return TokenType::UINTCONSTANT;
 				} else {
-					throw std::runtime_error{"Unrecognized integer suffix found!"};
+					InvalidNumber("Unrecognized integer suffix found!", TokenType::INTCONSTANT);
+					return TokenType::UNDEFINED;
 				}
 			} else {
 				return TokenType::INTCONSTANT;
@@ -439,12 +646,18 @@ namespace crayon {
 		}
 		TokenType Lexer::HandleFloatSuffix() {
 			// Handle floating suffix.
-			if (Letter(Peek())) {
+			if (HasCharClass(Peek(), charClassLetter)) {
 				if (Match('l')) {
-					Consume('f', "Unknown floating suffix found! Was 'lf' intended?");
+					if (!Match('f')) {
+						InvalidNumber("Unknown floating suffix found! Was 'lf' intended?", TokenType::DOUBLECONSTANT);
+						return TokenType::UNDEFINED;
+					}
 					return TokenType::DOUBLECONSTANT;
 				} else if (Match('L')) {
-					Consume('F', "Unknown floating suffix found! Was 'LF' intended?");
+					if (!Match('F')) {
+						InvalidNumber("Unknown floating suffix found! Was 'LF' intended?", TokenType::DOUBLECONSTANT);
+						return TokenType::UNDEFINED;
+					}
 					return TokenType::DOUBLECONSTANT;
 				} else if (Match('f') || Match('F')) {
 					// Single precision floating-point constant.
@@ -452,7 +665,8 @@ namespace crayon {
 					// the suffix 'f' or 'F' is optional.
 					return TokenType::FLOATCONSTANT;
 				} else {
-					throw std::runtime_error{"Unrecognized floating suffix found!"};
+					InvalidNumber("Unrecognized floating suffix found!", TokenType::FLOATCONSTANT);
+					return TokenType::UNDEFINED;
 				}
 			} else {
 				// No suffix present. Assume single precision floating-point constant.
@@ -465,74 +679,70 @@ namespace crayon {
 				Advance();
 			}
 			if (AtEnd()) {
-				throw std::runtime_error{"Unterminated string literal!"};
+				Error("Unterminated string literal!");
+				return;
 			}
-			Consume(delim, "Unterminated string literal!");
+			// The closing delimiter.
+			Advance();
 			AddToken(TokenType::STRING);
 		}
 		void Lexer::Identifier() {
-			while (AlphaNumeric(Peek())) {
-				Advance();
-			}
+			size_t pos = state.current;
+			SkipIdentifierTail(srcData, srcSize, pos);
+			state.current = static_cast<uint32_t>(pos);
 			AddIdOrKeyword();
 		}
 
+		// Literals are converted and interned once here, the parser only picks up their ids
+		// (in the pipelined mode the parser interns the converted values).
+		// Literals that fail to convert are reported and kept as zeros.
 		void Lexer::AddIntConstant(IntConstType intConstType) {
-			AddToken(TokenType::INTCONSTANT);
-			// Token& intConst = tokens[tokens.size() - 1];
-			// int base = static_cast<int>(intConstType);
-			// int64_t value = static_cast<int64_t>(std::strtol(intConst.lexeme.data(), nullptr, base));
-			// TODO: add the constant to a constant table (or constant pool)?
+			uint32_t bits{0};
+			if (const char* errMsg = ParseIntConstBits(GetIntConstDigits(intConstType, 0), intConstType, bits)) {
+				Error(errMsg);
+			}
+			AddConstantToken(TokenType::INTCONSTANT, static_cast<int>(bits));
 		}
 		void Lexer::AddUintConstant(IntConstType intConstType) {
-			AddToken(TokenType::UINTCONSTANT);
-			// Token& intConst = tokens[tokens.size() - 1];
-			// int base = static_cast<int>(intConstType);
-			// uint64_t value = static_cast<uint64_t>(std::strtoul(intConst.lexeme.data(), nullptr, base));
-			// TODO: add the constant to a constant table (or constant pool)?
+			// Skip the 'u' or 'U' suffix.
+			uint32_t bits{0};
+			if (const char* errMsg = ParseIntConstBits(GetIntConstDigits(intConstType, 1), intConstType, bits)) {
+				Error(errMsg);
+			}
+			AddConstantToken(TokenType::UINTCONSTANT, static_cast<unsigned int>(bits));
 		}
 		void Lexer::AddFloatConstant() {
-			AddToken(TokenType::FLOATCONSTANT);
-			// Token& floatConst = tokens[tokens.size() - 1];
-			// float value = std::strtof(floatConst.lexeme.data(), nullptr);
-			// TODO: add the constant to a constant table (or constant pool)?
+			float value{0.0f};
+			if (const char* errMsg = ParseFloatValue(GetFloatConstDigits(), value)) {
+				Error(errMsg);
+			}
+			AddConstantToken(TokenType::FLOATCONSTANT, value);
 		}
 		void Lexer::AddDoubleConstant() {
-			AddToken(TokenType::DOUBLECONSTANT);
-			// Token& floatConst = tokens[tokens.size() - 1];
-			// double value = std::strtod(floatConst.lexeme.data(), nullptr);
-			// TODO: add the constant to a constant table (or constant pool)?
+			double value{0.0};
+			if (const char* errMsg = ParseDoubleValue(GetFloatConstDigits(), value)) {
+				Error(errMsg);
+			}
+			AddConstantToken(TokenType::DOUBLECONSTANT, value);
 		}
 
-		void Lexer::AddIdOrKeyword() {
-			Token token = CreateToken();
-			auto searchRes = config.keywords->find(token.lexeme);
-			if (searchRes == config.keywords->end())
-				token.tokenType = TokenType::IDENTIFIER;
-			else
-				token.tokenType = searchRes->second;
-			AddToken(token);
+		std::string_view Lexer::GetIntConstDigits(IntConstType intConstType, uint32_t suffixSize) const {
+			// Skip the "0x" or "0X" prefix, 'std::from_chars' doesn't accept it.
+			uint32_t prefixSize = intConstType == IntConstType::HEX ? 2 : 0;
+			return std::string_view{srcData + state.start + prefixSize, state.current - state.start - prefixSize - suffixSize};
+		}
+		std::string_view Lexer::GetFloatConstDigits() const {
+			// The exponent always ends with a digit, so trailing letters can only be the suffix.
+			uint32_t end = state.current;
+			while (HasCharClass(srcData[end - 1], charClassLetter)) {
+				end--;
+			}
+			return std::string_view{srcData + state.start, end - state.start};
 		}
 
-		bool Lexer::Letter(char c) const {
-			return c >= 'A' && c <= 'Z' || c >= 'a' && c <= 'z';
-		}
-		bool Lexer::Alpha(char c) const {
-			return Letter(c) || c == '_';
-		}
-		bool Lexer::DecimalDigit(char c) const {
-			return c >= '0' && c <= '9';
-		}
-		bool Lexer::OctalDigit(char c) const {
-			return c >= '0' && c <= '7';
-		}
-		bool Lexer::HexadecimalDigit(char c) const {
-			return c >= '0' && c <= '9' ||
-				   c >= 'A' && c <= 'F' ||
-				   c >= 'a' && c <= 'f';
-		}
-		bool Lexer::AlphaNumeric(char c) const {
-			return Alpha(c) || DecimalDigit(c);
+		void Lexer::AddIdOrKeyword() {
+			std::string_view lexeme{srcData + state.start, state.current - state.start};
+			AddToken(FindKeyword(lexeme));
 		}
 
 		bool Lexer::AtEnd() const {
@@ -1,4 +1,5 @@
 #include "GLSL/Analyzer/Parser.h"
+#include "GLSL/Analyzer/Lexer.h"
 #include "GLSL/Error.h"
 
 #include <cassert>
@@ -44,37 +45,132 @@ namespace crayon {
 		static constexpr std::string_view glFragDepth_varName       {"gl_FragDepth"       };
 		static constexpr std::string_view glSampleMask_varName      {"gl_SampleMask"      };
 
-		void Parser::Parse(const Token* tokenStream, size_t tokenStreamSize, const ParserConfig& parserConfig) {
-			this->tokenStream = tokenStream;
-			this->tokenStreamSize = tokenStreamSize;
-			this->parserConfig = parserConfig;
-			current = 0;
-			semanticAnalyzer = std::make_unique<SemanticAnalyzer>();
-			typeTable = std::make_unique<TypeTable>();
-			constTable = std::make_unique<ConstantTable>();
+		void Parser::Parse(const TokenStream& tokenStream, const ParserConfig& parserConfig) {
+			SetTokenStream(&tokenStream);
+			Reset(parserConfig);
 			// TranslationUnit();
 			ShaderProgram();
 			this->tokenStreamSize = 0;
 			this->tokenStream = nullptr;
 		}
+		void Parser::ParseHeader(const TokenStream& tokenStream, const ParserConfig& parserConfig) {
+			SetTokenStream(&tokenStream);
+			Reset(parserConfig);
+			InitializeExternalScope();
+			headerTransUnit = astArena->New<TransUnit>();
+			while (!AtEnd()) {
+				Decl* decl = ExternalDeclaration();
+				if (decl) headerTransUnit->AddDeclaration(decl);
+			}
+			this->tokenStreamSize = 0;
+			this->tokenStream = nullptr;
+		}
+		void Parser::ParsePipelined(TokenRing& tokenRing, TokenStream& tokenStream, const ParserConfig& parserConfig) {
+			SetTokenStream(&tokenStream);
+			this->tokenRing = &tokenRing;
+			this->pipelinedTokens = &tokenStream;
+			Reset(parserConfig);
+			ShaderProgram();
+			// Parsing may stop early (e.g. trailing tokens), the rest still belongs to the stream.
+			while (this->tokenRing) {
+				PullTokens();
+			}
+			SetTokenStream(nullptr);
+		}
+		void Parser::ParseStreaming(Lexer& lexer, const TokenWindow& tokenWindow, const ParserConfig& parserConfig) {
+			SetTokenStream(nullptr);
+			this->tokenLexer = &lexer;
+			this->tokenWindow = &tokenWindow;
+			this->tokenStreamSize = tokenWindow.GetSize();
+			Reset(parserConfig);
+			ShaderProgram();
+			// The lexical errors past the point where parsing stopped are still reported.
+			while (this->tokenLexer) {
+				if (!this->tokenLexer->ScanAhead(tokenWindowSize / 2)) {
+					this->tokenLexer = nullptr;
+				}
+			}
+			SetTokenStream(nullptr);
+		}
 		bool Parser::HadSyntaxError() const {
 			return hadSyntaxError;
 		}
-		std::shared_ptr<ShaderProgramBlock> Parser::GetShaderProgramBlock() const {
+		bool Parser::HadSemanticError() const {
+			return semanticAnalyzer && semanticAnalyzer->HadSemanticError();
+		}
+		const std::vector<SyntaxError>& Parser::GetSyntaxErrors() const {
+			return syntaxErrors;
+		}
+		ShaderProgramBlock* Parser::GetShaderProgramBlock() const {
 			return shaderProgramBlock;
 		}
+		TransUnit* Parser::GetHeaderTransUnit() const {
+			return headerTransUnit;
+		}
 
 		TypeTable* Parser::GetTypeTable() const {
-			return typeTable.get();
+			return typeTable;
 		}
 		ConstantTable* Parser::GetConstantTable() const {
-			return constTable.get();
+			return constTable;
+		}
+
+		void Parser::SetTokenStream(const TokenStream* tokenStream) {
+			this->tokenStream = tokenStream;
+			this->tokenStreamSize = tokenStream ? tokenStream->GetSize() : 0;
+			tokenRing = nullptr;
+			pipelinedTokens = nullptr;
+			tokenWindow = nullptr;
+			tokenLexer = nullptr;
+		}
+		void Parser::Reset(const ParserConfig& parserConfig) {
+			this->parserConfig = parserConfig;
+			current = 0;
+			hadSyntaxError = false;
+			panicking = false;
+			syntaxErrors.clear();
+			assert(parserConfig.typeTable && parserConfig.constTable && "Check if the type and constant tables are provided first!");
+			assert(parserConfig.astArena && "Check if the syntax tree arena is provided first!");
+			assert(parserConfig.errorReporter && "Check if the error reporter is provided first!");
+			semanticAnalyzer = std::make_unique<SemanticAnalyzer>();
+			semanticAnalyzer->SetErrorReporter(parserConfig.errorReporter);
+			typeTable = parserConfig.typeTable;
+			constTable = parserConfig.constTable;
+			astArena = parserConfig.astArena;
+			Fetch();
 		}
 
 		void Parser::InitializeExternalScope() {
 			externalScope = std::make_shared<ExternalScopeEnvironment>();
 			currentScope = externalScope;
 			SetSemanticAnalyzerEnvironmentContext();
+			if (parserConfig.pchDecls) {
+				DeclarePrecompiledDecls();
+			}
+		}
+		// Mirrors what 'DeclarationOrFunctionDefinition' adds to the external scope.
+		void Parser::DeclarePrecompiledDecls() {
+			for (Decl* decl : *parserConfig.pchDecls) {
+				switch (decl->GetKind()) {
+					case DeclKind::STRUCT: {
+						StructDecl* structDecl = static_cast<StructDecl*>(decl);
+						if (!structDecl->IsStructDeclAnonymous()) {
+							externalScope->AddStructDecl(structDecl);
+						}
+						break;
+					}
+					case DeclKind::INTERFACE_BLOCK: externalScope->AddInterfaceBlockDecl(static_cast<InterfaceBlockDecl*>(decl)); break;
+					case DeclKind::FUN: externalScope->AddFunDecl(static_cast<FunDecl*>(decl)); break;
+					case DeclKind::DECL_LIST:
+						for (VarDecl* varDecl : static_cast<DeclList*>(decl)->GetDecls()) {
+							externalScope->AddVarDecl(varDecl);
+						}
+						break;
+					case DeclKind::VAR: externalScope->AddVarDecl(static_cast<VarDecl*>(decl)); break;
+					// Function parameters are never external declarations, qualifier declarations declare nothing.
+					default: break;
+				}
+			}
 		}
 		void Parser::InitVertShaderExternalScopeCtx() {
 			shaderType = ShaderType::VS;
@@ -84,37 +180,37 @@ namespace crayon {
 			if (parserConfig.gpuApiType != GpuApiType::VULKAN) {
 				// - Only when NOT targeting Vulkan.
 				externalScope->AddVarDecl(
-					CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glVertexID_varName));
+					CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glVertexID_varName));
 				externalScope->AddVarDecl(
-					CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glInstanceID_varName));
+					CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glInstanceID_varName));
 			} else {
 				// - Only when targeting Vulkan.
 				externalScope->AddVarDecl(
-					CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glVertexIndex_varName));
+					CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glVertexIndex_varName));
 				externalScope->AddVarDecl(
-					CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glInstanceIndex_varName));
+					CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glInstanceIndex_varName));
 			}
 			// Common declarations.
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glDrawID_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glDrawID_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glBaseVertex_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glBaseVertex_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glBaseInstance_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glBaseInstance_varName));
 			// 2) gl_PerVertex output Interface Block.
-			std::vector<std::shared_ptr<VarDecl>> perVertexFields(4);
-			perVertexFields[0] = CreateNonArrayTypeNonArrayVarDecl(TokenType::VEC4, glPosition_varName);
-			perVertexFields[1] = CreateNonArrayTypeNonArrayVarDecl(TokenType::FLOAT, glPointSize_varName);
+			std::vector<VarDecl*> perVertexFields(4);
+			perVertexFields[0] = CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::VEC4, glPosition_varName);
+			perVertexFields[1] = CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::FLOAT, glPointSize_varName);
 
 			std::vector<ArrayDim> dimensions(1);
 			dimensions[0].dimSize = 1;
 
-			perVertexFields[2] = CreateNonArrayTypeArrayVarDecl(TokenType::FLOAT, glClipDistance_varName, dimensions);
-			perVertexFields[3] = CreateNonArrayTypeArrayVarDecl(TokenType::FLOAT, glCullDistance_varName, dimensions);
+			perVertexFields[2] = CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::FLOAT, glClipDistance_varName, dimensions);
+			perVertexFields[3] = CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::FLOAT, glCullDistance_varName, dimensions);
 
-			std::shared_ptr<InterfaceBlockDecl> glPerVertex = CreateInterfaceBlockDecl(TokenType::OUT,
-				                                                                       glPerVertex_intBlockName,
-				                                                                       perVertexFields);
+			InterfaceBlockDecl* glPerVertex = CreateInterfaceBlockDecl(*astArena, TokenType::OUT,
+			                                                           glPerVertex_intBlockName,
+			                                                           perVertexFields);
 			externalScope->AddInterfaceBlockDecl(glPerVertex);
 		}
 		void Parser::ClearVertShaderExternalScopeCtx() {
@@ -140,41 +236,41 @@ namespace crayon {
 			// The OpenGL Shading Language Specification 4.60.8:
 			// 7.1.5 Fragment Shader Special Variables
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::VEC4, glFragCoord_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::VEC4, glFragCoord_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::BOOL, glFrontFacing_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::BOOL, glFrontFacing_varName));
 
 			std::vector<ArrayDim> dimensions(1);
 			dimensions[0].dimSize = 1;
 
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeArrayVarDecl(TokenType::IN, TokenType::FLOAT, glClipDistance_varName, dimensions));
+				CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::IN, TokenType::FLOAT, glClipDistance_varName, dimensions));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeArrayVarDecl(TokenType::IN, TokenType::FLOAT, glCullDistance_varName, dimensions));
+				CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::IN, TokenType::FLOAT, glCullDistance_varName, dimensions));
 			
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::VEC2, glPointCoord_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::VEC2, glPointCoord_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glPrimitiveID_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glPrimitiveID_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glSampleID_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glSampleID_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::VEC2, glSamplePosition_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::VEC2, glSamplePosition_varName));
 
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeArrayVarDecl(TokenType::IN, TokenType::INT, glSampleMaskIn_varName, dimensions));
+				CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glSampleMaskIn_varName, dimensions));
 
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glLayer_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glLayer_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::INT, glViewportIndex_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::INT, glViewportIndex_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::IN, TokenType::BOOL, glHelperInvocation_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::IN, TokenType::BOOL, glHelperInvocation_varName));
 
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeNonArrayVarDecl(TokenType::OUT, TokenType::FLOAT, glFragDepth_varName));
+				CreateNonArrayTypeNonArrayVarDecl(*astArena, TokenType::OUT, TokenType::FLOAT, glFragDepth_varName));
 			externalScope->AddVarDecl(
-				CreateNonArrayTypeArrayVarDecl(TokenType::OUT, TokenType::INT, glSampleMask_varName, dimensions));
+				CreateNonArrayTypeArrayVarDecl(*astArena, TokenType::OUT, TokenType::INT, glSampleMask_varName, dimensions));
 		}
 		void Parser::ClearFragShaderExternalScopeCtx() {
 			externalScope->RemoveVarDecl(glFragCoord_varName);
@@ -212,8 +308,8 @@ namespace crayon {
 			EnvironmentContext envCtx{};
 			envCtx.externalScope = externalScope.get();
 			envCtx.currentScope = currentScope.get();
-			envCtx.typeTable = typeTable.get();
-			envCtx.constTable = constTable.get();
+			envCtx.typeTable = typeTable;
+			envCtx.constTable = constTable;
 			semanticAnalyzer->SetEnvironmentContext(envCtx);
 		}
 
@@ -223,51 +319,58 @@ namespace crayon {
 			// 
 			// }
 			InitializeExternalScope();
-			try {
-				Consume(TokenType::SHADER_PROGRAM_KW, "Expected a 'ShaderProgram' block!");
+			// The steps stop at the first error, which is handled below.
+			Consume(TokenType::SHADER_PROGRAM_KW, "Expected a 'ShaderProgram' block!");
+			if (!panicking) {
 				if (Match(TokenType::STRING)) {
 					// Use the user-defined name.
-					const Token* shaderProgramName = Previous();
-					shaderProgramBlock = std::make_shared<ShaderProgramBlock>(*shaderProgramName);
+					Token shaderProgramName = Previous();
+					shaderProgramBlock = astArena->New<ShaderProgramBlock>(shaderProgramName);
 				} else {
 					// There's no user-defined name, use the name of the asset file instead. (set it later?)
-					shaderProgramBlock = std::make_shared<ShaderProgramBlock>();
+					shaderProgramBlock = astArena->New<ShaderProgramBlock>();
 				}
 				Consume(TokenType::LEFT_BRACE, "The '{' character starting the 'ShaderProgram' block is expected!");
+			}
+			if (!panicking) {
 				RenderingPipeline();
+			}
+			if (!panicking) {
 				Consume(TokenType::RIGHT_BRACE, "The '}' character ending the 'ShaderProgram' block is expected!");
-			} catch (SyntaxError& se) {
+			}
+			if (panicking) {
 				// Synchronize.
-				hadSyntaxError = true;
-				std::cerr << se.what() << std::endl;
-				if (se.GetExpectedTokenType() != TokenType::RIGHT_BRACE) {
+				panicking = false;
+				if (syntaxErrors.back().GetExpectedTokenType() != TokenType::RIGHT_BRACE) {
 					SynchronizeBlock();
 				}
 			}
 		}
 		void Parser::RenderingPipeline() {
-			if (IsGraphicsPipeline(Peek()->tokenType)) {
+			if (IsGraphicsPipeline(PeekType())) {
 				GraphicsPipeline();
-			} else if (IsComputePipeline(Peek()->tokenType)) {
-				throw SyntaxError(*Peek(), "Compute pipeline is not supported yet!");
-			} else if (IsRayTracingPipeline(Peek()->tokenType)) {
-				throw SyntaxError(*Peek(), "Ray Tracing pipeline is not supported yet!");
+			} else if (IsComputePipeline(PeekType())) {
+				Error(Peek(), "Compute pipeline is not supported yet!");
+			} else if (IsRayTracingPipeline(PeekType())) {
+				Error(Peek(), "Ray Tracing pipeline is not supported yet!");
 			} else {
-				throw SyntaxError(*Peek(), "Unknown rendering pipeline!");
+				Error(Peek(), "Unknown rendering pipeline!");
 			}
 		}
 		void Parser::GraphicsPipeline() {
-			const Token* block = Peek();
-			if (block->tokenType == TokenType::FIXED_STAGES_CONFIG_KW) {
+			Token block = Peek();
+			if (block.tokenType == TokenType::FIXED_STAGES_CONFIG_KW) {
 				// Parse fixed stages configuration.
-				std::shared_ptr<FixedStagesConfigBlock> fixedStagesConfig = FixedStagesConfiguration();
+				FixedStagesConfigBlock* fixedStagesConfig = FixedStagesConfiguration();
+				if (panicking) return;
 				if (fixedStagesConfig) {
 					shaderProgramBlock->AddBlock(fixedStagesConfig);
 				}
 				GraphicsPipeline();
-			} else if (block->tokenType == TokenType::MATERIAL_PROPERTIES_KW) {
+			} else if (block.tokenType == TokenType::MATERIAL_PROPERTIES_KW) {
 				// Parse material properties.
-				std::shared_ptr<MaterialPropertiesBlock> materialPropertiesBlock = MaterialProperties();
+				MaterialPropertiesBlock* materialPropertiesBlock = MaterialProperties();
+				if (panicking) return;
 				if (materialPropertiesBlock) {
 					// Check whether any of the names of the declarations
 					// collide with built-in GLSL variables from all stages?
@@ -275,27 +378,29 @@ namespace crayon {
 					externalScope->SetMaterialPropertiesBlock(materialPropertiesBlock);
 				}
 				GraphicsPipeline();
-			} else if (block->tokenType == TokenType::VERTEX_INPUT_LAYOUT_KW) {
+			} else if (block.tokenType == TokenType::VERTEX_INPUT_LAYOUT_KW) {
 				// Parse vertex input layout.
 				// Check whether any of the names of the declarations
 				// collide with built-in GLSL variables from all stages?
-				std::shared_ptr<VertexInputLayoutBlock> vertexInputLayoutBlock = VertexInputLayout();
+				VertexInputLayoutBlock* vertexInputLayoutBlock = VertexInputLayout();
+				if (panicking) return;
 				if (vertexInputLayoutBlock) {
 					shaderProgramBlock->AddBlock(vertexInputLayoutBlock);
 					externalScope->SetVertexInputLayoutBlock(vertexInputLayoutBlock);
 				}
 				GraphicsPipeline();
-			} else if (block->tokenType == TokenType::COLOR_ATTACHMENTS_KW) {
+			} else if (block.tokenType == TokenType::COLOR_ATTACHMENTS_KW) {
 				// Parse color attachments.
 				// Check whether any of the names of the declarations
 				// collide with the built-in GLSL variables from all stages?
-				std::shared_ptr<ColorAttachmentsBlock> colorAttachmentsBlock = ColorAttachments();
+				ColorAttachmentsBlock* colorAttachmentsBlock = ColorAttachments();
+				if (panicking) return;
 				if (colorAttachmentsBlock) {
 					shaderProgramBlock->AddBlock(colorAttachmentsBlock);
 					externalScope->SetColorAttachmentsBlock(colorAttachmentsBlock);
 				}
 				GraphicsPipeline();
-			} else /* if (block->tokenType == TokenType::VS_KW) */ {
+			} else /* if (block.tokenType == TokenType::VS_KW) */ {
 				// Parse vertex shader.
 				// try .. catch .. Vertex Shader expected?
 				VertexShader();
@@ -308,121 +413,153 @@ namespace crayon {
 			// TODO
 		}
 
-		std::shared_ptr<FixedStagesConfigBlock> Parser::FixedStagesConfiguration() {
+		FixedStagesConfigBlock* Parser::FixedStagesConfiguration() {
 			Consume(TokenType::FIXED_STAGES_CONFIG_KW, "Fixed Stages Config block expected!");
+			if (panicking) return nullptr;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return nullptr;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				// Empty block.
-				return std::shared_ptr<FixedStagesConfigBlock>();
+				return nullptr;
 			}
 			// TODO: parse fixed stages config statements.
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
-			return std::shared_ptr<FixedStagesConfigBlock>();
+			return nullptr;
 		}
-		std::shared_ptr<MaterialPropertiesBlock> Parser::MaterialProperties() {
+		MaterialPropertiesBlock* Parser::MaterialProperties() {
 			Consume(TokenType::MATERIAL_PROPERTIES_KW, "Material Properties block expected!");
-			const Token* matPropBlockName = Consume(TokenType::STRING, "Material Properties block must have a name!");
+			if (panicking) return nullptr;
+			Token matPropBlockName = Consume(TokenType::STRING, "Material Properties block must have a name!");
+			if (panicking) return nullptr;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return nullptr;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				// Empty block.
-				throw SyntaxError(*Previous(), "Empty Material Properties block is not allowed!");
-			}
-			if (!IsMaterialPropertyType(Peek()->tokenType) &&
-				Peek()->tokenType != TokenType::LEFT_BRACKET) {
-				throw SyntaxError(*Peek(), "Material property declaration is expected!");
-			}
-			std::shared_ptr<MaterialPropertiesBlock> matPropBlock =
-				std::make_shared<MaterialPropertiesBlock>(*matPropBlockName);
-			while (IsMaterialPropertyType(Peek()->tokenType) ||
-				   Peek()->tokenType == TokenType::LEFT_BRACKET) {
-				std::shared_ptr<MatPropDecl> matPropDecl = MaterialPropertyDeclaration();
+				Error(Previous(), "Empty Material Properties block is not allowed!");
+				return nullptr;
+			}
+			if (!IsMaterialPropertyType(PeekType()) &&
+				PeekType() != TokenType::LEFT_BRACKET) {
+				Error(Peek(), "Material property declaration is expected!");
+				return nullptr;
+			}
+			MaterialPropertiesBlock* matPropBlock =
+				astArena->New<MaterialPropertiesBlock>(matPropBlockName);
+			while (IsMaterialPropertyType(PeekType()) ||
+				   PeekType() == TokenType::LEFT_BRACKET) {
+				MatPropDecl* matPropDecl = MaterialPropertyDeclaration();
+				if (panicking) return nullptr;
 				matPropBlock->AddMatPropDecl(matPropDecl);
 			}
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return nullptr;
 			return matPropBlock;
 		}
-		std::shared_ptr<VertexInputLayoutBlock> Parser::VertexInputLayout() {
+		VertexInputLayoutBlock* Parser::VertexInputLayout() {
 			Consume(TokenType::VERTEX_INPUT_LAYOUT_KW, "Vertex Input Layout block expected!");
+			if (panicking) return nullptr;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return nullptr;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				// Empty block.
-				return std::shared_ptr<VertexInputLayoutBlock>();
+				return nullptr;
 			}
-			std::shared_ptr<VertexInputLayoutBlock> vertexInputLayout = std::make_shared<VertexInputLayoutBlock>();
-			while (IsType(*Peek())) {
+			VertexInputLayoutBlock* vertexInputLayout = astArena->New<VertexInputLayoutBlock>();
+			while (IsType(Peek())) {
 				TypeSpec typeSpec = TypeSpecifier();
-				const Token* name = Consume(TokenType::IDENTIFIER, "Vertex attribute name is expected!");
+				if (panicking) return nullptr;
+				Token name = Consume(TokenType::IDENTIFIER, "Vertex attribute name is expected!");
+				if (panicking) return nullptr;
 				Consume(TokenType::COLON, "The ':' character is expected before the channel identifier!");
-				const Token* channel = Consume(TokenType::IDENTIFIER, "Vertex attribute channel identifier is expected!");
+				if (panicking) return nullptr;
+				Token channel = Consume(TokenType::IDENTIFIER, "Vertex attribute channel identifier is expected!");
+				if (panicking) return nullptr;
 				Consume(TokenType::SEMICOLON, "A semicolon ';' expected after the declaration!");
+				if (panicking) return nullptr;
 
-				std::shared_ptr<VertexAttribDecl> vertexAttribDecl =
-					std::make_shared<VertexAttribDecl>(typeSpec, *name, *channel);
+				VertexAttribDecl* vertexAttribDecl =
+					astArena->New<VertexAttribDecl>(typeSpec, name, channel);
 				if (!semanticAnalyzer->CheckVertexAttribDecl(vertexAttribDecl)) {
 					// TODO: error reporting method for vertex attribute declarations!
 					// errorReporter->ReportVarDeclInitExprTypeMismatch(varDecl);
-					hadSyntaxError;
-					throw std::runtime_error{"Vertex attribute declaration check failed!"};
+					Error(name, "Vertex attribute declaration check failed!");
+					return nullptr;
 				}
 				vertexInputLayout->AddVertexAttribDecl(vertexAttribDecl);
 			}
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return nullptr;
 			return vertexInputLayout;
 		}
-		std::shared_ptr<ColorAttachmentsBlock> Parser::ColorAttachments() {
+		ColorAttachmentsBlock* Parser::ColorAttachments() {
 			Consume(TokenType::COLOR_ATTACHMENTS_KW, "Color Attachments block expected!");
+			if (panicking) return nullptr;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return nullptr;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				// Empty block.
-				return std::shared_ptr<ColorAttachmentsBlock>();
+				return nullptr;
 			}
-			std::shared_ptr<ColorAttachmentsBlock> colorAttachments = std::make_shared<ColorAttachmentsBlock>();
-			while (IsType(*Peek())) {
+			ColorAttachmentsBlock* colorAttachments = astArena->New<ColorAttachmentsBlock>();
+			while (IsType(Peek())) {
 				TypeSpec typeSpec = TypeSpecifier();
-				const Token* name = Consume(TokenType::IDENTIFIER, "Color attachment name is expected!");
+				if (panicking) return nullptr;
+				Token name = Consume(TokenType::IDENTIFIER, "Color attachment name is expected!");
+				if (panicking) return nullptr;
 				Consume(TokenType::COLON, "The ':' character is expected before the channel identifier!");
-				const Token* channel = Consume(TokenType::IDENTIFIER, "Color attachment channel identifier is expected!");
+				if (panicking) return nullptr;
+				Token channel = Consume(TokenType::IDENTIFIER, "Color attachment channel identifier is expected!");
+				if (panicking) return nullptr;
 				Consume(TokenType::SEMICOLON, "A semicolon ';' expected after the declaration!");
+				if (panicking) return nullptr;
 
-				std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl =
-					std::make_shared<ColorAttachmentDecl>(typeSpec, *name, *channel);
+				ColorAttachmentDecl* colorAttachmentDecl =
+					astArena->New<ColorAttachmentDecl>(typeSpec, name, channel);
 				if (!semanticAnalyzer->CheckColorAttachmentDecl(colorAttachmentDecl)) {
 					// TODO: error reporting method for vertex attribute declarations!
 					// errorReporter->ReportVarDeclInitExprTypeMismatch(varDecl);
-					hadSyntaxError;
-					throw std::runtime_error{"Color attachment declaration check failed!"};
+					Error(name, "Color attachment declaration check failed!");
+					return nullptr;
 				}
 				colorAttachments->AddColorAttachmentDecl(colorAttachmentDecl);
 			}
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return nullptr;
 			return colorAttachments;
 		}
 
-		std::shared_ptr<MatPropDecl> Parser::MaterialPropertyDeclaration() {
+		MatPropDecl* Parser::MaterialPropertyDeclaration() {
 			// TODO: declare material property attribute object?
 			if (Match(TokenType::LEFT_BRACKET)) {
 				// TODO: parse material property attributes
 			}
-			const Token* matPropType = Advance();
-			const Token* matPropName = Consume(TokenType::IDENTIFIER, "Material property name is expected!");
+			Token matPropType = Advance();
+			Token matPropName = Consume(TokenType::IDENTIFIER, "Material property name is expected!");
+			if (panicking) return nullptr;
 			Consume(TokenType::SEMICOLON, "Material property declaration must end with a semicolon ';'!");
-			std::shared_ptr<MatPropDecl> matPropDecl = std::make_shared<MatPropDecl>(*matPropType, *matPropName);
+			if (panicking) return nullptr;
+			MatPropDecl* matPropDecl = astArena->New<MatPropDecl>(matPropType, matPropName);
 			return matPropDecl;
 		}
 
 		void Parser::VertexShader() {
 			Consume(TokenType::VS_KW, "Vertex Shader block expected!");
+			if (panicking) return;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return;
 			if (Match(TokenType::RIGHT_BRACE)) {
-				throw SyntaxError(*Previous(), "Empty Vertex Shader block is not allowed!");
+				Error(Previous(), "Empty Vertex Shader block is not allowed!");
+				return;
 			}
 			InitVertShaderExternalScopeCtx();
-			std::shared_ptr<TransUnit> transUnit = TranslationUnit();
-			std::shared_ptr<ShaderBlock> vertexShaderBlock = std::make_shared<ShaderBlock>(transUnit, ShaderType::VS);
+			TransUnit* transUnit = TranslationUnit();
+			if (panicking) return;
+			ShaderBlock* vertexShaderBlock = astArena->New<ShaderBlock>(transUnit, ShaderType::VS);
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return;
 			shaderProgramBlock->AddBlock(vertexShaderBlock);
 			ClearVertShaderExternalScopeCtx();
-			if (Peek()->tokenType >= TokenType::TCS_KW && Peek()->tokenType <= TokenType::FS_KW) {
+			if (PeekType() >= TokenType::TCS_KW && PeekType() <= TokenType::FS_KW) {
 				// 1. Vertex shader and something else.
 				//    (2nd production of the vertex_shader nonterminal in the extended grammar)
 				TessellationShader();
@@ -433,127 +570,151 @@ namespace crayon {
 			}
 		}
 		void Parser::TessellationShader() {
-			if (Peek()->tokenType == TokenType::TCS_KW) {
+			if (PeekType() == TokenType::TCS_KW) {
 				// 1. Parse Tessellation Control shader.
 				TessellationControlShader();
+				if (panicking) return;
 			}
-			if (Peek()->tokenType == TokenType::TES_KW) {
+			if (PeekType() == TokenType::TES_KW) {
 				// 2. Parse Tessellation Evaluation shader.
 				TessellationEvaluationShader();
+				if (panicking) return;
 			}
-			if (Peek()->tokenType >= TokenType::GS_KW && Peek()->tokenType <= TokenType::FS_KW) {
+			if (PeekType() >= TokenType::GS_KW && PeekType() <= TokenType::FS_KW) {
 				// 3. Optional tessellation shaders and potential geometry and fragment shaders.
 				GeometryShader();
 			} else {
-				throw SyntaxError(*Peek(), "Unexpected 'tessellation-shader' production encountered!");
+				Error(Peek(), "Unexpected 'tessellation-shader' production encountered!");
 			}
 		}
 		void Parser::TessellationControlShader() {
 			Consume(TokenType::TCS_KW, "Tessellation Control Shader block expected!");
+			if (panicking) return;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				return;
 			}
-			std::shared_ptr<TransUnit> transUnit = TranslationUnit();
-			std::shared_ptr<ShaderBlock> tcsShaderBlock = std::make_shared<ShaderBlock>(transUnit, ShaderType::TCS);
+			TransUnit* transUnit = TranslationUnit();
+			if (panicking) return;
+			ShaderBlock* tcsShaderBlock = astArena->New<ShaderBlock>(transUnit, ShaderType::TCS);
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return;
 			shaderProgramBlock->AddBlock(tcsShaderBlock);
 		}
 		void Parser::TessellationEvaluationShader() {
 			Consume(TokenType::TES_KW, "Tessellation Evaluation Shader block expected!");
+			if (panicking) return;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				return;
 			}
-			std::shared_ptr<TransUnit> transUnit = TranslationUnit();
-			std::shared_ptr<ShaderBlock> tesShaderBlock = std::make_shared<ShaderBlock>(transUnit, ShaderType::TES);
+			TransUnit* transUnit = TranslationUnit();
+			if (panicking) return;
+			ShaderBlock* tesShaderBlock = astArena->New<ShaderBlock>(transUnit, ShaderType::TES);
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return;
 			shaderProgramBlock->AddBlock(tesShaderBlock);
 		}
 		void Parser::GeometryShader() {
-			if (Peek()->tokenType == TokenType::GS_KW) {
+			if (PeekType() == TokenType::GS_KW) {
 				// 1. Parse Geometry shader.
 				Consume(TokenType::GS_KW, "Geometry Shader block expected!");
+				if (panicking) return;
 				Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+				if (panicking) return;
 				if (Match(TokenType::RIGHT_BRACE)) {
 					// TODO?
 				} else {
-					std::shared_ptr<TransUnit> transUnit = TranslationUnit();
-					std::shared_ptr<ShaderBlock> gsShaderBlock = std::make_shared<ShaderBlock>(transUnit, ShaderType::GS);
+					TransUnit* transUnit = TranslationUnit();
+					if (panicking) return;
+					ShaderBlock* gsShaderBlock = astArena->New<ShaderBlock>(transUnit, ShaderType::GS);
 					Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+					if (panicking) return;
 					shaderProgramBlock->AddBlock(gsShaderBlock);
 				}
 			}
-			if (Peek()->tokenType == TokenType::FS_KW) {
+			if (PeekType() == TokenType::FS_KW) {
 				// 2. Parse Fragment shader.
 				FragmentShader();
 			} else {
-				throw SyntaxError(*Peek(), "Unexpected 'geometry-shader' production encountered!");
+				Error(Peek(), "Unexpected 'geometry-shader' production encountered!");
 			}
 		}
 		void Parser::FragmentShader() {
 			Consume(TokenType::FS_KW, "Fragment Shader block expected!");
+			if (panicking) return;
 			Consume(TokenType::LEFT_BRACE, "Openning brace '{' expected!");
+			if (panicking) return;
 			if (Match(TokenType::RIGHT_BRACE)) {
 				return;
 			}
 			InitFragShaderExternalScopeCtx();
-			std::shared_ptr<TransUnit> transUnit = TranslationUnit();
-			std::shared_ptr<ShaderBlock> fsShaderBlock = std::make_shared<ShaderBlock>(transUnit, ShaderType::FS);
+			TransUnit* transUnit = TranslationUnit();
+			if (panicking) return;
+			ShaderBlock* fsShaderBlock = astArena->New<ShaderBlock>(transUnit, ShaderType::FS);
 			Consume(TokenType::RIGHT_BRACE, "Closing brace '}' expected!");
+			if (panicking) return;
 			ClearFragShaderExternalScopeCtx();
 			shaderProgramBlock->AddBlock(fsShaderBlock);
 		}
 
-		std::shared_ptr<TransUnit> Parser::TranslationUnit() {
+		TransUnit* Parser::TranslationUnit() {
 			Consume(TokenType::BEGIN, "Expected 'BEGIN' to start the translation unit!");
+			if (panicking) return nullptr;
 			// InitializeExternalScope();
-			std::shared_ptr<TransUnit> transUnit = std::make_shared<TransUnit>();
-			// while (!AtEnd()) {
-			while (Peek()->tokenType != TokenType::END) {
-				std::shared_ptr<Decl> decl = ExternalDeclaration();
+			TransUnit* transUnit = astArena->New<TransUnit>();
+			if (parserConfig.pchDecls) {
+				for (Decl* decl : *parserConfig.pchDecls) {
+					transUnit->AddDeclaration(decl);
+				}
+			}
+			// A missing 'END' is reported by 'Consume' once the tokens run out.
+			while (PeekType() != TokenType::END && !AtEnd()) {
+				Decl* decl = ExternalDeclaration();
 				if (decl) transUnit->AddDeclaration(decl);
 			}
 			Consume(TokenType::END, "Expected 'END' to end the translation unit!");
+			if (panicking) return nullptr;
 			return transUnit;
 		}
 
-		std::shared_ptr<Decl> Parser::ExternalDeclaration() {
+		Decl* Parser::ExternalDeclaration() {
 			while (!AtEnd()) {
-				try {
-					// Parse external declaration.
-					// 1. A single semicolon, ignore it.
-					if (Match(TokenType::SEMICOLON)) {
-						return std::shared_ptr<Decl>{};
-					}
-					// 2. Declaration or function definition.
-					return DeclarationOrFunctionDefinition(DeclContext::EXTERNAL);
-				} catch (SyntaxError& se) {
-					// Synchronize.
-					hadSyntaxError = true;
-					std::cerr << se.what() << std::endl;
-					if (se.GetExpectedTokenType() != TokenType::SEMICOLON) {
-						SynchronizeStmt();
-					}
+				// Parse external declaration.
+				// 1. A single semicolon, ignore it.
+				if (Match(TokenType::SEMICOLON)) {
+					return nullptr;
+				}
+				// 2. Declaration or function definition.
+				Decl* decl = DeclarationOrFunctionDefinition(DeclContext::EXTERNAL);
+				if (!panicking) {
+					return decl;
+				}
+				// Synchronize.
+				panicking = false;
+				if (syntaxErrors.back().GetExpectedTokenType() != TokenType::SEMICOLON) {
+					SynchronizeStmt();
 				}
 			}
-			return std::shared_ptr<Decl>();
+			return nullptr;
 		}
-		std::shared_ptr<Decl> Parser::DeclarationOrFunctionDefinition(DeclContext declContext) {
+		Decl* Parser::DeclarationOrFunctionDefinition(DeclContext declContext) {
 			FullSpecType fullSpecType{};
 			// 1. Type qualifiers or type qualifier declarations.
-			if (IsQualifier(Peek()->tokenType)) {
+			if (IsQualifier(PeekType())) {
 				// Parse type qualifiers.
 				if (Match(TokenType::PRECISE)) {
 					// 1. Could be a precision statement (which is parsed in 'declaration')
 					//    Example: precise lowp float;
-					fullSpecType.qualifier.precise = *Previous();
-					if (IsPrecisionQualifier(Peek()->tokenType)) {
-						fullSpecType.qualifier.precision = *Advance();
-						const Token* token = Peek();
-						if (token->tokenType == TokenType::FLOAT ||
-							token->tokenType == TokenType::INT ||
-							IsTypeOpaque(token->tokenType)) {
+					fullSpecType.qualifier.precise = Previous();
+					if (IsPrecisionQualifier(PeekType())) {
+						fullSpecType.qualifier.precision = Advance();
+						Token token = Peek();
+						if (token.tokenType == TokenType::FLOAT ||
+							token.tokenType == TokenType::INT ||
+							IsTypeOpaque(token.tokenType)) {
 							// At this point we've parsed precision qualifiers
 							// and a valid type specifier. To be 100% sure that this
 							// a default precision qualifier statement
@@ -565,8 +726,11 @@ namespace crayon {
 							// to parse the type is because this should improve our
 							// error reporting if the type had an array specifier, for example.
 							fullSpecType.specifier = TypeSpecifier();
+							if (panicking) return nullptr;
 							if (fullSpecType.specifier.IsArray()) {
-								throw std::runtime_error{"Default Precision Qualifier statement is not allowed for array types!"};
+								Error(fullSpecType.specifier.type,
+								      "Default Precision Qualifier statement is not allowed for array types!");
+								return nullptr;
 							}
 							// if (Match(TokenType::COMMA)) {
 								// [TODO]: return a new parse statement declaration?
@@ -585,6 +749,7 @@ namespace crayon {
 				} else {
 					fullSpecType.qualifier = TypeQualifier();
 				}
+				if (panicking) return nullptr;
 
 				// At this point only qualifiers have been consumed.
 				// We could've either stopped at a type token or a semicolon.
@@ -598,8 +763,8 @@ namespace crayon {
 				// (Default Precision Qualifiers were handled before).
 				if (Match(TokenType::SEMICOLON)) {
 					// 1.2 Qualifier declaration
-					std::shared_ptr<QualDecl> qualDecl =
-						std::make_shared<QualDecl>(fullSpecType.qualifier);
+					QualDecl* qualDecl =
+						astArena->New<QualDecl>(fullSpecType.qualifier);
 					return qualDecl;
 				}
 			}
@@ -611,45 +776,44 @@ namespace crayon {
 			// be followed by identifiers, not necessarily types. This is the case with
 			// interface blocks. Otherwise, we try to match a type token before moving forward.
 			// 2. Interface blocks.
-			if (Peek()->tokenType == TokenType::IDENTIFIER) {
-				const Token* interfaceBlockName = Advance();
+			if (PeekType() == TokenType::IDENTIFIER) {
+				Token interfaceBlockName = Advance();
 				// Interface blocks are only allowed in the external scope!
 				if (declContext != DeclContext::EXTERNAL) {
-					throw SyntaxError{
-						*interfaceBlockName,
-						"An interface block declaration is only allowed in the external (global) scope!"
-					};
+					Error(interfaceBlockName, "An interface block declaration is only allowed in the external (global) scope!");
+					return nullptr;
 				}
 				// 1st Check: storage qualifiers. Must be one of:
 				// "in", "out", "uniform", or "buffer".
 				if (!fullSpecType.qualifier.storage.has_value()) {
-					throw SyntaxError{
-						*interfaceBlockName,
-						"An interface block declaration must have a storage qualifier!"
-					};
+					Error(interfaceBlockName, "An interface block declaration must have a storage qualifier!");
+					return nullptr;
 				}
 				TokenType storageQual = fullSpecType.qualifier.storage.value().tokenType;
 				if (storageQual != TokenType::IN &&
 					storageQual != TokenType::OUT &&
 					storageQual != TokenType::UNIFORM &&
 					storageQual != TokenType::BUFFER) {
-					throw SyntaxError{
-						*interfaceBlockName,
-						"An interface block declaration must have an IN, OUT, UNIFORM, or BUFFER storage qualifier!"
-					};
+					Error(interfaceBlockName,
+					      "An interface block declaration must have an IN, OUT, UNIFORM, or BUFFER storage qualifier!");
+					return nullptr;
 				}
 				// TODO: add more checks according to the specification!
 				// Parse interface block fields.
 				Consume(TokenType::LEFT_BRACE, "Interface block field declarations must start with a '{'!");
-				std::shared_ptr<InterfaceBlockDecl> interfaceBlockDecl =
-					std::make_shared<InterfaceBlockDecl>(*interfaceBlockName, fullSpecType.qualifier);
-				while (Peek()->tokenType != TokenType::RIGHT_BRACE) {
-					std::shared_ptr<VarDecl> fieldDecl = StructFieldDecl();
+				if (panicking) return nullptr;
+				InterfaceBlockDecl* interfaceBlockDecl =
+					astArena->New<InterfaceBlockDecl>(interfaceBlockName, fullSpecType.qualifier);
+				while (PeekType() != TokenType::RIGHT_BRACE) {
+					VarDecl* fieldDecl = StructFieldDecl();
+					if (panicking) return nullptr;
 					interfaceBlockDecl->AddField(fieldDecl);
 					Consume(TokenType::SEMICOLON, "Missing ';' after a struct field declaration!");
+					if (panicking) return nullptr;
 				}
 				externalScope->AddInterfaceBlockDecl(interfaceBlockDecl);
 				Consume(TokenType::RIGHT_BRACE, "Matching '}' at the end of the interface block declaration is not found!");
+				if (panicking) return nullptr;
 				return interfaceBlockDecl;
 			}
 			// 3. Other declarations: variable and function declarations (function definitions included).
@@ -658,12 +822,14 @@ namespace crayon {
 			//     Variables of user-defined types (structs) are parsed later.
 			//     The struct declaration (named or anonymous), if it's declared together with the variables,
 			//     is going to be attached to the 'fullSpectype.specifier' instance ('typeDecl' field).
-			if (IsType(*Peek())) {
+			if (IsType(Peek())) {
 				fullSpecType.specifier = TypeSpecifier();
+				if (panicking) return nullptr;
 				// TODO: add struct declaration to the external scope here!
 				// Check if the structure declaration is well-formed here too!
 			} else {
-				throw SyntaxError{*Peek(), "Type specifier expected in a declaration!"};
+				Error(Peek(), "Type specifier expected in a declaration!");
+				return nullptr;
 			}
 			// a) Type qualifiers that end with a semicolon were handled before.
 			// b) Single type specifier followed by a semicolon is valid according to the grammar:
@@ -679,18 +845,17 @@ namespace crayon {
 			if (Match(TokenType::SEMICOLON)) {
 				// We can declare structures only in the external (global) scope.
 				if (declContext != DeclContext::EXTERNAL) {
-					throw SyntaxError{
-						// TODO:
-						// The 'type' field can be empty if the structure is anonymous.
-						// Need to find a way to properly report such structure declarations
-						// in nested scopes.
-						fullSpecType.specifier.type,
-						"A struct declaration is only allowed in the external (global) scope!"
-					};
+					// TODO:
+					// The 'type' field can be empty if the structure is anonymous.
+					// Need to find a way to properly report such structure declarations
+					// in nested scopes.
+					Error(fullSpecType.specifier.type, "A struct declaration is only allowed in the external (global) scope!");
+					return nullptr;
 				}
 				// Not a struct declaration. We don't expect that, so report a syntax error.
 				if (!fullSpecType.specifier.typeDecl) {
-					throw std::runtime_error{"Invalid declaration!"};
+					Error(Previous(), "Invalid declaration!");
+					return nullptr;
 				}
 				if (!fullSpecType.specifier.typeDecl->IsStructDeclAnonymous()) {
 					externalScope->AddStructDecl(fullSpecType.specifier.typeDecl);
@@ -701,20 +866,22 @@ namespace crayon {
 			// (Optional type qualifiers and a type specifier).
 			// We continue on since the next token wasn't a semicolon.
 			// The only token allowed at this step is an identifier.
-			const Token* identifier = Consume(TokenType::IDENTIFIER, "Expected an identifier in a declaration!");
-			const Token* peek = Peek();
+			Token identifier = Consume(TokenType::IDENTIFIER, "Expected an identifier in a declaration!");
+			if (panicking) return nullptr;
+			Token peek = Peek();
 			// 4. Variable declaration or variable declaration list.
-			if (peek->tokenType == TokenType::LEFT_BRACKET || peek->tokenType == TokenType::EQUAL ||
-				peek->tokenType == TokenType::COMMA || peek->tokenType == TokenType::SEMICOLON) {
+			if (peek.tokenType == TokenType::LEFT_BRACKET || peek.tokenType == TokenType::EQUAL ||
+				peek.tokenType == TokenType::COMMA || peek.tokenType == TokenType::SEMICOLON) {
 				// Create a variable declaration upfront.
 				// We'll either return it alone, or as part of a declaration list.
-				std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, *identifier);
+				VarDecl* varDecl = astArena->New<VarDecl>(fullSpecType, identifier);
 				ParseVarDeclRest(varDecl);
+				if (panicking) return nullptr;
 				// Are we done (SEMICOLON)? Or is it a declaration list (COMMA)?
 				if (Match(TokenType::SEMICOLON)) {
 					// 4.1 Single variable declaration
-					if (!semanticAnalyzer->CheckVarDecl(varDecl.get(), declContext, shaderType)) {
-						std::cout << "Var. decl. type check failed!\n";
+					if (!semanticAnalyzer->CheckVarDecl(varDecl, declContext, shaderType)) {
+						parserConfig.errorReporter->ReportError("Var. decl. type check failed!");
 						hadSyntaxError;
 					}
 					// If the check fails, should we still add the variable to the environment?
@@ -722,126 +889,146 @@ namespace crayon {
 					return varDecl;
 				} else if (Match(TokenType::COMMA)) {
 					// 4.2 Declaration list.
-					std::shared_ptr<DeclList> declList = std::make_shared<DeclList>(fullSpecType);
+					DeclList* declList = astArena->New<DeclList>(fullSpecType);
 					currentScope->AddVarDecl(varDecl);
 					declList->AddDecl(varDecl);
 					// Starting after the COMMA.
 					do {
 						// Parse the rest of the list.
-						const Token* identifier = Consume(TokenType::IDENTIFIER, "Expected an identifier in a declaration!");
-						std::shared_ptr<VarDecl> varDecl = std::make_shared<VarDecl>(fullSpecType, *identifier);
+						Token identifier = Consume(TokenType::IDENTIFIER, "Expected an identifier in a declaration!");
+						if (panicking) return nullptr;
+						VarDecl* varDecl = astArena->New<VarDecl>(fullSpecType, identifier);
 						ParseVarDeclRest(varDecl);
+						if (panicking) return nullptr;
 						currentScope->AddVarDecl(varDecl);
 						// Type check.
-						if (!semanticAnalyzer->CheckVarDecl(varDecl.get(), declContext, shaderType)) {
-							std::cout << "Var. decl. type check failed!\n";
+						if (!semanticAnalyzer->CheckVarDecl(varDecl, declContext, shaderType)) {
+							parserConfig.errorReporter->ReportError("Var. decl. type check failed!");
 							hadSyntaxError;
 						}
 						declList->AddDecl(varDecl);
 					} while (Match(TokenType::COMMA));
 					Consume(TokenType::SEMICOLON, "Declaration list must end with a semicolon!");
+					if (panicking) return nullptr;
 					return declList;
 				}
 			}
 			// 5. Function declaration or function defintion
 			if (Match(TokenType::LEFT_PAREN)) {
 				if (declContext != DeclContext::EXTERNAL) {
-					throw std::runtime_error{
-						"Function declarations and function definitions are only allowed in the external (global) scope!"
-					};
+					Error(identifier, "Function declarations and function definitions are only allowed in the external (global) scope!");
+					return nullptr;
 				}
-				std::shared_ptr<FunProto> funProto = FunctionPrototype(fullSpecType, *identifier);
+				FunProto* funProto = FunctionPrototype(fullSpecType, identifier);
+				if (panicking) return nullptr;
 				if (Match(TokenType::SEMICOLON)) {
 					// 5.1 Function declaration.
-					std::shared_ptr<FunDecl> funDecl = std::make_shared<FunDecl>(funProto);
+					FunDecl* funDecl = astArena->New<FunDecl>(funProto);
 					externalScope->AddFunDecl(funDecl);
 					return funDecl;
-				} else if (Peek()->tokenType == TokenType::LEFT_BRACE) {
+				} else if (PeekType() == TokenType::LEFT_BRACE) {
 					// 5.2 Function definition
-					std::shared_ptr<BlockStmt> stmts = BlockStatement();
-					std::shared_ptr<FunDecl> funDef = std::make_shared<FunDecl>(funProto, stmts);
+					BlockStmt* stmts = BlockStatement();
+					if (panicking) return nullptr;
+					FunDecl* funDef = astArena->New<FunDecl>(funProto, stmts);
 					externalScope->AddFunDecl(funDef);
 					return funDef;
 				} else {
-					throw std::runtime_error{"[Fun. decl.] Invalid function declaration!"};
+					Error(Peek(), "[Fun. decl.] Invalid function declaration!");
+					return nullptr;
 				}
 			}
-			// If none of the above, throw a syntax error: "Expected a declaration!"
-			// throw std::runtime_error{"Expected a function definition or function declaration!"};
-			// throw std::runtime_error{"Expected a declaration!"};
-			throw SyntaxError{*Peek(), "Invalid declaration syntax!"};
+			// If none of the above, report a syntax error: "Expected a declaration!"
+			Error(Peek(), "Invalid declaration syntax!");
+			return nullptr;
 		}
-		std::shared_ptr<Decl> Parser::Declaration(DeclContext declContext) {
+		Decl* Parser::Declaration(DeclContext declContext) {
             return DeclarationOrFunctionDefinition(declContext);
         }
-		void Parser::ParseVarDeclRest(std::shared_ptr<VarDecl> varDecl) {
+		void Parser::ParseVarDeclRest(VarDecl* varDecl) {
 			// Optional parts of a variable declaration:
 			// Array specifier?
-			if (Peek()->tokenType == TokenType::LEFT_BRACKET) {
-				for (const ArrayDim& dimension : ArraySpecifier()) {
+			if (PeekType() == TokenType::LEFT_BRACKET) {
+				std::vector<ArrayDim> dimensions = ArraySpecifier();
+				if (panicking) return;
+				for (const ArrayDim& dimension : dimensions) {
 					varDecl->AddDimension(dimension);
 				}
 			}
 			// Initializer?
 			if (Match(TokenType::EQUAL)) {
-				const Token* equal = Previous();
-				std::shared_ptr<Expr> initializer = Initializer();
+				Expr* initializer = Initializer();
+				if (panicking) return;
 				varDecl->SetInitializerExpr(initializer);
 			}
 		}
-		std::shared_ptr<StructDecl> Parser::StructDeclaration() {
+		StructDecl* Parser::StructDeclaration() {
 			Consume(TokenType::STRUCT, "A structure declaration must start with the 'struct' keyword!");
-			std::shared_ptr<StructDecl> structDecl;
+			if (panicking) return nullptr;
+			StructDecl* structDecl{nullptr};
 			if (Match(TokenType::LEFT_BRACE)) {
 				// Unnamed struct.
-				structDecl = std::make_shared<StructDecl>();
-			} else if (Peek()->tokenType == TokenType::IDENTIFIER) {
+				structDecl = astArena->New<StructDecl>();
+			} else if (PeekType() == TokenType::IDENTIFIER) {
 				// New struct with a name. Don't forget to add it to the environment.
-				const Token* structId = Advance();
-				structDecl = std::make_shared<StructDecl>(*structId);
+				Token structId = Advance();
+				structDecl = astArena->New<StructDecl>(structId);
 			} else {
-				throw std::runtime_error{"Invalid struct declaration! Struct name or '{' is expected!"};
+				Error(Peek(), "Invalid struct declaration! Struct name or '{' is expected!");
+				return nullptr;
 			}
 			Consume(TokenType::LEFT_BRACE, "Struct field declarations must start with a '{'!");
-			while (Peek()->tokenType != TokenType::RIGHT_BRACE) {
-				std::shared_ptr<VarDecl> fieldDecl = StructFieldDecl();
+			if (panicking) return nullptr;
+			while (PeekType() != TokenType::RIGHT_BRACE) {
+				VarDecl* fieldDecl = StructFieldDecl();
+				if (panicking) return nullptr;
 				structDecl->AddField(fieldDecl);
 				Consume(TokenType::SEMICOLON, "Missing ';' after a struct field declaration!");
+				if (panicking) return nullptr;
 			}
 			Consume(TokenType::RIGHT_BRACE, "Matching '}' at the end of the struct declaration is not found!");
+			if (panicking) return nullptr;
 			return structDecl;
 		}
-		std::shared_ptr<VarDecl> Parser::StructFieldDecl() {
+		VarDecl* Parser::StructFieldDecl() {
 			FullSpecType fullSpecType = FullySpecifiedType();
-			const Token* identifier =
+			if (panicking) return nullptr;
+			Token identifier =
 				Consume(TokenType::IDENTIFIER, "Anonymous struct members aren't supported!");
-			std::shared_ptr<VarDecl> fieldDecl =
-				std::make_shared<VarDecl>(fullSpecType, *identifier);
-			if (Peek()->tokenType == TokenType::LEFT_BRACKET) {
-				for (const ArrayDim& dimension : ArraySpecifier()) {
+			if (panicking) return nullptr;
+			VarDecl* fieldDecl =
+				astArena->New<VarDecl>(fullSpecType, identifier);
+			if (PeekType() == TokenType::LEFT_BRACKET) {
+				std::vector<ArrayDim> dimensions = ArraySpecifier();
+				if (panicking) return nullptr;
+				for (const ArrayDim& dimension : dimensions) {
 					fieldDecl->AddDimension(dimension);
 				}
 			}
 			return fieldDecl;
 		}
 
-		std::shared_ptr<FunProto> Parser::FunctionPrototype(const FullSpecType& fullSpecType, const Token& identifier) {
-			std::shared_ptr<FunProto> funProto = std::make_shared<FunProto>(fullSpecType, identifier);
+		FunProto* Parser::FunctionPrototype(const FullSpecType& fullSpecType, const Token& identifier) {
+			FunProto* funProto = astArena->New<FunProto>(fullSpecType, identifier);
 			FunctionParameterList(funProto);
+			if (panicking) return nullptr;
 			Consume(TokenType::RIGHT_PAREN, "Unterminated function parameter list!");
+			if (panicking) return nullptr;
 			return funProto;
 		}
 		// Parse optional function declaration or function definition parameters.
-		void Parser::FunctionParameterList(std::shared_ptr<FunProto> funProto) {
+		void Parser::FunctionParameterList(FunProto* funProto) {
 			// 1. No parameters
-			if (Peek()->tokenType == TokenType::RIGHT_PAREN) {
+			if (PeekType() == TokenType::RIGHT_PAREN) {
 				return;
 			}
 			// 2. One or more parameters
-			std::shared_ptr<FunParam> param = FunctionParameter();
+			FunParam* param = FunctionParameter();
+			if (panicking) return;
 			funProto->AddFunParam(param);
 			while (Match(TokenType::COMMA)) {
 				param = FunctionParameter();
+				if (panicking) return;
 				funProto->AddFunParam(param);
 			}
 		}
@@ -862,7 +1049,7 @@ namespace crayon {
 		// 
 		// parameter_type_specifier:
 		//     type_specifier
-		std::shared_ptr<FunParam> Parser::FunctionParameter() {
+		FunParam* Parser::FunctionParameter() {
 			// Reusing the FullySpecifiedType function here,
 			// even though that's in violation of the grammar.
 			// I'm not quite sure why they decided to reuse type_qualifier and type_specifier
@@ -874,33 +1061,29 @@ namespace crayon {
 			// why the grammar designers went with the productions (that) they did.
 			/*
 			FullSpecType fullSpecType{};
-			if (IsQualifier(Peek()->tokenType)) {
+			if (IsQualifier(PeekType())) {
 				fullSpecType.qualifier = TypeQualifier();
 			}
-			if (IsType(Peek()->tokenType)) {
+			if (IsType(PeekType())) {
 				fullSpecType.specifier = TypeSpecifier();
 			} else {
 				// throw std::runtime_error{ "Type specifier of a function parameter expected!" };
 				throw std::runtime_error{ "A function parameter must have a type specifier!" };
 			}
 			*/
-			FullSpecType fullSpecType{};
-			try {
-				fullSpecType = FullySpecifiedType();
-			} catch (const SyntaxError& se) {
-				// We can improve error reporting by catching a syntax error here and adding more information
-				// give the context we're in (function parameter declaration).
-				// std::string_view errMsg{"An invalid function parameter declaration!"};
-				throw se;
-			}
+			// We can improve error reporting by adding more information to a syntax error here,
+			// given the context we're in (function parameter declaration).
+			// std::string_view errMsg{"An invalid function parameter declaration!"};
+			FullSpecType fullSpecType = FullySpecifiedType();
+			if (panicking) return nullptr;
 			// Both function declarations and function definitions
 			// can have unnamed parameters.
 			if (Match(TokenType::IDENTIFIER)) {
-				const Token* identifier = Previous();
-				std::shared_ptr<FunParam> funParam = std::make_shared<FunParam>(fullSpecType, *identifier);
+				Token identifier = Previous();
+				FunParam* funParam = astArena->New<FunParam>(fullSpecType, identifier);
 				return funParam;
 			} else {
-				std::shared_ptr<FunParam> funParam = std::make_shared<FunParam>(fullSpecType);
+				FunParam* funParam = astArena->New<FunParam>(fullSpecType);
 				return funParam;
 			}
 		}
@@ -913,46 +1096,50 @@ namespace crayon {
 		// to create a new scope for new function definition?
 		// Until I encounter a use case where this would be important,
 		// the BlockStatement() procedure is used for both nonterminals.
-		std::shared_ptr<BlockStmt> Parser::BlockStatement() {
+		BlockStmt* Parser::BlockStatement() {
 			Consume(TokenType::LEFT_BRACE, "Openning brace at the start of a block statement expected!");
+			if (panicking) return nullptr;
 			EnterNewScope();
-			std::shared_ptr<BlockStmt> stmts = std::make_shared<BlockStmt>();
+			BlockStmt* stmts = astArena->New<BlockStmt>();
 			if (Match(TokenType::RIGHT_BRACE)) {
 				// 1. An empty block.
 				return stmts;
 			}
-			while (Peek()->tokenType != TokenType::RIGHT_BRACE) {
-				std::shared_ptr<Stmt> stmt = Statement();
+			// A missing '}' is reported by 'Consume' once the tokens run out.
+			while (PeekType() != TokenType::RIGHT_BRACE && !AtEnd()) {
+				Stmt* stmt = Statement();
 				// Stmt can be empty if there was a syntax error during parsing.
 				// Synchronization mechanism makes sure we're now standing at the boundary
 				// of the next statement while an empty object is returned instead of the previous statement.
 				if (stmt) stmts->AddStmt(stmt);
 			}
 			Consume(TokenType::RIGHT_BRACE, "Closing brace at the end of a block statement expected!");
+			if (panicking) return nullptr;
 			RestoreEnclosingScope();
 			return stmts;
 		}
-		std::shared_ptr<Stmt> Parser::Statement() {
+		Stmt* Parser::Statement() {
 			while (!AtEnd()) {
-				try {
-					if (Peek()->tokenType == TokenType::LEFT_BRACE) {
-						return BlockStatement();
-					}
-					return SimpleStatement();
-				} catch (SyntaxError& se) {
-					// Synchronize.
-					hadSyntaxError = true;
-					std::cerr << se.what() << std::endl;
-					if (se.GetExpectedTokenType() != TokenType::SEMICOLON) {
-						SynchronizeStmt();
-						// Make sure that after we've reached the next statement, an empty statement is returned.
-						return std::shared_ptr<Stmt>();
-					}
+				Stmt* stmt{nullptr};
+				if (PeekType() == TokenType::LEFT_BRACE) {
+					stmt = BlockStatement();
+				} else {
+					stmt = SimpleStatement();
+				}
+				if (!panicking) {
+					return stmt;
+				}
+				// Synchronize.
+				panicking = false;
+				if (syntaxErrors.back().GetExpectedTokenType() != TokenType::SEMICOLON) {
+					SynchronizeStmt();
+					// Make sure that after we've reached the next statement, an empty statement is returned.
+					return nullptr;
 				}
 			}
-			return std::shared_ptr<Stmt>{};
+			return nullptr;
 		}
-		std::shared_ptr<Stmt> Parser::SimpleStatement() {
+		Stmt* Parser::SimpleStatement() {
 			// 1. First we check whether the current lookahead token
 			//    belongs to any of the terminals from the first sets
 			//    of the following productions:
@@ -965,20 +1152,37 @@ namespace crayon {
 			// 2. Check the current lookahead token to see if it's either
 			//    a type qualifier or a type specifier. If so, then we
 			//    parse a declaration.
-			if (IsDeclaration(*Peek())) {
+			if (IsDeclaration(Peek())) {
 				// 2. It's a declaration statement.
-				std::shared_ptr<Decl> decl = Declaration(DeclContext::BLOCK);
+				Decl* decl = Declaration(DeclContext::BLOCK);
+				if (panicking) return nullptr;
 				// Consume(TokenType::SEMICOLON, "A semicolon expected after a declaration statement!");
-				std::shared_ptr<DeclStmt> declStmt = std::make_shared<DeclStmt>(decl);
+				DeclStmt* declStmt = astArena->New<DeclStmt>(decl);
 				return declStmt;
 			} else {
 				// 3. Otherwise, we parse an expression statement.
-				std::shared_ptr<ExprStmt> exprStmt = std::make_shared<ExprStmt>(Expression());
+				Expr* expr = Expression();
+				if (panicking) return nullptr;
+				ExprStmt* exprStmt = astArena->New<ExprStmt>(expr);
 				Consume(TokenType::SEMICOLON, "A semicolon expected after an expression statement!");
+				if (panicking) return nullptr;
 				return exprStmt;
 			}
 		}
 
+		void Parser::Error(const Token& errToken, std::string_view errMsg) {
+			Error(errToken, TokenType::UNDEFINED, errMsg);
+		}
+		void Parser::Error(const Token& errToken, TokenType expected, std::string_view errMsg) {
+			// Productions return as soon as they see the panic mode, so a second error is a follow-up of the first.
+			if (panicking) {
+				return;
+			}
+			panicking = true;
+			hadSyntaxError = true;
+			syntaxErrors.emplace_back(errToken, expected, errMsg);
+			parserConfig.errorReporter->ReportSyntaxError(syntaxErrors.back());
+		}
 		void Parser::SynchronizeStmt() {
 			// We entered the "panic" mode where we're ensure where exactly we are in the grammar.
 			// We skip over all tokens until we reach something
@@ -987,7 +1191,7 @@ namespace crayon {
 			// begins after a semicolon. Our goal is to match a semicolon,
 			// move the pointer to the next token and return from the function.
 			while (!AtEnd()) {
-				if (Advance()->tokenType == TokenType::SEMICOLON) {
+				if (Advance().tokenType == TokenType::SEMICOLON) {
 					break;
 				}
 			}
@@ -1006,28 +1210,32 @@ namespace crayon {
 		//     'assignment_expression'
 		//     'expression' COMMA 'assignment_expression'
 		// The last production is ignored for now.
-		std::shared_ptr<Expr> Parser::Expression() {
+		Expr* Parser::Expression() {
 			return AssignmentExpression();
 		}
-		std::shared_ptr<Expr> Parser::Initializer() {
+		Expr* Parser::Initializer() {
 			if (Match(TokenType::LEFT_BRACE)) {
 				// Parse an initializer list.
-				std::shared_ptr<Expr> initListExpr = InitializerList();
+				Expr* initListExpr = InitializerList();
+				if (panicking) return nullptr;
 				Match(TokenType::COMMA); // We don't need to do anything special.
 				Consume(TokenType::RIGHT_BRACE, "'}' expected in an initializer!");
+				if (panicking) return nullptr;
 				return initListExpr;
 			} else {
 				// Parse a single initializer expression.
-				std::shared_ptr<Expr> initializerExpr = AssignmentExpression();
+				Expr* initializerExpr = AssignmentExpression();
 				return initializerExpr;
 			}
 		}
-		std::shared_ptr<Expr> Parser::InitializerList() {
-			std::shared_ptr<InitListExpr> initListExpr = std::make_shared<InitListExpr>();
-			std::shared_ptr<Expr> expr = Initializer();
+		Expr* Parser::InitializerList() {
+			InitListExpr* initListExpr = astArena->New<InitListExpr>();
+			Expr* expr = Initializer();
+			if (panicking) return nullptr;
 			initListExpr->AddInitExpr(expr);
-			while (Match(TokenType::COMMA) && Peek()->tokenType != TokenType::RIGHT_BRACE) {
+			while (Match(TokenType::COMMA) && PeekType() != TokenType::RIGHT_BRACE) {
 				expr = Initializer();
+				if (panicking) return nullptr;
 				initListExpr->AddInitExpr(expr);
 			}
 			return initListExpr;
@@ -1036,11 +1244,7 @@ namespace crayon {
 		// 'assignment_expression':
 		//     'conditional_expression'
 		//     'unary_expression' 'assignment_operator' 'assignment_expression'
-		// Currently, there are following limitations:
-		// a) We don't have a method that parses conditional expressions, so
-		//    we start with additive expressions.
-		// b) The only assignment operator supported right now is the ASSIGN terminal.
-		std::shared_ptr<Expr> Parser::AssignmentExpression() {
+		Expr* Parser::AssignmentExpression() {
 			// [TODO]: explain how the grammar is parsed.
 			//         what happened to 'unary_expression'?
 			// Essentially, we don't know whether we should call
@@ -1049,69 +1253,92 @@ namespace crayon {
 			// What we do instead is call the more "broader" ConditionalExpression function
 			// and then check whether the expression returned is a valid lvalue
 			// among those produced by the UnaryExpression procedure and its descendants.
-			std::shared_ptr<Expr> assignExpr = ConditionalExpression();
+			Expr* assignExpr = ConditionalExpression();
+			if (panicking) return nullptr;
 			// if (Match(TokenType::EQUAL)) {
-			if (IsAssignmentOperator(Peek()->tokenType)) {
+			if (IsAssignmentOperator(PeekType())) {
 				// [TODO]: check whether the 'expr' is a valid assignment target.
 				//         in other words, check if it's an lvalue.
 				// if the check fails, throw a syntax error.
-				const Token* assignOp = Advance();
-				std::shared_ptr<Expr> rvalue = AssignmentExpression();
-				assignExpr = std::make_shared<AssignExpr>(assignExpr, rvalue, *assignOp);
+				Token assignOp = Advance();
+				Expr* rvalue = AssignmentExpression();
+				if (panicking) return nullptr;
+				assignExpr = astArena->New<AssignExpr>(assignExpr, rvalue, assignOp);
 				//exprTypeInferenceVisitor->SetEnvironment(currentScope.get());
 				//assignExpr->Accept(exprTypeInferenceVisitor.get());
 				//if (assignExpr->GetExprType().type == GlslBasicType::UNDEFINED) {
-				//	throw SyntaxError{*assignOp, "Variable expression type error!"};
+				//	throw SyntaxError{assignOp, "Variable expression type error!"};
 				//}
 				//exprTypeInferenceVisitor->ResetEnvironment();
 			}
 			return assignExpr;
 		}
-		std::shared_ptr<Expr> Parser::ConditionalExpression() {
-			// TODO: implement parsing of conditional expressions.
-			return AdditiveExpression();
-		}
-		std::shared_ptr<Expr> Parser::AdditiveExpression() {
-			std::shared_ptr<Expr> expr = MultiplicativeExpression();
-			while (Match(TokenType::PLUS) || Match(TokenType::DASH)) {
-				const Token* op = Previous();
-				std::shared_ptr<Expr> term = MultiplicativeExpression();
-				expr = std::make_shared<BinaryExpr>(expr, *op, term);
+		// Parse a conditional expression.
+		// 'conditional_expression':
+		//     'logical_or_expression'
+		//     'logical_or_expression' QUESTION 'expression' COLON 'assignment_expression'
+		Expr* Parser::ConditionalExpression() {
+			Expr* condition = BinaryExpression(GetBinaryOpPrecedence(TokenType::OR_OP));
+			if (panicking) return nullptr;
+			if (Match(TokenType::QUESTION)) {
+				Expr* trueExpr = Expression();
+				if (panicking) return nullptr;
+				Consume(TokenType::COLON, "':' expected in a ternary expression!");
+				if (panicking) return nullptr;
+				Expr* falseExpr = AssignmentExpression();
+				if (panicking) return nullptr;
+				return astArena->New<TernaryExpr>(condition, trueExpr, falseExpr);
+			}
+			return condition;
+		}
+		// Parse the binary operators, from 'logical_or_expression' down to 'multiplicative_expression',
+		// by precedence climbing instead of a procedure per precedence level: the loop takes the operators
+		// binding at least as tight as 'minPrecedence', and the right operand of each one only takes the operators
+		// binding tighter (they're all left-associative). The precedences come from 'GetBinaryOpPrecedence'.
+		// This way, an operand costs a single call rather than one per level.
+		Expr* Parser::BinaryExpression(int minPrecedence) {
+			Expr* expr = UnaryExpression();
+			if (panicking) return nullptr;
+			int precedence = GetBinaryOpPrecedence(PeekType());
+			while (precedence >= minPrecedence) {
+				Token op = Advance();
+				Expr* right = BinaryExpression(precedence + 1);
+				if (panicking) return nullptr;
+				expr = astArena->New<BinaryExpr>(expr, op, right);
+				precedence = GetBinaryOpPrecedence(PeekType());
 			}
 			return expr;
 		}
-		std::shared_ptr<Expr> Parser::MultiplicativeExpression() {
-			std::shared_ptr<Expr> term = UnaryExpression();
-			while (Match(TokenType::STAR) || Match(TokenType::SLASH)) {
-				const Token* op = Previous();
-				std::shared_ptr<Expr> primary = UnaryExpression();
-				term = std::make_shared<BinaryExpr>(term, *op, primary);
-			}
-			return term;
-		}
-		std::shared_ptr<Expr> Parser::UnaryExpression() {
-			if (Match(TokenType::PLUS) || Match(TokenType::DASH)) {
-				const Token* op = Previous();
-				std::shared_ptr<Expr> expr = UnaryExpression();
-				return std::make_shared<UnaryExpr>(*op, expr);
+		Expr* Parser::UnaryExpression() {
+			if (Match(TokenType::PLUS) || Match(TokenType::DASH) ||
+			    Match(TokenType::BANG) || Match(TokenType::TILDE)) {
+				Token op = Previous();
+				Expr* expr = UnaryExpression();
+				if (panicking) return nullptr;
+				return astArena->New<UnaryExpr>(op, expr);
 			} else {
 				return PostfixExpression();
 			}
 		}
-		std::shared_ptr<Expr> Parser::PostfixExpression() {
+		Expr* Parser::PostfixExpression() {
 			// Parse the first part of the postfix expression.
-			std::shared_ptr<Expr> expr;
-			if (IsType(*Peek())) {
+			Expr* expr{nullptr};
+			if (IsType(Peek())) {
 				// 1. Parse a constructor call.
 				TypeSpec typeSpec = TypeSpecifier();
+				if (panicking) return nullptr;
 				Consume(TokenType::LEFT_PAREN, "Constructor call must have an openning '('!");
-				std::shared_ptr<CtorCallExpr> ctorCall = std::make_shared<CtorCallExpr>(typeSpec);
-				FunCallArgs(ctorCall.get());
+				if (panicking) return nullptr;
+				CtorCallExpr* ctorCall = astArena->New<CtorCallExpr>(typeSpec);
+				FunCallArgs(ctorCall);
+				if (panicking) return nullptr;
 				Consume(TokenType::RIGHT_PAREN, "Constructor call must have a closing ')'!");
+				if (panicking) return nullptr;
 				expr = ctorCall;
 			} else {
 				// 2. Parse a primary expression.
 				expr = PrimaryExpression();
+				if (panicking) return nullptr;
 			}
 
 			// Parse the rest of the postfix expression.
@@ -1120,14 +1347,17 @@ namespace crayon {
 			// 2. Field selections
 			while (true) {
 				if (Match(TokenType::LEFT_PAREN)) {
-					std::shared_ptr<FunCallExpr> funCall = std::make_shared<FunCallExpr>(expr);
-					FunCallArgs(funCall.get());
+					FunCallExpr* funCall = astArena->New<FunCallExpr>(expr);
+					FunCallArgs(funCall);
+					if (panicking) return nullptr;
 					Consume(TokenType::RIGHT_PAREN, "Function call must have a closing ')'!");
+					if (panicking) return nullptr;
 					expr = funCall;
 				} else if (Match(TokenType::DOT)) {
-					const Token* field = Consume(
+					Token field = Consume(
 						TokenType::IDENTIFIER, "Field name must be a valid identifier!");
-					expr = std::make_shared<FieldSelectExpr>(expr, *field);
+					if (panicking) return nullptr;
+					expr = astArena->New<FieldSelectExpr>(expr, field);
 				} else {
 					break;
 				}
@@ -1135,102 +1365,110 @@ namespace crayon {
 
 			return expr;
 		}
-		std::shared_ptr<Expr> Parser::PrimaryExpression() {
-			std::shared_ptr<Expr> primary;
+		Expr* Parser::PrimaryExpression() {
+			Expr* primary{nullptr};
 			if (Match(TokenType::LEFT_PAREN)) {
 				// 1. Group expression.
 				primary = Expression();
+				if (panicking) return nullptr;
 				Consume(TokenType::RIGHT_PAREN, "Matching ')' parenthesis missing!");
+				if (panicking) return nullptr;
 			} else if (Match(TokenType::IDENTIFIER)) {
 				// 2. It's a variable identifier.
-				const Token* var = Previous();
+				Token var = Previous();
 				// 1)
 				/*
-				if (!currentScope->VarDeclExists(var->lexeme)) {
-					throw SyntaxError{*var, "Identifier is not defined!"};
+				if (!currentScope->VarDeclExists(var.lexeme)) {
+					Error(var, "Identifier is not defined!");
+					return nullptr;
 				}
 				*/
 				// 2)
-				if (!currentScope->SymbolDeclared(var->lexeme)) {
-					throw SyntaxError{*var, "Identifier is not defined!"};
+				if (!currentScope->SymbolDeclared(var.lexeme)) {
+					Error(var, "Identifier is not defined!");
+					return nullptr;
 				}
-				primary = std::make_shared<VarExpr>(*var);
+				primary = astArena->New<VarExpr>(var);
 			} else if (Match(TokenType::INTCONSTANT)) {
 				// 3. It's an integer constant.
-				const Token* intConst = Previous();
-				int intVal = ParseIntValue(intConst->lexeme);
-				ConstId intConstId = constTable->AddConstant(intVal);
-				primary = std::make_shared<IntConstExpr>(*intConst, intConstId);
+				Token intConst = Previous();
+				ConstId intConstId = PreviousConstId();
+				primary = astArena->New<IntConstExpr>(intConst, intConstId);
 				// primary->Accept(exprTypeInferenceVisitor.get());
 			} else if (Match(TokenType::UINTCONSTANT)) {
 				// 4. It's an unsigned integer constant.
-				const Token* uintConst = Previous();
-				unsigned int uintVal = ParseUintValue(uintConst->lexeme);
-				ConstId intConstId = constTable->AddConstant(uintVal);
-				primary = std::make_shared<UintConstExpr>(*uintConst, intConstId);
+				Token uintConst = Previous();
+				ConstId intConstId = PreviousConstId();
+				primary = astArena->New<UintConstExpr>(uintConst, intConstId);
 				// primary->Accept(exprTypeInferenceVisitor.get());
 			} else if (Match(TokenType::FLOATCONSTANT)) {
 				// 5. It's a single precision floating-point constant.
-				const Token* floatConst = Previous();
-				float floatVal = ParseFloatValue(floatConst->lexeme);
-				ConstId floatConstId = constTable->AddConstant(floatVal);
-				primary = std::make_shared<FloatConstExpr>(*floatConst, floatConstId);
+				Token floatConst = Previous();
+				ConstId floatConstId = PreviousConstId();
+				primary = astArena->New<FloatConstExpr>(floatConst, floatConstId);
 				// primary->Accept(exprTypeInferenceVisitor.get());
 			} else if (Match(TokenType::DOUBLECONSTANT)) {
 				// 6. It's a double precision floating-point constant.
-				const Token* doubleConst = Previous();
-				double doubleVal = ParseDoubleValue(doubleConst->lexeme);
-				ConstId doubleConstId = constTable->AddConstant(doubleVal);
-				primary = std::make_shared<DoubleConstExpr>(*doubleConst, doubleConstId);
+				Token doubleConst = Previous();
+				ConstId doubleConstId = PreviousConstId();
+				primary = astArena->New<DoubleConstExpr>(doubleConst, doubleConstId);
 				// primary->Accept(exprTypeInferenceVisitor.get());
 			} else {
-				throw SyntaxError{*Peek(), "Unexpected primary expression!"};
+				Error(Peek(), "Unexpected primary expression!");
+				return nullptr;
 			}
 			return primary;
 		}
 
 		void Parser::FunCallArgs(CallExpr* callExpr) {
 			// 1. No arguments
-			if (Peek()->tokenType == TokenType::RIGHT_PAREN ||
-			    Peek()->tokenType == TokenType::VOID) {
+			if (PeekType() == TokenType::RIGHT_PAREN ||
+			    PeekType() == TokenType::VOID) {
 				Advance();
 				return;
 			}
 			// 2. One or more arguments
-			std::shared_ptr<Expr> arg = AssignmentExpression();
+			Expr* arg = AssignmentExpression();
+			if (panicking) return;
 			callExpr->AddArg(arg);
 			while (Match(TokenType::COMMA)) {
 				arg = AssignmentExpression();
+				if (panicking) return;
 				callExpr->AddArg(arg);
 			}
 		}
-		std::vector<std::shared_ptr<Expr>> Parser::FunCallArgs() {
-			std::vector<std::shared_ptr<Expr>> args;
+		std::vector<Expr*> Parser::FunCallArgs() {
+			std::vector<Expr*> args;
 			// 1. No arguments
-			if (Peek()->tokenType == TokenType::RIGHT_PAREN ||
-			    Peek()->tokenType == TokenType::VOID) {
+			if (PeekType() == TokenType::RIGHT_PAREN ||
+			    PeekType() == TokenType::VOID) {
 				Advance();
 				return args;
 			}
 			// 2. One or more arguments
-			std::shared_ptr<Expr> arg = AssignmentExpression();
+			Expr* arg = AssignmentExpression();
+			if (panicking) return {};
 			args.push_back(arg);
 			while (Match(TokenType::COMMA)) {
 				arg = AssignmentExpression();
+				if (panicking) return {};
 				args.push_back(arg);
 			}
 			return args;
 		}
 
 		FullSpecType Parser::FullySpecifiedType() {
-			const Token* token = Peek();
+			Token token = Peek();
 			FullSpecType fullSpecType{};
-			if (IsQualifier(token->tokenType)) {
+			if (IsQualifier(token.tokenType)) {
 				fullSpecType.qualifier = TypeQualifier();
-			} if (IsType(*token)) {
+				if (panicking) return FullSpecType{};
+			} if (IsType(token)) {
 				fullSpecType.specifier = TypeSpecifier();
+				if (panicking) return FullSpecType{};
 			} else {
-				throw SyntaxError{*token, "Type specifier expected in a fully-specified type declaration!"};
+				Error(token, "Type specifier expected in a fully-specified type declaration!");
+				return FullSpecType{};
 			}
 			return fullSpecType;
 		}
@@ -1238,104 +1476,119 @@ namespace crayon {
 		TypeQual Parser::TypeQualifier() {
 			TypeQual typeQual{};
 			SingleTypeQualifier(typeQual);
+			if (panicking) return TypeQual{};
 			TypeQualifierRest(typeQual);
+			if (panicking) return TypeQual{};
 			return typeQual;
 		}
 		void Parser::SingleTypeQualifier(TypeQual& typeQual) {
-			const Token* qualifier = Peek();
-			if (qualifier->tokenType == TokenType::LAYOUT) {
+			Token qualifier = Peek();
+			if (qualifier.tokenType == TokenType::LAYOUT) {
 				// 1. Handle a layout qualifier.
 				Advance();
 				Consume(
 					TokenType::LEFT_PAREN,
 					"Expected an opening parenthesis after the layout specifier keyword!");
+				if (panicking) return;
 				LayoutQualifierList(typeQual.layout);
+				if (panicking) return;
 				Consume(
 					TokenType::RIGHT_PAREN,
 					"Expected a closing parenthesis after the layout specifier!");
-			} else if (IsStorageQualifier(qualifier->tokenType)) {
+			} else if (IsStorageQualifier(qualifier.tokenType)) {
 				// 2. Handle a storage qualifier.
 				Advance();
-				typeQual.storage = *qualifier;
+				typeQual.storage = qualifier;
 			} else {
 				// 3. [TODO]: add more qualifier types later
-				throw std::runtime_error{ "Expected a type qualifier!" };
+				Error(qualifier, "Expected a type qualifier!");
 			}
 		}
 		void Parser::TypeQualifierRest(TypeQual& typeQual) {
 			// One or more qualifiers has already been parsed, so it's fine if there's no more of them.
 			// If there are more, however, we parse all of them.
-			while (IsQualifier(Peek()->tokenType)) {
+			while (IsQualifier(PeekType())) {
 				SingleTypeQualifier(typeQual);
+				if (panicking) return;
 			}
 		}
 
 		void Parser::LayoutQualifierList(std::list<LayoutQualifier>& layout) {
 			layout.push_back(SingleLayoutQualifier());
+			if (panicking) return;
 			while (Match(TokenType::COMMA)) {
 				layout.push_back(SingleLayoutQualifier());
+				if (panicking) return;
 			}
 		}
 		LayoutQualifier Parser::SingleLayoutQualifier() {
-			const Token* identifier = Consume(TokenType::IDENTIFIER, "Layout specifier name expected!");
+			Token identifier = Consume(TokenType::IDENTIFIER, "Layout specifier name expected!");
+			if (panicking) return LayoutQualifier{};
 			if (Match(TokenType::EQUAL)) {
 				// A constant expression should be expected, but an int constant is ok for now.
-				const Token* value = Consume(
+				Consume(
 					TokenType::INTCONSTANT,
 					// TODO: show what layout name is missing an integer value!
 					"An integer constant as a layout specifier value is expected!");
-				int qualifierValue = static_cast<int>(std::strtol(value->lexeme.data(), nullptr, 10));
-				return LayoutQualifier{ *identifier, qualifierValue };
+				if (panicking) return LayoutQualifier{};
+				int qualifierValue = std::get<int>(constTable->GetConstVal(PreviousConstId()));
+				return LayoutQualifier{ identifier, qualifierValue };
 			} else {
-				return LayoutQualifier{ *identifier };
+				return LayoutQualifier{ identifier };
 			}
 		}
 
 		TypeSpec Parser::TypeSpecifier() {
-			const Token* token = Peek();
+			Token token = Peek();
 			TypeSpec typeSpec{};
-			if (IsTypeBasic(token->tokenType)) {
+			if (IsTypeBasic(token.tokenType)) {
 				// 1. Basic type.
-				typeSpec.type = *token;
+				typeSpec.type = token;
 				Advance();
-			} else if (IsTypeAggregate(*token)) {
+			} else if (IsTypeAggregate(token)) {
 				// 2. User-defined aggregate type.
-				typeSpec.type = *token;
-				// typeSpec.typeDecl = currentScope->GetStructDecl(token->lexeme);
+				typeSpec.type = token;
+				// typeSpec.typeDecl = currentScope->GetStructDecl(token.lexeme);
 				Advance();
-			} else if (token->tokenType == TokenType::STRUCT) {
+			} else if (token.tokenType == TokenType::STRUCT) {
 				// 3. New struct declaration (either named or unnamed).
 				// std::cout << "Ok, at least that part is correct...\n";
-				// typeSpec.type = *token;
-				std::shared_ptr<StructDecl> structDecl = StructDeclaration();
+				// typeSpec.type = token;
+				StructDecl* structDecl = StructDeclaration();
+				if (panicking) return TypeSpec{};
 				typeSpec.type = structDecl->GetName(); // Can be empty if the struct is anonymous!
 				typeSpec.typeDecl = structDecl;
 			} else {
-				if (token->tokenType == TokenType::IDENTIFIER) {
-					if (!externalScope->StructDeclExists(token->lexeme)) {
-						throw std::runtime_error{"Use of undeclared type!"};
+				if (token.tokenType == TokenType::IDENTIFIER) {
+					if (!externalScope->StructDeclExists(token.lexeme)) {
+						Error(token, "Use of undeclared type!");
+						return TypeSpec{};
 					}
 				} else {
-					throw std::runtime_error{"Unknown type specifier encountered!"};
+					Error(token, "Unknown type specifier encountered!");
+					return TypeSpec{};
 				}
 			}
-			if (Peek()->tokenType == TokenType::LEFT_BRACKET) {
+			if (PeekType() == TokenType::LEFT_BRACKET) {
 				typeSpec.dimensions = ArraySpecifier();
+				if (panicking) return TypeSpec{};
 			}
 			return typeSpec;
 		}
 		std::vector<ArrayDim> Parser::ArraySpecifier() {
 			std::vector<ArrayDim> dimensions;
-			while (Peek()->tokenType == TokenType::LEFT_BRACKET) {
+			while (PeekType() == TokenType::LEFT_BRACKET) {
 				Advance();
 				if (Match(TokenType::RIGHT_BRACKET)) {
 					dimensions.push_back(ArrayDim{});
 				} else {
-					std::shared_ptr<Expr> constIntExpr = ConditionalExpression();
+					Expr* constIntExpr = ConditionalExpression();
+					if (panicking) return {};
 					ArrayDim arrayDim{};
 					arrayDim.dimExpr = constIntExpr;
 					dimensions.push_back(arrayDim);
 					Consume(TokenType::RIGHT_BRACKET, "Right bracket expected after specifying array dimension size!");
+					if (panicking) return {};
 				}
 			}
 			return dimensions;
@@ -1405,47 +1658,58 @@ namespace crayon {
 			return false;
 		}
 
-		const Token* Parser::Advance() {
+		Token Parser::Advance() {
 			if (AtEnd())
 				return Last();
-			return tokenStream + current++;
+			Token token = GetToken(current++);
+			Fetch();
+			return token;
+		}
+		Token Parser::Previous() const {
+			return GetToken(current - 1);
 		}
-		const Token* Parser::Previous() {
-			return tokenStream + (current - 1);
+		ConstId Parser::PreviousConstId() const {
+			// The lexer has already interned the literal.
+			return GetConstId(current - 1);
 		}
-		const Token* Parser::Peek() const {
+		Token Parser::Peek() const {
 			// 1. Works with the core GLSL.
 			if (AtEnd())
 				return Last();
-			return tokenStream + current;
+			return GetToken(current);
 			// 2. Works with the extended GLSL.
-			// return tokenStream + current;
+			// return tokenStream->GetToken(current);
+		}
+		TokenType Parser::PeekType() const {
+			if (AtEnd())
+				return Last().tokenType;
+			return GetTokenType(current);
 		}
 		bool Parser::Match(TokenType tokenType) {
 			// 1. Works with the core GLSL.
 			if (AtEnd())
 				return false;
-			if (Peek()->tokenType == tokenType)	{
-				Advance();
+			if (PeekType() == tokenType)	{
+				current++;
+				Fetch();
 				return true;
 			}
 			return false;
 			// 2. Works with the extended GLSL.
 			/*
-			if (Peek()->tokenType == tokenType)	{
+			if (PeekType() == tokenType)	{
 				Advance();
 				return true;
 			}
 			return false;
 			*/
 		}
-		const Token* Parser::Consume(TokenType tokenType, std::string_view msg) {
+		Token Parser::Consume(TokenType tokenType, std::string_view msg) {
 			if (Match(tokenType)) {
 				return Previous();
-			} else {
-				throw SyntaxError{*Peek(), tokenType, msg};
-				// throw std::runtime_error{msg.data()};
 			}
+			Error(Peek(), tokenType, msg);
+			return Token{};
 		}
 
 		bool Parser::AtEnd() const {
@@ -1454,11 +1718,57 @@ namespace crayon {
 				return true;
 			return false;
 			// 2. Works with the extended GLSL.
-			// return Peek()->tokenType == TokenType::END;
+			// return PeekType() == TokenType::END;
+		}
+		Token Parser::Last() const {
+			// An empty stream (e.g. after a lexical error) is only reported, never read.
+			if (tokenStreamSize == 0)
+				return Token{};
+			return GetToken(tokenStreamSize - 1);
+		}
+
+		void Parser::Fetch() {
+			// Blocks while the lexer is behind, 'AtEnd' is only true once the ring is closed and drained.
+			while (tokenRing && current >= tokenStreamSize) {
+				PullTokens();
+			}
+			// Scanning half a window at a time keeps the previous token in the window.
+			while (tokenLexer && current >= tokenStreamSize) {
+				if (!tokenLexer->ScanAhead(tokenWindowSize / 2)) {
+					tokenLexer = nullptr;
+				}
+				tokenStreamSize = tokenWindow->GetSize();
+			}
+		}
+		void Parser::PullTokens() {
+			constexpr size_t pullBatchSize{256};
+			RingToken batch[pullBatchSize];
+			size_t count = tokenRing->Pop(batch, pullBatchSize);
+			if (count == 0) {
+				tokenRing = nullptr;
+				return;
+			}
+			for (size_t i = 0; i < count; i++) {
+				const RingToken& ringToken = batch[i];
+				if (ringToken.constant) {
+					ConstId constId = constTable->AddConstant(ringToken.constVal);
+					pipelinedTokens->AppendConstant(ringToken.tokenType, ringToken.offset, ringToken.length, constId);
+				} else {
+					pipelinedTokens->Append(ringToken.tokenType, ringToken.offset, ringToken.length);
+				}
+			}
+			tokenStreamSize = pipelinedTokens->GetSize();
+		}
+
+		Token Parser::GetToken(size_t idx) const {
+			return tokenWindow ? tokenWindow->GetToken(idx) : tokenStream->GetToken(idx);
+		}
+		TokenType Parser::GetTokenType(size_t idx) const {
+			return tokenWindow ? tokenWindow->GetTokenType(idx) : tokenStream->GetTokenType(idx);
 		}
-		const Token* Parser::Last() const {
-			return tokenStream + (tokenStreamSize - 1);
+		ConstId Parser::GetConstId(size_t idx) const {
+			return tokenWindow ? tokenWindow->GetConstId(idx) : tokenStream->GetConstId(idx);
 		}
 		
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,1018 @@
+#include "GLSL/Analyzer/Preprocessor.h"
+#include "GLSL/Analyzer/CharScan.h"
+#include "GLSL/Analyzer/Keywords.h"
+#include "GLSL/PpFileCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+namespace crayon {
+	namespace glsl {
+
+		// Both limits only exist to turn runaway recursion into an error.
+		constexpr uint32_t maxIncludeDepth{64};
+		constexpr uint32_t maxExpansionDepth{256};
+
+		static std::string_view TrimSpaces(std::string_view text) {
+			size_t first = text.find_first_not_of(" \t\r");
+			if (first == std::string_view::npos) {
+				return std::string_view{};
+			}
+			size_t last = text.find_last_not_of(" \t\r");
+			return text.substr(first, last - first + 1);
+		}
+		static void SkipSpaces(std::string_view text, size_t& pos) {
+			while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+				pos++;
+			}
+		}
+		static std::string_view ReadIdentifier(std::string_view text, size_t& pos) {
+			if (pos >= text.size() || !HasCharClass(text[pos], charClassAlpha)) {
+				return std::string_view{};
+			}
+			size_t start = pos;
+			pos++;
+			while (pos < text.size() && HasCharClass(text[pos], charClassAlnum)) {
+				pos++;
+			}
+			return text.substr(start, pos - start);
+		}
+		// Returns the position after the closing quote, or the end of the text if the literal isn't terminated.
+		static size_t SkipQuoted(std::string_view text, size_t pos) {
+			size_t end = text.find(text[pos], pos + 1);
+			return end == std::string_view::npos ? text.size() : end + 1;
+		}
+
+		static PpDirective DirectiveFromName(std::string_view name) {
+			if (name.empty()) return PpDirective::EMPTY;
+			if (name == "include") return PpDirective::INCLUDE;
+			if (name == "define") return PpDirective::DEFINE;
+			if (name == "undef") return PpDirective::UNDEF;
+			if (name == "if") return PpDirective::IF;
+			if (name == "ifdef") return PpDirective::IFDEF;
+			if (name == "ifndef") return PpDirective::IFNDEF;
+			if (name == "elif") return PpDirective::ELIF;
+			if (name == "else") return PpDirective::ELSE;
+			if (name == "endif") return PpDirective::ENDIF;
+			if (name == "pragma") return PpDirective::PRAGMA;
+			if (name == "error") return PpDirective::ERROR;
+			if (name == "version") return PpDirective::VERSION;
+			if (name == "extension") return PpDirective::EXTENSION;
+			if (name == "line") return PpDirective::LINE;
+			return PpDirective::UNKNOWN;
+		}
+
+		// Follows the comments of a source code line. Returns 'true' if it holds nothing but whitespace and comments.
+		static bool ScanLineComments(std::string_view line, bool& inComment) {
+			bool blank{true};
+			size_t pos{0};
+			while (pos < line.size()) {
+				if (inComment) {
+					size_t commentEnd = line.find("*/", pos);
+					if (commentEnd == std::string_view::npos) {
+						return blank;
+					}
+					pos = commentEnd + 2;
+					inComment = false;
+					continue;
+				}
+				if (blank) {
+					pos = line.find_first_not_of(" \t\r", pos);
+					if (pos == std::string_view::npos) {
+						return blank;
+					}
+				} else {
+					// Past the first token only comments and literals matter.
+					pos = line.find_first_of("/\"'", pos);
+					if (pos == std::string_view::npos) {
+						return blank;
+					}
+				}
+				char c = line[pos];
+				if (c == '/' && pos + 1 < line.size() && line[pos + 1] == '/') {
+					return blank;
+				}
+				if (c == '/' && pos + 1 < line.size() && line[pos + 1] == '*') {
+					inComment = true;
+					pos += 2;
+					continue;
+				}
+				blank = false;
+				pos = c == '"' || c == '\'' ? SkipQuoted(line, pos) : pos + 1;
+			}
+			return blank;
+		}
+		// Follows the tokens of the main file's preprocessed lines to the 'BEGIN' of every shader stage,
+		// which comes right after the stage's keyword and opening brace ("VertexShader { BEGIN").
+		// 'matchedTokens' counts the tokens of that sequence seen so far, it carries over to the next line.
+		// Returns 'true' if the line completes the sequence. Comments, literals and numbers are skipped.
+		static bool ScanStageStart(std::string_view line, bool inComment, uint32_t& matchedTokens) {
+			bool stageStarts{false};
+			size_t pos{0};
+			while (pos < line.size()) {
+				if (inComment) {
+					size_t commentEnd = line.find("*/", pos);
+					if (commentEnd == std::string_view::npos) {
+						break;
+					}
+					pos = commentEnd + 2;
+					inComment = false;
+					continue;
+				}
+				char c = line[pos];
+				char next = pos + 1 < line.size() ? line[pos + 1] : '\0';
+				if (c == ' ' || c == '\t' || c == '\r') {
+					pos++;
+				} else if (c == '/' && next == '/') {
+					break;
+				} else if (c == '/' && next == '*') {
+					inComment = true;
+					pos += 2;
+				} else if (HasCharClass(c, charClassAlpha)) {
+					TokenType tokenType = FindKeyword(ReadIdentifier(line, pos));
+					if (tokenType >= TokenType::VS_KW && tokenType <= TokenType::CS_KW) {
+						matchedTokens = 1;
+					} else if (tokenType == TokenType::BEGIN && matchedTokens == 2) {
+						stageStarts = true;
+						matchedTokens = 0;
+					} else {
+						matchedTokens = 0;
+					}
+				} else if (c == '{') {
+					matchedTokens = matchedTokens == 1 ? 2 : 0;
+					pos++;
+				} else {
+					matchedTokens = 0;
+					if (c == '"' || c == '\'') {
+						pos = SkipQuoted(line, pos);
+					} else if (HasCharClass(c, charClassDecimal)) {
+						// Skips the suffixes and exponents of numbers along with their digits.
+						while (pos < line.size() && HasCharClass(line[pos], charClassAlnum)) {
+							pos++;
+						}
+					} else {
+						pos++;
+					}
+				}
+			}
+			return stageStarts;
+		}
+		// Replaces the comments of a directive by spaces. A block comment left open continues on the next lines.
+		static std::string StripComments(std::string_view directive, bool& inComment) {
+			std::string stripped;
+			size_t pos{0};
+			size_t copyStart{0};
+			while (pos < directive.size()) {
+				char c = directive[pos];
+				if (c == '"') {
+					pos = SkipQuoted(directive, pos);
+				} else if (c == '/' && pos + 1 < directive.size() && directive[pos + 1] == '/') {
+					break;
+				} else if (c == '/' && pos + 1 < directive.size() && directive[pos + 1] == '*') {
+					stripped.append(directive.substr(copyStart, pos - copyStart));
+					stripped += ' ';
+					size_t commentEnd = directive.find("*/", pos + 2);
+					if (commentEnd == std::string_view::npos) {
+						inComment = true;
+						return stripped;
+					}
+					pos = copyStart = commentEnd + 2;
+				} else {
+					pos++;
+				}
+			}
+			stripped.append(directive.substr(copyStart, pos - copyStart));
+			return stripped;
+		}
+
+		// The file is guarded if its first line (ignoring blank ones) is '#ifndef <guard>'
+		// and the matching '#endif' is its last one.
+		static std::string FindGuardMacro(const std::vector<PpLine>& lines) {
+			size_t first{0};
+			while (first < lines.size() && lines[first].directive == PpDirective::NONE && lines[first].blank) {
+				first++;
+			}
+			size_t last = lines.size();
+			while (last > first && lines[last - 1].directive == PpDirective::NONE && lines[last - 1].blank) {
+				last--;
+			}
+			if (first == last || lines[first].directive != PpDirective::IFNDEF || lines[last - 1].directive != PpDirective::ENDIF) {
+				return std::string{};
+			}
+			size_t depth{0};
+			for (size_t i = first; i < last; i++) {
+				switch (lines[i].directive) {
+					case PpDirective::IF:
+					case PpDirective::IFDEF:
+					case PpDirective::IFNDEF:
+						depth++;
+						break;
+					case PpDirective::ELIF:
+					case PpDirective::ELSE:
+						// An '#else' of the guard itself would include code when the guard is defined.
+						if (depth == 1) {
+							return std::string{};
+						}
+						break;
+					case PpDirective::ENDIF:
+						depth--;
+						if (depth == 0 && i != last - 1) {
+							return std::string{};
+						}
+						break;
+					default:
+						break;
+				}
+			}
+			size_t pos{0};
+			std::string_view guard = ReadIdentifier(lines[first].args, pos);
+			return pos == lines[first].args.size() ? std::string{guard} : std::string{};
+		}
+
+		void ScanPpFile(PpFile& file) {
+			std::string_view text = file.text;
+			file.lines.clear();
+			file.hasDirectives = false;
+			bool inComment{false};
+			size_t pos{0};
+			while (pos < text.size()) {
+				size_t lineEnd = text.find('\n', pos);
+				lineEnd = lineEnd == std::string_view::npos ? text.size() : lineEnd;
+				PpLine line{};
+				line.text = text.substr(pos, lineEnd - pos);
+				size_t first = line.text.find_first_not_of(" \t");
+				if (!inComment && first != std::string_view::npos && line.text[first] == '#') {
+					// 1. Join the continued lines.
+					std::string directive;
+					std::string_view physicalLine = line.text.substr(first + 1);
+					while (true) {
+						std::string_view content = physicalLine;
+						if (!content.empty() && content.back() == '\r') {
+							content.remove_suffix(1);
+						}
+						if (content.empty() || content.back() != '\\' || lineEnd == text.size()) {
+							directive.append(content);
+							break;
+						}
+						directive.append(content.substr(0, content.size() - 1));
+						pos = lineEnd + 1;
+						lineEnd = text.find('\n', pos);
+						lineEnd = lineEnd == std::string_view::npos ? text.size() : lineEnd;
+						physicalLine = text.substr(pos, lineEnd - pos);
+						line.lineCount++;
+					}
+					// 2. Split it into the name and the arguments.
+					std::string stripped = StripComments(directive, inComment);
+					size_t namePos{0};
+					SkipSpaces(stripped, namePos);
+					std::string_view name = ReadIdentifier(stripped, namePos);
+					line.directive = DirectiveFromName(name);
+					if (line.directive == PpDirective::EMPTY && namePos < stripped.size() && !TrimSpaces(stripped).empty()) {
+						// Something other than a name follows the '#'.
+						line.directive = PpDirective::UNKNOWN;
+					}
+					line.args = std::string{TrimSpaces(std::string_view{stripped}.substr(namePos))};
+					file.hasDirectives = true;
+				} else {
+					line.startsInComment = inComment;
+					line.blank = ScanLineComments(line.text, inComment);
+				}
+				file.lines.push_back(std::move(line));
+				pos = lineEnd + 1;
+			}
+			file.guardMacro = FindGuardMacro(file.lines);
+		}
+
+		// Integer constant expressions of '#if' and '#elif', evaluated after the macro expansion.
+		// Identifiers left over are undefined macros, they evaluate to 0.
+		class PpExprEvaluator {
+		public:
+			explicit PpExprEvaluator(std::string_view expr)
+				: expr(expr) {
+			}
+
+			// Throws 'std::runtime_error' if the expression is ill-formed.
+			int64_t Evaluate() {
+				int64_t value = Conditional();
+				SkipSpaces(expr, pos);
+				if (pos != expr.size()) {
+					throw std::runtime_error{"Unexpected '" + std::string{expr.substr(pos, 1)} + "' in the condition!"};
+				}
+				return value;
+			}
+
+		private:
+			enum class BinaryOp {
+				NONE, LOGICAL_OR, LOGICAL_AND, BITWISE_OR, BITWISE_XOR, BITWISE_AND,
+				EQUAL, NOT_EQUAL, LESS, GREATER, LESS_EQUAL, GREATER_EQUAL, SHIFT_LEFT, SHIFT_RIGHT,
+				ADD, SUB, MUL, DIV, MOD,
+			};
+			struct BinaryOpInfo {
+				std::string_view symbol;
+				BinaryOp op;
+				int precedence;
+			};
+			// Two character operators come first, so that '<<' isn't taken for '<'.
+			static constexpr BinaryOpInfo binaryOps[]{
+				{"||", BinaryOp::LOGICAL_OR,    1},
+				{"&&", BinaryOp::LOGICAL_AND,   2},
+				{"==", BinaryOp::EQUAL,         6},
+				{"!=", BinaryOp::NOT_EQUAL,     6},
+				{"<=", BinaryOp::LESS_EQUAL,    7},
+				{">=", BinaryOp::GREATER_EQUAL, 7},
+				{"<<", BinaryOp::SHIFT_LEFT,    8},
+				{">>", BinaryOp::SHIFT_RIGHT,   8},
+				{"|",  BinaryOp::BITWISE_OR,    3},
+				{"^",  BinaryOp::BITWISE_XOR,   4},
+				{"&",  BinaryOp::BITWISE_AND,   5},
+				{"<",  BinaryOp::LESS,          7},
+				{">",  BinaryOp::GREATER,       7},
+				{"+",  BinaryOp::ADD,           9},
+				{"-",  BinaryOp::SUB,           9},
+				{"*",  BinaryOp::MUL,          10},
+				{"/",  BinaryOp::DIV,          10},
+				{"%",  BinaryOp::MOD,          10},
+			};
+
+			int64_t Conditional() {
+				int64_t condition = Binary(1);
+				if (!Match('?')) {
+					return condition;
+				}
+				int64_t thenValue = Conditional();
+				if (!Match(':')) {
+					throw std::runtime_error{"':' expected in the condition!"};
+				}
+				int64_t elseValue = Conditional();
+				return condition ? thenValue : elseValue;
+			}
+			int64_t Binary(int minPrecedence) {
+				int64_t lhs = Unary();
+				while (true) {
+					SkipSpaces(expr, pos);
+					const BinaryOpInfo* opInfo{nullptr};
+					for (const BinaryOpInfo& candidate : binaryOps) {
+						if (expr.substr(pos, candidate.symbol.size()) == candidate.symbol) {
+							opInfo = &candidate;
+							break;
+						}
+					}
+					if (!opInfo || opInfo->precedence < minPrecedence) {
+						return lhs;
+					}
+					pos += opInfo->symbol.size();
+					int64_t rhs = Binary(opInfo->precedence + 1);
+					lhs = Apply(opInfo->op, lhs, rhs);
+				}
+			}
+			int64_t Unary() {
+				SkipSpaces(expr, pos);
+				if (Match('!')) return !Unary();
+				if (Match('~')) return ~Unary();
+				if (Match('-')) return -Unary();
+				if (Match('+')) return Unary();
+				if (Match('(')) {
+					int64_t value = Conditional();
+					if (!Match(')')) {
+						throw std::runtime_error{"')' expected in the condition!"};
+					}
+					return value;
+				}
+				if (pos < expr.size() && HasCharClass(expr[pos], charClassDecimal)) {
+					return Number();
+				}
+				if (!ReadIdentifier(expr, pos).empty()) {
+					return 0;
+				}
+				throw std::runtime_error{"Operand expected in the condition!"};
+			}
+			int64_t Number() {
+				int base{10};
+				if (expr[pos] == '0' && pos + 1 < expr.size() && (expr[pos + 1] == 'x' || expr[pos + 1] == 'X')) {
+					base = 16;
+					pos += 2;
+				} else if (expr[pos] == '0') {
+					base = 8;
+				}
+				uint64_t value{0};
+				std::from_chars_result res = std::from_chars(expr.data() + pos, expr.data() + expr.size(), value, base);
+				if (res.ec != std::errc{}) {
+					throw std::runtime_error{"Invalid integer constant in the condition!"};
+				}
+				pos = res.ptr - expr.data();
+				if (pos < expr.size() && (expr[pos] == 'u' || expr[pos] == 'U')) {
+					pos++;
+				}
+				return static_cast<int64_t>(value);
+			}
+			static int64_t Apply(BinaryOp op, int64_t lhs, int64_t rhs) {
+				switch (op) {
+					case BinaryOp::LOGICAL_OR:    return lhs || rhs;
+					case BinaryOp::LOGICAL_AND:   return lhs && rhs;
+					case BinaryOp::BITWISE_OR:    return lhs | rhs;
+					case BinaryOp::BITWISE_XOR:   return lhs ^ rhs;
+					case BinaryOp::BITWISE_AND:   return lhs & rhs;
+					case BinaryOp::EQUAL:         return lhs == rhs;
+					case BinaryOp::NOT_EQUAL:     return lhs != rhs;
+					case BinaryOp::LESS:          return lhs < rhs;
+					case BinaryOp::GREATER:       return lhs > rhs;
+					case BinaryOp::LESS_EQUAL:    return lhs <= rhs;
+					case BinaryOp::GREATER_EQUAL: return lhs >= rhs;
+					case BinaryOp::SHIFT_LEFT:
+					case BinaryOp::SHIFT_RIGHT:
+						if (rhs < 0 || rhs >= 64) {
+							throw std::runtime_error{"Shift amount out of range in the condition!"};
+						}
+						return op == BinaryOp::SHIFT_LEFT ? static_cast<int64_t>(static_cast<uint64_t>(lhs) << rhs) : lhs >> rhs;
+					case BinaryOp::ADD:           return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs));
+					case BinaryOp::SUB:           return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs));
+					case BinaryOp::MUL:           return static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs));
+					case BinaryOp::DIV:
+					case BinaryOp::MOD:
+						if (rhs == 0) {
+							throw std::runtime_error{"Division by zero in the condition!"};
+						}
+						if (lhs == INT64_MIN && rhs == -1) {
+							return op == BinaryOp::DIV ? lhs : 0;
+						}
+						return op == BinaryOp::DIV ? lhs / rhs : lhs % rhs;
+					default:
+						assert(false && "Unhandled binary operator!");
+						return 0;
+				}
+			}
+
+			bool Match(char c) {
+				SkipSpaces(expr, pos);
+				if (pos < expr.size() && expr[pos] == c) {
+					pos++;
+					return true;
+				}
+				return false;
+			}
+
+			std::string_view expr;
+			size_t pos{0};
+		};
+
+		bool Preprocessor::HasDirectives(const char* srcData, size_t srcSize) {
+			return srcSize > 0 && std::memchr(srcData, '#', srcSize) != nullptr;
+		}
+
+		void Preprocessor::Process(const char* srcData, size_t srcSize, const PreprocessorConfig& config) {
+			assert(config.ppFileCache && "Check if the scanned file cache is provided first!");
+			this->config = config;
+			output.clear();
+			lineMap.Clear();
+			outputLineCount = 0;
+			macros.clear();
+			includedFiles.clear();
+			onceFiles.clear();
+			conditionals.clear();
+			stageHeaderTokens = 0;
+			stageStateSaved = false;
+			stageOnceFiles.clear();
+			stageGuardMacros.clear();
+			mainFile = PpFile{};
+			mainFile.path = config.srcCodePath;
+			mainFile.text = std::string_view{srcData, srcSize};
+			ScanPpFile(mainFile);
+			if (config.precompiledFiles) {
+				onceFiles.insert(config.precompiledFiles->begin(), config.precompiledFiles->end());
+			}
+			if (config.predefinedMacros) {
+				for (std::string_view macroDefinition : *config.predefinedMacros) {
+					Define(macroDefinition);
+				}
+			}
+			output.reserve(srcSize + srcSize / 8);
+			ProcessFile(mainFile, 0);
+			// Every line is terminated in the output, the last one of the main file might not have been.
+			if (srcSize > 0 && srcData[srcSize - 1] != '\n' && !output.empty()) {
+				output.pop_back();
+			}
+			currentFile = nullptr;
+		}
+		const std::string& Preprocessor::GetOutput() const {
+			return output;
+		}
+		const SrcLineMap& Preprocessor::GetLineMap() const {
+			return lineMap;
+		}
+		std::vector<std::string> Preprocessor::GetMacroDefinitions() const {
+			std::vector<std::string> macroDefinitions;
+			macroDefinitions.reserve(macros.size());
+			for (const auto& [name, macro] : macros) {
+				std::string macroDefinition{name};
+				if (macro.functionLike) {
+					macroDefinition += '(';
+					for (size_t i = 0; i < macro.params.size(); i++) {
+						macroDefinition.append(i == 0 ? "" : ", ").append(macro.params[i]);
+					}
+					macroDefinition += ')';
+				}
+				macroDefinition.append(" ").append(macro.body);
+				macroDefinitions.push_back(std::move(macroDefinition));
+			}
+			// Sorted, so that the same header always produces the same list.
+			std::sort(macroDefinitions.begin(), macroDefinitions.end());
+			return macroDefinitions;
+		}
+		std::vector<std::string> Preprocessor::GetProcessedFiles() const {
+			std::vector<std::string> processedFiles;
+			if (!mainFile.path.empty()) {
+				std::error_code errCode{};
+				std::filesystem::path canonical = std::filesystem::weakly_canonical(mainFile.path, errCode);
+				processedFiles.push_back((errCode ? mainFile.path.lexically_normal() : canonical).generic_string());
+			}
+			// Included paths are canonical already.
+			for (const std::shared_ptr<const PpFile>& includedFile : includedFiles) {
+				processedFiles.push_back(includedFile->path.generic_string());
+			}
+			std::sort(processedFiles.begin(), processedFiles.end());
+			processedFiles.erase(std::unique(processedFiles.begin(), processedFiles.end()), processedFiles.end());
+			return processedFiles;
+		}
+
+		void Preprocessor::ProcessFile(const PpFile& file, uint32_t includeDepth) {
+			size_t conditionalBase = conditionals.size();
+			// The main file has no name in the line map.
+			std::string fileName = includeDepth == 0 ? std::string{} : file.path.generic_string();
+			lineMap.Add(outputLineCount, fileName, 0);
+			uint32_t lineNum{1};
+			for (const PpLine& line : file.lines) {
+				// Restored after every line, an include changes them.
+				currentFile = &file;
+				currentLineNum = lineNum;
+				lineNum += line.lineCount;
+				if (line.directive == PpDirective::NONE) {
+					if (IsActive()) {
+						size_t lineStart = output.size();
+						if (macros.empty()) {
+							output.append(line.text);
+						} else {
+							Expand(line.text, line.startsInComment, output, 0);
+						}
+						// The rest of the line can't include anything, the stage may as well start after it.
+						if (includeDepth == 0 && ScanStageStart(std::string_view{output}.substr(lineStart), line.startsInComment,
+						                                        stageHeaderTokens)) {
+							BeginStage();
+						}
+					}
+					output += '\n';
+					outputLineCount++;
+					continue;
+				}
+				switch (line.directive) {
+					case PpDirective::IF:
+					case PpDirective::IFDEF:
+					case PpDirective::IFNDEF: {
+						Conditional conditional{};
+						conditional.parentActive = IsActive();
+						if (conditional.parentActive) {
+							if (line.directive == PpDirective::IF) {
+								conditional.active = EvalCondition(line.args);
+							} else {
+								size_t pos{0};
+								std::string_view name = ReadIdentifier(line.args, pos);
+								if (name.empty() || pos != line.args.size()) {
+									Error("A single macro name is expected!");
+								}
+								bool defined = macros.find(name) != macros.end();
+								conditional.active = line.directive == PpDirective::IFDEF ? defined : !defined;
+							}
+						}
+						conditional.taken = conditional.active;
+						conditionals.push_back(conditional);
+						break;
+					}
+					case PpDirective::ELIF:
+					case PpDirective::ELSE: {
+						bool isElse = line.directive == PpDirective::ELSE;
+						if (conditionals.size() == conditionalBase) {
+							Error(isElse ? "'#else' without '#if'!" : "'#elif' without '#if'!");
+						}
+						Conditional& conditional = conditionals.back();
+						if (conditional.elseSeen) {
+							Error(isElse ? "'#else' after '#else'!" : "'#elif' after '#else'!");
+						}
+						// The condition of a branch that can't be taken isn't even evaluated.
+						conditional.active = conditional.parentActive && !conditional.taken &&
+						                     (isElse || EvalCondition(line.args));
+						conditional.taken = conditional.taken || conditional.active;
+						conditional.elseSeen = isElse;
+						break;
+					}
+					case PpDirective::ENDIF:
+						if (conditionals.size() == conditionalBase) {
+							Error("'#endif' without '#if'!");
+						}
+						conditionals.pop_back();
+						break;
+					default:
+						if (IsActive()) {
+							ProcessDirective(file, line, includeDepth);
+							currentFile = &file;
+							// The lines of an included file come first, the directive's own lines follow them.
+							if (line.directive == PpDirective::INCLUDE) {
+								lineMap.Add(outputLineCount, fileName, lineNum - line.lineCount - 1);
+							}
+						}
+						break;
+				}
+				output.append(line.lineCount, '\n');
+				outputLineCount += line.lineCount;
+			}
+			currentFile = &file;
+			currentLineNum = lineNum;
+			if (conditionals.size() != conditionalBase) {
+				Error("Unterminated conditional directive, '#endif' expected!");
+			}
+		}
+		void Preprocessor::ProcessDirective(const PpFile& file, const PpLine& line, uint32_t includeDepth) {
+			switch (line.directive) {
+				case PpDirective::INCLUDE:
+					Include(file, line.args, includeDepth);
+					break;
+				case PpDirective::DEFINE:
+					Define(line.args);
+					break;
+				case PpDirective::UNDEF: {
+					size_t pos{0};
+					std::string_view name = ReadIdentifier(line.args, pos);
+					if (name.empty() || pos != line.args.size()) {
+						Error("A single macro name is expected!");
+					}
+					macros.erase(name);
+					break;
+				}
+				case PpDirective::PRAGMA:
+					// Other pragmas (optimize, debug, etc.) don't affect the generated code.
+					if (line.args == "once" && !file.path.empty()) {
+						onceFiles.insert(file.path.generic_string());
+					}
+					break;
+				case PpDirective::ERROR:
+					Error("#error " + line.args);
+				case PpDirective::UNKNOWN:
+					Error("Unknown directive: '" + std::string{TrimSpaces(line.text)} + "'!");
+				default:
+					break;
+			}
+		}
+		bool Preprocessor::IsActive() const {
+			return conditionals.empty() || conditionals.back().active;
+		}
+		void Preprocessor::BeginStage() {
+			if (!stageStateSaved) {
+				stageOnceFiles = onceFiles;
+				stageStateSaved = true;
+				return;
+			}
+			// The headers included by the previous stage are included again, the other macros stay defined.
+			onceFiles = stageOnceFiles;
+			for (std::string_view guardMacro : stageGuardMacros) {
+				macros.erase(guardMacro);
+			}
+			stageGuardMacros.clear();
+		}
+
+		void Preprocessor::Include(const PpFile& file, std::string_view args, uint32_t includeDepth) {
+			if (includeDepth + 1 >= maxIncludeDepth) {
+				Error("Includes are nested too deeply, is there an include cycle without an include guard?");
+			}
+			bool quoted = !args.empty() && args[0] == '"';
+			size_t nameEnd = args.empty() ? std::string_view::npos : args.find(quoted ? '"' : '>', 1);
+			if ((!quoted && (args.empty() || args[0] != '<')) || nameEnd == std::string_view::npos ||
+			    nameEnd != args.size() - 1 || nameEnd == 1) {
+				Error("'#include' expects \"file\" or <file>!");
+			}
+			std::string_view name = args.substr(1, nameEnd - 1);
+			std::filesystem::path path = ResolveInclude(file, name, quoted);
+			if (path.empty()) {
+				Error("Include file not found: '" + std::string{name} + "'!");
+			}
+			if (onceFiles.count(path.generic_string()) > 0) {
+				return;
+			}
+			std::shared_ptr<const PpFile> includedFile;
+			try {
+				includedFile = config.ppFileCache->Load(path);
+			} catch (std::runtime_error& err) {
+				Error(err.what());
+			}
+			if (!includedFile->guardMacro.empty() && macros.find(includedFile->guardMacro) != macros.end()) {
+				return;
+			}
+			includedFiles.push_back(includedFile);
+			ProcessFile(*includedFile, includeDepth + 1);
+			if (stageStateSaved && !includedFile->guardMacro.empty()) {
+				stageGuardMacros.push_back(includedFile->guardMacro);
+			}
+		}
+		std::filesystem::path Preprocessor::ResolveInclude(const PpFile& file, std::string_view name, bool quoted) const {
+			auto tryDir = [name](const std::filesystem::path& dir) {
+				std::error_code errCode{};
+				std::filesystem::path candidate = dir / std::filesystem::path{name};
+				if (!std::filesystem::is_regular_file(candidate, errCode)) {
+					return std::filesystem::path{};
+				}
+				// A single spelling per file, for '#pragma once' and the scanned file cache.
+				std::filesystem::path canonical = std::filesystem::weakly_canonical(candidate, errCode);
+				return errCode ? candidate.lexically_normal() : canonical;
+			};
+			if (quoted && !file.path.empty()) {
+				std::filesystem::path path = tryDir(file.path.parent_path());
+				if (!path.empty()) {
+					return path;
+				}
+			}
+			if (config.includeDirs) {
+				for (const std::filesystem::path& includeDir : *config.includeDirs) {
+					std::filesystem::path path = tryDir(includeDir);
+					if (!path.empty()) {
+						return path;
+					}
+				}
+			}
+			return std::filesystem::path{};
+		}
+		void Preprocessor::Define(std::string_view args) {
+			size_t pos{0};
+			std::string_view name = ReadIdentifier(args, pos);
+			if (name.empty()) {
+				Error("Macro name expected after '#define'!");
+			}
+			if (name == "defined") {
+				Error("'defined' can't be used as a macro name!");
+			}
+			Macro macro{};
+			// Only a parenthesis right after the name makes a function-like macro.
+			if (pos < args.size() && args[pos] == '(') {
+				macro.functionLike = true;
+				pos++;
+				SkipSpaces(args, pos);
+				if (pos < args.size() && args[pos] == ')') {
+					pos++;
+				} else {
+					while (true) {
+						SkipSpaces(args, pos);
+						std::string_view param = ReadIdentifier(args, pos);
+						if (param.empty()) {
+							Error(args.substr(pos, 3) == "..." ? "Variadic macros aren't supported!" : "Macro parameter name expected!");
+						}
+						macro.params.push_back(param);
+						SkipSpaces(args, pos);
+						if (pos < args.size() && args[pos] == ',') {
+							pos++;
+						} else if (pos < args.size() && args[pos] == ')') {
+							pos++;
+							break;
+						} else {
+							Error("',' or ')' expected in the macro parameter list!");
+						}
+					}
+				}
+			}
+			macro.body = TrimSpaces(args.substr(pos));
+			macros[name] = macro;
+		}
+
+		void Preprocessor::Expand(std::string_view text, bool startsInComment, std::string& out, uint32_t expansionDepth) {
+			if (expansionDepth > maxExpansionDepth) {
+				Error("Macros are expanded too deeply!");
+			}
+			bool inComment = startsInComment;
+			size_t copyStart{0};
+			size_t pos{0};
+			while (pos < text.size()) {
+				if (inComment) {
+					size_t commentEnd = text.find("*/", pos);
+					pos = commentEnd == std::string_view::npos ? text.size() : commentEnd + 2;
+					inComment = false;
+					continue;
+				}
+				char c = text[pos];
+				char next = pos + 1 < text.size() ? text[pos + 1] : '\0';
+				if (c == '/' && next == '/') {
+					break;
+				} else if (c == '/' && next == '*') {
+					inComment = true;
+					pos += 2;
+				} else if (c == '"' || c == '\'') {
+					pos = SkipQuoted(text, pos);
+				} else if (HasCharClass(c, charClassDecimal) || (c == '.' && HasCharClass(next, charClassDecimal))) {
+					// Numbers, suffixes and exponents included, are never expanded.
+					pos++;
+					while (pos < text.size() && (HasCharClass(text[pos], charClassAlnum) || text[pos] == '.' ||
+					       ((text[pos] == '+' || text[pos] == '-') && (text[pos - 1] == 'e' || text[pos - 1] == 'E')))) {
+						pos++;
+					}
+				} else if (HasCharClass(c, charClassAlpha)) {
+					size_t nameStart = pos;
+					std::string_view name = ReadIdentifier(text, pos);
+					auto macroIt = macros.find(name);
+					if (macroIt != macros.end() && !macroIt->second.expanding) {
+						out.append(text.substr(copyStart, nameStart - copyStart));
+						pos = copyStart = ExpandMacro(macroIt->second, name, text, pos, out, expansionDepth);
+					}
+				} else {
+					pos++;
+				}
+			}
+			out.append(text.substr(copyStart));
+		}
+		size_t Preprocessor::ExpandMacro(Macro& macro, std::string_view name, std::string_view text, size_t nameEnd,
+		                                 std::string& out, uint32_t expansionDepth) {
+			if (!macro.functionLike) {
+				macro.expanding = true;
+				Expand(macro.body, false, out, expansionDepth + 1);
+				macro.expanding = false;
+				return nameEnd;
+			}
+			// 1. A function-like macro's name without arguments is left alone.
+			size_t pos = nameEnd;
+			SkipSpaces(text, pos);
+			if (pos >= text.size() || text[pos] != '(') {
+				out.append(name);
+				return nameEnd;
+			}
+			// 2. The arguments, split by the commas outside of nested parentheses.
+			std::vector<std::string_view> args;
+			size_t argStart = ++pos;
+			uint32_t parenDepth{0};
+			while (true) {
+				if (pos >= text.size()) {
+					Error("Unterminated invocation of the macro '" + std::string{name} + "', it must fit into a single line!");
+				}
+				char c = text[pos];
+				if (c == '"' || c == '\'') {
+					pos = SkipQuoted(text, pos);
+					continue;
+				}
+				if (c == '(') {
+					parenDepth++;
+				} else if (c == ')' && parenDepth > 0) {
+					parenDepth--;
+				} else if ((c == ')' || c == ',') && parenDepth == 0) {
+					args.push_back(TrimSpaces(text.substr(argStart, pos - argStart)));
+					argStart = pos + 1;
+					if (c == ')') {
+						pos++;
+						break;
+					}
+				}
+				pos++;
+			}
+			if (macro.params.empty() && args.size() == 1 && args[0].empty()) {
+				args.clear();
+			}
+			if (args.size() != macro.params.size()) {
+				Error("The macro '" + std::string{name} + "' expects " + std::to_string(macro.params.size()) +
+				      " argument(s), " + std::to_string(args.size()) + " given!");
+			}
+			// 3. The replacement is rescanned for more macros, except for this one.
+			std::string replacement = Substitute(macro, args, expansionDepth);
+			macro.expanding = true;
+			Expand(replacement, false, out, expansionDepth + 1);
+			macro.expanding = false;
+			return pos;
+		}
+		std::string Preprocessor::Substitute(const Macro& macro, const std::vector<std::string_view>& args, uint32_t expansionDepth) {
+			auto findParam = [&macro](std::string_view name) {
+				for (size_t i = 0; i < macro.params.size(); i++) {
+					if (macro.params[i] == name) {
+						return i;
+					}
+				}
+				return macro.params.size();
+			};
+			// Arguments are expanded on their own first, unless they're operands of '#' or '##'.
+			std::vector<std::string> expandedArgs(args.size());
+			std::vector<bool> argsExpanded(args.size(), false);
+			std::string_view body = macro.body;
+			std::string replacement;
+			bool pasted{false};
+			size_t pos{0};
+			while (pos < body.size()) {
+				char c = body[pos];
+				if (c == '#' && pos + 1 < body.size() && body[pos + 1] == '#') {
+					while (!replacement.empty() && (replacement.back() == ' ' || replacement.back() == '\t')) {
+						replacement.pop_back();
+					}
+					pos += 2;
+					SkipSpaces(body, pos);
+					pasted = true;
+					continue;
+				}
+				if (c == '#') {
+					pos++;
+					SkipSpaces(body, pos);
+					size_t paramIdx = findParam(ReadIdentifier(body, pos));
+					if (paramIdx == macro.params.size()) {
+						Error("'#' must be followed by a macro parameter!");
+					}
+					replacement += '"';
+					for (char argChar : args[paramIdx]) {
+						if (argChar == '"' || argChar == '\\') {
+							replacement += '\\';
+						}
+						replacement += argChar;
+					}
+					replacement += '"';
+					pasted = false;
+					continue;
+				}
+				if (HasCharClass(c, charClassAlpha)) {
+					std::string_view identifier = ReadIdentifier(body, pos);
+					size_t paramIdx = findParam(identifier);
+					if (paramIdx == macro.params.size()) {
+						replacement.append(identifier);
+					} else {
+						size_t nextPos = pos;
+						SkipSpaces(body, nextPos);
+						bool pasteNext = body.substr(nextPos, 2) == "##";
+						if (pasted || pasteNext) {
+							replacement.append(args[paramIdx]);
+						} else {
+							if (!argsExpanded[paramIdx]) {
+								Expand(args[paramIdx], false, expandedArgs[paramIdx], expansionDepth + 1);
+								argsExpanded[paramIdx] = true;
+							}
+							replacement.append(expandedArgs[paramIdx]);
+						}
+					}
+					pasted = false;
+					continue;
+				}
+				if (c == '"' || c == '\'') {
+					size_t end = SkipQuoted(body, pos);
+					replacement.append(body.substr(pos, end - pos));
+					pos = end;
+				} else {
+					replacement += c;
+					pos++;
+				}
+				pasted = false;
+			}
+			return replacement;
+		}
+
+		bool Preprocessor::EvalCondition(std::string_view args) {
+			// 1. 'defined' is resolved before the macros are expanded.
+			std::string resolved;
+			size_t pos{0};
+			size_t copyStart{0};
+			while (pos < args.size()) {
+				if (!HasCharClass(args[pos], charClassAlpha)) {
+					pos++;
+					continue;
+				}
+				size_t nameStart = pos;
+				if (ReadIdentifier(args, pos) != "defined") {
+					continue;
+				}
+				SkipSpaces(args, pos);
+				bool parenthesized = pos < args.size() && args[pos] == '(';
+				if (parenthesized) {
+					pos++;
+					SkipSpaces(args, pos);
+				}
+				std::string_view name = ReadIdentifier(args, pos);
+				SkipSpaces(args, pos);
+				if (name.empty() || (parenthesized && (pos >= args.size() || args[pos++] != ')'))) {
+					Error("'defined' expects a macro name!");
+				}
+				resolved.append(args.substr(copyStart, nameStart - copyStart));
+				resolved += macros.find(name) != macros.end() ? " 1 " : " 0 ";
+				copyStart = pos;
+			}
+			resolved.append(args.substr(copyStart));
+			// 2. The expansion and the evaluation.
+			std::string expanded;
+			Expand(resolved, false, expanded, 0);
+			if (TrimSpaces(expanded).empty()) {
+				Error("Condition expected!");
+			}
+			try {
+				return PpExprEvaluator{expanded}.Evaluate() != 0;
+			} catch (std::runtime_error& err) {
+				Error(err.what());
+			}
+		}
+
+		void Preprocessor::Error(std::string_view errMsg) const {
+			std::string location;
+			if (currentFile) {
+				location = currentFile->path.empty() ? std::string{} : currentFile->path.generic_string() + ":";
+				location += std::to_string(currentLineNum);
+			}
+			throw std::runtime_error{"Preprocessor error [" + location + "]: " + std::string{errMsg}};
+		}
+
+	}
+}
@@ -8,16 +8,25 @@ namespace crayon {
 		void SemanticAnalyzer::SetEnvironmentContext(const EnvironmentContext& envCtx) {
 			this->envCtx = envCtx;
 			exprTypeInferenceVisitor.SetEnvironmentContext(this->envCtx);
+			exprEvalVisitor.SetEnvironmentContext(this->envCtx);
 		}
 		void SemanticAnalyzer::ResetEnvironmentContext() {
 			this->envCtx = EnvironmentContext();
 			exprTypeInferenceVisitor.ResetEnvironmentContext();
+			exprEvalVisitor.ResetEnvironmentContext();
 		}
 
-		bool SemanticAnalyzer::CheckVertexAttribDecl(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) {
+		void SemanticAnalyzer::SetErrorReporter(const ErrorReporter* errorReporter) {
+			this->errorReporter = errorReporter;
+		}
+		bool SemanticAnalyzer::HadSemanticError() const {
+			return hadSemanticError;
+		}
+
+		bool SemanticAnalyzer::CheckVertexAttribDecl(VertexAttribDecl* vertexAttribDecl) {
 			return CheckVertexAttribType(vertexAttribDecl) && CheckVertexAttribChannel(vertexAttribDecl);
 		}
-		bool SemanticAnalyzer::CheckVertexAttribType(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) {
+		bool SemanticAnalyzer::CheckVertexAttribType(VertexAttribDecl* vertexAttribDecl) {
 			// Check the attribute's type specifier. The type must not be:
 			// 1. A boolean type
 			// 2. An opaque type
@@ -44,15 +53,15 @@ namespace crayon {
 			}
 			return true;
 		}
-		bool SemanticAnalyzer::CheckVertexAttribChannel(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) {
+		bool SemanticAnalyzer::CheckVertexAttribChannel(VertexAttribDecl* vertexAttribDecl) {
 			// The channel identifier must map to one of the values in the 'VertexAttribChannel' enumeration.
 			return IdentifierTokenToVertexAttribChannel(vertexAttribDecl->GetChannel()) != VertexAttribChannel::UNDEFINED;
 		}
 
-		bool SemanticAnalyzer::CheckColorAttachmentDecl(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl) {
+		bool SemanticAnalyzer::CheckColorAttachmentDecl(ColorAttachmentDecl* colorAttachmentDecl) {
 			return CheckColorAttachmentType(colorAttachmentDecl) && CheckColorAttachmentChannel(colorAttachmentDecl);
 		}
-		bool SemanticAnalyzer::CheckColorAttachmentType(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl) {
+		bool SemanticAnalyzer::CheckColorAttachmentType(ColorAttachmentDecl* colorAttachmentDecl) {
 			// Check the attachment's type specifier. The type must not be:
 			// 1. A boolean type
 			// 2. A double-precision scalar or vector type
@@ -89,7 +98,7 @@ namespace crayon {
 			}
 			return true;
 		}
-		bool SemanticAnalyzer::CheckColorAttachmentChannel(std::shared_ptr<ColorAttachmentDecl> colorAttachmentDecl) {
+		bool SemanticAnalyzer::CheckColorAttachmentChannel(ColorAttachmentDecl* colorAttachmentDecl) {
 			// The channel identifier must map to one of the values in the 'ColorAttachmentChannel' enumeration.
 			return IdentifierTokenToColorAttachmentChannel(colorAttachmentDecl->GetChannel()) != ColorAttachmentChannel::UNDEFINED;
 		}
@@ -137,14 +146,14 @@ namespace crayon {
 			// we either have to check both, or, better yet, we can retrieve the combined type
 			// of the declaration and check that instead.
 			TypeSpec combinedVarDeclType = varDecl->GetVarTypeSpec();
-			if (CheckTypeSpec(combinedVarDeclType)) {
+			if (!CheckTypeSpec(combinedVarDeclType)) {
 				valid = false;
 				// Report ill-formed type.
 			}
 			// The initializer expression check is the next step.
 			if (varDecl->HasInitializerExpr()) {
-				std::shared_ptr<Expr> initializer = varDecl->GetInitializerExpr();
-				initializer->Accept(&exprTypeInferenceVisitor);
+				Expr* initializer = varDecl->GetInitializerExpr();
+				exprTypeInferenceVisitor.Visit(initializer);
 				size_t initExprTypeId = initializer->GetExprTypeId();
 				const TypeSpec& initExprType = envCtx.typeTable->GetType(initExprTypeId);
 				// 1. Strong type comparison. Types must be the same.
@@ -179,7 +188,7 @@ namespace crayon {
 				// the first and second arguments must be converted to "float" and "vec2", respectively.
 				size_t compsToInit = GetComponentCount(ctorType.type.tokenType);
 				size_t compsAvailable{0};
-				for (const std::shared_ptr<Expr>& arg : ctorCallExpr->GetArgs()) {
+				for (Expr* arg : ctorCallExpr->GetArgs()) {
 					if (compsAvailable >= compsToInit) {
 						// We're about to process another argument, but we already
 						// have enough components to initalize the object with.
@@ -207,7 +216,7 @@ namespace crayon {
 				// Implicit Conversion rules from GLSL spec. Chapter 4.1.10 are applied.
 				// Note that the rules are different from the explicit conversions permitted
 				// in non-array transparent type constructors.
-				const std::vector<std::shared_ptr<Expr>>& ctorArgs = ctorCallExpr->GetArgs();
+				const std::vector<Expr*>& ctorArgs = ctorCallExpr->GetArgs();
 				if (ctorType.dimensions.size() != ctorArgs.size()) {
 					// The number of arguments differs from the dimension of the array we're initializing.
 					// TODO: report this
@@ -230,7 +239,7 @@ namespace crayon {
 				// Now we check each argument's type if it's the same or at least promotable to
 				// the parameter type we've just inferred.
 				for (size_t i = 0; i < ctorArgs.size(); i++) {
-					const std::shared_ptr<Expr>& arg = ctorArgs[i];
+					Expr* arg = ctorArgs[i];
 					const TypeSpec& argType = envCtx.typeTable->GetType(arg->GetExprTypeId());
 					if (!IsTypePromotable(argType, paramType)) {
 						// Argument type cannot be promoted to the parameter type.
@@ -259,7 +268,7 @@ namespace crayon {
 						// Report that implicitly defined array dimension size is not supported!
 						valid = false;
 					} else {
-						arrayDim.dimExpr->Accept(&exprTypeInferenceVisitor);
+						exprTypeInferenceVisitor.Visit(arrayDim.dimExpr);
 						if (!arrayDim.dimExpr->IsConstExpr()) {
 							valid = false;
 							// Report a semantic error, since a non-const expression was used
@@ -271,8 +280,14 @@ namespace crayon {
 						        (arrayDimType.type.tokenType == TokenType::INT ||
 								 arrayDimType.type.tokenType == TokenType::UINT)) {
 								// Scalar integer array dimension expression type.
-								arrayDim.dimExpr->Accept(&exprEvalVisitor);
-								if (exprEvalVisitor.ResultInt()) {
+								if (!exprEvalVisitor.Evaluate(arrayDim.dimExpr)) {
+									valid = false;
+									hadSemanticError = true;
+									Expr* errExpr = exprEvalVisitor.GetErrorExpr();
+									errorReporter->ReportSemanticError(SemanticError{
+										errExpr ? errExpr->GetExprSrcText() : arrayDim.dimExpr->GetExprSrcText(),
+										exprEvalVisitor.GetErrorMessage()});
+								} else if (exprEvalVisitor.ResultInt()) {
 									arrayDim.dimSize = static_cast<size_t>(exprEvalVisitor.GetIntResult());
 								} else if (exprEvalVisitor.ResultUint()) {
 									arrayDim.dimSize = static_cast<size_t>(exprEvalVisitor.GetUintResult());
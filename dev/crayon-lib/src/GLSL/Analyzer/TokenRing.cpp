@@ -0,0 +1,83 @@
+#include "GLSL/Analyzer/TokenRing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace crayon {
+	namespace glsl {
+
+		// The other side usually catches up within a few hundred nanoseconds, a context switch costs more than that.
+		static void Backoff(uint32_t& attempt) {
+			if (attempt < 64) {
+				attempt++;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+
+		TokenRing::TokenRing(size_t capacity) {
+			size_t roundedCapacity{publishBatchSize};
+			while (roundedCapacity < capacity) {
+				roundedCapacity *= 2;
+			}
+			slots.resize(roundedCapacity);
+			mask = roundedCapacity - 1;
+		}
+
+		void TokenRing::Push(const RingToken& token) {
+			assert(!closed.load(std::memory_order_relaxed) && "The ring is already closed!");
+			if (producerHead - producerTail == slots.size()) {
+				producerTail = tail.load(std::memory_order_acquire);
+				if (producerHead - producerTail == slots.size()) {
+					// The consumer may be waiting for the unpublished tokens, so they go out before waiting.
+					Publish();
+					uint32_t attempt{0};
+					while (producerHead - producerTail == slots.size()) {
+						Backoff(attempt);
+						producerTail = tail.load(std::memory_order_acquire);
+					}
+				}
+			}
+			slots[producerHead & mask] = token;
+			producerHead++;
+			if (producerHead - head.load(std::memory_order_relaxed) >= publishBatchSize) {
+				Publish();
+			}
+		}
+		void TokenRing::Close() {
+			Publish();
+			closed.store(true, std::memory_order_release);
+		}
+		void TokenRing::Publish() {
+			head.store(producerHead, std::memory_order_release);
+		}
+
+		size_t TokenRing::Pop(RingToken* out, size_t maxCount) {
+			if (consumerHead == consumerTail) {
+				consumerHead = head.load(std::memory_order_acquire);
+				uint32_t attempt{0};
+				while (consumerHead == consumerTail) {
+					// The final head is published before the ring is closed, it must be read again after seeing the flag.
+					if (closed.load(std::memory_order_acquire)) {
+						consumerHead = head.load(std::memory_order_acquire);
+						if (consumerHead == consumerTail) {
+							return 0;
+						}
+						break;
+					}
+					Backoff(attempt);
+					consumerHead = head.load(std::memory_order_acquire);
+				}
+			}
+			size_t count = std::min(consumerHead - consumerTail, maxCount);
+			for (size_t i = 0; i < count; i++) {
+				out[i] = slots[(consumerTail + i) & mask];
+			}
+			consumerTail += count;
+			tail.store(consumerTail, std::memory_order_release);
+			return count;
+		}
+
+	}
+}
@@ -0,0 +1,96 @@
+#include "GLSL/Analyzer/TokenStream.h"
+
+namespace crayon {
+	namespace glsl {
+
+		void TokenStream::Reset(const char* srcData, size_t srcSize) {
+			assert(srcSize <= maxTokenStreamSrcSize && "Token offsets are 32 bits wide!");
+			this->srcData = srcData;
+			this->srcSize = srcSize;
+			offsets.clear();
+			lengths.clear();
+			tokenTypes.clear();
+			constTokenIdxs.clear();
+			constIds.clear();
+		}
+		void TokenStream::Reserve(size_t tokenCount) {
+			offsets.reserve(tokenCount);
+			lengths.reserve(tokenCount);
+			tokenTypes.reserve(tokenCount);
+		}
+
+		size_t TokenStream::FindFirstTokenEndingAtOrAfter(size_t offset) const {
+			size_t first{0};
+			size_t count = GetSize();
+			while (count > 0) {
+				size_t step = count / 2;
+				size_t idx = first + step;
+				if (static_cast<size_t>(offsets[idx]) + lengths[idx] < offset) {
+					first = idx + 1;
+					count -= step + 1;
+				} else {
+					count = step;
+				}
+			}
+			return first;
+		}
+		size_t TokenStream::FindFirstTokenStartingAtOrAfter(size_t offset) const {
+			auto tokenOffset = std::lower_bound(offsets.begin(), offsets.end(), static_cast<uint32_t>(offset));
+			return tokenOffset - offsets.begin();
+		}
+
+		template<typename T>
+		static void SpliceArray(std::vector<T>& dst, size_t first, size_t last, const std::vector<T>& src) {
+			// Overwrite the common part, then only the tail moves (once).
+			size_t common = std::min(last - first, src.size());
+			std::copy(src.begin(), src.begin() + common, dst.begin() + first);
+			if (src.size() > common) {
+				dst.insert(dst.begin() + first + common, src.begin() + common, src.end());
+			} else {
+				dst.erase(dst.begin() + first + common, dst.begin() + last);
+			}
+		}
+
+		void TokenStream::Splice(size_t first, size_t last, const TokenStream& replacement, ptrdiff_t offsetShift) {
+			assert(first <= last && last <= GetSize() && "The spliced range is out of bounds!");
+			assert(replacement.srcSize <= maxTokenStreamSrcSize && "Token offsets are 32 bits wide!");
+			// 1. The constants of the replaced tokens, their indices become relative to the replacement.
+			size_t constFirst = std::lower_bound(constTokenIdxs.begin(), constTokenIdxs.end(), static_cast<uint32_t>(first)) - constTokenIdxs.begin();
+			size_t constLast = std::lower_bound(constTokenIdxs.begin(), constTokenIdxs.end(), static_cast<uint32_t>(last)) - constTokenIdxs.begin();
+			std::vector<uint32_t> replacementConstTokenIdxs{replacement.constTokenIdxs};
+			for (uint32_t& constTokenIdx : replacementConstTokenIdxs) {
+				constTokenIdx += static_cast<uint32_t>(first);
+			}
+			SpliceArray(constTokenIdxs, constFirst, constLast, replacementConstTokenIdxs);
+			SpliceArray(constIds, constFirst, constLast, replacement.constIds);
+			ptrdiff_t idxShift = static_cast<ptrdiff_t>(replacement.GetSize()) - static_cast<ptrdiff_t>(last - first);
+			for (size_t i = constFirst + replacementConstTokenIdxs.size(); i < constTokenIdxs.size(); i++) {
+				constTokenIdxs[i] = static_cast<uint32_t>(constTokenIdxs[i] + idxShift);
+			}
+			// 2. The tokens themselves.
+			SpliceArray(offsets, first, last, replacement.offsets);
+			SpliceArray(lengths, first, last, replacement.lengths);
+			SpliceArray(tokenTypes, first, last, replacement.tokenTypes);
+			for (size_t i = first + replacement.GetSize(); i < offsets.size(); i++) {
+				offsets[i] = static_cast<uint32_t>(offsets[i] + offsetShift);
+			}
+			srcData = replacement.srcData;
+			srcSize = replacement.srcSize;
+		}
+
+		const char* TokenStream::GetSrcData() const {
+			return srcData;
+		}
+		size_t TokenStream::GetSrcSize() const {
+			return srcSize;
+		}
+
+		void TokenWindow::Reset(const char* srcData, size_t srcSize) {
+			assert(srcSize <= maxTokenStreamSrcSize && "Token offsets are 32 bits wide!");
+			this->srcData = srcData;
+			this->srcSize = srcSize;
+			size = 0;
+		}
+
+	}
+}
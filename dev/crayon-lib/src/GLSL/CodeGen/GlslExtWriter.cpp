@@ -3,20 +3,22 @@
 namespace crayon {
 	namespace glsl {
 
-		GlslExtWriter::GlslExtWriter(const GlslWriterConfig& config) {
+		GlslExtWriter::GlslExtWriter(const GlslWriterConfig& config, AstArena& astArena,
+			                             CompileStats* stats, TraceRecorder* trace)
+			: astArena(astArena), stats(stats), trace(trace) {
 			glslWriter = std::make_unique<GlslWriter>(config);
 		}
 
 		std::shared_ptr<ShaderProgram> GlslExtWriter::CompileToGlsl(ShaderProgramBlock* program) {
 			std::string_view name = program->GetShaderProgramName();
 			shaderProgram = std::make_shared<ShaderProgram>(name);
-			program->Accept(this);
+			Visit(program);
 			return shaderProgram;
 		}
 
 		void GlslExtWriter::VisitShaderProgramBlock(ShaderProgramBlock* programBlock) {
-			for (const std::shared_ptr<Block>& block : programBlock->GetBlocks()) {
-				block->Accept(this);
+			for (Block* block : programBlock->GetBlocks()) {
+				Visit(block);
 			}
 		}
 		void GlslExtWriter::VisitFixedStagesConfigBlock(FixedStagesConfigBlock* fixedStagesConfigBlock) {
@@ -25,7 +27,7 @@ namespace crayon {
 		void GlslExtWriter::VisitMaterialPropertiesBlock(MaterialPropertiesBlock* materialPropertiesBlock) {
 			MaterialProps matPropsDesc{};
 			matPropsDesc.name = ExtractStringLiteral(materialPropertiesBlock->GetName());
-			for (const std::shared_ptr<MatPropDecl>& matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
+			for (MatPropDecl* matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
 				const Token& type = matPropDecl->GetType();
 				const Token& name = matPropDecl->GetName();
 				TokenType tokenType = MapMaterialPropertyType(type.tokenType);
@@ -48,29 +50,31 @@ namespace crayon {
 			shaderProgram->SetColorAttachments(GenerateColorAttachments(colorAttachmentsBlock));
 		}
 		void GlslExtWriter::VisitShaderBlock(ShaderBlock* shaderBlock) {
+			PhaseTimer stageTimer{};
+			ShaderType shaderType = shaderBlock->GetShaderType();
+			TraceScope stageSpan{trace, ShaderTypeToStr(shaderType), "stage"};
 			glslWriter->ResetInternalState();
 			glslWriter->PrintGlslVersionLine();
-			ShaderType shaderType = shaderBlock->GetShaderType();
 			switch (shaderType) {
 				case ShaderType::VS: {
 					// Print vertex input layout (variable declarations are used).
 					const VertexInputLayoutDesc& vertexInputLayout = shaderProgram->GetVertexInputLayout();
-					for (std::shared_ptr<VarDecl>& vertexAttribDecl : CreateVertexAttribDecls(vertexInputLayout)) {
-						vertexAttribDecl->Accept(glslWriter.get());
+					for (VarDecl* vertexAttribDecl : CreateVertexAttribDecls(astArena, vertexInputLayout)) {
+						glslWriter->Visit(vertexAttribDecl);
 						glslWriter->PrintNewLine();
 					}
 					// TEST
 					const MaterialProps& matProps = shaderProgram->GetMaterialProps();
 					if (!matProps.IsEmpty()) {
-						std::shared_ptr<InterfaceBlockDecl> matPropsIntBlock = CreateUniformInterfaceBlockDecl(matProps);
-						matPropsIntBlock->Accept(glslWriter.get());
+						InterfaceBlockDecl* matPropsIntBlock = CreateUniformInterfaceBlockDecl(astArena, matProps);
+						glslWriter->Visit(matPropsIntBlock);
 						glslWriter->PrintNewLine();
 					}
 					// TEST
 
-					std::shared_ptr<TransUnit> transUnit = shaderBlock->GetTranslationUnit();
+					TransUnit* transUnit = shaderBlock->GetTranslationUnit();
 					shaderProgram->SetShaderModuleGlsl(ShaderType::VS,
-						                               glslWriter->CompileTranslationUnitToGlsl(transUnit.get()));
+						                               glslWriter->CompileTranslationUnitToGlsl(transUnit));
 					break;
 				}
 				case ShaderType::TCS:
@@ -85,24 +89,27 @@ namespace crayon {
 				case ShaderType::FS: {
 					// Print color attachments.
 					const ColorAttachments& colorAttachments = shaderProgram->GetColorAttachments();
-					for (std::shared_ptr<VarDecl>& vertexAttribDecl : CreateColorAttachmentVarDecls(colorAttachments)) {
-						vertexAttribDecl->Accept(glslWriter.get());
+					for (VarDecl* vertexAttribDecl : CreateColorAttachmentVarDecls(astArena, colorAttachments)) {
+						glslWriter->Visit(vertexAttribDecl);
 						glslWriter->PrintNewLine();
 					}
 					// Print material properties (uniform interface block is used).
 					const MaterialProps& matProps = shaderProgram->GetMaterialProps();
 					if (!matProps.IsEmpty()) {
-						std::shared_ptr<InterfaceBlockDecl> matPropsIntBlock = CreateUniformInterfaceBlockDecl(matProps);
-						matPropsIntBlock->Accept(glslWriter.get());
+						InterfaceBlockDecl* matPropsIntBlock = CreateUniformInterfaceBlockDecl(astArena, matProps);
+						glslWriter->Visit(matPropsIntBlock);
 						glslWriter->PrintNewLine();
 					}
 					// Print the rest of the code:
-					std::shared_ptr<TransUnit> transUnit = shaderBlock->GetTranslationUnit();
+					TransUnit* transUnit = shaderBlock->GetTranslationUnit();
 					shaderProgram->SetShaderModuleGlsl(ShaderType::FS,
-						                               glslWriter->CompileTranslationUnitToGlsl(transUnit.get()));
+						                               glslWriter->CompileTranslationUnitToGlsl(transUnit));
 					break;
 				}
 			}
+			if (stats) {
+				stats->stages[static_cast<size_t>(shaderType)].glslGeneration = stageTimer.Stop();
+			}
 		}
 		
 	}
@@ -6,16 +6,33 @@
 namespace crayon {
 	namespace glsl {
 
+		// Assignments and ternary expressions bind looser than any binary operator,
+		// unary and postfix expressions bind tighter.
+		static constexpr int assignPrecedence{-1};
+		static constexpr int ternaryPrecedence{0};
+		static constexpr int unaryPrecedence{12};
+		static constexpr int postfixPrecedence{13};
+
+		static int GetExprPrecedence(Expr* expr) {
+			switch (expr->GetKind()) {
+				case ExprKind::ASSIGN: return assignPrecedence;
+				case ExprKind::TERNARY: return ternaryPrecedence;
+				case ExprKind::BINARY: return GetBinaryOpPrecedence(static_cast<BinaryExpr*>(expr)->GetOperator().tokenType);
+				case ExprKind::UNARY: return unaryPrecedence;
+				default: return postfixPrecedence;
+			}
+		}
+
 		GlslWriter::GlslWriter(const GlslWriterConfig& config)
 			: config(config) {
 		}
 
 		std::string GlslWriter::CompileShaderProgramToGlsl(ShaderProgramBlock* shaderProgram) {
-			shaderProgram->Accept(this);
+			Visit(shaderProgram);
 			return src.str();
 		}
 		std::string GlslWriter::CompileTranslationUnitToGlsl(TransUnit* transUnit) {
-			transUnit->Accept(this);
+			Visit(transUnit);
 			return src.str();
 		}
 
@@ -39,9 +56,9 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<Block>& block : programBlock->GetBlocks()) {
+			for (Block* block : programBlock->GetBlocks()) {
 				WriteIndentation();
-				block->Accept(this);
+				Visit(block);
 				src << "\n";
 			}
 			indentLvl--;
@@ -56,7 +73,7 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<MatPropDecl>& matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
+			for (MatPropDecl* matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
 				WriteIndentation();
 				const Token& type = matPropDecl->GetType();
 				const Token& name = matPropDecl->GetName();
@@ -74,7 +91,7 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<VertexAttribDecl>& vertexAttribDecl : vertexInputLayoutBlock->GetAttribDecls()) {
+			for (VertexAttribDecl* vertexAttribDecl : vertexInputLayoutBlock->GetAttribDecls()) {
 				WriteIndentation();
 				const TypeSpec& typeSpec = vertexAttribDecl->GetTypeSpec();
 				src << typeSpec.type.lexeme;
@@ -93,7 +110,7 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<ColorAttachmentDecl>& colorAttachment : colorAttachmentsBlock->GetColorAttachments()) {
+			for (ColorAttachmentDecl* colorAttachment : colorAttachmentsBlock->GetColorAttachments()) {
 				WriteIndentation();
 				const TypeSpec& typeSpec = colorAttachment->GetTypeSpec();
 				src << typeSpec.type.lexeme;
@@ -130,7 +147,7 @@ namespace crayon {
 			indentLvl++;
 			WriteIndentation();
 			src << "BEGIN\n";
-			shaderBlock->GetTranslationUnit()->Accept(this);
+			Visit(shaderBlock->GetTranslationUnit());
 			WriteIndentation();
 			src << "END\n";
 			indentLvl--;
@@ -140,9 +157,9 @@ namespace crayon {
 		// Decl visit methods
 		void GlslWriter::VisitTransUnit(TransUnit* transUnit) {
 			// ResetInternalState();
-			for (const std::shared_ptr<Decl>& decl : transUnit->GetDeclarations()) {
+			for (Decl* decl : transUnit->GetDeclarations()) {
 				WriteIndentation();
-				decl->Accept(this);
+				Visit(decl);
 				src << "\n";
 			}
 			// Do we want to leave the last new line character?
@@ -158,9 +175,9 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<VarDecl>& varDecl : intBlockDecl->GetFields()) {
+			for (VarDecl* varDecl : intBlockDecl->GetFields()) {
 				WriteIndentation();
-				varDecl->Accept(this);
+				Visit(varDecl);
 				src << "\n";
 			}
 			indentLvl--;
@@ -178,7 +195,7 @@ namespace crayon {
 				}
 				if (varDecl->HasInitializerExpr()) {
 					src << " = ";
-					varDecl->GetInitializerExpr()->Accept(this);
+					Visit(varDecl->GetInitializerExpr());
 				}
 				src << ",";
 			}
@@ -186,7 +203,7 @@ namespace crayon {
 			src << ";";
 		}
 		void GlslWriter::VisitFunDecl(FunDecl* funDecl) {
-			std::shared_ptr<FunProto> funProto = funDecl->GetFunProto();
+			FunProto* funProto = funDecl->GetFunProto();
 			WriteFunctionPrototype(funProto);
 			if (funDecl->IsFunDecl()) {
 				src << ";";
@@ -194,8 +211,8 @@ namespace crayon {
 			} else {
 				src << " "; // before the opening bracket
 			}
-			std::shared_ptr<BlockStmt> funStmts = funDecl->GetBlockStmt();
-			VisitBlockStmt(funStmts.get());
+			BlockStmt* funStmts = funDecl->GetBlockStmt();
+			VisitBlockStmt(funStmts);
 		}
 		void GlslWriter::VisitQualDecl(QualDecl* qualDecl) {
 			const TypeQual& typeQual = qualDecl->GetTypeQualifier();
@@ -213,7 +230,7 @@ namespace crayon {
 			}
 			if (varDecl->HasInitializerExpr()) {
 				src << " = ";
-				varDecl->GetInitializerExpr()->Accept(this);
+				Visit(varDecl->GetInitializerExpr());
 			}
 			src << ";";
 		}
@@ -223,8 +240,8 @@ namespace crayon {
 			WriteOpeningBlockBrace();
 			src << "\n";
 			indentLvl++;
-			for (const std::shared_ptr<Stmt>& stmt : blockStmt->GetStatements()) {
-				stmt.get()->Accept(this);
+			for (Stmt* stmt : blockStmt->GetStatements()) {
+				Visit(stmt);
 				src << "\n";
 			}
 			indentLvl--;
@@ -232,12 +249,12 @@ namespace crayon {
 		}
 		void GlslWriter::VisitDeclStmt(DeclStmt* declStmt) {
 			WriteIndentation();
-			declStmt->GetDeclaration()->Accept(this);
+			Visit(declStmt->GetDeclaration());
 			// src << ";";
 		}
 		void GlslWriter::VisitExprStmt(ExprStmt* exprStmt) {
 			WriteIndentation();
-			exprStmt->GetExpression()->Accept(this);
+			Visit(exprStmt->GetExpression());
 			src << ";";
 		}
 
@@ -251,11 +268,11 @@ namespace crayon {
 			if (initListLvl == 1) {
 				src << "\n";
 			}
-			for (const std::shared_ptr<Expr>& initExpr : InitListExpr->GetInitExprs()) {
+			for (Expr* initExpr : InitListExpr->GetInitExprs()) {
 				if (initListLvl == 1) {
 					WriteIndentation();
 				}
-				initExpr.get()->Accept(this);
+				Visit(initExpr.get());
 				src << ", ";
 				if (initListLvl == 1) {
 					RemoveFromOutput(1);
@@ -284,37 +301,48 @@ namespace crayon {
 			Expr* lvalue = assignExpr->GetLvalue();
 			Expr* rvalue = assignExpr->GetRvalue();
 
-			lvalue->Accept(this);
+			Visit(lvalue);
 			src << " " << assignExpr->GetAssignOp().lexeme << " ";
-			rvalue->Accept(this);
+			Visit(rvalue);
+		}
+		void GlslWriter::VisitTernaryExpr(TernaryExpr* ternaryExpr) {
+			// The branches may be any expression: they're delimited by '?' and ':'.
+			WriteOperand(ternaryExpr->GetCondition(), ternaryPrecedence + 1);
+			src << " ? ";
+			Visit(ternaryExpr->GetTrueExpr());
+			src << " : ";
+			Visit(ternaryExpr->GetFalseExpr());
 		}
 		void GlslWriter::VisitBinaryExpr(BinaryExpr* binaryExpr) {
 			Expr* left = binaryExpr->GetLeftExpr();
 			Expr* right = binaryExpr->GetRightExpr();
 			const Token& op = binaryExpr->GetOperator();
 
-			left->Accept(this);
+			// The binary operators are left-associative.
+			int precedence = GetBinaryOpPrecedence(op.tokenType);
+			WriteOperand(left, precedence);
 			src << " " << op.lexeme << " ";
-			right->Accept(this);
+			WriteOperand(right, precedence + 1);
 		}
 		void GlslWriter::VisitUnaryExpr(UnaryExpr* unaryExpr) {
 			Expr* expr = unaryExpr->GetExpr();
 			const Token& op = unaryExpr->GetOperator();
 
 			src << op.lexeme;
-			expr->Accept(this);
+			// Nested unary operators are parenthesized as well, "--x" would be a decrement.
+			WriteOperand(expr, postfixPrecedence);
 		}
 		void GlslWriter::VisitFieldSelectExpr(FieldSelectExpr* fieldSelectExpr) {
 			Expr* target = fieldSelectExpr->GetTarget();
 			const Token& field = fieldSelectExpr->GetField();
 
-			target->Accept(this);
+			WriteOperand(target, postfixPrecedence);
 			src << ".";
 			src << field.lexeme;
 		}
 		void GlslWriter::VisitFunCallExpr(FunCallExpr* funCallExpr) {
 			Expr* target = funCallExpr->GetTarget();
-			target->Accept(this);
+			Visit(target);
 			if (funCallExpr->HasArgs()) {
 				WriteFunCallArgs(funCallExpr);
 			}
@@ -350,7 +378,7 @@ namespace crayon {
 		}
 		void GlslWriter::VisitGroupExpr(GroupExpr* groupExpr) {
 			src << "(";
-			groupExpr->Accept(this);
+			Visit(groupExpr->GetExpr());
 			src << ")";
 		}
 
@@ -367,7 +395,7 @@ namespace crayon {
 		}
 		void GlslWriter::WriteTypeSpecifier(const TypeSpec& typeSpec) {
 			if (typeSpec.typeDecl) {
-				WriteStructDecl(typeSpec.typeDecl.get());
+				WriteStructDecl(typeSpec.typeDecl);
 			} else {
 				src << typeSpec.type.lexeme;
 			}
@@ -377,7 +405,7 @@ namespace crayon {
 				src << "[";
 				if (dimension.dimExpr) {
 					// Dimension size can be left unspecified.
-					dimension.dimExpr.get()->Accept(this);
+					Visit(dimension.dimExpr);
 				}
 				src << "]";
 			}
@@ -440,9 +468,9 @@ namespace crayon {
 			src << "\n";
 
 			indentLvl++;
-			for (const std::shared_ptr<VarDecl>& varDecl : structDecl->GetFields()) {
+			for (VarDecl* varDecl : structDecl->GetFields()) {
 				WriteIndentation();
-				varDecl->Accept(this);
+				Visit(varDecl);
 				src << "\n";
 			}
 			indentLvl--;
@@ -454,9 +482,9 @@ namespace crayon {
 		void GlslWriter::WriteInitListFirst(InitListExpr* initListExpr) {
 			// WriteOpeningBlockBrace();
 			src << "{\n";
-			for (const std::shared_ptr<Expr>& initExpr : initListExpr->GetInitExprs()) {
+			for (Expr* initExpr : initListExpr->GetInitExprs()) {
 				WriteIndentation();
-				initExpr.get()->Accept(this);
+				Visit(initExpr);
 				src << ",\n";
 			}
 			// 1 - if you want a trailing comma, and
@@ -467,15 +495,15 @@ namespace crayon {
 		void GlslWriter::WriteInitListRest(InitListExpr* initListExpr) {
 			// WriteOpeningBlockBrace();
 			src << "{";
-			for (const std::shared_ptr<Expr>& initExpr : initListExpr->GetInitExprs()) {
-				initExpr.get()->Accept(this);
+			for (Expr* initExpr : initListExpr->GetInitExprs()) {
+				Visit(initExpr);
 				src << ", ";
 			}
 			RemoveFromOutput(2);
 			src << "}";
 		}
 
-		void GlslWriter::WriteFunctionPrototype(std::shared_ptr<FunProto> funProto) {
+		void GlslWriter::WriteFunctionPrototype(FunProto* funProto) {
 			const FullSpecType& retType = funProto->GetReturnType();
 			const Token& funName = funProto->GetFunctionName();
 
@@ -489,8 +517,8 @@ namespace crayon {
 			}
 			src << ")";
 		}
-		void GlslWriter::WriteFunctionParameterList(const std::vector<std::shared_ptr<FunParam>>& funParamList) {
-			for (const std::shared_ptr<FunParam>& funParam : funParamList) {
+		void GlslWriter::WriteFunctionParameterList(const std::vector<FunParam*>& funParamList) {
+			for (FunParam* funParam : funParamList) {
 				const FullSpecType& paramType = funParam->GetVarType();
 				WriteFullySpecifiedType(paramType);
 				src << " ";
@@ -506,14 +534,23 @@ namespace crayon {
 		void GlslWriter::WriteFunCallArgs(CallExpr* callExpr) {
 			WriteFunCallArgs(callExpr->GetArgs());
 		}
-		void GlslWriter::WriteFunCallArgs(const std::vector<std::shared_ptr<Expr>>& callArgs) {
-			for (const std::shared_ptr<Expr>& arg : callArgs) {
-				arg->Accept(this);
+		void GlslWriter::WriteFunCallArgs(const std::vector<Expr*>& callArgs) {
+			for (Expr* arg : callArgs) {
+				Visit(arg);
 				src << ", ";
 			}
 			if (!callArgs.empty())
 				RemoveFromOutput(2); // to remove the last two characters: ", "
 		}
+		void GlslWriter::WriteOperand(Expr* operand, int precedence) {
+			if (GetExprPrecedence(operand) < precedence) {
+				src << "(";
+				Visit(operand);
+				src << ")";
+			} else {
+				Visit(operand);
+			}
+		}
 
 		void GlslWriter::WriteOpeningBlockBrace() {
 			if (config.openingBraceOnSameLine) {
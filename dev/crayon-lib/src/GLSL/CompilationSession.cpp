@@ -0,0 +1,488 @@
+#include "GLSL/CompilationSession.h"
+#include "GLSL/CompileCache.h"
+#include "GLSL/CodeGen/GlslWriter.h"
+#include "GLSL/CodeGen/GlslExtWriter.h"
+#include "GLSL/AST/AstPrinter.h"
+
+#include "Sha256.h"
+
+#include "Trace.h"
+
+#include <cassert>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace crayon {
+	namespace glsl {
+
+		// Generated files are placed next to the source file and named after it ("<name>.<stage>.<format>"),
+		// so the sessions of a batch never write the same files.
+		static void WriteShaderModuleFiles(const ShaderModule& shaderModule, const std::filesystem::path& srcCodePath,
+		                                   std::string_view stage) {
+			std::string basePath = (srcCodePath.parent_path() / srcCodePath.stem()).string();
+			basePath += ".";
+			basePath += stage;
+			if (shaderModule.HasGlsl()) {
+				std::ofstream glslFile{basePath + ".glsl", std::ofstream::out | std::ofstream::binary};
+				glslFile << shaderModule.glsl;
+			}
+			if (shaderModule.HasSpvAsm()) {
+				std::ofstream spvAsmFile{basePath + ".spvasm", std::ofstream::out | std::ofstream::binary};
+				spvAsmFile << shaderModule.spvAsm;
+			}
+			if (shaderModule.HasSpvBinary()) {
+				std::ofstream spvBinaryFile{basePath + ".spv", std::ofstream::out | std::ofstream::binary};
+				spvBinaryFile.write(reinterpret_cast<const char*>(shaderModule.spvBinary.data()),
+				                    shaderModule.spvBinary.size() * sizeof(uint32_t));
+			}
+		}
+
+		CompilationSession::CompilationSession() {
+			preprocessor = std::make_unique<Preprocessor>();
+			ppFileCache = std::make_unique<PpFileCache>();
+			lexer = std::make_unique<Lexer>();
+			parser = std::make_unique<Parser>();
+			errorReporter = std::make_unique<ErrorReporter>();
+			typeTable = std::make_unique<TypeTable>();
+			constTable = std::make_unique<ConstantTable>();
+			astArena = std::make_unique<AstArena>();
+		}
+
+		bool CompilationSession::Compile(const std::filesystem::path& srcCodePath, const CompilerConfig& compilerConfig) {
+			ReadSrcCode(srcCodePath);
+			this->srcCodePath = srcCodePath;
+			const DebugDumpConfig& dumpConfig = compilerConfig.debugDump;
+			debugDump.Reset(dumpConfig.channels);
+			bool compiled = CompileAndCollectStats(srcFile.GetData(), srcFile.GetSize(), compilerConfig);
+			// The dumps of a failed compilation are the most useful ones, so they're written either way.
+			if (dumpConfig.channels != 0) {
+				std::filesystem::path dumpDir = dumpConfig.dumpDir.empty() ? srcCodePath.parent_path() : dumpConfig.dumpDir;
+				debugDump.WriteFiles(dumpDir, srcCodePath.stem().string());
+			}
+			if (!compiled) {
+				return false;
+			}
+			WriteOutputFiles(srcCodePath);
+			return true;
+		}
+		bool CompilationSession::Compile(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig) {
+			srcCodePath.clear();
+			// Without a dump directory there's nowhere to write the dumps to, so they aren't even collected.
+			const DebugDumpConfig& dumpConfig = compilerConfig.debugDump;
+			debugDump.Reset(dumpConfig.dumpDir.empty() ? 0 : dumpConfig.channels);
+			bool compiled = CompileAndCollectStats(srcCode, srcCodeSize, compilerConfig);
+			if (dumpConfig.channels != 0 && !dumpConfig.dumpDir.empty()) {
+				Sha256 hasher{};
+				hasher.Update(srcCode, srcCodeSize);
+				std::string baseName = "memory_" + DigestToHexString(hasher.Finalize()).substr(0, 16);
+				debugDump.WriteFiles(dumpConfig.dumpDir, baseName);
+			}
+			return compiled;
+		}
+
+		bool CompilationSession::PrecompileHeader(const std::filesystem::path& headerPath, const std::filesystem::path& pchPath,
+		                                          const CompilerConfig& compilerConfig) {
+			if (compilerConfig.errStream) {
+				errorReporter->SetErrorStream(compilerConfig.errStream);
+			}
+			srcFile.Open(headerPath);
+			srcCodePath = headerPath;
+
+			// 1. Preprocessing, always: the macros and the included files are part of the header.
+			PreprocessorConfig ppConfig{};
+			ppConfig.srcCodePath = srcCodePath;
+			ppConfig.includeDirs = &compilerConfig.includeDirs;
+			ppConfig.ppFileCache = compilerConfig.ppFileCache ? compilerConfig.ppFileCache : ppFileCache.get();
+			try {
+				preprocessor->Process(srcFile.GetData(), srcFile.GetSize(), ppConfig);
+			} catch (std::runtime_error& err) {
+				errorReporter->ReportError(err.what());
+				return false;
+			}
+			const std::string& srcCode = preprocessor->GetOutput();
+			errorReporter->SetSrcCodeLink(srcCode.data(), srcCode.size());
+			errorReporter->SetLineMap(&preprocessor->GetLineMap());
+
+			// 2. Lexing
+			LexerConfig lexConfig{};
+			lexConfig.errorReporter = errorReporter.get();
+			lexConfig.gpuApiType = compilerConfig.options.gpuApiType;
+			lexConfig.constTable = constTable.get();
+			bool lexed = lexer->Scan(srcCode.data(), srcCode.size(), lexConfig);
+
+			// 3. Parsing
+			ParserConfig parserConfig{};
+			parserConfig.errorReporter = errorReporter.get();
+			parserConfig.typeTable = typeTable.get();
+			parserConfig.constTable = constTable.get();
+			parserConfig.astArena = astArena.get();
+			parserConfig.gpuApiType = compilerConfig.options.gpuApiType;
+			parser->ParseHeader(lexer->GetTokenStream(), parserConfig);
+			if (!lexed || parser->HadSyntaxError() || parser->HadSemanticError()) {
+				return false;
+			}
+
+			// 4. Writing
+			PchContents contents{};
+			contents.srcCode = srcCode;
+			contents.files = preprocessor->GetProcessedFiles();
+			contents.macros = preprocessor->GetMacroDefinitions();
+			contents.decls = parser->GetHeaderTransUnit()->GetDeclarations();
+			contents.typeTable = typeTable.get();
+			contents.constTable = constTable.get();
+			PrecompiledHeader::Write(pchPath, contents);
+			return true;
+		}
+
+		const ShaderProgram& CompilationSession::GetShaderProgram() const {
+			return shaderProgram;
+		}
+		const CompileStats& CompilationSession::GetStats() const {
+			return stats;
+		}
+
+		bool CompilationSession::CompileAndCollectStats(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig) {
+			if (compilerConfig.errStream) {
+				errorReporter->SetErrorStream(compilerConfig.errStream);
+			}
+			stats = CompileStats{};
+			stats.srcCodeSize = srcCodeSize;
+			bool compiled = CompileOrLoadSrcCode(srcCode, srcCodeSize, compilerConfig);
+			if (compiled) {
+				CollectStageStats();
+			}
+			if (compilerConfig.stats) {
+				*compilerConfig.stats = stats;
+			}
+			return compiled;
+		}
+
+		bool CompilationSession::CompileOrLoadSrcCode(const char* srcCode, size_t srcCodeSize, const CompilerConfig& compilerConfig) {
+			// The cache key is computed from the preprocessed source code, so that it covers the included files too.
+			// The macros of a precompiled header may be used by source code without a single directive.
+			const PrecompiledHeader* pch = compilerConfig.pch;
+			const SrcLineMap* lineMap{nullptr};
+			if (Preprocessor::HasDirectives(srcCode, srcCodeSize) || (pch && !pch->GetMacros().empty())) {
+				PreprocessorConfig ppConfig{};
+				ppConfig.srcCodePath = srcCodePath;
+				ppConfig.includeDirs = &compilerConfig.includeDirs;
+				ppConfig.ppFileCache = compilerConfig.ppFileCache ? compilerConfig.ppFileCache : ppFileCache.get();
+				if (pch) {
+					ppConfig.predefinedMacros = &pch->GetMacros();
+					ppConfig.precompiledFiles = &pch->GetFiles();
+				}
+				PhaseTimer ppTimer{};
+				TraceScope ppSpan{compilerConfig.trace, CompilePhaseToStr(CompilePhase::PREPROCESSING), "phase"};
+				try {
+					preprocessor->Process(srcCode, srcCodeSize, ppConfig);
+				} catch (std::runtime_error& err) {
+					errorReporter->ReportError(err.what());
+					return false;
+				}
+				stats.phases[static_cast<size_t>(CompilePhase::PREPROCESSING)] = ppTimer.Stop();
+				ppSpan.End();
+				// Valid until the next compilation, just like the source file.
+				srcCode = preprocessor->GetOutput().data();
+				srcCodeSize = preprocessor->GetOutput().size();
+				lineMap = &preprocessor->GetLineMap();
+			}
+
+			// A cache hit skips the whole front end and code generation.
+			std::string cacheKey;
+			bool cacheHit{false};
+			if (compilerConfig.cache) {
+				cacheKey = CompileCache::ComputeKey(srcCode, srcCodeSize, compilerConfig.options,
+				                                   pch ? pch->GetSrcCode() : std::string_view{});
+				cacheHit = compilerConfig.cache->Load(cacheKey, shaderProgram);
+			}
+			if (!cacheHit) {
+				if (!CompileSrcCode(srcCode, srcCodeSize, lineMap, compilerConfig)) {
+					return false;
+				}
+				if (compilerConfig.cache) {
+					compilerConfig.cache->Store(cacheKey, shaderProgram);
+				}
+			}
+			stats.cacheHit = cacheHit;
+			return true;
+		}
+
+		bool CompilationSession::CompileSrcCode(const char* srcCode, size_t srcCodeSize, const SrcLineMap* lineMap,
+		                                        const CompilerConfig& compilerConfig) {
+			errorReporter->SetSrcCodeLink(srcCode, srcCodeSize);
+			errorReporter->SetLineMap(lineMap);
+
+			GpuApiType gpuApiType = compilerConfig.options.gpuApiType;
+
+			// 1. Lexing
+
+			LexerConfig lexConfig{};
+			lexConfig.errorReporter = errorReporter.get();
+			lexConfig.gpuApiType = gpuApiType;
+			lexConfig.constTable = constTable.get();
+			// The lexer runs along with the parser in the pipelined and streaming modes, see below.
+			// On a single hardware thread the two would only take turns.
+			bool streaming = compilerConfig.streaming && !compilerConfig.pch && !debugDump.IsEnabled(DumpChannel::TOKENS);
+			bool pipelined = compilerConfig.pipelined && !streaming && !compilerConfig.pch &&
+			                 srcCodeSize >= minPipelinedSrcSize && srcCodeSize <= maxTokenStreamSrcSize &&
+			                 std::thread::hardware_concurrency() > 1;
+			bool lexed{true};
+			if (!pipelined && !streaming) {
+				PhaseTimer lexingTimer{};
+				TraceScope lexingSpan{compilerConfig.trace, CompilePhaseToStr(CompilePhase::LEXING), "phase"};
+				// Lexical errors are already reported, parsing goes on so that the syntax errors are reported too.
+				lexed = lexer->Scan(srcCode, srcCodeSize, lexConfig);
+				stats.phases[static_cast<size_t>(CompilePhase::LEXING)] = lexingTimer.Stop();
+				lexingSpan.End();
+				stats.tokenCount = lexer->GetTokenStream().GetSize();
+				if (debugDump.IsEnabled(DumpChannel::TOKENS)) {
+					DumpTokens(lexer->GetTokenStream());
+				}
+			}
+			
+			// 2. Parsing
+
+			ParserConfig parserConfig{};
+			parserConfig.errorReporter = errorReporter.get();
+			parserConfig.typeTable = typeTable.get();
+			parserConfig.constTable = constTable.get();
+			parserConfig.astArena = astArena.get();
+			parserConfig.gpuApiType = gpuApiType;
+			if (compilerConfig.pch) {
+				try {
+					pchDecls = compilerConfig.pch->Instantiate(*typeTable, *constTable, *astArena);
+				} catch (std::runtime_error& err) {
+					errorReporter->ReportError(err.what());
+					return false;
+				}
+				parserConfig.pchDecls = &pchDecls;
+			}
+			PhaseTimer parsingTimer{};
+			TraceScope parsingSpan{compilerConfig.trace, CompilePhaseToStr(CompilePhase::PARSING), "phase"};
+			size_t astNodeCountBefore = GetThreadAstNodeCount();
+			if (pipelined) {
+				// The parsing time includes the waits for the lexer, it's the time of the whole front end.
+				lexed = LexAndParsePipelined(srcCode, srcCodeSize, lexConfig, parserConfig, compilerConfig.trace);
+			} else if (streaming) {
+				// Lexing is a part of parsing, it has no phase of its own.
+				lexed = LexAndParseStreaming(srcCode, srcCodeSize, lexConfig, parserConfig);
+			} else {
+				parser->Parse(lexer->GetTokenStream(), parserConfig);
+			}
+			stats.phases[static_cast<size_t>(CompilePhase::PARSING)] = parsingTimer.Stop();
+			parsingSpan.End();
+			stats.astNodeCount = GetThreadAstNodeCount() - astNodeCountBefore;
+			if (pipelined) {
+				stats.tokenCount = pipelinedTokens.GetSize();
+				if (debugDump.IsEnabled(DumpChannel::TOKENS)) {
+					DumpTokens(pipelinedTokens);
+				}
+			}
+
+			DumpParseResults();
+
+			if (!lexed || parser->HadSyntaxError() || parser->HadSemanticError()) {
+				return false;
+			}
+
+			// 3. Generating vertex and fragment shaders source code.
+			//    We parsed extended GLSL source code, but we're going to produce core GLSL source code.
+
+			PhaseTimer glslGenTimer{};
+			TraceScope glslGenSpan{compilerConfig.trace, CompilePhaseToStr(CompilePhase::GLSL_GENERATION), "phase"};
+			std::shared_ptr<GlslExtWriter> glslExtWriter = std::make_shared<GlslExtWriter>(compilerConfig.options.glslWriterConfig, *astArena, &stats, compilerConfig.trace);
+			ShaderProgramBlock* shaderProgramBlock = parser->GetShaderProgramBlock();
+			std::shared_ptr<ShaderProgram> glslProgram = glslExtWriter->CompileToGlsl(shaderProgramBlock);
+			stats.phases[static_cast<size_t>(CompilePhase::GLSL_GENERATION)] = glslGenTimer.Stop();
+			glslGenSpan.End();
+
+			PhaseTimer spvGenTimer{};
+			TraceScope spvGenSpan{compilerConfig.trace, CompilePhaseToStr(CompilePhase::SPIRV_GENERATION), "phase"};
+			spirv::GlslToSpvGeneratorConfig spvGenConfig{};
+			spvGenConfig.type = compilerConfig.options.spvType;
+			spvGenConfig.typeTable = typeTable.get();
+			spvGenConfig.constTable = constTable.get();
+			spvGenConfig.astArena = astArena.get();
+			spvGenConfig.stats = &stats;
+			spvGenConfig.trace = compilerConfig.trace;
+			spvGenerator = std::make_unique<spirv::GlslToSpvGenerator>(spvGenConfig);
+			// 4. Create a list of SPIR-V instructions.
+			spvGenerator->CompileToSpv(shaderProgramBlock);
+			const ShaderProgram& spvProgram = spvGenerator->GetShaderProgram();
+			stats.phases[static_cast<size_t>(CompilePhase::SPIRV_GENERATION)] = spvGenTimer.Stop();
+			spvGenSpan.End();
+
+			// 5. The GLSL program already has the reflection data, so we only add the SPIR-V modules.
+			shaderProgram = *glslProgram;
+			for (size_t i = 0; i < static_cast<size_t>(ShaderType::COUNT); i++) {
+				ShaderType shaderType = static_cast<ShaderType>(i);
+				const ShaderModule& spvModule = spvProgram.GetShaderModule(shaderType);
+				if (spvModule.HasSpvAsm()) {
+					shaderProgram.SetShaderModuleSpvAsm(shaderType, spvModule.spvAsm);
+				}
+				if (spvModule.HasSpvBinary()) {
+					shaderProgram.SetShaderModuleSpvBinary(shaderType, spvModule.spvBinary);
+				}
+			}
+			if (debugDump.IsEnabled(DumpChannel::SPIRV)) {
+				DumpSpirv();
+			}
+			return true;
+		}
+
+		bool CompilationSession::LexAndParsePipelined(const char* srcCode, size_t srcCodeSize, LexerConfig lexConfig,
+		                                              const ParserConfig& parserConfig, TraceRecorder* trace) {
+			TokenRing tokenRing{};
+			lexConfig.tokenRing = &tokenRing;
+			bool lexed{false};
+			PhaseStats lexingStats{};
+			std::thread lexerThread{[&]() {
+				PhaseTimer lexingTimer{};
+				TraceScope lexingSpan{trace, CompilePhaseToStr(CompilePhase::LEXING), "phase"};
+				lexed = lexer->Scan(srcCode, srcCodeSize, lexConfig);
+				lexingStats = lexingTimer.Stop();
+			}};
+			// The lexer only records its errors. The parser's diagnostics are held back until the lexer is done,
+			// so that they follow the lexical errors, just like in the sequential mode.
+			std::ostream& errStream = errorReporter->GetErrorStream();
+			std::ostringstream parserDiagnostics;
+			errorReporter->SetErrorStream(&parserDiagnostics);
+			pipelinedTokens.Reset(srcCode, srcCodeSize);
+			pipelinedTokens.Reserve(srcCodeSize / 4 + 1);
+			try {
+				parser->ParsePipelined(tokenRing, pipelinedTokens, parserConfig);
+			} catch (...) {
+				// The lexer may be waiting for room in the ring, it can't be joined before the ring is drained.
+				RingToken ringTokens[64];
+				while (tokenRing.Pop(ringTokens, 64) != 0) {
+				}
+				lexerThread.join();
+				errorReporter->SetErrorStream(&errStream);
+				throw;
+			}
+			lexerThread.join();
+			errorReporter->SetErrorStream(&errStream);
+			for (const LexicalError& lexicalError : lexer->GetErrors()) {
+				errorReporter->ReportLexicalError(lexicalError);
+			}
+			errStream << parserDiagnostics.str();
+			stats.phases[static_cast<size_t>(CompilePhase::LEXING)] = lexingStats;
+			return lexed;
+		}
+
+		bool CompilationSession::LexAndParseStreaming(const char* srcCode, size_t srcCodeSize, const LexerConfig& lexConfig,
+		                                              const ParserConfig& parserConfig) {
+			TokenWindow tokenWindow{};
+			// The lexer only records its errors, the parser's diagnostics are held back as in the pipelined mode.
+			std::ostream& errStream = errorReporter->GetErrorStream();
+			std::ostringstream parserDiagnostics;
+			errorReporter->SetErrorStream(&parserDiagnostics);
+			lexer->BeginScan(srcCode, srcCodeSize, tokenWindow, lexConfig);
+			try {
+				parser->ParseStreaming(*lexer, tokenWindow, parserConfig);
+			} catch (...) {
+				errorReporter->SetErrorStream(&errStream);
+				throw;
+			}
+			errorReporter->SetErrorStream(&errStream);
+			for (const LexicalError& lexicalError : lexer->GetErrors()) {
+				errorReporter->ReportLexicalError(lexicalError);
+			}
+			errStream << parserDiagnostics.str();
+			stats.tokenCount = tokenWindow.GetSize();
+			return lexer->GetErrors().empty();
+		}
+
+		void CompilationSession::CollectStageStats() {
+			for (size_t i = 0; i < static_cast<size_t>(ShaderType::COUNT); i++) {
+				ShaderType shaderType = static_cast<ShaderType>(i);
+				if (!shaderProgram.HasShaderModule(shaderType)) {
+					continue;
+				}
+				const ShaderModule& shaderModule = shaderProgram.GetShaderModule(shaderType);
+				ShaderStageStats& stageStats = stats.stages[i];
+				stageStats.present = true;
+				stageStats.glslSize = shaderModule.glsl.size();
+				stageStats.spvInstructionCount = CountSpvInstructions(shaderModule);
+			}
+		}
+
+		void CompilationSession::WriteOutputFiles(const std::filesystem::path& srcCodePath) {
+			if (shaderProgram.HasShaderModule(ShaderType::VS)) {
+				WriteShaderModuleFiles(shaderProgram.GetShaderModule(ShaderType::VS), srcCodePath, "vs");
+			}
+			if (shaderProgram.HasShaderModule(ShaderType::FS)) {
+				WriteShaderModuleFiles(shaderProgram.GetShaderModule(ShaderType::FS), srcCodePath, "fs");
+			}
+		}
+
+		void CompilationSession::ReadSrcCode(const std::filesystem::path& srcCodePath) {
+			std::string srcCodeFileExt = srcCodePath.extension().generic_string();
+			if (!FileExtCsl(srcCodeFileExt)) {
+				std::string errMsg{ "File extension must be \".csl\"" };
+				throw std::runtime_error{ errMsg };
+			}
+
+			// The tokens and the error reporter point directly into the file's mapping.
+			srcFile.Open(srcCodePath);
+		}
+
+		void CompilationSession::DumpTokens(const TokenStream& tokens) {
+			std::ostream& sink = debugDump.GetSink(DumpChannel::TOKENS);
+			const SrcLineIndex& lineIndex = errorReporter->GetLineIndex();
+			for (size_t i = 0; i < tokens.GetSize(); i++) {
+				Token token = tokens.GetToken(i);
+				PrintToken(sink, token, lineIndex.Locate(token.lexeme));
+				sink << " " << TokenTypeToStr(token.tokenType) << "\n";
+			}
+		}
+		void CompilationSession::DumpParseResults() {
+			if (debugDump.IsEnabled(DumpChannel::CONSTANTS)) {
+				std::ostream& sink = debugDump.GetSink(DumpChannel::CONSTANTS);
+				sink << std::fixed << std::showpoint;
+				for (const ConstantValue& constVal : constTable->GetConstants()) {
+					PrintConstantValue(sink, constVal);
+					sink << "\n";
+				}
+			}
+			if (debugDump.IsEnabled(DumpChannel::TYPES)) {
+				std::ostream& sink = debugDump.GetSink(DumpChannel::TYPES);
+				for (size_t typeId = 0; typeId < typeTable->GetTypeCount(); typeId++) {
+					sink << typeId << ": " << MangleTypeSpecName(typeTable->GetType(typeId)) << "\n";
+				}
+			}
+			// The tree of a program with syntax errors may be incomplete.
+			ShaderProgramBlock* shaderProgramBlock = parser->GetShaderProgramBlock();
+			if (debugDump.IsEnabled(DumpChannel::AST) && !parser->HadSyntaxError() && shaderProgramBlock) {
+				AstPrinter astPrinter{debugDump.GetSink(DumpChannel::AST)};
+				astPrinter.Print(shaderProgramBlock);
+			}
+		}
+		void CompilationSession::DumpSpirv() {
+			std::ostream& sink = debugDump.GetSink(DumpChannel::SPIRV);
+			for (size_t i = 0; i < static_cast<size_t>(ShaderType::COUNT); i++) {
+				ShaderType shaderType = static_cast<ShaderType>(i);
+				if (!shaderProgram.HasShaderModule(shaderType)) {
+					continue;
+				}
+				const ShaderModule& shaderModule = shaderProgram.GetShaderModule(shaderType);
+				sink << "; " << ShaderTypeToStr(shaderType) << "\n";
+				if (shaderModule.HasSpvAsm()) {
+					sink << shaderModule.spvAsm << "\n";
+				} else if (shaderModule.HasSpvBinary()) {
+					// Words of the binary module, 8 per line.
+					sink << std::hex << std::setfill('0');
+					for (size_t wordIdx = 0; wordIdx < shaderModule.spvBinary.size(); wordIdx++) {
+						sink << std::setw(8) << shaderModule.spvBinary[wordIdx] << ((wordIdx + 1) % 8 == 0 ? "\n" : " ");
+					}
+					sink << std::dec << std::setfill(' ') << "\n";
+				}
+			}
+		}
+
+	}
+}
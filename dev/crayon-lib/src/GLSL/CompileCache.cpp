@@ -0,0 +1,111 @@
+#include "GLSL/CompileCache.h"
+
+#include "Sha256.h"
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace crayon {
+	namespace glsl {
+
+		static constexpr std::string_view cacheEntryExt{".cspg"};
+
+		CompileCache::CompileCache(const std::filesystem::path& cacheDir)
+			: cacheDir(cacheDir) {
+			std::error_code errCode;
+			std::filesystem::create_directories(cacheDir, errCode);
+			if (errCode) {
+				throw std::runtime_error{"Couldn't create the cache directory: " + cacheDir.string()};
+			}
+		}
+
+		std::string CompileCache::ComputeKey(const char* srcCodeData, size_t srcCodeSize, const CompileOptions& options,
+		                                     std::string_view pchSrcCode) {
+			Sha256 hasher{};
+			// 1. Compiler version. Every field is length- or size-prefixed,
+			//    so that different inputs can't produce the same byte sequence.
+			hasher.UpdateValue(static_cast<uint64_t>(compilerVersion.size()));
+			hasher.Update(compilerVersion);
+			// 2. Compile options.
+			hasher.UpdateValue(static_cast<int32_t>(options.gpuApiType));
+			hasher.UpdateValue(static_cast<int32_t>(options.spvType));
+			hasher.UpdateValue(static_cast<int32_t>(options.glslWriterConfig.indentCount));
+			hasher.UpdateValue(options.glslWriterConfig.indentChar);
+			hasher.UpdateValue(static_cast<uint8_t>(options.glslWriterConfig.openingBraceOnSameLine));
+			// 3. Source code.
+			hasher.UpdateValue(static_cast<uint64_t>(srcCodeSize));
+			hasher.Update(srcCodeData, srcCodeSize);
+			// 4. Precompiled header. Left out without one, so that the keys of other programs don't change.
+			if (!pchSrcCode.empty()) {
+				hasher.UpdateValue(static_cast<uint64_t>(pchSrcCode.size()));
+				hasher.Update(pchSrcCode);
+			}
+			return DigestToHexString(hasher.Finalize());
+		}
+
+		bool CompileCache::Load(const std::string& key, ShaderProgram& shaderProgram) {
+			std::ifstream entryFile{GetEntryPath(key), std::ifstream::in | std::ifstream::ate | std::ifstream::binary};
+			if (!entryFile.is_open()) {
+				missCount++;
+				return false;
+			}
+			size_t entrySize = entryFile.tellg();
+			std::vector<uint8_t> entryData(entrySize);
+			entryFile.seekg(0);
+			entryFile.read(reinterpret_cast<char*>(entryData.data()), entrySize);
+			if (!entryFile || !DeserializeShaderProgram(entryData.data(), entryData.size(), shaderProgram)) {
+				missCount++;
+				return false;
+			}
+			hitCount++;
+			return true;
+		}
+		void CompileCache::Store(const std::string& key, const ShaderProgram& shaderProgram) {
+			std::vector<uint8_t> entryData;
+			SerializeShaderProgram(shaderProgram, entryData);
+
+			// A unique temporary name, so that concurrent writers (threads or processes) never share a file.
+			static thread_local std::mt19937_64 randomEngine{std::random_device{}()};
+			std::filesystem::path entryPath = GetEntryPath(key);
+			std::filesystem::path tmpPath = entryPath;
+			tmpPath += ".tmp" + std::to_string(randomEngine());
+
+			std::ofstream tmpFile{tmpPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc};
+			if (!tmpFile.is_open()) {
+				return;
+			}
+			tmpFile.write(reinterpret_cast<const char*>(entryData.data()), entryData.size());
+			tmpFile.close();
+
+			std::error_code errCode;
+			if (!tmpFile) {
+				std::filesystem::remove(tmpPath, errCode);
+				return;
+			}
+			std::filesystem::rename(tmpPath, entryPath, errCode);
+			if (errCode) {
+				std::filesystem::remove(tmpPath, errCode);
+			}
+		}
+
+		const std::filesystem::path& CompileCache::GetCacheDir() const {
+			return cacheDir;
+		}
+		uint32_t CompileCache::GetHitCount() const {
+			return hitCount;
+		}
+		uint32_t CompileCache::GetMissCount() const {
+			return missCount;
+		}
+
+		std::filesystem::path CompileCache::GetEntryPath(const std::string& key) const {
+			std::filesystem::path entryPath = cacheDir / key;
+			entryPath += cacheEntryExt;
+			return entryPath;
+		}
+
+	}
+}
@@ -0,0 +1,11 @@
+#include "GLSL/CompileOptions.h"
+
+namespace crayon {
+	namespace glsl {
+
+		CompileOptions::CompileOptions() {
+			glslWriterConfig.openingBraceOnSameLine = true;
+		}
+
+	}
+}
@@ -0,0 +1,105 @@
+#include "GLSL/CompileProtocol.h"
+
+#include "ByteStream.h"
+
+namespace crayon {
+	namespace glsl {
+
+		static void WriteCompileOptions(ByteWriter& writer, const CompileOptions& options) {
+			writer.WriteI32(static_cast<int32_t>(options.gpuApiType));
+			writer.WriteI32(static_cast<int32_t>(options.spvType));
+			writer.WriteI32(static_cast<int32_t>(options.glslWriterConfig.indentCount));
+			writer.WriteU32(static_cast<uint8_t>(options.glslWriterConfig.indentChar));
+			writer.WriteU32(options.glslWriterConfig.openingBraceOnSameLine ? 1 : 0);
+		}
+		static bool ReadCompileOptions(ByteReader& reader, CompileOptions& options) {
+			int32_t gpuApiType{0};
+			int32_t spvType{0};
+			int32_t indentCount{0};
+			uint32_t indentChar{0};
+			uint32_t openingBraceOnSameLine{0};
+			if (!reader.ReadI32(gpuApiType) || !reader.ReadI32(spvType) || !reader.ReadI32(indentCount) ||
+				!reader.ReadU32(indentChar) || !reader.ReadU32(openingBraceOnSameLine)) {
+				return false;
+			}
+			if (gpuApiType < static_cast<int32_t>(GpuApiType::NONE) ||
+				gpuApiType > static_cast<int32_t>(GpuApiType::VULKAN)) {
+				return false;
+			}
+			if (spvType < static_cast<int32_t>(spirv::SpvType::ASM) ||
+				spvType > static_cast<int32_t>(spirv::SpvType::BINARY)) {
+				return false;
+			}
+			if (indentCount < 0 || indentChar > 0xFF) {
+				return false;
+			}
+			options.gpuApiType = static_cast<GpuApiType>(gpuApiType);
+			options.spvType = static_cast<spirv::SpvType>(spvType);
+			options.glslWriterConfig.indentCount = indentCount;
+			options.glslWriterConfig.indentChar = static_cast<char>(indentChar);
+			options.glslWriterConfig.openingBraceOnSameLine = openingBraceOnSameLine != 0;
+			return true;
+		}
+
+		void SerializeCompileRequest(const CompileRequest& request, std::vector<uint8_t>& data) {
+			ByteWriter writer{data};
+			writer.WriteU32(compileRequestMagic);
+			writer.WriteU32(compileProtocolVersion);
+			writer.WriteI32(static_cast<int32_t>(request.type));
+			if (request.type == CompileRequestType::COMPILE) {
+				WriteCompileOptions(writer, request.options);
+				writer.WriteString(request.srcCode);
+			}
+		}
+		bool DeserializeCompileRequest(const uint8_t* data, size_t size, CompileRequest& request) {
+			ByteReader reader{data, size};
+			uint32_t magic{0};
+			uint32_t version{0};
+			if (!reader.ReadU32(magic) || magic != compileRequestMagic ||
+				!reader.ReadU32(version) || version != compileProtocolVersion) {
+				return false;
+			}
+			if (!reader.ReadEnum(request.type)) {
+				return false;
+			}
+			switch (request.type) {
+				case CompileRequestType::COMPILE:
+					if (!ReadCompileOptions(reader, request.options) || !reader.ReadString(request.srcCode)) {
+						return false;
+					}
+					break;
+				case CompileRequestType::SHUTDOWN:
+					break;
+				default:
+					return false;
+			}
+			return reader.AtEnd();
+		}
+
+		void SerializeCompileResponse(const CompileResponse& response, std::vector<uint8_t>& data) {
+			ByteWriter writer{data};
+			writer.WriteU32(compileResponseMagic);
+			writer.WriteU32(compileProtocolVersion);
+			writer.WriteI32(static_cast<int32_t>(response.status));
+			writer.WriteString(response.errMsg);
+			if (response.status == CompileResponseStatus::OK) {
+				writer.Write(response.shaderProgramData.data(), response.shaderProgramData.size());
+			}
+		}
+		bool DeserializeCompileResponse(const uint8_t* data, size_t size, CompileResponse& response) {
+			ByteReader reader{data, size};
+			uint32_t magic{0};
+			uint32_t version{0};
+			if (!reader.ReadU32(magic) || magic != compileResponseMagic ||
+				!reader.ReadU32(version) || version != compileProtocolVersion) {
+				return false;
+			}
+			if (!reader.ReadEnum(response.status) || !reader.ReadString(response.errMsg)) {
+				return false;
+			}
+			response.shaderProgramData.resize(reader.GetRemainingSize());
+			return reader.Read(response.shaderProgramData.data(), response.shaderProgramData.size());
+		}
+
+	}
+}
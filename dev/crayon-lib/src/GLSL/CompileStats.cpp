@@ -0,0 +1,198 @@
+#include "GLSL/CompileStats.h"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace crayon {
+	namespace glsl {
+
+		static double GetThreadCpuTimeMs() {
+#ifdef _WIN32
+			FILETIME creationTime{}, exitTime{}, kernelTime{}, userTime{};
+			if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+				return 0.0;
+			}
+			// FILETIME is measured in 100 ns intervals.
+			auto toTicks = [](const FILETIME& fileTime) {
+				return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+			};
+			return static_cast<double>(toTicks(kernelTime) + toTicks(userTime)) / 10000.0;
+#else
+			timespec cpuTime{};
+			if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) != 0) {
+				return 0.0;
+			}
+			return static_cast<double>(cpuTime.tv_sec) * 1000.0 + static_cast<double>(cpuTime.tv_nsec) / 1000000.0;
+#endif
+		}
+
+		PhaseStats& PhaseStats::operator+=(const PhaseStats& other) {
+			wallTimeMs += other.wallTimeMs;
+			cpuTimeMs += other.cpuTimeMs;
+			allocatedBytes += other.allocatedBytes;
+			allocationCount += other.allocationCount;
+			return *this;
+		}
+
+		CompileStats& CompileStats::operator+=(const CompileStats& other) {
+			for (size_t i = 0; i < phases.size(); i++) {
+				phases[i] += other.phases[i];
+			}
+			for (size_t i = 0; i < stages.size(); i++) {
+				ShaderStageStats& stage = stages[i];
+				const ShaderStageStats& otherStage = other.stages[i];
+				stage.present = stage.present || otherStage.present;
+				stage.glslGeneration += otherStage.glslGeneration;
+				stage.spvGeneration += otherStage.spvGeneration;
+				stage.glslSize += otherStage.glslSize;
+				stage.spvInstructionCount += otherStage.spvInstructionCount;
+			}
+			srcCodeSize += other.srcCodeSize;
+			tokenCount += other.tokenCount;
+			astNodeCount += other.astNodeCount;
+			return *this;
+		}
+
+		PhaseTimer::PhaseTimer()
+			: wallStart(std::chrono::steady_clock::now()),
+			  cpuStartMs(GetThreadCpuTimeMs()),
+			  allocStart(GetThreadAllocStats()) {
+		}
+
+		PhaseStats PhaseTimer::Stop() const {
+			const AllocStats& allocStats = GetThreadAllocStats();
+			PhaseStats phaseStats{};
+			phaseStats.wallTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+			phaseStats.cpuTimeMs = GetThreadCpuTimeMs() - cpuStartMs;
+			phaseStats.allocatedBytes = allocStats.allocatedBytes - allocStart.allocatedBytes;
+			phaseStats.allocationCount = allocStats.allocationCount - allocStart.allocationCount;
+			return phaseStats;
+		}
+
+		static thread_local size_t astNodeCount{0};
+
+		void CountAstNode() {
+			astNodeCount++;
+		}
+		size_t GetThreadAstNodeCount() {
+			return astNodeCount;
+		}
+
+		size_t CountSpvInstructions(const ShaderModule& shaderModule) {
+			if (shaderModule.HasSpvBinary()) {
+				// 1. Skip the header (magic, version, generator, bound and schema).
+				// 2. The high 16 bits of an instruction's first word hold its word count.
+				constexpr size_t headerWordCount{5};
+				size_t instCount{0};
+				size_t wordIdx = headerWordCount;
+				while (wordIdx < shaderModule.spvBinary.size()) {
+					uint32_t wordCount = shaderModule.spvBinary[wordIdx] >> 16;
+					if (wordCount == 0) {
+						break;
+					}
+					wordIdx += wordCount;
+					instCount++;
+				}
+				return instCount;
+			}
+			// One instruction per line, comments start with ';'.
+			size_t instCount{0};
+			std::istringstream spvAsm{shaderModule.spvAsm};
+			std::string line;
+			while (std::getline(spvAsm, line)) {
+				size_t first = line.find_first_not_of(" \t\r");
+				if (first != std::string::npos && line[first] != ';') {
+					instCount++;
+				}
+			}
+			return instCount;
+		}
+
+		std::string_view CompilePhaseToStr(CompilePhase phase) {
+			switch (phase) {
+				case CompilePhase::PREPROCESSING:
+					return "preprocessing";
+				case CompilePhase::LEXING:
+					return "lexing";
+				case CompilePhase::PARSING:
+					return "parsing";
+				case CompilePhase::GLSL_GENERATION:
+					return "glslGeneration";
+				case CompilePhase::SPIRV_GENERATION:
+					return "spvGeneration";
+				default:
+					return "unknown";
+			}
+		}
+		std::string_view ShaderTypeToStr(ShaderType shaderType) {
+			switch (shaderType) {
+				case ShaderType::VS:
+					return "vs";
+				case ShaderType::TCS:
+					return "tcs";
+				case ShaderType::TES:
+					return "tes";
+				case ShaderType::GS:
+					return "gs";
+				case ShaderType::FS:
+					return "fs";
+				case ShaderType::CS:
+					return "cs";
+				default:
+					return "unknown";
+			}
+		}
+
+		static void WritePhaseStatsJson(std::ostream& out, const PhaseStats& phaseStats) {
+			out << "{\"wallTimeMs\":" << phaseStats.wallTimeMs
+			    << ",\"cpuTimeMs\":" << phaseStats.cpuTimeMs
+			    << ",\"allocatedBytes\":" << phaseStats.allocatedBytes
+			    << ",\"allocationCount\":" << phaseStats.allocationCount << "}";
+		}
+
+		void WriteCompileStatsJson(std::ostream& out, const CompileStats& stats) {
+			// Formatted separately, so that the stream's own flags are left untouched.
+			std::ostringstream json;
+			json << std::fixed << std::setprecision(3);
+			json << "{\"cacheHit\":" << (stats.cacheHit ? "true" : "false")
+			     << ",\"srcCodeSize\":" << stats.srcCodeSize
+			     << ",\"tokenCount\":" << stats.tokenCount
+			     << ",\"astNodeCount\":" << stats.astNodeCount;
+			json << ",\"phases\":{";
+			for (size_t i = 0; i < stats.phases.size(); i++) {
+				json << (i == 0 ? "" : ",") << "\"" << CompilePhaseToStr(static_cast<CompilePhase>(i)) << "\":";
+				WritePhaseStatsJson(json, stats.phases[i]);
+			}
+			json << "},\"stages\":{";
+			bool firstStage{true};
+			for (size_t i = 0; i < stats.stages.size(); i++) {
+				const ShaderStageStats& stage = stats.stages[i];
+				if (!stage.present) {
+					continue;
+				}
+				json << (firstStage ? "" : ",") << "\"" << ShaderTypeToStr(static_cast<ShaderType>(i)) << "\":{";
+				json << "\"glslSize\":" << stage.glslSize
+				     << ",\"spvInstructionCount\":" << stage.spvInstructionCount
+				     << ",\"glslGeneration\":";
+				WritePhaseStatsJson(json, stage.glslGeneration);
+				json << ",\"spvGeneration\":";
+				WritePhaseStatsJson(json, stage.spvGeneration);
+				json << "}";
+				firstStage = false;
+			}
+			json << "}}";
+			out << json.str();
+		}
+
+	}
+}
@@ -0,0 +1,94 @@
+#include "GLSL/DebugDump.h"
+
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace crayon {
+	namespace glsl {
+
+		std::string_view DumpChannelToStr(DumpChannel channel) {
+			switch (channel) {
+				case DumpChannel::TOKENS:
+					return "tokens";
+				case DumpChannel::AST:
+					return "ast";
+				case DumpChannel::CONSTANTS:
+					return "constants";
+				case DumpChannel::TYPES:
+					return "types";
+				case DumpChannel::SPIRV:
+					return "spirv";
+				default:
+					return "unknown";
+			}
+		}
+
+		uint32_t ParseDumpChannels(std::string_view channelList) {
+			if (channelList == "all") {
+				return allDumpChannels;
+			}
+			uint32_t channels{0};
+			while (!channelList.empty()) {
+				size_t commaPos = channelList.find(',');
+				std::string_view name = channelList.substr(0, commaPos);
+				bool found{false};
+				for (size_t i = 0; i < static_cast<size_t>(DumpChannel::COUNT); i++) {
+					DumpChannel channel = static_cast<DumpChannel>(i);
+					if (name == DumpChannelToStr(channel)) {
+						channels |= DumpChannelBit(channel);
+						found = true;
+						break;
+					}
+				}
+				if (!found) {
+					throw std::invalid_argument{"Unknown dump channel: '" + std::string{name} + "'"};
+				}
+				channelList = commaPos == std::string_view::npos ? std::string_view{} : channelList.substr(commaPos + 1);
+			}
+			if (channels == 0) {
+				throw std::invalid_argument{"No dump channels provided"};
+			}
+			return channels;
+		}
+
+		void DebugDump::Reset(uint32_t channels) {
+			this->channels = channels;
+			for (std::unique_ptr<std::ostringstream>& sink : sinks) {
+				sink.reset();
+			}
+		}
+
+		std::ostream& DebugDump::GetSink(DumpChannel channel) {
+			assert(IsEnabled(channel) && "Check if the channel is enabled first!");
+			std::unique_ptr<std::ostringstream>& sink = sinks[static_cast<size_t>(channel)];
+			if (!sink) {
+				sink = std::make_unique<std::ostringstream>();
+			}
+			return *sink;
+		}
+
+		void DebugDump::WriteFiles(const std::filesystem::path& dir, std::string_view baseName) const {
+			if (!dir.empty()) {
+				std::filesystem::create_directories(dir);
+			}
+			for (size_t i = 0; i < sinks.size(); i++) {
+				if (!sinks[i]) {
+					continue;
+				}
+				std::string fileName{baseName};
+				fileName += ".";
+				fileName += DumpChannelToStr(static_cast<DumpChannel>(i));
+				fileName += ".txt";
+				std::filesystem::path dumpPath = dir / fileName;
+				std::ofstream dumpFile{dumpPath, std::ofstream::out | std::ofstream::binary};
+				dumpFile << sinks[i]->str();
+				if (!dumpFile) {
+					throw std::runtime_error{"Couldn't write the dump file: " + dumpPath.string()};
+				}
+			}
+		}
+
+	}
+}
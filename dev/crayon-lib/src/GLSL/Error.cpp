@@ -1,62 +1,103 @@
 #include "GLSL/Error.h"
 
-#include <iostream>
 #include <iterator>
-#include <sstream>
 
 namespace crayon {
 	namespace glsl {
 
         SyntaxError::SyntaxError(const Token& errToken)
             : errToken(errToken) {
-            CreateErrMsg(std::string_view{});
         }
         SyntaxError::SyntaxError(const Token& errToken, std::string_view errMsg)
-            : errToken(errToken) {
-            CreateErrMsg(errMsg);
+            : errToken(errToken), errMsg(errMsg) {
         }
         SyntaxError::SyntaxError(const Token& errToken, TokenType expected)
             : errToken(errToken), expected(expected) {
-            CreateErrMsg(std::string_view{});
         }
         SyntaxError::SyntaxError(const Token& errToken, TokenType expected, std::string_view errMsg)
-            : errToken(errToken), expected(expected) {
-            CreateErrMsg(errMsg);
+            : errToken(errToken), errMsg(errMsg), expected(expected) {
         }
 
-        const char* SyntaxError::what() const noexcept {
-            return errMsg.data();
-        }
         const Token& SyntaxError::GetErrorToken() const {
             return errToken;
         }
         TokenType SyntaxError::GetExpectedTokenType() const {
             return expected;
         }
+        std::string_view SyntaxError::GetErrorMessage() const {
+            return errMsg;
+        }
 
-        void SyntaxError::CreateErrMsg(std::string_view errMsg) {
-            std::stringstream errStream;
+        void ErrorReporter::SetSrcCodeLink(const char* srcCodeData, size_t srcCodeSize) {
+            this->srcCodeData = srcCodeData;
+            this->srcCodeSize = srcCodeSize;
+            lineMap = nullptr;
+            lineIndex.Clear();
+        }
+        void ErrorReporter::SetLineMap(const SrcLineMap* lineMap) {
+            this->lineMap = lineMap;
+            lineIndex.SetLineMap(lineMap);
+        }
+        void ErrorReporter::SetErrorStream(std::ostream* errStream) {
+            this->errStream = errStream;
+        }
+        std::ostream& ErrorReporter::GetErrorStream() const {
+            return *errStream;
+        }
+
+        const SrcLineIndex& ErrorReporter::GetLineIndex() const {
+            if (!lineIndex.IsBuilt()) {
+                lineIndex.Build(srcCodeData, srcCodeSize);
+                lineIndex.SetLineMap(lineMap);
+            }
+            return lineIndex;
+        }
+        void ErrorReporter::ReportLocation(std::string_view text) const {
+            SrcLocation location = GetLineIndex().Locate(text);
+            SrcFileLine fileLine = GetLineIndex().ResolveLine(location.line);
+            *errStream << " [";
+            if (!fileLine.fileName.empty()) {
+                *errStream << fileLine.fileName << ":";
+            }
             // +1 for 'line' and 'startCol' is because internally lines and columns are indexed starting from 0.
-            errStream << "Syntax error ["
-			    << errToken.line + 1 << ":" << errToken.startCol + 1
-				<< "]: " << errMsg;
-            errStream << "\n";
-            if (expected != TokenType::UNDEFINED) {
-                errStream << "Expected '" << TokenTypeToStr(expected) << "'" << ", " <<
+            *errStream << fileLine.line + 1 << ":" << location.startCol + 1 << "]";
+        }
+
+        void ErrorReporter::ReportLexicalError(const LexicalError& lexicalError) const {
+            *errStream << "Lexical error";
+            if (!lexicalError.lexeme.empty() && GetLineIndex().Contains(lexicalError.lexeme)) {
+                ReportLocation(lexicalError.lexeme);
+            }
+            *errStream << ": " << lexicalError.errMsg << std::endl;
+        }
+        void ErrorReporter::ReportSyntaxError(const SyntaxError& syntaxError) const {
+            const Token& errToken = syntaxError.GetErrorToken();
+            *errStream << "Syntax error";
+            if (GetLineIndex().Contains(errToken.lexeme)) {
+                ReportLocation(errToken.lexeme);
+            }
+            *errStream << ": " << syntaxError.GetErrorMessage() << "\n";
+            if (syntaxError.GetExpectedTokenType() != TokenType::UNDEFINED) {
+                *errStream << "Expected '" << TokenTypeToStr(syntaxError.GetExpectedTokenType()) << "'" << ", " <<
                     "Encountered: '" << TokenTypeToStr(errToken.tokenType) << "'!";
             } else {
-                errStream << "Token: '" << TokenTypeToStr(errToken.tokenType) << "'"
+                *errStream << "Token: '" << TokenTypeToStr(errToken.tokenType) << "'"
                     << ", " << "lexeme: '" << errToken.lexeme << "'.";
             }
-            this->errMsg = std::move(errStream.str());
+            *errStream << std::endl;
         }
-
-        void ErrorReporter::SetSrcCodeLink(const char* srcCodeData, size_t srcCodeSize) {
-            this->srcCodeData = srcCodeData;
-            this->srcCodeSize = srcCodeSize;
+        void ErrorReporter::ReportSemanticError(const SemanticError& semanticError) const {
+            *errStream << "Semantic error";
+            if (!semanticError.srcText.empty() && GetLineIndex().Contains(semanticError.srcText)) {
+                ReportLocation(semanticError.srcText);
+            }
+            *errStream << ": " << semanticError.errMsg << std::endl;
+        }
+        void ErrorReporter::ReportError(std::string_view errMsg) const {
+            *errStream << errMsg << std::endl;
         }
 
-        void ErrorReporter::ReportVarDeclInitExprTypeMismatch(std::shared_ptr<VarDecl> varDecl) const {
+        void ErrorReporter::ReportVarDeclInitExprTypeMismatch(VarDecl* varDecl) const {
             // We need to report the entire line containing the variable declaration.
             // To get the source code line we're going to have to use some token that
             // fully lies on that line. We're going to walk backward to determine where the line starts,
@@ -68,52 +109,67 @@ namespace crayon {
             // 3) The variable name identifier token is always present, so that's what we're going to go with.
             // First we print the source code line.
             const Token& varName = varDecl->GetVarName();
+            const SrcLineIndex& lineIndex = GetLineIndex();
+            SrcLocation varNameLocation = lineIndex.Locate(varName.lexeme);
             // Print the error message.
-            std::cerr << "[Var. decl.] The initializer expression type doesn't match the type of the variable declaration!\n";
+            *errStream << "[Var. decl.] The initializer expression type doesn't match the type of the variable declaration!\n";
             // Computer the number of digits in the line number.
             size_t lineDigitCount{0};
-            size_t lineNumber = static_cast<size_t>(varName.line) + 1; // Always non-zero!
+            // The line of the file it comes from, the file is only printed if it isn't the main one.
+            SrcFileLine varNameFileLine = lineIndex.ResolveLine(varNameLocation.line);
+            size_t lineNumber = static_cast<size_t>(varNameFileLine.line) + 1; // Always non-zero!
             while (lineNumber != 0) {
                 lineNumber = lineNumber / 10;
                 lineDigitCount++;
             }
-            std::cerr << static_cast<size_t>(varName.line) + 1 << ".| ";
-            size_t offset = lineDigitCount + 3; // The ".| " sequence is exactly 3 characters long.
+            size_t fileNameSize{0};
+            if (!varNameFileLine.fileName.empty()) {
+                *errStream << varNameFileLine.fileName << ":";
+                fileNameSize = varNameFileLine.fileName.size() + 1;
+            }
+            *errStream << static_cast<size_t>(varNameFileLine.line) + 1 << ".| ";
+            size_t offset = fileNameSize + lineDigitCount + 3; // The ".| " sequence is exactly 3 characters long.
             // Now we have to check if we're at a tab boundary.
             // If not, we pad the offset number to get to the next tab boundary.
             // We assume that a single tab is 4 space ' ' characters.
             // 
             // Print the line containing the error.
-            // std::cerr << srcCodeLine;
-            std::string_view srcCodeLine = GetSrcCodeTokenLine(varName);
+            // *errStream << srcCodeLine;
+            std::string_view srcCodeLine = lineIndex.GetLineText(varNameLocation.line);
             const char* lineData = srcCodeLine.data();
             size_t trimmedSize = srcCodeLine.size();
             while (*lineData == '\t') {
-                std::fill_n(std::ostream_iterator<char>(std::cerr), 4, ' ');
+                std::fill_n(std::ostream_iterator<char>(*errStream), 4, ' ');
                 lineData++;
                 trimmedSize--;
             }
-            std::cerr << std::string_view{lineData, trimmedSize} << "\n";
+            *errStream << std::string_view{lineData, trimmedSize} << "\n";
             // Highlight the violating parts:
             // 1. Variable name
             // TODO: fix col number!
-            std::fill_n(std::ostream_iterator<char>(std::cerr), offset + varName.startCol, ' ');
-            std::fill_n(std::ostream_iterator<char>(std::cerr), varName.endCol - varName.startCol, '^');
+            std::fill_n(std::ostream_iterator<char>(*errStream), offset + varNameLocation.startCol, ' ');
+            std::fill_n(std::ostream_iterator<char>(*errStream), varNameLocation.endCol - varNameLocation.startCol, '^');
             // 2. Initializer expression.
-            std::pair<size_t, size_t> exprColBounds = varDecl->GetInitializerExpr()->GetExprColBounds();
-            std::fill_n(std::ostream_iterator<char>(std::cerr), exprColBounds.first - varName.endCol, ' ');
-            std::fill_n(std::ostream_iterator<char>(std::cerr), exprColBounds.second - exprColBounds.first, '^');
-            std::cerr << std::endl;
+            std::string_view exprSrcText = varDecl->GetInitializerExpr()->GetExprSrcText();
+            SrcLocation exprLocation{};
+            if (lineIndex.Contains(exprSrcText)) {
+                exprLocation = lineIndex.Locate(exprSrcText);
+            }
+            if (exprLocation.line == varNameLocation.line && exprLocation.startCol >= varNameLocation.endCol) {
+                std::fill_n(std::ostream_iterator<char>(*errStream), exprLocation.startCol - varNameLocation.endCol, ' ');
+                std::fill_n(std::ostream_iterator<char>(*errStream), exprLocation.endCol - exprLocation.startCol, '^');
+            }
+            *errStream << std::endl;
         }
 
-        void ErrorReporter::ReportVertexAttribDeclType(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) const {
+        void ErrorReporter::ReportVertexAttribDeclType(VertexAttribDecl* vertexAttribDecl) const {
             // TODO
         }
-        void ErrorReporter::ReportVertexAttribDeclChannel(std::shared_ptr<VertexAttribDecl> vertexAttribDecl) const {
+        void ErrorReporter::ReportVertexAttribDeclChannel(VertexAttribDecl* vertexAttribDecl) const {
             // TODO
         }
 
-        void ErrorReporter::ReportMaterialPropertyType(std::shared_ptr<MatPropDecl> matPropDecl) const {
+        void ErrorReporter::ReportMaterialPropertyType(MatPropDecl* matPropDecl) const {
             // TODO
         }
 
@@ -121,28 +177,5 @@ namespace crayon {
             // TODO
         }
 
-        std::string_view ErrorReporter::GetSrcCodeTokenLine(const Token& token) const {
-            const char* srcCodePtr = token.lexeme.data();
-            // 1. Walk backward to find the '\n' character that advances to our current line.
-            //    Be aware of the edge case when the current line is the very first one.
-            const char* start = srcCodeData;
-            const char* lineStart = srcCodePtr;
-            while (lineStart > start && *lineStart != '\n') {
-                lineStart--;
-            }
-            lineStart++;
-            // 2. Walk forward to find the '\n' character that advance to the next line.
-            //    Be aware of the edge case when the current line is the last one.
-            const char* end = srcCodeData + srcCodeSize;
-            const char* lineEnd = srcCodePtr;
-            while (lineEnd < end && *lineEnd != '\n') {
-                lineEnd++;
-            }
-            lineEnd--;
-            // The two pointer we've found form the beginning and end of the line we're looking for.
-            size_t lineSize = lineEnd - lineStart + 1;
-            return std::string_view{lineStart, lineSize};
-        }
-
     }
 }
\ No newline at end of file
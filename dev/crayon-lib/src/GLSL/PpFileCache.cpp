@@ -0,0 +1,49 @@
+#include "GLSL/PpFileCache.h"
+
+#include "SrcFile.h"
+
+#include <stdexcept>
+#include <system_error>
+
+namespace crayon {
+	namespace glsl {
+
+		std::shared_ptr<const PpFile> PpFileCache::Load(const std::filesystem::path& path) {
+			std::error_code errCode{};
+			std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(path, errCode);
+			if (errCode) {
+				throw std::runtime_error{"Couldn't open the include file: " + path.string()};
+			}
+			std::string key = path.generic_string();
+			{
+				std::lock_guard<std::mutex> lock{entriesMutex};
+				auto searchRes = entries.find(key);
+				if (searchRes != entries.end() && searchRes->second.lastWriteTime == lastWriteTime) {
+					hitCount++;
+					return searchRes->second.file;
+				}
+			}
+			// Scanned outside of the lock, two threads missing the same file at once just scan it twice.
+			missCount++;
+			SrcFile srcFile{};
+			srcFile.Open(path);
+			auto file = std::make_shared<PpFile>();
+			file->path = path;
+			// Copied, a cached mapping would break if the file were truncated later on.
+			file->content.assign(srcFile.GetData(), srcFile.GetSize());
+			file->text = file->content;
+			ScanPpFile(*file);
+			std::lock_guard<std::mutex> lock{entriesMutex};
+			entries[key] = Entry{lastWriteTime, file};
+			return file;
+		}
+
+		uint32_t PpFileCache::GetHitCount() const {
+			return hitCount;
+		}
+		uint32_t PpFileCache::GetMissCount() const {
+			return missCount;
+		}
+
+	}
+}
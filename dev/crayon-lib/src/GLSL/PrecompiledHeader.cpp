@@ -0,0 +1,261 @@
+#include "GLSL/PrecompiledHeader.h"
+
+#include "GLSL/CompileOptions.h"
+
+#include "GLSL/AST/AstArena.h"
+#include "GLSL/AST/FlatAst.h"
+
+#include "ByteStream.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <variant>
+
+namespace crayon {
+	namespace glsl {
+
+		static void ThrowCorrupted() {
+			throw std::runtime_error{"The precompiled header is corrupted, precompile it again."};
+		}
+
+		static void WriteStr(ByteWriter& writer, const FlatStr& str) {
+			writer.WriteU32(str.offset);
+			writer.WriteU32(str.length);
+		}
+		static void WriteIds(ByteWriter& writer, const std::vector<FlatId>& ids) {
+			writer.WriteU32(static_cast<uint32_t>(ids.size()));
+			for (FlatId id : ids) {
+				writer.WriteU32(id);
+			}
+		}
+		static void WriteConstants(ByteWriter& writer, const ConstantTable& constTable) {
+			std::vector<ConstantValue> constants = constTable.GetConstants();
+			// Added back in the same order, so that they get the same relative ids.
+			std::sort(constants.begin(), constants.end(), [](const ConstantValue& left, const ConstantValue& right) {
+				return left.id < right.id;
+			});
+			writer.WriteU32(static_cast<uint32_t>(constants.size()));
+			for (const ConstantValue& constant : constants) {
+				writer.WriteI32(static_cast<int32_t>(constant.constType));
+				writer.WriteU32(constant.id);
+				std::visit([&writer](auto value) {
+					writer.Write(&value, sizeof(value));
+				}, constant.value);
+			}
+		}
+
+		// Every element takes at least a byte, a larger count can only come from corrupted data.
+		static bool ReadCount(ByteReader& reader, uint32_t& count) {
+			return reader.ReadU32(count) && count <= reader.GetRemainingSize();
+		}
+		static bool ReadIds(ByteReader& reader, std::vector<FlatId>& ids) {
+			uint32_t count{0};
+			if (!ReadCount(reader, count)) {
+				return false;
+			}
+			ids.assign(count, noFlatId);
+			for (FlatId& id : ids) {
+				if (!reader.ReadU32(id)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		template <typename T>
+		static bool ReadConstant(ByteReader& reader, ConstId id, std::vector<ConstantValue>& constants) {
+			T value{};
+			if (!reader.Read(&value, sizeof(value))) {
+				return false;
+			}
+			constants.emplace_back(value, id);
+			return true;
+		}
+		static bool ReadConstants(ByteReader& reader, std::vector<ConstantValue>& constants) {
+			uint32_t constCount{0};
+			if (!ReadCount(reader, constCount)) {
+				return false;
+			}
+			constants.clear();
+			for (uint32_t i = 0; i < constCount; i++) {
+				int32_t constType{0};
+				ConstId id{0};
+				if (!reader.ReadI32(constType) || !reader.ReadU32(id)) {
+					return false;
+				}
+				bool read{false};
+				switch (static_cast<ConstType>(constType)) {
+					case ConstType::INT: read = ReadConstant<int>(reader, id, constants); break;
+					case ConstType::UINT: read = ReadConstant<unsigned int>(reader, id, constants); break;
+					case ConstType::FLOAT: read = ReadConstant<float>(reader, id, constants); break;
+					case ConstType::DOUBLE: read = ReadConstant<double>(reader, id, constants); break;
+					default: break;
+				}
+				if (!read) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void PrecompiledHeader::Write(const std::filesystem::path& pchPath, const PchContents& contents) {
+			// 1. The tables go first into their own buffer, flattening may add lexemes to the string data.
+			FlatAst flatAst{};
+			FlatAstBuilder flatAstBuilder{flatAst, contents.srcCode};
+			std::vector<uint8_t> tables;
+			ByteWriter tablesWriter{tables};
+			tablesWriter.WriteU32(static_cast<uint32_t>(contents.macros.size()));
+			for (const std::string& macro : contents.macros) {
+				WriteStr(tablesWriter, flatAstBuilder.AddStr(macro));
+			}
+			WriteConstants(tablesWriter, *contents.constTable);
+			std::vector<FlatId> typeSpecIds;
+			for (size_t typeId = 1; typeId < contents.typeTable->GetTypeCount(); typeId++) {
+				typeSpecIds.push_back(flatAstBuilder.AddTypeSpec(contents.typeTable->GetType(typeId)));
+			}
+			WriteIds(tablesWriter, typeSpecIds);
+			std::vector<FlatId> declIds;
+			for (Decl* decl : contents.decls) {
+				declIds.push_back(flatAstBuilder.AddDecl(decl));
+			}
+			WriteIds(tablesWriter, declIds);
+			flatAst.Write(tablesWriter);
+
+			// 2. The header, the string data and the files.
+			std::vector<uint8_t> data;
+			ByteWriter writer{data};
+			writer.WriteU32(pchMagic);
+			writer.WriteU32(pchFormatVersion);
+			writer.WriteString(compilerVersion);
+			writer.WriteString(flatAst.GetStrData());
+			writer.WriteU32(static_cast<uint32_t>(contents.srcCode.size()));
+			writer.WriteU32(static_cast<uint32_t>(contents.files.size()));
+			for (const std::string& file : contents.files) {
+				writer.WriteString(file);
+			}
+			writer.Write(tables.data(), tables.size());
+
+			// 3. Write the file.
+			std::ofstream pchFile{pchPath, std::ios::binary | std::ios::trunc};
+			pchFile.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			if (!pchFile) {
+				throw std::runtime_error{"Couldn't write the precompiled header: " + pchPath.string()};
+			}
+		}
+
+		void PrecompiledHeader::Open(const std::filesystem::path& pchPath) {
+			std::error_code errCode{};
+			if (!std::filesystem::is_regular_file(pchPath, errCode)) {
+				throw std::runtime_error{"Couldn't open the precompiled header: " + pchPath.string()};
+			}
+			path = pchPath;
+			file.Open(pchPath);
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(file.GetData());
+			ByteReader reader{data, file.GetSize()};
+
+			// 1. The header.
+			uint32_t magic{0};
+			uint32_t version{0};
+			std::string pchCompilerVersion;
+			if (!reader.ReadU32(magic) || magic != pchMagic) {
+				throw std::runtime_error{"Not a precompiled header: " + pchPath.string()};
+			}
+			if (!reader.ReadU32(version) || version != pchFormatVersion ||
+				!reader.ReadString(pchCompilerVersion) || pchCompilerVersion != compilerVersion) {
+				throw std::runtime_error{"The precompiled header was written by another version of the compiler, "
+				                         "precompile it again: " + pchPath.string()};
+			}
+
+			// 2. The string data, kept in the mapping.
+			uint32_t strDataSize{0};
+			if (!reader.ReadU32(strDataSize) || reader.GetRemainingSize() < strDataSize) {
+				ThrowCorrupted();
+			}
+			size_t strDataOffset = file.GetSize() - reader.GetRemainingSize();
+			strData = std::string_view{file.GetData() + strDataOffset, strDataSize};
+			size_t offset = strDataOffset + strDataSize;
+
+			// 3. The files and the tables.
+			uint32_t srcCodeSize32{0};
+			uint32_t fileCount{0};
+			uint32_t macroCount{0};
+			ByteReader tablesReader{data + offset, file.GetSize() - offset};
+			if (!tablesReader.ReadU32(srcCodeSize32) || srcCodeSize32 > strData.size() || !ReadCount(tablesReader, fileCount)) {
+				ThrowCorrupted();
+			}
+			srcCodeSize = srcCodeSize32;
+			files.assign(fileCount, std::string());
+			for (std::string& pchFile : files) {
+				if (!tablesReader.ReadString(pchFile)) {
+					ThrowCorrupted();
+				}
+			}
+			if (!ReadCount(tablesReader, macroCount)) {
+				ThrowCorrupted();
+			}
+			macros.assign(macroCount, std::string_view());
+			for (std::string_view& macro : macros) {
+				FlatStr macroStr{};
+				if (!tablesReader.ReadU32(macroStr.offset) || !tablesReader.ReadU32(macroStr.length) ||
+					macroStr.offset > strData.size() || macroStr.length > strData.size() - macroStr.offset) {
+					ThrowCorrupted();
+				}
+				macro = macroStr.length == 0 ? std::string_view{} : strData.substr(macroStr.offset, macroStr.length);
+			}
+			if (!ReadConstants(tablesReader, constants) || !ReadIds(tablesReader, typeSpecIds) ||
+				!ReadIds(tablesReader, declIds) || !flatAst.Read(tablesReader, strData) || !tablesReader.AtEnd()) {
+				ThrowCorrupted();
+			}
+
+			// 4. A dry run reports the rest of the corruptions (nodes containing themselves and such)
+			// now rather than in every compilation.
+			try {
+				AstArena astArena{};
+				TypeTable typeTable{};
+				ConstantTable constTable{};
+				Instantiate(typeTable, constTable, astArena);
+			} catch (const std::runtime_error&) {
+				ThrowCorrupted();
+			}
+		}
+
+		const std::filesystem::path& PrecompiledHeader::GetPath() const {
+			return path;
+		}
+		std::string_view PrecompiledHeader::GetSrcCode() const {
+			return strData.substr(0, srcCodeSize);
+		}
+		const std::vector<std::string>& PrecompiledHeader::GetFiles() const {
+			return files;
+		}
+		const std::vector<std::string_view>& PrecompiledHeader::GetMacros() const {
+			return macros;
+		}
+
+		std::vector<Decl*> PrecompiledHeader::Instantiate(TypeTable& typeTable, ConstantTable& constTable, AstArena& astArena) const {
+			std::unordered_map<ConstId, ConstId> constIds;
+			for (const ConstantValue& constant : constants) {
+				constIds[constant.id] = constTable.AddConstant(constant.value);
+			}
+			FlatAstLoaderConfig loaderConfig{};
+			loaderConfig.astArena = &astArena;
+			loaderConfig.constIds = &constIds;
+			FlatAstLoader loader{flatAst, loaderConfig};
+			// Indexed by the header's type ids.
+			std::vector<size_t> typeIds(1, 0);
+			for (FlatId typeSpecId : typeSpecIds) {
+				typeIds.push_back(typeTable.GetTypeId(loader.LoadTypeSpec(typeSpecId)));
+			}
+			std::vector<Decl*> decls;
+			for (FlatId declId : declIds) {
+				decls.push_back(loader.LoadDecl(declId));
+			}
+			// Every type is known by now.
+			loader.SetExprTypeIds(typeIds);
+			return decls;
+		}
+
+	}
+}
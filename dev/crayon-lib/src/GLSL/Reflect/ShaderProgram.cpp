@@ -1,5 +1,7 @@
 #include "GLSL/Reflect/ShaderProgram.h"
 
+#include "ByteStream.h"
+
 namespace crayon {
 
 	bool ShaderModule::IsValid() const {
@@ -66,4 +68,153 @@ namespace crayon {
 		return name;
 	}
 
+	// "CSPG" (Crayon Shader ProGram).
+	static constexpr uint32_t shaderProgramMagic{0x47505343};
+	// Increment every time the layout of the serialized data changes.
+	static constexpr uint32_t shaderProgramFormatVersion{1};
+
+	void SerializeShaderProgram(const ShaderProgram& shaderProgram, std::vector<uint8_t>& data) {
+		ByteWriter writer{data};
+		writer.WriteU32(shaderProgramMagic);
+		writer.WriteU32(shaderProgramFormatVersion);
+		writer.WriteString(shaderProgram.GetName());
+		// 1. Material properties.
+		const MaterialProps& matProps = shaderProgram.GetMaterialProps();
+		writer.WriteString(matProps.name);
+		writer.WriteU32(static_cast<uint32_t>(matProps.matProps.size()));
+		for (const MaterialPropDesc& matProp : matProps.matProps) {
+			writer.WriteString(matProp.name);
+			writer.WriteString(matProp.visibleName);
+			writer.WriteI32(static_cast<int32_t>(matProp.type));
+			writer.WriteU32(matProp.showInEditor ? 1 : 0);
+		}
+		// 2. Vertex input layout.
+		const VertexInputLayoutDesc& vertexInputLayout = shaderProgram.GetVertexInputLayout();
+		writer.WriteU32(static_cast<uint32_t>(vertexInputLayout.attributes.size()));
+		for (const VertexAttribDesc& vertexAttrib : vertexInputLayout.attributes) {
+			writer.WriteString(vertexAttrib.name);
+			writer.WriteU32(vertexAttrib.dimension);
+			writer.WriteU32(vertexAttrib.offset);
+			writer.WriteI32(static_cast<int32_t>(vertexAttrib.channel));
+			writer.WriteI32(static_cast<int32_t>(vertexAttrib.type));
+		}
+		// 3. Color attachments (only the ones in use).
+		std::vector<ColorAttachmentDesc> colorAttachments = shaderProgram.GetColorAttachments().GetColorAttachments();
+		writer.WriteU32(static_cast<uint32_t>(colorAttachments.size()));
+		for (const ColorAttachmentDesc& colorAttachment : colorAttachments) {
+			writer.WriteString(colorAttachment.name);
+			writer.WriteI32(static_cast<int32_t>(colorAttachment.channel));
+			writer.WriteI32(static_cast<int32_t>(colorAttachment.type));
+		}
+		// 4. Shader modules.
+		writer.WriteU32(static_cast<uint32_t>(ShaderType::COUNT));
+		for (size_t i = 0; i < static_cast<size_t>(ShaderType::COUNT); i++) {
+			const ShaderModule& shaderModule = shaderProgram.GetShaderModule(static_cast<ShaderType>(i));
+			writer.WriteString(shaderModule.glsl);
+			writer.WriteString(shaderModule.spvAsm);
+			writer.WriteU32(static_cast<uint32_t>(shaderModule.spvBinary.size()));
+			writer.Write(shaderModule.spvBinary.data(), shaderModule.spvBinary.size() * sizeof(uint32_t));
+		}
+	}
+	bool DeserializeShaderProgram(const uint8_t* data, size_t size, ShaderProgram& shaderProgram) {
+		ByteReader reader{data, size};
+		uint32_t magic{0};
+		uint32_t formatVersion{0};
+		if (!reader.ReadU32(magic) || magic != shaderProgramMagic ||
+		    !reader.ReadU32(formatVersion) || formatVersion != shaderProgramFormatVersion) {
+			return false;
+		}
+		ShaderProgram program{};
+		std::string name;
+		if (!reader.ReadString(name)) {
+			return false;
+		}
+		program.SetName(name);
+		// 1. Material properties.
+		MaterialProps matProps{};
+		uint32_t matPropCount{0};
+		if (!reader.ReadString(matProps.name) || !reader.ReadU32(matPropCount)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < matPropCount; i++) {
+			MaterialPropDesc matProp{};
+			uint32_t showInEditor{0};
+			if (!reader.ReadString(matProp.name) ||
+			    !reader.ReadString(matProp.visibleName) ||
+			    !reader.ReadEnum(matProp.type) ||
+			    !reader.ReadU32(showInEditor)) {
+				return false;
+			}
+			matProp.showInEditor = showInEditor != 0;
+			matProps.AddMatProp(matProp);
+		}
+		program.SetMaterialProps(matProps);
+		// 2. Vertex input layout.
+		VertexInputLayoutDesc vertexInputLayout{};
+		uint32_t vertexAttribCount{0};
+		if (!reader.ReadU32(vertexAttribCount)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < vertexAttribCount; i++) {
+			VertexAttribDesc vertexAttrib{};
+			if (!reader.ReadString(vertexAttrib.name) ||
+			    !reader.ReadU32(vertexAttrib.dimension) ||
+			    !reader.ReadU32(vertexAttrib.offset) ||
+			    !reader.ReadEnum(vertexAttrib.channel) ||
+			    !reader.ReadEnum(vertexAttrib.type)) {
+				return false;
+			}
+			vertexInputLayout.AddVertexAttrib(vertexAttrib);
+		}
+		program.SetVertexInputLayout(vertexInputLayout);
+		// 3. Color attachments.
+		uint32_t colorAttachmentCount{0};
+		if (!reader.ReadU32(colorAttachmentCount)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < colorAttachmentCount; i++) {
+			ColorAttachmentDesc colorAttachment{};
+			if (!reader.ReadString(colorAttachment.name) ||
+			    !reader.ReadEnum(colorAttachment.channel) ||
+			    !reader.ReadEnum(colorAttachment.type)) {
+				return false;
+			}
+			if (colorAttachment.channel <= ColorAttachmentChannel::UNDEFINED ||
+			    colorAttachment.channel >= ColorAttachmentChannel::COUNT) {
+				return false;
+			}
+			program.AddColorAttachmentDesc(colorAttachment);
+		}
+		// 4. Shader modules.
+		uint32_t shaderModuleCount{0};
+		if (!reader.ReadU32(shaderModuleCount) || shaderModuleCount != static_cast<uint32_t>(ShaderType::COUNT)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < shaderModuleCount; i++) {
+			ShaderType shaderType = static_cast<ShaderType>(i);
+			std::string glsl;
+			std::string spvAsm;
+			uint32_t spvWordCount{0};
+			if (!reader.ReadString(glsl) || !reader.ReadString(spvAsm) || !reader.ReadU32(spvWordCount)) {
+				return false;
+			}
+			// Don't trust the word count before making sure the data is actually there.
+			if (spvWordCount > reader.GetRemainingSize() / sizeof(uint32_t)) {
+				return false;
+			}
+			std::vector<uint32_t> spvBinary(spvWordCount);
+			if (!reader.Read(spvBinary.data(), spvBinary.size() * sizeof(uint32_t))) {
+				return false;
+			}
+			program.SetShaderModuleGlsl(shaderType, glsl);
+			program.SetShaderModuleSpvAsm(shaderType, spvAsm);
+			program.SetShaderModuleSpvBinary(shaderType, spvBinary);
+		}
+		if (!reader.AtEnd()) {
+			return false;
+		}
+		shaderProgram = std::move(program);
+		return true;
+	}
+
 }
\ No newline at end of file
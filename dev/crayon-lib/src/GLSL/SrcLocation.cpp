@@ -0,0 +1,127 @@
+#include "GLSL/SrcLocation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace crayon {
+	namespace glsl {
+
+		void SrcLineMap::Clear() {
+			runs.clear();
+			fileNames.clear();
+		}
+		void SrcLineMap::Add(uint32_t line, std::string_view fileName, uint32_t fileLine) {
+			assert((runs.empty() || runs.back().line <= line) && "Lines must be added in order!");
+			// A handful of files at most, a linear search will do.
+			auto fileNameIt = std::find(fileNames.begin(), fileNames.end(), fileName);
+			uint32_t fileIndex = static_cast<uint32_t>(fileNameIt - fileNames.begin());
+			if (fileNameIt == fileNames.end()) {
+				fileNames.emplace_back(fileName);
+			}
+			if (!runs.empty()) {
+				Run& lastRun = runs.back();
+				// The previous run just goes on, e.g. after an include skipped by its guard.
+				if (lastRun.fileIndex == fileIndex && lastRun.fileLine + (line - lastRun.line) == fileLine) {
+					return;
+				}
+				// The previous run is empty, e.g. an empty included file.
+				if (lastRun.line == line) {
+					lastRun = Run{line, fileIndex, fileLine};
+					return;
+				}
+			}
+			runs.push_back(Run{line, fileIndex, fileLine});
+		}
+		SrcFileLine SrcLineMap::Resolve(uint32_t line) const {
+			// The last run starting at or before the line.
+			auto nextRun = std::upper_bound(runs.begin(), runs.end(), line, [](uint32_t line, const Run& run) {
+				return line < run.line;
+			});
+			if (nextRun == runs.begin()) {
+				return SrcFileLine{std::string_view{}, line};
+			}
+			const Run& run = *(nextRun - 1);
+			return SrcFileLine{fileNames[run.fileIndex], run.fileLine + (line - run.line)};
+		}
+
+		void SrcLineIndex::Build(const char* srcData, size_t srcSize) {
+			this->srcData = srcData;
+			this->srcSize = srcSize;
+			lineStarts.clear();
+			lineStarts.push_back(0);
+			const char* current = srcData;
+			const char* end = srcData + srcSize;
+			// 'memchr' is already vectorized by every standard library worth using.
+			while (const void* lineEnd = std::memchr(current, '\n', end - current)) {
+				current = static_cast<const char*>(lineEnd) + 1;
+				lineStarts.push_back(static_cast<uint32_t>(current - srcData));
+			}
+		}
+		void SrcLineIndex::Clear() {
+			lineStarts.clear();
+			srcData = nullptr;
+			srcSize = 0;
+			lineMap = nullptr;
+		}
+		bool SrcLineIndex::IsBuilt() const {
+			return !lineStarts.empty();
+		}
+
+		bool SrcLineIndex::Contains(std::string_view text) const {
+			// Compared as integers, pointers into different arrays can't be ordered.
+			uintptr_t textStart = reinterpret_cast<uintptr_t>(text.data());
+			uintptr_t srcStart = reinterpret_cast<uintptr_t>(srcData);
+			return srcData && textStart >= srcStart && textStart + text.size() <= srcStart + srcSize;
+		}
+		SrcLocation SrcLineIndex::Locate(std::string_view text) const {
+			assert(Contains(text) && "The text must point into the indexed source code!");
+			size_t offset = text.data() - srcData;
+			SrcLocation location{};
+			location.line = GetLine(offset);
+			location.startCol = GetCol(location.line, offset);
+			location.endCol = GetCol(location.line, offset + text.size());
+			return location;
+		}
+		std::string_view SrcLineIndex::GetLineText(uint32_t line) const {
+			assert(line < lineStarts.size() && "The line is out of range!");
+			size_t lineStart = lineStarts[line];
+			size_t lineEnd = line + 1 < lineStarts.size() ? lineStarts[line + 1] - 1 : srcSize;
+			return std::string_view{srcData + lineStart, lineEnd - lineStart};
+		}
+
+		void SrcLineIndex::SetLineMap(const SrcLineMap* lineMap) {
+			this->lineMap = lineMap;
+		}
+		SrcFileLine SrcLineIndex::ResolveLine(uint32_t line) const {
+			return lineMap ? lineMap->Resolve(line) : SrcFileLine{std::string_view{}, line};
+		}
+
+		uint32_t SrcLineIndex::GetLine(size_t offset) const {
+			// The last line starting at or before the offset.
+			auto nextLineStart = std::upper_bound(lineStarts.begin(), lineStarts.end(), static_cast<uint32_t>(offset));
+			return static_cast<uint32_t>(nextLineStart - lineStarts.begin()) - 1;
+		}
+		uint32_t SrcLineIndex::GetCol(uint32_t line, size_t offset) const {
+			uint32_t col{0};
+			for (size_t i = lineStarts[line]; i < offset; i++) {
+				switch (srcData[i]) {
+					case '\t':
+						// That should depend on the editor's configuration somehow, right?
+						col += 4;
+						break;
+					case '\r':
+					case '\n':
+						// '\n' is only reachable by the end of a text spanning several lines.
+						col = 0;
+						break;
+					default:
+						col++;
+						break;
+				}
+			}
+			return col;
+		}
+
+	}
+}
@@ -76,7 +76,10 @@ namespace crayon {
 			"LEFT_BRACKET", "RIGHT_BRACKET",
 			"LEFT_BRACE", "RIGHT_BRACE",
 			"DOT", "COMMA", "SEMICOLON",
+			"QUESTION", // ?
 
+			// GLSL language extension punctuation marks:
+			"COLON",
 			// GLSL language extension keywords:
 			"STRING",
 			"SHADER_PROGRAM_KW",
@@ -149,7 +152,7 @@ namespace crayon {
 			"&", "^", "|", // &, ^, |
 			// Logical operators:
 			"&&", "^^", "||", // &&, ^^, ||
-			"==", // ==
+			"=", // =
 			"*=", "/=", "%=", // *=, /=, %=
 			"+=", "-=", // +=, -=
 			"<<=", ">>=", // <<=, >>=
@@ -165,7 +168,10 @@ namespace crayon {
 			"[", "]",
 			"{", "}",
 			".", ",", ";",
+			"?", // ?
 
+			// GLSL language extension punctuation marks:
+			":",
 			// GLSL language extension keywords:
 			"", // STRING
 			"ShaderProgram",
@@ -185,10 +191,16 @@ namespace crayon {
 			"ComputeShader",
 			// TODO
 		};
-
-		bool Token::HasSrcCodeRepresentation() const {
-			return line == -1 && startCol == -1 && endCol == -1;
-		}
+		// Indexed from STAR, the binary operators are contiguous and listed from the highest precedence down.
+		constexpr std::array<int, static_cast<size_t>(TokenType::OR_OP) - static_cast<size_t>(TokenType::STAR) + 1> binaryOpPrecedences{
+			11, 11, 11, // *, /, %
+			10, 10, // +, -
+			9, 9, // <<, >>
+			8, 8, 8, 8, // <, >, <=, >=
+			7, 7, // ==, !=
+			6, 5, 4, // &, ^, |
+			3, 2, 1, // &&, ^^, ||
+		};
 
 		Token GenerateToken(TokenType tokenType) {
 			Token token{};
@@ -197,11 +209,11 @@ namespace crayon {
 			return token;
 		}
 
-		void PrintToken(std::ostream& out, const Token& token) {
+		void PrintToken(std::ostream& out, const Token& token, const SrcLocation& location) {
 			// +1 for 'line' and 'startCol' variables is because internally lines and columns are indexed starting from 0.
 			out << "{"
 				<< "'" << token.lexeme << "'" << ", " 
-				<< "[" << token.line + 1 << ":" << token.startCol + 1 << "]"
+				<< "[" << location.line + 1 << ":" << location.startCol + 1 << "]"
 				<< "}";
 		}
 
@@ -218,6 +230,12 @@ namespace crayon {
 			return tokenLexeme;
 		}
 
+		int GetBinaryOpPrecedence(TokenType tokenType) {
+			if (tokenType < TokenType::STAR || tokenType > TokenType::OR_OP)
+				return 0;
+			return binaryOpPrecedences[static_cast<size_t>(tokenType) - static_cast<size_t>(TokenType::STAR)];
+		}
+
 		std::string_view ExtractStringLiteral(const Token& token) {
 			assert(token.tokenType == TokenType::STRING && "The token must be of the STRING type!");
 			// - Start past the initial string delimiter character ("'" or '"')
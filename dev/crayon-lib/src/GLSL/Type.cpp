@@ -377,14 +377,43 @@ namespace crayon {
 		}
 
 		TokenType InferExprType(TokenType lhs, TokenType rhs, TokenType op) {
+			// Only scalars, vectors and matrices can be operands of the binary operators from here on.
+			if (!IsTypeTransparent(lhs) || !IsTypeTransparent(rhs))
+				return TokenType::UNDEFINED;
 			// First of all, we need to figure out what type of operation is applied.
-			if (op == TokenType::PLUS || op == TokenType::DASH ||
-				op == TokenType::STAR || op == TokenType::SLASH) {
+			switch (op) {
 				// 1. Arithmetic binary operation.
-				return InferArithmeticBinaryExprType(lhs, rhs, op);
+				case TokenType::PLUS:
+				case TokenType::DASH:
+				case TokenType::STAR:
+				case TokenType::SLASH:
+					return InferArithmeticBinaryExprType(lhs, rhs, op);
+				// 2. Operations on integers only.
+				case TokenType::PERCENT:
+				case TokenType::AMPERSAND:
+				case TokenType::CARET:
+				case TokenType::VERTICAL_BAR:
+					return InferIntegerBinaryExprType(lhs, rhs, op);
+				case TokenType::LEFT_OP:
+				case TokenType::RIGHT_OP:
+					return InferShiftExprType(lhs, rhs);
+				// 3. Comparisons.
+				case TokenType::LEFT_ANGLE:
+				case TokenType::RIGHT_ANGLE:
+				case TokenType::LE_OP:
+				case TokenType::GE_OP:
+					return InferRelationalExprType(lhs, rhs);
+				case TokenType::EQ_OP:
+				case TokenType::NE_OP:
+					return InferEqualityExprType(lhs, rhs);
+				// 4. Logical operations.
+				case TokenType::AND_OP:
+				case TokenType::XOR_OP:
+				case TokenType::OR_OP:
+					return InferLogicalExprType(lhs, rhs);
+				default:
+					return TokenType::UNDEFINED;
 			}
-			// TODO: implement other types of operations.
-			return TokenType::UNDEFINED;
 		}
 		TokenType InferArithmeticBinaryExprType(TokenType lhs, TokenType rhs, TokenType op) {
 			// Following the specification's explanation on p.123
@@ -453,6 +482,75 @@ namespace crayon {
 			else
 				return TokenType::UNDEFINED;
 		}
+		static bool IsFundamentalTypeInteger(TokenType type) {
+			TokenType fundType = GetFundamentalType(type);
+			return fundType == TokenType::INT || fundType == TokenType::UINT;
+		}
+		TokenType InferIntegerBinaryExprType(TokenType lhs, TokenType rhs, TokenType op) {
+			// The %, &, ^ and | operators take integer scalars and vectors (there are no integer matrices),
+			// the operands are matched the same way as with the arithmetic binary operators.
+			if (!IsFundamentalTypeInteger(lhs) || !IsFundamentalTypeInteger(rhs))
+				return TokenType::UNDEFINED;
+			return InferArithmeticBinaryExprType(lhs, rhs, op);
+		}
+		TokenType InferShiftExprType(TokenType lhs, TokenType rhs) {
+			// Integer operands, which don't have to be of the same fundamental type. The right operand may only
+			// be a vector if the left one is a vector of the same size. The result is of the left operand's type.
+			if (!IsFundamentalTypeInteger(lhs) || !IsFundamentalTypeInteger(rhs))
+				return TokenType::UNDEFINED;
+			if (IsTypeScalar(rhs))
+				return lhs;
+			if (IsTypeVector(lhs) && GetColVecNumberOfRows(lhs) == GetColVecNumberOfRows(rhs))
+				return lhs;
+			return TokenType::UNDEFINED;
+		}
+		TokenType InferRelationalExprType(TokenType lhs, TokenType rhs) {
+			// Integer and floating-point scalars only (the vectors are compared with the built-in functions).
+			if (!IsTypeScalar(lhs) || !IsTypeScalar(rhs))
+				return TokenType::UNDEFINED;
+			if (lhs == TokenType::BOOL || rhs == TokenType::BOOL)
+				return TokenType::UNDEFINED;
+			return TokenType::BOOL;
+		}
+		TokenType InferEqualityExprType(TokenType lhs, TokenType rhs) {
+			// The operands must be of the same type after the implicit conversions,
+			// booleans are never converted.
+			if (lhs == rhs)
+				return lhs == TokenType::VOID ? TokenType::UNDEFINED : TokenType::BOOL;
+			if (GetFundamentalType(lhs) == TokenType::BOOL || GetFundamentalType(rhs) == TokenType::BOOL)
+				return TokenType::UNDEFINED;
+			if (IsTypeScalar(lhs) && IsTypeScalar(rhs))
+				return TokenType::BOOL;
+			if (IsTypeVector(lhs) && IsTypeVector(rhs) &&
+			    GetColVecNumberOfRows(lhs) == GetColVecNumberOfRows(rhs))
+				return TokenType::BOOL;
+			if (IsTypeMatrix(lhs) && IsTypeMatrix(rhs) &&
+			    GetMatNumberOfRows(lhs) == GetMatNumberOfRows(rhs) &&
+			    GetMatNumberOfCols(lhs) == GetMatNumberOfCols(rhs))
+				return TokenType::BOOL;
+			return TokenType::UNDEFINED;
+		}
+		TokenType InferLogicalExprType(TokenType lhs, TokenType rhs) {
+			// Boolean scalars only.
+			if (lhs != TokenType::BOOL || rhs != TokenType::BOOL)
+				return TokenType::UNDEFINED;
+			return TokenType::BOOL;
+		}
+		TokenType InferUnaryExprType(TokenType operand, TokenType op) {
+			if (!IsTypeTransparent(operand) || operand == TokenType::VOID)
+				return TokenType::UNDEFINED;
+			switch (op) {
+				case TokenType::PLUS:
+				case TokenType::DASH:
+					return GetFundamentalType(operand) == TokenType::BOOL ? TokenType::UNDEFINED : operand;
+				case TokenType::BANG:
+					return operand == TokenType::BOOL ? TokenType::BOOL : TokenType::UNDEFINED;
+				case TokenType::TILDE:
+					return IsFundamentalTypeInteger(operand) ? operand : TokenType::UNDEFINED;
+				default:
+					return TokenType::UNDEFINED;
+			}
+		}
 		TokenType InferScalarOpScalarExprType(TokenType lhs, TokenType rhs, TokenType op) {
 			// 1. Both operands are scalars.
 			// The operation is applied resulting in a scalar of the "biggest" type.
@@ -799,7 +897,7 @@ namespace crayon {
 					// we also need to account for a possibility of the types' categories being different.
 					// By type categories we mean a type being a scalar, a vector, or a matrix.
 					// If the check below is 'true', the the types' categories don't match, which is not promotable.
-					if (!IsTypeScalar(check.type.tokenType) && !IsTypeScalar(promoteTo.type.tokenType))
+					if (!IsTypeScalar(check.type.tokenType) || !IsTypeScalar(promoteTo.type.tokenType))
 						// Types are "mixed", which is not promotable.
 						return false;
 				}
@@ -870,6 +968,38 @@ namespace crayon {
 			resType.type = GenerateToken(resTokType);
 			return resType;
 		}
+		TypeSpec InferExprType(const TypeSpec& lhs, const TypeSpec& rhs, TokenType op) {
+			TypeSpec resType{};
+			if (lhs.IsStructure() || rhs.IsStructure() || lhs.IsArray() || rhs.IsArray()) {
+				// Structures and arrays can only be compared, and only with a value of the same type.
+				if ((op == TokenType::EQ_OP || op == TokenType::NE_OP) && lhs == rhs && !lhs.IsOpaque()) {
+					resType.type = GenerateToken(TokenType::BOOL);
+				}
+				return resType;
+			}
+			if (lhs.IsOpaque() || rhs.IsOpaque())
+				return resType;
+			resType.type = GenerateToken(InferExprType(lhs.type.tokenType, rhs.type.tokenType, op));
+			return resType;
+		}
+		TypeSpec InferUnaryExprType(const TypeSpec& operand, TokenType op) {
+			TypeSpec resType{};
+			if (operand.IsStructure() || operand.IsOpaque() || operand.IsArray())
+				return resType;
+			resType.type = GenerateToken(InferUnaryExprType(operand.type.tokenType, op));
+			return resType;
+		}
+		TypeSpec InferTernaryExprType(const TypeSpec& condition, const TypeSpec& trueType, const TypeSpec& falseType) {
+			// The condition is a boolean scalar, the branches may be of any type as long as
+			// one of them converts to the type of the other, which is the type of the expression.
+			if (condition.IsArray() || condition.type.tokenType != TokenType::BOOL)
+				return TypeSpec();
+			if (IsTypePromotable(trueType, falseType))
+				return falseType;
+			if (IsTypePromotable(falseType, trueType))
+				return trueType;
+			return TypeSpec();
+		}
 
 		std::string MangleTypeSpecName(const TypeSpec& typeSpec) {
 			std::stringstream nameMangler;
@@ -894,7 +1024,7 @@ namespace crayon {
 			typeMap["unknown"] = 0;
 		}
 
-		const TypeSpec& TypeTable::GetType(size_t idx) {
+		const TypeSpec& TypeTable::GetType(size_t idx) const {
 			assert(idx < types.size() && "Type index is out of bounds!");
 			return types[idx];
 		}
@@ -931,5 +1061,9 @@ namespace crayon {
 			return searchRes->second;
 		}
 
+		size_t TypeTable::GetTypeCount() const {
+			return types.size();
+		}
+
 	}
 }
\ No newline at end of file
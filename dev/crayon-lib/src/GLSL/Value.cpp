@@ -1,6 +1,7 @@
 #include "GLSL/Value.h"
 
 #include <cassert>
+#include <charconv>
 
 namespace crayon {
     namespace glsl {
@@ -63,61 +64,64 @@ namespace crayon {
             return constants;
         }
 
-        int ParseIntValue(std::string_view intVal) {
-            if (intVal.size() == 1 && intVal[0] == '0')
-                return 0;
-            int radix = 0;
-            if (intVal[0] == '0') {
-                if (intVal[1] == 'x' || intVal[1] == 'X')
-                    radix = 16;
-                else
-                    radix = 8;
+        const char* ParseIntConstBits(std::string_view digits, IntConstType intConstType, uint32_t& bits) {
+            uint64_t value{0};
+            std::from_chars_result res = std::from_chars(digits.data(), digits.data() + digits.size(), value,
+                                                         static_cast<int>(intConstType));
+            if (res.ec == std::errc::result_out_of_range || value > UINT32_MAX) {
+                return "Integer constant doesn't fit into 32 bits!";
             }
-            // Could use a radix value of 0, in which case the function will auto-detect the number's base.
-            int value = static_cast<int>(std::strtol(intVal.data(), nullptr, radix));
-            return value;
+            if (res.ec != std::errc{} || res.ptr != digits.data() + digits.size()) {
+                return "Invalid integer constant!";
+            }
+            bits = static_cast<uint32_t>(value);
+            return nullptr;
         }
-        unsigned int ParseUintValue(std::string_view uintVal) {
-            if (uintVal.size() == 1 && uintVal[0] == '0')
-                return 0;
-            int radix = 0;
-            if (uintVal[0] == '0') {
-                if (uintVal[1] == 'x' || uintVal[1] == 'X')
-                    radix = 16;
-                else
-                    radix = 8;
+        template<typename T>
+        static const char* ParseFloatingPointValue(std::string_view floatVal, T& value) {
+            std::from_chars_result res = std::from_chars(floatVal.data(), floatVal.data() + floatVal.size(), value,
+                                                         std::chars_format::general);
+            if (res.ec == std::errc::result_out_of_range) {
+                // Underflow flushes to zero (or a denormal) like 'strtof' did, only overflow is an error.
+                long double wideValue{0};
+                res = std::from_chars(floatVal.data(), floatVal.data() + floatVal.size(), wideValue,
+                                      std::chars_format::general);
+                if (res.ec != std::errc{} || wideValue >= 1.0l || wideValue <= -1.0l) {
+                    return "Floating-point constant is out of range!";
+                }
+                value = static_cast<T>(wideValue);
+                return nullptr;
+            }
+            if (res.ec != std::errc{} || res.ptr != floatVal.data() + floatVal.size()) {
+                return "Invalid floating-point constant!";
             }
-            // Could use a radix value of 0, in which case the function will auto-detect the number's base.
-            unsigned int value = static_cast<unsigned int>(std::strtoul(uintVal.data(), nullptr, radix));
-            return value;
+            return nullptr;
         }
-        float ParseFloatValue(std::string_view floatVal) {
-            float value = std::strtof(floatVal.data(), nullptr);
-            return value;
+        const char* ParseFloatValue(std::string_view floatVal, float& value) {
+            return ParseFloatingPointValue<float>(floatVal, value);
         }
-        double ParseDoubleValue(std::string_view doubleVal) {
-            double value = std::strtod(doubleVal.data(), nullptr);
-            return value;
+        const char* ParseDoubleValue(std::string_view doubleVal, double& value) {
+            return ParseFloatingPointValue<double>(doubleVal, value);
         }
 
         void PrintConstantValue(std::ostream& out, const ConstantValue& constVal) {
-            std::cout << "{" << "ID: " << constVal.id << ", ";
-            std::cout << "VALUE: ";
+            out << "{" << "ID: " << constVal.id << ", ";
+            out << "VALUE: ";
             switch (constVal.constType) {
                 case ConstType::INT:
-                    std::cout << std::get<int>(constVal.value);
+                    out << std::get<int>(constVal.value);
                     break;
                 case ConstType::UINT:
-                    std::cout << std::get<unsigned int>(constVal.value);
+                    out << std::get<unsigned int>(constVal.value);
                     break;
                 case ConstType::FLOAT:
-                    std::cout << std::get<float>(constVal.value);
+                    out << std::get<float>(constVal.value);
                     break;
                 case ConstType::DOUBLE:
-                    std::cout << std::get<double>(constVal.value);
+                    out << std::get<double>(constVal.value);
                     break;
             }
-            std::cout << "}";
+            out << "}";
         }
 
     }
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <stdexcept>
 
 namespace crayon {
 	namespace spirv {
@@ -25,7 +26,7 @@ namespace crayon {
 			assert(intBlockSearchRes != intBlocks.end() && "Make sure that the interface block exists first!");
 			if (intBlockSearchRes == intBlocks.end()) return nullptr;
 			assert(intBlockSearchRes->second->HasField(varName) && "Check the existence of the field first!");
-			return intBlockSearchRes->second->GetField(varName).get();
+			return intBlockSearchRes->second->GetField(varName);
 		}
 		glsl::VarDecl* SpvEnvironment::GetIntBlockVarDecl(std::string_view intBlockName,
 			                                                              std::string_view varName,
@@ -34,7 +35,7 @@ namespace crayon {
 			assert(intBlockSearchRes != intBlocks.end() && "Make sure that the interface block exists first!");
 			if (intBlockSearchRes == intBlocks.end()) return nullptr;
 			assert(intBlockSearchRes->second->HasField(varName) && "Check the existence of the field first!");
-			return intBlockSearchRes->second->GetField(varName, fieldIdx).get();
+			return intBlockSearchRes->second->GetField(varName, fieldIdx);
 		}
 		glsl::VarDecl* SpvEnvironment::GetVarDecl(std::string_view varName) {
 			auto varDeclSearchRes = variables.find(varName);
@@ -93,7 +94,7 @@ namespace crayon {
 			// GenerateTestProgram();
 			std::string_view name = program->GetShaderProgramName();
 			shaderProgram.SetName(name);
-			program->Accept(this);
+			Visit(program);
 		}
 
 		const ShaderProgram& GlslToSpvGenerator::GetShaderProgram() const {
@@ -107,30 +108,30 @@ namespace crayon {
 			// 1. SPIR-V mode-setting instructions.
 			SpvInstruction shaderCapability = OpCapability(SpvCapability::SHADER);
 			modeInstructions.push_back(shaderCapability);
-			SpvInstruction opExtInstImport = OpExtInstImport(std::string_view{"GLSL.std.450"});
+			SpvInstruction opExtInstImport = OpExtInstImport(spvIdGenerator, std::string_view{"GLSL.std.450"});
 			modeInstructions.push_back(opExtInstImport);
 			SpvInstruction opMemoryModel = OpMemoryModel(SpvAddressingModel::LOGICAL, SpvMemoryModel::GLSL_450);
 			modeInstructions.push_back(opMemoryModel);
 			// 2. OpTypeXXX
 			// 2.1 OpTypeVoid
-			SpvInstruction opTypeVoid = OpTypeVoid();
+			SpvInstruction opTypeVoid = OpTypeVoid(spvIdGenerator);
 			tvc.push_back(opTypeVoid);
 			// 2.2 OpTypeFloat
-			SpvInstruction opTypeFloat = OpTypeFloat(32);
+			SpvInstruction opTypeFloat = OpTypeFloat(spvIdGenerator, 32);
 			tvc.push_back(opTypeFloat);
 			// 2.3 OpTypeVector
 			// Declaring a vec4 type.
-			SpvInstruction opTypeVector3 = OpTypeVector(opTypeFloat, 3);
+			SpvInstruction opTypeVector3 = OpTypeVector(spvIdGenerator, opTypeFloat, 3);
 			tvc.push_back(opTypeVector3);
-			SpvInstruction opTypeVector4 = OpTypeVector(opTypeFloat, 4);
+			SpvInstruction opTypeVector4 = OpTypeVector(spvIdGenerator, opTypeFloat, 4);
 			tvc.push_back(opTypeVector4);
 			// Creating a type pointer to the vec4 type with the uniform storage class.
-			SpvInstruction opTypePointerVec4 = OpTypePointer(opTypeVector3, SpvStorageClass::UNIFORM);
+			SpvInstruction opTypePointerVec4 = OpTypePointer(spvIdGenerator, opTypeVector3, SpvStorageClass::UNIFORM);
 			tvc.push_back(opTypePointerVec4);
 			// 3. Constant instructions.
-			SpvInstruction opConstantFl_0_5 = OpConstant(opTypeFloat, 0.5f);
+			SpvInstruction opConstantFl_0_5 = OpConstant(spvIdGenerator, opTypeFloat, 0.5f);
 			tvc.push_back(opConstantFl_0_5);
-			SpvInstruction opConstantFl_1_0 = OpConstant(opTypeFloat, 1.0f);
+			SpvInstruction opConstantFl_1_0 = OpConstant(spvIdGenerator, opTypeFloat, 1.0f);
 			tvc.push_back(opConstantFl_1_0);
 			// 3.1 Composite constant (vec4)
 			std::vector<SpvInstruction> constituents(4);
@@ -138,28 +139,25 @@ namespace crayon {
 			constituents[1] = opConstantFl_0_5;
 			constituents[2] = opConstantFl_0_5;
 			constituents[3] = opConstantFl_1_0;
-			SpvInstruction opConstantCompositeVec4 = OpConstantComposite(opTypeVector4, constituents);
+			SpvInstruction opConstantCompositeVec4 = OpConstantComposite(spvIdGenerator, opTypeVector4, constituents);
 			tvc.push_back(opConstantCompositeVec4);
 			// 4. Functions
 			// Creating a function type of the form: "void fun_name()" where "fun_name" can be any function name.
 			// Function has no parameters and doesn't return anything.
-			SpvInstruction opTypeFunctionVoid = OpTypeFunction(opTypeVoid);
+			SpvInstruction opTypeFunctionVoid = OpTypeFunction(spvIdGenerator, opTypeVoid);
 			tvc.push_back(opTypeFunctionVoid);
 			// Creating a void function with no parameters.
-			SpvInstruction opVoidFunction = OpFunction(opTypeFunctionVoid, SpvFunctionControl::NONE);
+			SpvInstruction opVoidFunction = OpFunction(spvIdGenerator, opTypeFunctionVoid, SpvFunctionControl::NONE);
 			instructions.push_back(opVoidFunction);
-			SpvInstruction voidFunBlockStart = OpLabel();
+			SpvInstruction voidFunBlockStart = OpLabel(spvIdGenerator);
 			instructions.push_back(voidFunBlockStart);
 			// 5. Variable declaration.
-			SpvInstruction vec3InTypePointer = OpTypePointer(opTypeVector3, SpvStorageClass::INPUT);
+			SpvInstruction vec3InTypePointer = OpTypePointer(spvIdGenerator, opTypeVector3, SpvStorageClass::INPUT);
 			tvc.push_back(vec3InTypePointer);
-			SpvInstruction vec4OutTypePointer = OpTypePointer(opTypeVector4, SpvStorageClass::OUTPUT);
+			SpvInstruction vec4OutTypePointer = OpTypePointer(spvIdGenerator, opTypeVector4, SpvStorageClass::OUTPUT);
 			tvc.push_back(vec4OutTypePointer);
-			// a) Variable without an initializer.
-			SpvInstruction vec3InVarDecl = OpVariable(vec3InTypePointer, SpvStorageClass::INPUT);
-			SpvInstruction vec4OutVarDecl = OpVariable(vec4OutTypePointer, SpvStorageClass::OUTPUT);
-			// b) Variable with an initializer.
-			// SpvInstruction vec4VarDecl = OpVariable(vec4TypePointer, SpvStorageClass::OUTPUT, opConstantCompositeVec4);
+			SpvInstruction vec3InVarDecl = OpVariable(spvIdGenerator, vec3InTypePointer, SpvStorageClass::INPUT);
+			SpvInstruction vec4OutVarDecl = OpVariable(spvIdGenerator, vec4OutTypePointer, SpvStorageClass::OUTPUT);
 			interfaceVars.push_back(vec3InVarDecl);
 			interfaceVars.push_back(vec4OutVarDecl);
 			// 6. Storing composite constant in a variable (whose types should match).
@@ -185,6 +183,10 @@ namespace crayon {
 		void GlslToSpvGenerator::ClearState() {
 			spvEnv.Clear();
 
+			// Every shader module gets its own id sequence starting from 1.
+			spvIdGenerator = SpvIdGenerator{};
+
+			modeInstructions.clear();
 			decorations.clear();
 			tvc.clear();
 
@@ -193,6 +195,15 @@ namespace crayon {
 			instructions.clear();
 		}
 
+		void GlslToSpvGenerator::CreateModeInstructions() {
+			SpvInstruction shaderCapability = OpCapability(SpvCapability::SHADER);
+			modeInstructions.push_back(shaderCapability);
+			SpvInstruction opExtInstImport = OpExtInstImport(spvIdGenerator, std::string_view{"GLSL.std.450"});
+			modeInstructions.push_back(opExtInstImport);
+			SpvInstruction opMemoryModel = OpMemoryModel(SpvAddressingModel::LOGICAL, SpvMemoryModel::GLSL_450);
+			modeInstructions.push_back(opMemoryModel);
+		}
+
 		std::vector<uint32_t> GlslToSpvGenerator::GenerateSpvBinary() {
 			std::vector<uint32_t> spvBinary;
 			PrintFirstWords(spvBinary);
@@ -205,7 +216,7 @@ namespace crayon {
 		}
 		std::string GlslToSpvGenerator::GenerateSpvAsmText() {
 			std::stringstream spvAsmText;
-			idFieldWidth = CalcDigitCount(GetLastGeneratedSpvId()) + 1; // 1 is from the "%" character
+			idFieldWidth = CalcDigitCount(spvIdGenerator.GetLastGeneratedUniqueId()) + 1; // 1 is from the "%" character
 			PrintExtInstructions(spvAsmText);
 			PrintModeInstructions(spvAsmText);
 			PrintEntryPointInstruction(spvAsmText);
@@ -218,19 +229,19 @@ namespace crayon {
 		// NEW
 
 		void GlslToSpvGenerator::CreateVertexInputLayoutInstructions() {
-			spvEnv.vertexInputVarDecls = CreateVertexAttribDecls(shaderProgram.GetVertexInputLayout());
-			for (const std::shared_ptr<VarDecl>& vertexAttribVarDecl : spvEnv.vertexInputVarDecls) {
-				spvEnv.AddVarDecl(vertexAttribVarDecl.get());
+			spvEnv.vertexInputVarDecls = CreateVertexAttribDecls(*config.astArena, shaderProgram.GetVertexInputLayout());
+			for (VarDecl* vertexAttribVarDecl : spvEnv.vertexInputVarDecls) {
+				spvEnv.AddVarDecl(vertexAttribVarDecl);
 			}
 
-			const std::vector<std::shared_ptr<VertexAttribDecl>>& attribDecls = vertexInputLayoutBlock->GetAttribDecls();
+			const std::vector<VertexAttribDecl*>& attribDecls = vertexInputLayoutBlock->GetAttribDecls();
 			for (size_t i = 0; i < attribDecls.size(); i++) {
 				const Token& channelToken = attribDecls[i]->GetChannel();
 				VertexAttribChannel vertexAttribChannel = IdentifierTokenToVertexAttribChannel(channelToken);
 				int location = GetVertexAttribChannelNum(vertexAttribChannel);
 
 				SpvInstruction typePtrInst = GetTypePtrDeclInst(attribDecls[i]->GetTypeSpec(), SpvStorageClass::INPUT);
-				SpvInstruction varDeclInst = OpVariable(typePtrInst, SpvStorageClass::INPUT);
+				SpvInstruction varDeclInst = OpVariable(spvIdGenerator, typePtrInst, SpvStorageClass::INPUT);
 				interfaceVars.push_back(varDeclInst);
 				tvc.push_back(varDeclInst);
 
@@ -243,7 +254,7 @@ namespace crayon {
 			}
 		}
 		void GlslToSpvGenerator::CreateColorAttachmentInstructions() {
-			const std::vector<std::shared_ptr<ColorAttachmentDecl>>& colorAttachments =
+			const std::vector<ColorAttachmentDecl*>& colorAttachments =
 				colorAttachmentsBlock->GetColorAttachments();
 
 			for (size_t i = 0; i < colorAttachments.size(); i++) {
@@ -252,7 +263,7 @@ namespace crayon {
 				int location = GetColorAttachmentChannelNum(colorAttachmentChannel);
 
 				SpvInstruction typePtrInst = GetTypePtrDeclInst(colorAttachments[i]->GetTypeSpec(), SpvStorageClass::OUTPUT);
-				SpvInstruction varDeclInst = OpVariable(typePtrInst, SpvStorageClass::OUTPUT);
+				SpvInstruction varDeclInst = OpVariable(spvIdGenerator, typePtrInst, SpvStorageClass::OUTPUT);
 				interfaceVars.push_back(varDeclInst);
 				tvc.push_back(varDeclInst);
 
@@ -264,9 +275,9 @@ namespace crayon {
 				decorations.push_back(locDecInst);
 			}
 
-			spvEnv.colorAttachmentVarDecls = CreateColorAttachmentVarDecls(shaderProgram.GetColorAttachments());
-			for (const std::shared_ptr<VarDecl>& colorAttachmentVarDecl : spvEnv.colorAttachmentVarDecls) {
-				spvEnv.AddVarDecl(colorAttachmentVarDecl.get());
+			spvEnv.colorAttachmentVarDecls = CreateColorAttachmentVarDecls(*config.astArena, shaderProgram.GetColorAttachments());
+			for (VarDecl* colorAttachmentVarDecl : spvEnv.colorAttachmentVarDecls) {
+				spvEnv.AddVarDecl(colorAttachmentVarDecl);
 			}
 		}
 
@@ -296,7 +307,7 @@ namespace crayon {
 				typeDeclInst = CreateArrayTypeDeclInst(typeSpec);
 			} else {
 				if (typeSpec.type.tokenType == TokenType::VOID) {
-					typeDeclInst = OpTypeVoid();
+					typeDeclInst = OpTypeVoid(spvIdGenerator);
 				} else if (typeSpec.IsScalar()) {
 					typeDeclInst = CreateScalarTypeDeclInst(typeSpec);
 				} else if (typeSpec.IsVector()) {
@@ -315,7 +326,7 @@ namespace crayon {
 		}
 		SpvInstruction GlslToSpvGenerator::CreateTypePtrDeclInst(const glsl::TypeSpec& typeSpec, SpvStorageClass storageClass) {
 			SpvInstruction typeDeclInst = GetTypeDeclInst(typeSpec);
-			SpvInstruction typePtrInst = OpTypePointer(typeDeclInst, storageClass);
+			SpvInstruction typePtrInst = OpTypePointer(spvIdGenerator, typeDeclInst, storageClass);
 			std::string mangledTypePtrName = MangleTypePtrName(typeSpec, storageClass);
 			spvEnv.typePtrs.insert({mangledTypePtrName, typePtrInst});
 			tvc.push_back(typePtrInst);
@@ -325,19 +336,19 @@ namespace crayon {
 		SpvInstruction GlslToSpvGenerator::CreateScalarTypeDeclInst(const glsl::TypeSpec& typeSpec) {
 			switch (typeSpec.type.tokenType) {
 				case TokenType::BOOL: {
-					return OpTypeBool();
+					return OpTypeBool(spvIdGenerator);
 				}
 				case TokenType::INT: {
-					return OpTypeInt(32, SpvSignedness::SIGNED);
+					return OpTypeInt(spvIdGenerator, 32, SpvSignedness::SIGNED);
 				}
 				case TokenType::UINT: {
-					return OpTypeInt(32, SpvSignedness::UNSIGNED);
+					return OpTypeInt(spvIdGenerator, 32, SpvSignedness::UNSIGNED);
 				}
 				case TokenType::FLOAT: {
-					return OpTypeFloat(32);
+					return OpTypeFloat(spvIdGenerator, 32);
 				}
 				case TokenType::DOUBLE: {
-					return OpTypeFloat(64);
+					return OpTypeFloat(spvIdGenerator, 64);
 				}
 				default: {
 					assert(false && "Non-scalar type provided!");
@@ -354,7 +365,7 @@ namespace crayon {
 
 			SpvInstruction fundTypeDeclInst = GetTypeDeclInst(fundTypeSpec);
 			uint32_t componentCount = static_cast<uint32_t>(GetColVecNumberOfRows(typeSpec.type.tokenType));
-			return OpTypeVector(fundTypeDeclInst, componentCount);
+			return OpTypeVector(spvIdGenerator, fundTypeDeclInst, componentCount);
 		}
 		SpvInstruction GlslToSpvGenerator::CreateMatrixTypeDeclInst(const glsl::TypeSpec& typeSpec) {
 			// TODO
@@ -372,7 +383,7 @@ namespace crayon {
 
 				SpvInstruction baseTypeDeclInst = GetTypeDeclInst(baseTypeSpec);
 				SpvInstruction dimConst = GetConstInst(static_cast<uint32_t>(typeSpec.dimensions[0].dimSize));
-				SpvInstruction arrayDeclInst = OpTypeArray(baseTypeDeclInst, dimConst);
+				SpvInstruction arrayDeclInst = OpTypeArray(spvIdGenerator, baseTypeDeclInst, dimConst);
 				return arrayDeclInst;
 			}
 			// 2. Arrays of more than one dimension.
@@ -384,7 +395,7 @@ namespace crayon {
 
 			SpvInstruction arrayTypeDeclInst = GetTypeDeclInst(arrayType);
 			SpvInstruction dimConst = GetConstInst(static_cast<uint32_t>(typeSpec.dimensions[0].dimSize));
-			SpvInstruction arrayDeclInst = OpTypeArray(arrayTypeDeclInst, dimConst);
+			SpvInstruction arrayDeclInst = OpTypeArray(spvIdGenerator, arrayTypeDeclInst, dimConst);
 
 			return arrayDeclInst;
 		}
@@ -395,7 +406,7 @@ namespace crayon {
 			InterfaceBlockDecl* glPerVertex = spvEnv.GetIntBlock(intBlockName);
 			// 2. Then we get the field declaration pointer as well as its index among other fields.
 			size_t fieldIdx{ 0 };
-			std::shared_ptr<VarDecl> fieldDecl = glPerVertex->GetField(fieldName, fieldIdx);
+			VarDecl* fieldDecl = glPerVertex->GetField(fieldName, fieldIdx);
 			// 3. Now we need a type pointer that is going to be used to construct an OpAccessChain instruction.
 			//    So we basically combine the storage qualifier of the interface block and
 			//    the type specifier of the field.
@@ -423,7 +434,7 @@ namespace crayon {
 			SpvInstruction fieldIdxConstInst = GetConstInst(static_cast<uint32_t>(fieldIdx));
 
 			// And now we can produce an OpAccessChain instruction.
-			SpvInstruction opAccessChainInst = OpAccessChain(typePtrDeclInst, intBlockVarDeclInst, fieldIdxConstInst);
+			SpvInstruction opAccessChainInst = OpAccessChain(spvIdGenerator, typePtrDeclInst, intBlockVarDeclInst, fieldIdxConstInst);
 			return opAccessChainInst;
 		}
 
@@ -443,7 +454,7 @@ namespace crayon {
 			const FullSpecType& retType = funProto->GetReturnType();
 			SpvInstruction retTypeDeclInst = GetTypeDeclInst(retType.specifier);
 
-			SpvInstruction typeFunDeclInst = OpTypeFunction(retTypeDeclInst);
+			SpvInstruction typeFunDeclInst = OpTypeFunction(spvIdGenerator, retTypeDeclInst);
 			std::string mangledFunTypeName = MangleTypeFunctionName(funProto);
 			spvEnv.typeDecls.insert({mangledFunTypeName, typeFunDeclInst});
 			tvc.push_back(typeFunDeclInst);
@@ -454,7 +465,7 @@ namespace crayon {
 			TypeSpec typeSpec{};
 			typeSpec.type = GenerateToken(TokenType::INT);
 			SpvInstruction typeDeclInst = GetTypeDeclInst(typeSpec);
-			SpvInstruction constDeclInst = OpConstant(typeDeclInst, constVal);
+			SpvInstruction constDeclInst = OpConstant(spvIdGenerator, typeDeclInst, constVal);
 
 			std::string mangledConstName = MangleConstName(constVal);
 			spvEnv.constants.insert({ mangledConstName, constDeclInst });
@@ -466,7 +477,7 @@ namespace crayon {
 			TypeSpec typeSpec{};
 			typeSpec.type = GenerateToken(TokenType::UINT);
 			SpvInstruction typeDeclInst = GetTypeDeclInst(typeSpec);
-			SpvInstruction constDeclInst = OpConstant(typeDeclInst, constVal);
+			SpvInstruction constDeclInst = OpConstant(spvIdGenerator, typeDeclInst, constVal);
 
 			std::string mangledConstName = MangleConstName(constVal);
 			spvEnv.constants.insert({ mangledConstName, constDeclInst });
@@ -478,7 +489,7 @@ namespace crayon {
 			TypeSpec typeSpec{};
 			typeSpec.type = GenerateToken(TokenType::FLOAT);
 			SpvInstruction typeDeclInst = GetTypeDeclInst(typeSpec);
-			SpvInstruction constDeclInst = OpConstant(typeDeclInst, constVal);
+			SpvInstruction constDeclInst = OpConstant(spvIdGenerator, typeDeclInst, constVal);
 
 			std::string mangledConstName = MangleConstName(constVal);
 			spvEnv.constants.insert({ mangledConstName, constDeclInst });
@@ -490,7 +501,7 @@ namespace crayon {
 			TypeSpec typeSpec{};
 			typeSpec.type = GenerateToken(TokenType::DOUBLE);
 			SpvInstruction typeDeclInst = GetTypeDeclInst(typeSpec);
-			SpvInstruction constDeclInst = OpConstant(typeDeclInst, constVal);
+			SpvInstruction constDeclInst = OpConstant(spvIdGenerator, typeDeclInst, constVal);
 
 			std::string mangledConstName = MangleConstName(constVal);
 			spvEnv.constants.insert({ mangledConstName, constDeclInst });
@@ -580,7 +591,7 @@ namespace crayon {
 			uint32_t generataorMagicNumber = 0;
 			storage.push_back(generataorMagicNumber);
 
-			uint32_t bound = GetLastGeneratedSpvId() + 1;
+			uint32_t bound = spvIdGenerator.GetLastGeneratedUniqueId() + 1;
 			storage.push_back(bound);
 
 			uint32_t instructionSchemaReserved = 0;
@@ -684,14 +695,8 @@ namespace crayon {
 		}
 
 		void GlslToSpvGenerator::VisitShaderProgramBlock(glsl::ShaderProgramBlock* programBlock) {
-			SpvInstruction shaderCapability = OpCapability(SpvCapability::SHADER);
-			modeInstructions.push_back(shaderCapability);
-			SpvInstruction opExtInstImport = OpExtInstImport(std::string_view{"GLSL.std.450"});
-			modeInstructions.push_back(opExtInstImport);
-			SpvInstruction opMemoryModel = OpMemoryModel(SpvAddressingModel::LOGICAL, SpvMemoryModel::GLSL_450);
-			modeInstructions.push_back(opMemoryModel);
-			for (const std::shared_ptr<Block>& block : programBlock->GetBlocks()) {
-				block->Accept(this);
+			for (Block* block : programBlock->GetBlocks()) {
+				Visit(block);
 			}
 		}
 		void GlslToSpvGenerator::VisitFixedStagesConfigBlock(glsl::FixedStagesConfigBlock* fixedStagesConfigBlock) {
@@ -700,7 +705,7 @@ namespace crayon {
 		void GlslToSpvGenerator::VisitMaterialPropertiesBlock(glsl::MaterialPropertiesBlock* materialPropertiesBlock) {
 			MaterialProps matPropsDesc{};
 			matPropsDesc.name = ExtractStringLiteral(materialPropertiesBlock->GetName());
-			for (const std::shared_ptr<MatPropDecl>& matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
+			for (MatPropDecl* matPropDecl : materialPropertiesBlock->GetMatPropDecls()) {
 				const Token& type = matPropDecl->GetType();
 				const Token& name = matPropDecl->GetName();
 				TokenType tokenType = MapMaterialPropertyType(type.tokenType);
@@ -721,7 +726,7 @@ namespace crayon {
 			this->vertexInputLayoutBlock = vertexInputLayoutBlock;
 
 			//spvEnv.vertexInputVarDecls = CreateVertexAttribDecls(shaderProgram.GetVertexInputLayout());
-			//for (const std::shared_ptr<VarDecl>& vertexAttribVarDecl : spvEnv.vertexInputVarDecls) {
+			//for (VarDecl* vertexAttribVarDecl : spvEnv.vertexInputVarDecls) {
 			//	spvEnv.AddVarDecl(vertexAttribVarDecl.get());
 			//}
 		}
@@ -730,23 +735,29 @@ namespace crayon {
 			this->colorAttachmentsBlock = colorAttachmentsBlock;
 
 			//spvEnv.colorAttachmentVarDecls = CreateColorAttachmentVarDecls(shaderProgram.GetColorAttachments());
-			//for (const std::shared_ptr<VarDecl>& colorAttachmentVarDecl : spvEnv.colorAttachmentVarDecls) {
+			//for (VarDecl* colorAttachmentVarDecl : spvEnv.colorAttachmentVarDecls) {
 			//	spvEnv.AddVarDecl(colorAttachmentVarDecl.get());
 			//}
 		}
 		void GlslToSpvGenerator::VisitShaderBlock(glsl::ShaderBlock* shaderBlock) {
+			// Mode-setting instructions are repeated in every module,
+			// because each module is a separate SPIR-V binary with its own ids.
+			glsl::PhaseTimer stageTimer{};
 			ShaderType shaderType = shaderBlock->GetShaderType();
+			TraceScope stageSpan{config.trace, glsl::ShaderTypeToStr(shaderType), "stage"};
+			ClearState();
+			CreateModeInstructions();
 			switch (shaderType) {
 				case ShaderType::VS: {
 					spvEnv.execModel = SpvExecutionModel::VERTEX;
 
-					std::shared_ptr<InterfaceBlockDecl> glPerVertex = CreatePerVertexIntBlockDecl();
-					glPerVertex->Accept(this);
+					InterfaceBlockDecl* glPerVertex = CreatePerVertexIntBlockDecl(*config.astArena);
+					Visit(glPerVertex);
 
 					CreateVertexInputLayoutInstructions();
 					
-					std::shared_ptr<TransUnit> transUnit = shaderBlock->GetTranslationUnit();
-					transUnit->Accept(this);
+					TransUnit* transUnit = shaderBlock->GetTranslationUnit();
+					Visit(transUnit);
 
 					if (config.type == SpvType::ASM) {
 						shaderProgram.SetShaderModuleSpvAsm(ShaderType::VS, GenerateSpvAsmText());
@@ -773,8 +784,8 @@ namespace crayon {
 
 					CreateColorAttachmentInstructions();
 
-					std::shared_ptr<TransUnit> transUnit = shaderBlock->GetTranslationUnit();
-					transUnit->Accept(this);
+					TransUnit* transUnit = shaderBlock->GetTranslationUnit();
+					Visit(transUnit);
 
 					if (config.type == SpvType::ASM) {
 						shaderProgram.SetShaderModuleSpvAsm(ShaderType::FS, GenerateSpvAsmText());
@@ -789,11 +800,15 @@ namespace crayon {
 					return;
 				}
 			}
+			if (config.stats) {
+				glsl::ShaderStageStats& stageStats = config.stats->stages[static_cast<size_t>(shaderType)];
+				stageStats.spvGeneration = stageTimer.Stop();
+			}
 		}
 
 		void GlslToSpvGenerator::VisitTransUnit(glsl::TransUnit* transUnit) {
-			for (const std::shared_ptr<Decl>& decl : transUnit->GetDeclarations()) {
-				decl->Accept(this);
+			for (Decl* decl : transUnit->GetDeclarations()) {
+				Visit(decl);
 			}
 		}
 		void GlslToSpvGenerator::VisitStructDecl(glsl::StructDecl* structDecl) {
@@ -804,7 +819,7 @@ namespace crayon {
 			nameMangler << intBlockDecl->GetName().lexeme;
 			// 1. First we create a struct type.
 			std::vector<SpvInstruction> intBlockMembers(intBlockDecl->GetFieldCount());
-			const std::vector<std::shared_ptr<glsl::VarDecl>>& intBlockFields = intBlockDecl->GetFields();
+			const std::vector<glsl::VarDecl*>& intBlockFields = intBlockDecl->GetFields();
 			for (size_t i = 0; i < intBlockFields.size(); i++) {
 				// Every field must have a type, but not necessarily a type pointer.
 				// A type pointer is only needed if we access a block member.
@@ -819,7 +834,7 @@ namespace crayon {
 			}
 			// There's no need to try to get a type declaration instruction because we assume
 			// that the parser has already made sure that an interface block is only declared once.
-			SpvInstruction intBlockTypeDeclInst = OpTypeStruct(intBlockMembers);
+			SpvInstruction intBlockTypeDeclInst = OpTypeStruct(spvIdGenerator, intBlockMembers);
 			tvc.push_back(intBlockTypeDeclInst);
 			spvEnv.typeDecls.insert({nameMangler.str(), intBlockTypeDeclInst});
 
@@ -847,7 +862,7 @@ namespace crayon {
 				}
 			}
 			nameMangler << "type_ptr_" << SpvStorageClassToString(spvStorageClass) << "_" << intBlockDecl->GetName().lexeme;
-			SpvInstruction intBlockTypePtrInst = OpTypePointer(intBlockTypeDeclInst, spvStorageClass);
+			SpvInstruction intBlockTypePtrInst = OpTypePointer(spvIdGenerator, intBlockTypeDeclInst, spvStorageClass);
 			tvc.push_back(intBlockTypePtrInst);
 			spvEnv.typePtrs.insert({nameMangler.str(), intBlockTypePtrInst});
 
@@ -857,7 +872,7 @@ namespace crayon {
 			// 4. We also create a variable.
 			// nameMangler << "var_" << intBlockDecl->GetName().lexeme;
 			nameMangler << intBlockDecl->GetName().lexeme;
-			SpvInstruction intBlockVarDeclInst = OpVariable(intBlockTypePtrInst, spvStorageClass);
+			SpvInstruction intBlockVarDeclInst = OpVariable(spvIdGenerator, intBlockTypePtrInst, spvStorageClass);
 			tvc.push_back(intBlockVarDeclInst);
 			spvEnv.varDecls.insert({nameMangler.str(), intBlockVarDeclInst});
 
@@ -892,11 +907,11 @@ namespace crayon {
 				return;
 
 			// 2. Function prototype.
-			std::shared_ptr<FunProto> funProto = funDecl->GetFunProto();
-			std::string funMangledName = MangleTypeFunctionName(funProto.get());
-			SpvInstruction typeFunDeclInst = GetTypeFunDeclInst(funProto.get());
+			FunProto* funProto = funDecl->GetFunProto();
+			std::string funMangledName = MangleTypeFunctionName(funProto);
+			SpvInstruction typeFunDeclInst = GetTypeFunDeclInst(funProto);
 
-			SpvInstruction funDeclInst = OpFunction(typeFunDeclInst, SpvFunctionControl::NONE);
+			SpvInstruction funDeclInst = OpFunction(spvIdGenerator, typeFunDeclInst, SpvFunctionControl::NONE);
 			instructions.push_back(funDeclInst);
 
 			const Token& funName = funProto->GetFunctionName();
@@ -905,8 +920,8 @@ namespace crayon {
 				entryPointInst = OpEntryPoint(spvEnv.execModel, funDeclInst, entryPointFunName, interfaceVars);
 			}
 
-			std::shared_ptr<BlockStmt> funStmts = funDecl->GetBlockStmt();
-			funStmts->Accept(this);
+			BlockStmt* funStmts = funDecl->GetBlockStmt();
+			Visit(funStmts);
 			// VisitBlockStmt(funStmts.get());
 
 			const FullSpecType& retType = funProto->GetReturnType();
@@ -953,7 +968,7 @@ namespace crayon {
 			// Both type and type pointer creation, if necessary, will be handled with this call.
 			SpvInstruction typePtrInst = GetTypePtrDeclInst(varType.specifier, storageClass);
 
-			SpvInstruction varDeclInst = OpVariable(typePtrInst, storageClass);
+			SpvInstruction varDeclInst = OpVariable(spvIdGenerator, typePtrInst, storageClass);
 			if (storageClass == SpvStorageClass::INPUT ||
 				storageClass == SpvStorageClass::OUTPUT) {
 				interfaceVars.push_back(varDeclInst);
@@ -981,17 +996,17 @@ namespace crayon {
 
 		void GlslToSpvGenerator::VisitBlockStmt(glsl::BlockStmt* blockStmt) {
 			// Every block starts with a label.
-			SpvInstruction labelInst = OpLabel();
+			SpvInstruction labelInst = OpLabel(spvIdGenerator);
 			instructions.push_back(labelInst);
-			for (const std::shared_ptr<Stmt>& stmt : blockStmt->GetStatements()) {
-				stmt.get()->Accept(this);
+			for (Stmt* stmt : blockStmt->GetStatements()) {
+				Visit(stmt);
 			}
 		}
 		void GlslToSpvGenerator::VisitDeclStmt(glsl::DeclStmt* declStmt) {
 			// TODO
 		}
 		void GlslToSpvGenerator::VisitExprStmt(glsl::ExprStmt* exprStmt) {
-			exprStmt->GetExpression()->Accept(this);
+			Visit(exprStmt->GetExpression());
 		}
 
 		void GlslToSpvGenerator::VisitInitListExpr(glsl::InitListExpr* initListExpr) {
@@ -999,7 +1014,7 @@ namespace crayon {
 		}
 		void GlslToSpvGenerator::VisitAssignExpr(glsl::AssignExpr* assignExpr) {
 			Expr* rvalue = assignExpr->GetRvalue();
-			rvalue->Accept(this);
+			Visit(rvalue);
 			SpvInstruction rvalueRes = this->result;
 			// The lvalue should be handled based on what it actually is.
 			Expr* lvalue = assignExpr->GetLvalue();
@@ -1024,6 +1039,47 @@ namespace crayon {
 				}
 			}
 		}
+		void GlslToSpvGenerator::VisitTernaryExpr(glsl::TernaryExpr* ternaryExpr) {
+			// "OpSelect" evaluates both branches, which is fine as long as neither of them has side effects.
+			// Assignments, function calls and increments don't produce a result here yet, and interface block fields
+			// produce a pointer, so such operands are reported instead of silently reusing a stale or wrong result.
+			SpvInstruction operands[3];
+			Expr* operandExprs[3] = {ternaryExpr->GetCondition(), ternaryExpr->GetTrueExpr(), ternaryExpr->GetFalseExpr()};
+			for (size_t i = 0; i < 3; i++) {
+				this->result = SpvInstruction{};
+				Visit(operandExprs[i]);
+				if (!this->result.HasResultId() || this->result.GetOpCode() == SpvOpCode::OpAccessChain) {
+					throw std::runtime_error{"The SPIR-V generator doesn't support this operand of the '?:' operator yet!"};
+				}
+				operands[i] = this->result;
+			}
+			// The expressions in function bodies don't have their types inferred yet,
+			// so the types are taken from the generated instructions.
+			auto findTypeDeclInst = [this](uint32_t typeId) {
+				for (const auto& [typeName, typeDeclInst] : spvEnv.typeDecls) {
+					if (typeDeclInst.GetResultId() == typeId) {
+						return typeDeclInst;
+					}
+				}
+				return SpvInstruction{};
+			};
+			if (findTypeDeclInst(operands[0].GetResultType()).GetOpCode() != SpvOpCode::OpTypeBool) {
+				throw std::runtime_error{"The condition of the '?:' operator must be a boolean scalar!"};
+			}
+			if (operands[1].GetResultType() != operands[2].GetResultType()) {
+				throw std::runtime_error{"The SPIR-V generator doesn't support implicit conversions in the '?:' operator yet!"};
+			}
+			// SPIR-V 1.3 only accepts a scalar condition in "OpSelect" when the objects are scalars too,
+			// vectors would need the condition spread to a boolean vector first.
+			SpvInstruction typeDeclInst = findTypeDeclInst(operands[1].GetResultType());
+			SpvOpCode typeOpCode = typeDeclInst.GetOpCode();
+			if (typeOpCode != SpvOpCode::OpTypeBool && typeOpCode != SpvOpCode::OpTypeInt && typeOpCode != SpvOpCode::OpTypeFloat) {
+				throw std::runtime_error{"The SPIR-V generator doesn't support the '?:' operator on non-scalar operands yet!"};
+			}
+			SpvInstruction opSelectInst = OpSelect(spvIdGenerator, typeDeclInst, operands[0], operands[1], operands[2]);
+			instructions.push_back(opSelectInst);
+			this->result = opSelectInst;
+		}
 		void GlslToSpvGenerator::VisitBinaryExpr(glsl::BinaryExpr* binaryExpr) {
 			// TODO
 		}
@@ -1051,10 +1107,10 @@ namespace crayon {
 			// Again, thanks to the semantic analyzer, at this point we're sure that
 			// all the arguments we're dealing with are non-array transparent types
 			// (scalars, vectors, or matrices).
-			const std::vector<std::shared_ptr<Expr>>& ctorExprArgs = ctorCallExpr->GetArgs();
+			const std::vector<Expr*>& ctorExprArgs = ctorCallExpr->GetArgs();
 			std::vector<SpvInstruction> ctorInstArgs(ctorExprArgs.size());
 			for (size_t i = 0; i < ctorInstArgs.size(); i++) {
-				ctorExprArgs[i]->Accept(this);
+				Visit(ctorExprArgs[i]);
 				// Get the type of the argument expression and check to see
 				// if we need to convert the type of the result. For example, 
 				// vec3 -> dvec3 or dvec2 -> ivec2, etc.
@@ -1067,7 +1123,7 @@ namespace crayon {
 			}
 			// Finally create the appropriate instruction creating the composite object.
 			if (ctorCallConst) {
-				SpvInstruction opConstantComposite = OpConstantComposite(typeDeclInst, ctorInstArgs);
+				SpvInstruction opConstantComposite = OpConstantComposite(spvIdGenerator, typeDeclInst, ctorInstArgs);
 				instructions.push_back(opConstantComposite);
 				this->result = opConstantComposite;
 			} else {
@@ -1092,56 +1148,24 @@ namespace crayon {
 				SpvInstruction varDeclInst = spvEnv.varDecls.find(varName)->second;
 				
 				// 3. Finally, we can now produce the appropriate OpLoad instruction.
-				SpvInstruction opLoadInst = OpLoad(typeDeclInst, varDeclInst);
+				SpvInstruction opLoadInst = OpLoad(spvIdGenerator, typeDeclInst, varDeclInst);
 				instructions.push_back(opLoadInst);
 				this->result = opLoadInst;
 			}
 		}
 		void GlslToSpvGenerator::VisitIntConstExpr(glsl::IntConstExpr* intConstExpr) {
-			// TODO: use ConstId to extract the value of the constant from the constant table.
-			// The constant table should come from the parser. Seeing how we're already going to
-			// reuse the parser's environment, adding a reference/pointer to the constant table
-			// shouldn't be a lot of work.
-			// 1.
-			// int constVal = intConstExpr->GetValue();
-			// this->result = GetConstInst(constVal);
-			// 2.
 			ConstVal intConstVal = config.constTable->GetConstVal(intConstExpr->GetConstId());
 			this->result = GetConstInst(std::get<int>(intConstVal));
 		}
 		void GlslToSpvGenerator::VisitUintConstExpr(glsl::UintConstExpr* uintConstExpr) {
-			// TODO: use ConstId to extract the value of the constant from the constant table.
-			// The constant table should come from the parser. Seeing how we're already going to
-			// reuse the parser's environment, adding a reference/pointer to the constant table
-			// shouldn't be a lot of work.
-			// 1.
-			// unsigned int constVal = uintConstExpr->GetValue();
-			// this->result = GetConstInst(constVal);
-			// 2.
 			ConstVal uintConstVal = config.constTable->GetConstVal(uintConstExpr->GetConstId());
 			this->result = GetConstInst(std::get<unsigned int>(uintConstVal));
 		}
 		void GlslToSpvGenerator::VisitFloatConstExpr(glsl::FloatConstExpr* floatConstExpr) {
-			// TODO: use ConstId to extract the value of the constant from the constant table.
-			// The constant table should come from the parser. Seeing how we're already going to
-			// reuse the parser's environment, adding a reference/pointer to the constant table
-			// shouldn't be a lot of work.
-			// 1.
-			// float constVal = floatConstExpr->GetValue();
-			// this->result = GetConstInst(constVal);
-			// 2.
 			ConstVal floatConstVal = config.constTable->GetConstVal(floatConstExpr->GetConstId());
 			this->result = GetConstInst(std::get<float>(floatConstVal));
 		}
 		void GlslToSpvGenerator::VisitDoubleConstExpr(glsl::DoubleConstExpr* doubleConstExpr) {
-			// TODO: use ConstId to extract the value of the constant from the constant table.
-			// The constant table should come from the parser. Seeing how we're already going to
-			// reuse the parser's environment, adding a reference/pointer to the constant table
-			// shouldn't be a lot of work.
-			// 1.
-			// double constVal = doubleConstExpr->GetValue();
-			// this->result = GetConstInst(constVal);
-			// 2.
 			ConstVal doubleConstVal = config.constTable->GetConstVal(doubleConstExpr->GetConstId());
 			this->result = GetConstInst(std::get<double>(doubleConstVal));
 		}
@@ -1225,8 +1249,8 @@ namespace crayon {
 			// 2. Parameter list.
 			if (!funProto->FunParamListEmpty()) {
 				// TODO: figure out what to do with the parameters.
-				const std::vector<std::shared_ptr<FunParam>>& funParamList = funProto->GetFunParamList();
-				for (const std::shared_ptr<FunParam>& funParam : funParamList) {
+				const std::vector<FunParam*>& funParamList = funProto->GetFunParamList();
+				for (FunParam* funParam : funParamList) {
 					const FullSpecType& paramType = funParam->GetVarType();
 					// TODO
 					if (funParam->HasName()) {
@@ -11,8 +11,6 @@
 namespace crayon {
 	namespace spirv {
 
-		static SeqIdGenerator<uint32_t> spvIdGenerator;
-
 		static const std::unordered_map<SpvOpCode, std::string_view> spvOpCodeToStrMap = {
 			{SpvOpCode::OpNop,               "OpNop"              },
 			// Debug instructions.
@@ -97,6 +95,7 @@ namespace crayon {
 			{SpvOpCode::OpLogicalOr,         "OpLogicalOr"        },
 			{SpvOpCode::OpLogicalAnd,        "OpLogicalAnd"       },
 			{SpvOpCode::OpLogicalNot,        "OpLogicalNot"       },
+			{SpvOpCode::OpSelect,            "OpSelect"           },
 			{SpvOpCode::OpIEqual,            "OpIEqual"           },
 			{SpvOpCode::OpINotEqual,         "OpINotEqual"        },
 			{SpvOpCode::OpUGreaterThan,      "OpUGreaterThan"     },
@@ -237,10 +236,6 @@ namespace crayon {
 			return resultType;
 		}
 
-		uint32_t GetLastGeneratedSpvId() {
-			return spvIdGenerator.GetLastGeneratedUniqueId();
-		}
-
 		std::vector<uint32_t> GenerateLiteralStringWords(std::string_view str) {
 			uint16_t strWordLen = static_cast<uint16_t>(str.size() / sizeof(uint32_t));
 			if (str.size() % sizeof(uint32_t) != 0)
@@ -282,11 +277,11 @@ namespace crayon {
 			opCapability.PushLiteralOperand(static_cast<uint32_t>(capability));
 			return opCapability;
 		}
-		SpvInstruction OpExtInstImport(std::string_view extInstSetName) {
+		SpvInstruction OpExtInstImport(SpvIdGenerator& idGenerator, std::string_view extInstSetName) {
 			uint16_t nameWordLen = static_cast<uint16_t>(extInstSetName.size() / sizeof(uint32_t));
 			if (extInstSetName.size() % sizeof(uint32_t) != 0)
 				nameWordLen++;
-			SpvInstruction opExtInstImport(SpvOpCode::OpExtInstImport, 2 + nameWordLen, spvIdGenerator.GenerateUniqueId());
+			SpvInstruction opExtInstImport(SpvOpCode::OpExtInstImport, 2 + nameWordLen, idGenerator.GenerateUniqueId());
 			std::vector<uint32_t> nameWords(nameWordLen);
 			std::memset(nameWords.data(), 0, nameWordLen * sizeof(uint32_t));
 			std::memcpy(nameWords.data(), extInstSetName.data(), extInstSetName.size() * sizeof(char));
@@ -325,105 +320,97 @@ namespace crayon {
 			return opDecorate;
 		}
 
-		SpvInstruction OpTypeVoid() {
-			SpvInstruction opTypeVoid(SpvOpCode::OpTypeVoid, 2, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeVoid(SpvIdGenerator& idGenerator) {
+			SpvInstruction opTypeVoid(SpvOpCode::OpTypeVoid, 2, idGenerator.GenerateUniqueId());
 			return opTypeVoid;
 		}
-		SpvInstruction OpTypeBool() {
-			SpvInstruction opTypeBool(SpvOpCode::OpTypeBool, 2, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeBool(SpvIdGenerator& idGenerator) {
+			SpvInstruction opTypeBool(SpvOpCode::OpTypeBool, 2, idGenerator.GenerateUniqueId());
 			return opTypeBool;
 		}
-		SpvInstruction OpTypeInt(uint32_t width, SpvSignedness signedness) {
-			SpvInstruction opTypeInt(SpvOpCode::OpTypeInt, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeInt(SpvIdGenerator& idGenerator, uint32_t width, SpvSignedness signedness) {
+			SpvInstruction opTypeInt(SpvOpCode::OpTypeInt, 4, idGenerator.GenerateUniqueId());
 			opTypeInt.PushLiteralOperand(width);
 			opTypeInt.PushLiteralOperand(static_cast<uint32_t>(signedness));
 			return opTypeInt;
 		}
-		SpvInstruction OpTypeFloat(uint32_t width) {
-			SpvInstruction opTypeFloat(SpvOpCode::OpTypeFloat, 3, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeFloat(SpvIdGenerator& idGenerator, uint32_t width) {
+			SpvInstruction opTypeFloat(SpvOpCode::OpTypeFloat, 3, idGenerator.GenerateUniqueId());
 			opTypeFloat.PushLiteralOperand(width);
 			return opTypeFloat;
 		}
 
-		SpvInstruction OpTypeFunction(uint32_t retType) {
-			SpvInstruction opTypeFunction(SpvOpCode::OpFunction, 3, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeFunction(SpvIdGenerator& idGenerator, uint32_t retType) {
+			SpvInstruction opTypeFunction(SpvOpCode::OpFunction, 3, idGenerator.GenerateUniqueId());
 			opTypeFunction.PushIdOperand(retType);
 			return opTypeFunction;
 		}
-		SpvInstruction OpTypeFunction(const SpvInstruction& retTypeDeclInst) {
-			SpvInstruction opTypeFunction(SpvOpCode::OpTypeFunction, 3, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeFunction(SpvIdGenerator& idGenerator, const SpvInstruction& retTypeDeclInst) {
+			SpvInstruction opTypeFunction(SpvOpCode::OpTypeFunction, 3, idGenerator.GenerateUniqueId());
 			opTypeFunction.PushIdOperand(retTypeDeclInst.GetResultId());
 			return opTypeFunction;
 		}
-		SpvInstruction OpTypeFunction(uint32_t retType, const std::vector<uint32_t> params) {
-			// TODO
-			return SpvInstruction();
-		}
-		SpvInstruction OpTypeFunction(const SpvInstruction& typeDeclInst, const std::vector<uint32_t> params) {
-			// TODO
-			return SpvInstruction();
-		}
 		
-		SpvInstruction OpTypeVector(uint32_t type, uint32_t count) {
-			SpvInstruction opTypeVector(SpvOpCode::OpTypeVector, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeVector(SpvIdGenerator& idGenerator, uint32_t type, uint32_t count) {
+			SpvInstruction opTypeVector(SpvOpCode::OpTypeVector, 4, idGenerator.GenerateUniqueId());
 			opTypeVector.PushIdOperand(type);
 			opTypeVector.PushLiteralOperand(count);
 			return opTypeVector;
 		}
-		SpvInstruction OpTypeVector(const SpvInstruction& typeDeclInst, uint32_t count) {
-			SpvInstruction opTypeVector(SpvOpCode::OpTypeVector, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeVector(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, uint32_t count) {
+			SpvInstruction opTypeVector(SpvOpCode::OpTypeVector, 4, idGenerator.GenerateUniqueId());
 			opTypeVector.PushIdOperand(typeDeclInst.GetResultId());
 			opTypeVector.PushLiteralOperand(count);
 			return opTypeVector;
 		}
 		
-		SpvInstruction OpTypeArray(const SpvInstruction& elementType, const SpvInstruction& lengthConstInst) {
-			SpvInstruction opTypeArray(SpvOpCode::OpTypeArray, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypeArray(SpvIdGenerator& idGenerator, const SpvInstruction& elementType, const SpvInstruction& lengthConstInst) {
+			SpvInstruction opTypeArray(SpvOpCode::OpTypeArray, 4, idGenerator.GenerateUniqueId());
 			opTypeArray.PushIdOperand(elementType.GetResultId());
 			opTypeArray.PushIdOperand(lengthConstInst.GetResultId());
 			return opTypeArray;
 		}
-		SpvInstruction OpTypeStruct(const std::vector<SpvInstruction>& members) {
+		SpvInstruction OpTypeStruct(SpvIdGenerator& idGenerator, const std::vector<SpvInstruction>& members) {
 			uint16_t wordCount = static_cast<uint16_t>(2 + members.size());
-			SpvInstruction opTypeStruct(SpvOpCode::OpTypeStruct, wordCount, spvIdGenerator.GenerateUniqueId());
+			SpvInstruction opTypeStruct(SpvOpCode::OpTypeStruct, wordCount, idGenerator.GenerateUniqueId());
 			for (const SpvInstruction& member : members) {
 				opTypeStruct.PushIdOperand(member.GetResultId());
 			}
 			return opTypeStruct;
 		}
 
-		SpvInstruction OpTypePointer(uint32_t type, SpvStorageClass storageClass) {
-			SpvInstruction opTypePointer(SpvOpCode::OpTypePointer, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypePointer(SpvIdGenerator& idGenerator, uint32_t type, SpvStorageClass storageClass) {
+			SpvInstruction opTypePointer(SpvOpCode::OpTypePointer, 4, idGenerator.GenerateUniqueId());
 			opTypePointer.PushLiteralOperand(static_cast<uint32_t>(storageClass));
 			opTypePointer.PushIdOperand(type);
 			return opTypePointer;
 		}
-		SpvInstruction OpTypePointer(const SpvInstruction& typeDeclInst, SpvStorageClass storageClass) {
-			SpvInstruction opTypePointer(SpvOpCode::OpTypePointer, 4, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpTypePointer(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, SpvStorageClass storageClass) {
+			SpvInstruction opTypePointer(SpvOpCode::OpTypePointer, 4, idGenerator.GenerateUniqueId());
 			opTypePointer.PushLiteralOperand(static_cast<uint32_t>(storageClass));
 			opTypePointer.PushIdOperand(typeDeclInst.GetResultId());
 			return opTypePointer;
 		}
 
-		SpvInstruction OpVariable(const SpvInstruction& typePointer, SpvStorageClass storageClass) {
+		SpvInstruction OpVariable(SpvIdGenerator& idGenerator, const SpvInstruction& typePointer, SpvStorageClass storageClass) {
 			SpvInstruction opVariable(SpvOpCode::OpVariable, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      typePointer.GetResultId());
 			opVariable.PushLiteralOperand(static_cast<uint32_t>(storageClass));
 			return opVariable;
 		}
-		SpvInstruction OpVariable(const SpvInstruction& typePointer, SpvStorageClass storageClass,
+		SpvInstruction OpVariable(SpvIdGenerator& idGenerator, const SpvInstruction& typePointer, SpvStorageClass storageClass,
 			                      const SpvInstruction& initializer) {
 			SpvInstruction opVariable(SpvOpCode::OpVariable, 5,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      typePointer.GetResultId());
 			opVariable.PushLiteralOperand(static_cast<uint32_t>(storageClass));
 			opVariable.PushIdOperand(initializer.GetResultId());
 			return opVariable;
 		}
 
-		SpvInstruction OpLoad(const SpvInstruction& type, const SpvInstruction& pointer) {
-			SpvInstruction opLoad(SpvOpCode::OpLoad, 4, spvIdGenerator.GenerateUniqueId(), type.GetResultId());
+		SpvInstruction OpLoad(SpvIdGenerator& idGenerator, const SpvInstruction& type, const SpvInstruction& pointer) {
+			SpvInstruction opLoad(SpvOpCode::OpLoad, 4, idGenerator.GenerateUniqueId(), type.GetResultId());
 			opLoad.PushIdOperand(pointer.GetResultId());
 			return opLoad;
 		}
@@ -434,11 +421,11 @@ namespace crayon {
 			return opStore;
 		}
 
-		SpvInstruction OpAccessChain(const SpvInstruction& resultTypePtr,
+		SpvInstruction OpAccessChain(SpvIdGenerator& idGenerator, const SpvInstruction& resultTypePtr,
 			                         const SpvInstruction& baseType,
 			                         const SpvInstruction& fieldIdxConst) {
 			SpvInstruction opAccessChain(SpvOpCode::OpAccessChain, 5,
-				                         spvIdGenerator.GenerateUniqueId(),
+				                         idGenerator.GenerateUniqueId(),
 				                         resultTypePtr.GetResultId());
 			opAccessChain.PushIdOperand(baseType.GetResultId());
 			opAccessChain.PushIdOperand(fieldIdxConst.GetResultId());
@@ -446,9 +433,9 @@ namespace crayon {
 		}
 
 		/*
-		SpvInstruction OpConstant(uint32_t type, int value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, int value) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      type);
 			// Will the sign be preserved?
 			// How do we even handle signed constants?
@@ -457,44 +444,44 @@ namespace crayon {
 			opConstant.PushLiteralOperand(u32_val);
 			return opConstant;
 		}
-		SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, int value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, int value) {
 			// TODO
 			return SpvInstruction();
 		}
-		SpvInstruction OpConstant(uint32_t type, uint32_t value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, uint32_t value) {
 			return SpvInstruction();
 		}
-		SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, uint32_t value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, uint32_t value) {
 			// TODO
 			return SpvInstruction();
 		}
-		SpvInstruction OpConstant(uint32_t type, float value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, float value) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      type);
 			uint32_t u32_val = *reinterpret_cast<const uint32_t*>(&value);
 			opConstant.PushLiteralOperand(u32_val);
 			return opConstant;
 		}
-		SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, float value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, float value) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      typeDeclInst.GetResultId());
 			uint32_t u32_val = *reinterpret_cast<const uint32_t*>(&value);
 			opConstant.PushLiteralOperand(u32_val);
 			return opConstant;
 		}
-		SpvInstruction OpConstant(uint32_t type, double value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, double value) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      type);
 			uint32_t u32_val = *reinterpret_cast<const uint32_t*>(&value);
 			opConstant.PushLiteralOperand(u32_val);
 			return opConstant;
 		}
-		SpvInstruction OpConstant(const SpvInstruction& typeDeclInst, double value) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst, double value) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      typeDeclInst.GetResultId());
 			uint32_t u32_val = *reinterpret_cast<const uint32_t*>(&value);
 			opConstant.PushLiteralOperand(u32_val);
@@ -502,21 +489,21 @@ namespace crayon {
 		}
 		*/
 		
-		SpvInstruction OpConstant(uint32_t type, void* valPtr) {
+		SpvInstruction OpConstant(SpvIdGenerator& idGenerator, uint32_t type, void* valPtr) {
 			SpvInstruction opConstant(SpvOpCode::OpConstant, 4,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      type);
 			uint32_t u32_val = *reinterpret_cast<const uint32_t*>(valPtr);
 			opConstant.PushLiteralOperand(u32_val);
 			return opConstant;
 		}
 
-		SpvInstruction OpConstantComposite(const SpvInstruction& typeDeclInst,
+		SpvInstruction OpConstantComposite(SpvIdGenerator& idGenerator, const SpvInstruction& typeDeclInst,
 			                               const std::vector<SpvInstruction>& constituents) {
 			uint16_t wordCount = 3 + static_cast<uint16_t>(constituents.size());
 			SpvInstruction opConstantComposite(SpvOpCode::OpConstantComposite,
 				                               wordCount,
-				                               spvIdGenerator.GenerateUniqueId(),
+				                               idGenerator.GenerateUniqueId(),
 				                               typeDeclInst.GetResultId());
 			for (const SpvInstruction& constituent : constituents) {
 				opConstantComposite.PushIdOperand(constituent.GetResultId());
@@ -524,10 +511,19 @@ namespace crayon {
 			return opConstantComposite;
 		}
 
-		SpvInstruction OpFunction(const SpvInstruction& typeFunctionInst, SpvFunctionControl funCtrl) {
+		SpvInstruction OpSelect(SpvIdGenerator& idGenerator, const SpvInstruction& resultType, const SpvInstruction& condition,
+			                    const SpvInstruction& object1, const SpvInstruction& object2) {
+			SpvInstruction opSelect(SpvOpCode::OpSelect, 6, idGenerator.GenerateUniqueId(), resultType.GetResultId());
+			opSelect.PushIdOperand(condition.GetResultId());
+			opSelect.PushIdOperand(object1.GetResultId());
+			opSelect.PushIdOperand(object2.GetResultId());
+			return opSelect;
+		}
+
+		SpvInstruction OpFunction(SpvIdGenerator& idGenerator, const SpvInstruction& typeFunctionInst, SpvFunctionControl funCtrl) {
 			const SpvInstOperand funRetTypeId = typeFunctionInst.GetOperand(0);
 			SpvInstruction opFunction(SpvOpCode::OpFunction, 5,
-				                      spvIdGenerator.GenerateUniqueId(),
+				                      idGenerator.GenerateUniqueId(),
 				                      funRetTypeId.value);
 			opFunction.PushLiteralOperand(static_cast<uint32_t>(funCtrl));
 			opFunction.PushIdOperand(typeFunctionInst.GetResultId());
@@ -538,8 +534,8 @@ namespace crayon {
 			return funEnd;
 		}
 
-		SpvInstruction OpLabel() {
-			SpvInstruction opLabel(SpvOpCode::OpLabel, 2, spvIdGenerator.GenerateUniqueId());
+		SpvInstruction OpLabel(SpvIdGenerator& idGenerator) {
+			SpvInstruction opLabel(SpvOpCode::OpLabel, 2, idGenerator.GenerateUniqueId());
 			return opLabel;
 		}
 		SpvInstruction OpReturn() {
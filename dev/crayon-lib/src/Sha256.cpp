@@ -0,0 +1,123 @@
+#include "Sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace crayon {
+
+	static constexpr std::array<uint32_t, 64> roundConstants = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	static uint32_t RotateRight(uint32_t value, uint32_t count) {
+		return (value >> count) | (value << (32 - count));
+	}
+
+	Sha256::Sha256()
+		: state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {
+	}
+
+	void Sha256::Update(const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		totalSize += size;
+		// 1. Complete the partially filled block first.
+		if (bufferSize > 0) {
+			size_t toCopy = std::min(size, buffer.size() - bufferSize);
+			std::memcpy(buffer.data() + bufferSize, bytes, toCopy);
+			bufferSize += toCopy;
+			bytes += toCopy;
+			size -= toCopy;
+			if (bufferSize < buffer.size()) {
+				return;
+			}
+			ProcessBlock(buffer.data());
+			bufferSize = 0;
+		}
+		// 2. Process whole blocks directly from the input.
+		while (size >= buffer.size()) {
+			ProcessBlock(bytes);
+			bytes += buffer.size();
+			size -= buffer.size();
+		}
+		// 3. Keep the rest for later.
+		std::memcpy(buffer.data(), bytes, size);
+		bufferSize = size;
+	}
+	void Sha256::Update(std::string_view str) {
+		Update(str.data(), str.size());
+	}
+
+	Sha256::Digest Sha256::Finalize() {
+		uint64_t totalBits = totalSize * 8;
+		// Padding: a single '1' bit, zeros, and the message length in bits (big-endian).
+		uint8_t padding[72]{0x80};
+		size_t paddingSize = (bufferSize < 56 ? 56 : 120) - bufferSize;
+		for (int i = 0; i < 8; i++) {
+			padding[paddingSize + i] = static_cast<uint8_t>(totalBits >> (56 - 8 * i));
+		}
+		Update(padding, paddingSize + 8);
+
+		Digest digest{};
+		for (size_t i = 0; i < state.size(); i++) {
+			digest[4 * i + 0] = static_cast<uint8_t>(state[i] >> 24);
+			digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+			digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+			digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+		}
+		return digest;
+	}
+
+	void Sha256::ProcessBlock(const uint8_t* block) {
+		uint32_t w[64];
+		for (int i = 0; i < 16; i++) {
+			w[i] = (static_cast<uint32_t>(block[4 * i + 0]) << 24) |
+			       (static_cast<uint32_t>(block[4 * i + 1]) << 16) |
+			       (static_cast<uint32_t>(block[4 * i + 2]) << 8) |
+			       (static_cast<uint32_t>(block[4 * i + 3]));
+		}
+		for (int i = 16; i < 64; i++) {
+			uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+		for (int i = 0; i < 64; i++) {
+			uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+			uint32_t ch = (e & f) ^ (~e & g);
+			uint32_t temp1 = h + s1 + ch + roundConstants[i] + w[i];
+			uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+			uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+			uint32_t temp2 = s0 + maj;
+			h = g;
+			g = f;
+			f = e;
+			e = d + temp1;
+			d = c;
+			c = b;
+			b = a;
+			a = temp1 + temp2;
+		}
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+
+	std::string DigestToHexString(const Sha256::Digest& digest) {
+		static constexpr char hexDigits[] = "0123456789abcdef";
+		std::string hex(digest.size() * 2, '0');
+		for (size_t i = 0; i < digest.size(); i++) {
+			hex[2 * i + 0] = hexDigits[digest[i] >> 4];
+			hex[2 * i + 1] = hexDigits[digest[i] & 0x0f];
+		}
+		return hex;
+	}
+
+}
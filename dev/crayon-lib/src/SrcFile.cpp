@@ -0,0 +1,126 @@
+#include "SrcFile.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crayon {
+
+	SrcFile::~SrcFile() {
+		Close();
+	}
+
+	void SrcFile::Open(const std::filesystem::path& path) {
+		Close();
+		// Any failure to map the file falls back to reading it, which reports the errors.
+		if (!Map(path)) {
+			Read(path);
+		}
+	}
+	void SrcFile::Close() {
+		if (mappedData) {
+#ifdef _WIN32
+			UnmapViewOfFile(mappedData);
+#else
+			munmap(mappedData, size);
+#endif
+			mappedData = nullptr;
+		}
+		readData.clear();
+		readData.shrink_to_fit();
+		data = nullptr;
+		size = 0;
+	}
+
+	const char* SrcFile::GetData() const {
+		return data;
+	}
+	size_t SrcFile::GetSize() const {
+		return size;
+	}
+	bool SrcFile::IsMapped() const {
+		return mappedData != nullptr;
+	}
+
+	bool SrcFile::Map(const std::filesystem::path& path) {
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER fileSize{};
+		// Empty files can't be mapped.
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping) {
+				// The view keeps the mapping alive on its own.
+				mappedData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0) {
+			return false;
+		}
+		struct stat fileStat{};
+		// Empty files can't be mapped, neither can pipes and other special files.
+		if (fstat(file, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+			void* mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapping != MAP_FAILED) {
+				// The lexer reads the file front to back exactly once.
+				madvise(mapping, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+				mappedData = mapping;
+			}
+		}
+		// The mapping stays valid after the file is closed.
+		close(file);
+#endif
+		if (!mappedData) {
+			return false;
+		}
+#ifdef _WIN32
+		size = static_cast<size_t>(fileSize.QuadPart);
+#else
+		size = static_cast<size_t>(fileStat.st_size);
+#endif
+		data = static_cast<const char*>(mappedData);
+		return true;
+	}
+	void SrcFile::Read(const std::filesystem::path& path) {
+		std::ifstream file{path, std::ifstream::in | std::ifstream::binary};
+		if (!file.is_open()) {
+			std::string errMsg{"Couldn't open the .csl source code file: " + path.string()};
+			throw std::runtime_error{errMsg};
+		}
+		// The size isn't known in advance for special files, so the file is read in chunks.
+		constexpr size_t chunkSize{64 * 1024};
+		while (file) {
+			size_t readSize = readData.size();
+			readData.resize(readSize + chunkSize);
+			file.read(readData.data() + readSize, chunkSize);
+			readData.resize(readSize + static_cast<size_t>(file.gcount()));
+		}
+		if (file.bad()) {
+			std::string errMsg{"Couldn't read the .csl source code file: " + path.string()};
+			throw std::runtime_error{errMsg};
+		}
+		data = readData.data();
+		size = readData.size();
+	}
+
+}
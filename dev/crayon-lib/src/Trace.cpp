@@ -0,0 +1,89 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <ios>
+#include <ostream>
+
+namespace crayon {
+
+	// Small sequential ids read better in a trace viewer than the native thread ids.
+	static uint32_t GetTraceThreadId() {
+		static std::atomic<uint32_t> nextThreadId{0};
+		static thread_local uint32_t threadId = nextThreadId++;
+		return threadId;
+	}
+
+	TraceRecorder::TraceRecorder()
+		: origin(std::chrono::steady_clock::now()) {
+	}
+
+	void TraceRecorder::AddSpan(std::string_view name, std::string_view category,
+	                            std::chrono::steady_clock::time_point start,
+	                            std::chrono::steady_clock::time_point end) {
+		TraceEvent event{};
+		event.name = name;
+		event.category = category;
+		event.timestampUs = std::chrono::duration<double, std::micro>(start - origin).count();
+		event.durationUs = std::chrono::duration<double, std::micro>(end - start).count();
+		event.threadId = GetTraceThreadId();
+		std::lock_guard<std::mutex> eventsLock{eventsMutex};
+		events.push_back(std::move(event));
+	}
+	void TraceRecorder::SetThreadName(std::string_view name) {
+		ThreadName threadName{};
+		threadName.name = name;
+		threadName.threadId = GetTraceThreadId();
+		std::lock_guard<std::mutex> eventsLock{eventsMutex};
+		threadNames.push_back(std::move(threadName));
+	}
+
+	void TraceRecorder::Write(std::ostream& out) const {
+		std::lock_guard<std::mutex> eventsLock{eventsMutex};
+		std::ios_base::fmtflags outFlags = out.flags();
+		std::streamsize outPrecision = out.precision(3);
+		out << std::fixed;
+		out << "{\"traceEvents\":[";
+		bool first{true};
+		// 1. Metadata events naming the threads.
+		for (const ThreadName& threadName : threadNames) {
+			out << (first ? "\n" : ",\n")
+			    << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << threadName.threadId
+			    << ",\"args\":{\"name\":";
+			WriteJsonString(out, threadName.name);
+			out << "}}";
+			first = false;
+		}
+		// 2. Complete events ("X"), each one carries both its start and its duration.
+		for (const TraceEvent& event : events) {
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"name\":";
+			WriteJsonString(out, event.name);
+			out << ",\"cat\":";
+			WriteJsonString(out, event.category);
+			out << ",\"ts\":" << event.timestampUs << ",\"dur\":" << event.durationUs
+			    << ",\"pid\":1,\"tid\":" << event.threadId << "}";
+			first = false;
+		}
+		out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+		out.flags(outFlags);
+		out.precision(outPrecision);
+	}
+
+	TraceScope::TraceScope(TraceRecorder* recorder, std::string_view name, std::string_view category)
+		: recorder(recorder), category(category) {
+		if (recorder) {
+			this->name = name;
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	TraceScope::~TraceScope() {
+		End();
+	}
+
+	void TraceScope::End() {
+		if (recorder) {
+			recorder->AddSpan(name, category, start, std::chrono::steady_clock::now());
+			recorder = nullptr;
+		}
+	}
+
+}
@@ -1,5 +1,7 @@
 #include "Utility.h"
 
+#include <ostream>
+
 static constexpr std::string_view cslExt{ ".csl" };
 
 namespace crayon {
@@ -17,4 +19,27 @@ namespace crayon {
 		return count;
 	}
 
+	void WriteJsonString(std::ostream& out, std::string_view str) {
+		out << '"';
+		for (char c : str) {
+			switch (c) {
+				case '"':
+					out << "\\\"";
+					break;
+				case '\\':
+					out << "\\\\";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						constexpr char hexDigits[]{"0123456789abcdef"};
+						out << "\\u00" << hexDigits[(c >> 4) & 0xF] << hexDigits[c & 0xF];
+					} else {
+						out << c;
+					}
+					break;
+			}
+		}
+		out << '"';
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GLSL/Compiler.h"
+#include "GLSL/CompileStats.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace crayon {
+
+	struct BatchCompilerConfig {
+		// Number of worker threads. 0 means "use all available hardware threads".
+		uint32_t jobs{0};
+		glsl::CompilerConfig compilerConfig{};
+	};
+
+	struct BatchCompileResult {
+		std::filesystem::path srcCodePath;
+		std::string errMsg;
+		glsl::CompileStats stats;
+		bool success{false};
+	};
+
+	class BatchCompiler {
+	public:
+		// Compiles every file on a bounded pool of worker threads.
+		// The files are handed out to the workers one at a time.
+		// The results are returned in the same order as the source files.
+		std::vector<BatchCompileResult> Compile(const std::vector<std::filesystem::path>& srcCodePaths,
+		                                        const BatchCompilerConfig& batchConfig);
+
+		static void PrintReport(std::ostream& out, const std::vector<BatchCompileResult>& results);
+		// A JSON object with the statistics of every file and their sum.
+		static void PrintStatsJson(std::ostream& out, const std::vector<BatchCompileResult>& results);
+		static bool AllSucceeded(const std::vector<BatchCompileResult>& results);
+
+	private:
+		static BatchCompileResult CompileFile(const glsl::Compiler& compiler,
+		                                            const std::filesystem::path& srcCodePath,
+		                                            const glsl::CompilerConfig& compilerConfig);
+	};
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "GLSL/Compiler.h"
+#include "GLSL/CompileProtocol.h"
+
+#include "GLSL/Analyzer/Preprocessor.h"
+
+#include "Utility.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace crayon {
+
+	struct CompileServerConfig {
+		std::filesystem::path socketPath;
+		// Upper bound of the memory used by the compiled programs kept between requests.
+		size_t memCacheCapacity{256u * 1024u * 1024u};
+		// Number of connections served at a time, the others wait for a free worker.
+		// 0 means "use all available hardware threads".
+		uint32_t workerCount{0};
+		// Seconds a client has to send its next request before the connection is closed,
+		// so that idle clients don't hold the workers. 0 means "never".
+		uint32_t idleTimeout{30};
+		// Searched for the '#include' directives of every request (see 'glsl::CompilerConfig').
+		std::vector<std::filesystem::path> includeDirs;
+		// Optional, shared by every request. Included files are scanned again once they're modified.
+		glsl::PpFileCache* ppFileCache{nullptr};
+		// Optional, precedes the source code of every request.
+		const glsl::PrecompiledHeader* pch{nullptr};
+		// Print a line per request.
+		bool verbose{false};
+	};
+
+	// Long-lived compile daemon listening on a Unix domain socket (see "GLSL/CompileProtocol.h").
+	// The compiler is created once, and the compiled programs
+	// are kept in memory, so a repeated request is answered without compiling anything.
+	// The connections are served by a fixed pool of worker threads and may send any number of requests.
+	// Anyone allowed to connect to the socket may compile, so the socket file's permissions decide who uses the server.
+	// Shutdown requests are only accepted from clients running as the same user as the server.
+	class CompileServer {
+	public:
+		CompileServer(const CompileServerConfig& serverConfig);
+		~CompileServer();
+		CLASS_NO_COPY(CompileServer);
+		CLASS_NO_MOVE(CompileServer);
+
+		// Blocks until a client sends a shutdown request.
+		// Throws 'std::runtime_error' if the socket can't be set up or another server is listening on it.
+		void Run();
+
+	private:
+		void Work();
+		void ServeConnection(int clientFd, glsl::Preprocessor& preprocessor);
+		void ProcessRequest(const glsl::CompileRequest& request, glsl::Preprocessor& preprocessor,
+		                    glsl::CompileResponse& response);
+
+		void Shutdown();
+
+		std::shared_ptr<const std::vector<uint8_t>> FindCachedProgram(const std::string& key);
+		void CacheProgram(const std::string& key, std::shared_ptr<const std::vector<uint8_t>> shaderProgramData);
+
+		CompileServerConfig serverConfig;
+		glsl::Compiler compiler;
+		// Used if the configuration doesn't provide a cache of the scanned include files.
+		std::unique_ptr<glsl::PpFileCache> ownPpFileCache;
+
+		std::mutex memCacheMutex;
+		std::unordered_map<std::string, std::shared_ptr<const std::vector<uint8_t>>> memCache;
+		size_t memCacheSize{0};
+
+		std::mutex connectionsMutex;
+		// Signaled when a connection is queued, taken by a worker or when shutting down.
+		std::condition_variable connectionsChanged;
+		// Accepted, waiting for a worker. Bounded by the number of workers, the kernel queues the rest.
+		std::deque<int> pendingFds;
+		// Being served by a worker.
+		std::unordered_set<int> clientFds;
+		std::vector<std::thread> workers;
+		// Written to by 'Shutdown' to wake up the accepting thread.
+		int wakeupFds[2]{-1, -1};
+		int listenFd{-1};
+		bool shuttingDown{false};
+	};
+
+}
@@ -8,13 +8,16 @@ project ( "crayon" )
 
     includedirs {
         "%{include_dirs.crayon_lib}",
+        "%{include_dirs.crayon_alloc_tracking}",
         "%{include_dirs.crayon}",
     }
     libdirs {
         build_path .. "/bin/" .. target_dir
     }
 
+    -- The allocation tracking replaces the global 'operator new', it must come before the library it reports to.
     links {
+        "crayon-alloc-tracking",
         "crayon-lib",
     }
 
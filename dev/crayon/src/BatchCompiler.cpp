@@ -0,0 +1,112 @@
+#include "BatchCompiler.h"
+
+#include "Trace.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace crayon {
+
+	std::vector<BatchCompileResult> BatchCompiler::Compile(const std::vector<std::filesystem::path>& srcCodePaths,
+	                                                       const BatchCompilerConfig& batchConfig) {
+		std::vector<BatchCompileResult> results(srcCodePaths.size());
+		if (srcCodePaths.empty()) {
+			return results;
+		}
+
+		size_t workerCount = batchConfig.jobs;
+		if (workerCount == 0) {
+			// 'hardware_concurrency' is allowed to return 0 if the value is not computable.
+			workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		workerCount = std::min(workerCount, srcCodePaths.size());
+
+		// Every compilation runs in its own session, so the workers can share the compiler.
+		glsl::Compiler compiler{};
+		std::atomic<size_t> nextSrcIdx{0};
+		auto worker = [&](size_t workerIdx) {
+			if (TraceRecorder* trace = batchConfig.compilerConfig.trace) {
+				trace->SetThreadName("worker " + std::to_string(workerIdx));
+			}
+			for (size_t srcIdx = nextSrcIdx++; srcIdx < srcCodePaths.size(); srcIdx = nextSrcIdx++) {
+				results[srcIdx] = CompileFile(compiler, srcCodePaths[srcIdx], batchConfig.compilerConfig);
+			}
+		};
+
+		// The calling thread is one of the workers.
+		std::vector<std::thread> workers;
+		workers.reserve(workerCount - 1);
+		for (size_t i = 1; i < workerCount; i++) {
+			workers.emplace_back(worker, i);
+		}
+		worker(0);
+		for (std::thread& thread : workers) {
+			thread.join();
+		}
+		return results;
+	}
+
+	void BatchCompiler::PrintReport(std::ostream& out, const std::vector<BatchCompileResult>& results) {
+		size_t failed{0};
+		for (const BatchCompileResult& result : results) {
+			if (result.success) {
+				out << "[  OK  ] " << result.srcCodePath.string() << "\n";
+			} else {
+				out << "[FAILED] " << result.srcCodePath.string() << ": " << result.errMsg << "\n";
+				failed++;
+			}
+		}
+		out << results.size() << " file(s) compiled: "
+		    << results.size() - failed << " succeeded, " << failed << " failed." << std::endl;
+	}
+
+	void BatchCompiler::PrintStatsJson(std::ostream& out, const std::vector<BatchCompileResult>& results) {
+		glsl::CompileStats total{};
+		out << "{\"files\":[";
+		for (size_t i = 0; i < results.size(); i++) {
+			const BatchCompileResult& result = results[i];
+			out << (i == 0 ? "" : ",") << "\n{\"path\":";
+			WriteJsonString(out, result.srcCodePath.generic_string());
+			out << ",\"success\":" << (result.success ? "true" : "false") << ",\"stats\":";
+			glsl::WriteCompileStatsJson(out, result.stats);
+			out << "}";
+			total += result.stats;
+		}
+		out << "\n],\"total\":";
+		glsl::WriteCompileStatsJson(out, total);
+		out << "}" << std::endl;
+	}
+	bool BatchCompiler::AllSucceeded(const std::vector<BatchCompileResult>& results) {
+		return std::all_of(results.begin(), results.end(),
+			[](const BatchCompileResult& result) { return result.success; });
+	}
+
+	BatchCompileResult BatchCompiler::CompileFile(const glsl::Compiler& compiler,
+	                                                    const std::filesystem::path& srcCodePath,
+	                                                    const glsl::CompilerConfig& compilerConfig) {
+		BatchCompileResult result{};
+		result.srcCodePath = srcCodePath;
+		TraceScope fileSpan{compilerConfig.trace, srcCodePath.generic_string(), "file"};
+		glsl::CompilerConfig fileCompilerConfig = compilerConfig;
+		fileCompilerConfig.stats = &result.stats;
+		try {
+			result.success = compiler.Compile(srcCodePath, fileCompilerConfig);
+			if (!result.success) {
+				result.errMsg = "compilation errors (see the diagnostics above)";
+			}
+		}
+		catch (std::logic_error& le) {
+			result.errMsg = std::string{"logic error: "} + le.what();
+		}
+		catch (std::runtime_error& re) {
+			result.errMsg = std::string{"runtime error: "} + re.what();
+		}
+		return result;
+	}
+
+}
@@ -0,0 +1,432 @@
+#include "CompileServer.h"
+
+#include "GLSL/CompileCache.h"
+#include "GLSL/PpFileCache.h"
+#include "GLSL/PrecompiledHeader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace crayon {
+
+#ifndef _WIN32
+	using Deadline = std::chrono::steady_clock::time_point;
+
+	// Returns 'false' if nothing arrived before the deadline.
+	static bool WaitReadable(int fd, Deadline deadline) {
+		if (deadline == Deadline::max()) {
+			return true;
+		}
+		while (true) {
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+			if (remaining.count() <= 0) {
+				return false;
+			}
+			pollfd pollFd{};
+			pollFd.fd = fd;
+			pollFd.events = POLLIN;
+			int res = ::poll(&pollFd, 1, static_cast<int>(std::min<long long>(remaining.count(), INT_MAX)));
+			if (res < 0 && errno == EINTR) {
+				continue;
+			}
+			return res > 0;
+		}
+	}
+	static bool ReadAll(int fd, void* data, size_t size, Deadline deadline) {
+		uint8_t* bytes = static_cast<uint8_t*>(data);
+		while (size > 0) {
+			if (!WaitReadable(fd, deadline)) {
+				return false;
+			}
+			ssize_t count = ::read(fd, bytes, size);
+			if (count < 0 && errno == EINTR) {
+				continue;
+			}
+			if (count <= 0) {
+				return false;
+			}
+			bytes += count;
+			size -= static_cast<size_t>(count);
+		}
+		return true;
+	}
+	static bool WriteAll(int fd, const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		while (size > 0) {
+			ssize_t count = ::write(fd, bytes, size);
+			if (count < 0 && errno == EINTR) {
+				continue;
+			}
+			if (count <= 0) {
+				return false;
+			}
+			bytes += count;
+			size -= static_cast<size_t>(count);
+		}
+		return true;
+	}
+
+	// Returns 'false' if the connection was closed, the frame is too large or didn't arrive before the deadline.
+	static bool ReadFrame(int fd, std::vector<uint8_t>& payload, Deadline deadline) {
+		uint32_t payloadSize{0};
+		if (!ReadAll(fd, &payloadSize, sizeof(payloadSize), deadline) || payloadSize > glsl::maxCompileFrameSize) {
+			return false;
+		}
+		payload.resize(payloadSize);
+		return ReadAll(fd, payload.data(), payload.size(), deadline);
+	}
+	static bool WriteFrame(int fd, const std::vector<uint8_t>& payload) {
+		uint32_t payloadSize = static_cast<uint32_t>(payload.size());
+		return WriteAll(fd, &payloadSize, sizeof(payloadSize)) && WriteAll(fd, payload.data(), payload.size());
+	}
+
+	// Whether the client runs as the same user as the server.
+	static bool IsPeerServerUser(int fd) {
+#ifdef __linux__
+		ucred peerCred{};
+		socklen_t peerCredSize = sizeof(peerCred);
+		if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peerCred, &peerCredSize) != 0) {
+			return false;
+		}
+		return peerCred.uid == ::geteuid();
+#else
+		uid_t peerUid{0};
+		gid_t peerGid{0};
+		if (::getpeereid(fd, &peerUid, &peerGid) != 0) {
+			return false;
+		}
+		return peerUid == ::geteuid();
+#endif
+	}
+#endif
+
+	CompileServer::CompileServer(const CompileServerConfig& serverConfig)
+		: serverConfig(serverConfig) {
+		if (!serverConfig.ppFileCache) {
+			ownPpFileCache = std::make_unique<glsl::PpFileCache>();
+			this->serverConfig.ppFileCache = ownPpFileCache.get();
+		}
+	}
+	CompileServer::~CompileServer() {
+#ifndef _WIN32
+		if (listenFd >= 0) {
+			::close(listenFd);
+		}
+		for (int wakeupFd : wakeupFds) {
+			if (wakeupFd >= 0) {
+				::close(wakeupFd);
+			}
+		}
+#endif
+	}
+
+#ifdef _WIN32
+	void CompileServer::Run() {
+		throw std::runtime_error{"The compile server is not supported on this platform yet!"};
+	}
+	void CompileServer::Work() {
+	}
+	void CompileServer::ServeConnection(int clientFd, glsl::Preprocessor& preprocessor) {
+	}
+	void CompileServer::Shutdown() {
+	}
+#else
+	void CompileServer::Run() {
+		// A client disconnecting in the middle of a response must not kill the server.
+		std::signal(SIGPIPE, SIG_IGN);
+
+		// 1. Create the socket.
+		std::string socketPath = serverConfig.socketPath.string();
+		sockaddr_un socketAddr{};
+		if (socketPath.empty() || socketPath.size() >= sizeof(socketAddr.sun_path)) {
+			throw std::runtime_error{"Invalid socket path: '" + socketPath + "'"};
+		}
+		socketAddr.sun_family = AF_UNIX;
+		std::memcpy(socketAddr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+		if (::pipe(wakeupFds) != 0) {
+			throw std::runtime_error{"Couldn't create the wake-up pipe: " + std::string{std::strerror(errno)}};
+		}
+		listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listenFd < 0) {
+			throw std::runtime_error{"Couldn't create the socket: " + std::string{std::strerror(errno)}};
+		}
+		// 2. A socket file left behind by a server that didn't exit cleanly would make 'bind' fail.
+		// It's stale if nothing accepts connections on it, a running server's socket is left alone.
+		std::error_code errCode;
+		if (std::filesystem::is_socket(serverConfig.socketPath, errCode)) {
+			int probeFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+			bool refused{false};
+			if (probeFd >= 0) {
+				if (::connect(probeFd, reinterpret_cast<const sockaddr*>(&socketAddr), sizeof(socketAddr)) == 0) {
+					::close(probeFd);
+					throw std::runtime_error{"Another server is already listening on '" + socketPath + "'"};
+				}
+				refused = errno == ECONNREFUSED;
+				::close(probeFd);
+			}
+			if (refused) {
+				std::filesystem::remove(serverConfig.socketPath, errCode);
+			}
+		}
+		if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&socketAddr), sizeof(socketAddr)) != 0) {
+			throw std::runtime_error{"Couldn't bind the socket to '" + socketPath + "': " + std::strerror(errno)};
+		}
+		if (::listen(listenFd, SOMAXCONN) != 0) {
+			throw std::runtime_error{"Couldn't listen on '" + socketPath + "': " + std::strerror(errno)};
+		}
+		std::cout << "Listening on " << socketPath << std::endl;
+
+		// 3. Start the workers.
+		size_t workerCount = serverConfig.workerCount;
+		if (workerCount == 0) {
+			// 'hardware_concurrency' is allowed to return 0 if the value is not computable.
+			workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; i++) {
+			workers.emplace_back(&CompileServer::Work, this);
+		}
+
+		// 4. Accept connections until a shutdown request arrives.
+		// Connections are only accepted while a worker can take them soon, the others wait in the listen queue.
+		while (true) {
+			{
+				std::unique_lock<std::mutex> connectionsLock{connectionsMutex};
+				connectionsChanged.wait(connectionsLock, [this]() { return shuttingDown || pendingFds.size() < workers.size(); });
+				if (shuttingDown) {
+					break;
+				}
+			}
+			pollfd pollFds[2]{};
+			pollFds[0].fd = listenFd;
+			pollFds[0].events = POLLIN;
+			pollFds[1].fd = wakeupFds[0];
+			pollFds[1].events = POLLIN;
+			if (::poll(pollFds, 2, -1) < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			if (pollFds[1].revents != 0) {
+				break;
+			}
+			int clientFd = ::accept(listenFd, nullptr, nullptr);
+			if (clientFd < 0) {
+				continue;
+			}
+			std::lock_guard<std::mutex> connectionsLock{connectionsMutex};
+			if (shuttingDown) {
+				::close(clientFd);
+				break;
+			}
+			pendingFds.push_back(clientFd);
+			connectionsChanged.notify_all();
+		}
+
+		// 5. Wait for the workers to finish the connections they're serving.
+		{
+			std::lock_guard<std::mutex> connectionsLock{connectionsMutex};
+			// Also stops the workers if polling failed.
+			shuttingDown = true;
+			connectionsChanged.notify_all();
+		}
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		workers.clear();
+		// The connections no worker got to are closed without being served.
+		for (int clientFd : pendingFds) {
+			::close(clientFd);
+		}
+		pendingFds.clear();
+
+		::close(listenFd);
+		listenFd = -1;
+		std::filesystem::remove(serverConfig.socketPath, errCode);
+	}
+
+	void CompileServer::Work() {
+		// Reused by every request of the worker.
+		glsl::Preprocessor preprocessor{};
+		while (true) {
+			int clientFd{-1};
+			{
+				std::unique_lock<std::mutex> connectionsLock{connectionsMutex};
+				connectionsChanged.wait(connectionsLock, [this]() { return shuttingDown || !pendingFds.empty(); });
+				if (shuttingDown) {
+					return;
+				}
+				clientFd = pendingFds.front();
+				pendingFds.pop_front();
+				clientFds.insert(clientFd);
+				// There's room for another connection now.
+				connectionsChanged.notify_all();
+			}
+			ServeConnection(clientFd, preprocessor);
+		}
+	}
+
+	void CompileServer::ServeConnection(int clientFd, glsl::Preprocessor& preprocessor) {
+		// A client that stops reading the responses doesn't hold the worker either.
+		if (serverConfig.idleTimeout != 0) {
+			timeval sendTimeout{};
+			sendTimeout.tv_sec = static_cast<time_t>(serverConfig.idleTimeout);
+			::setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+		}
+		auto requestDeadline = [this]() {
+			if (serverConfig.idleTimeout == 0) {
+				return Deadline::max();
+			}
+			return std::chrono::steady_clock::now() + std::chrono::seconds{serverConfig.idleTimeout};
+		};
+		std::vector<uint8_t> requestData;
+		std::vector<uint8_t> responseData;
+		while (ReadFrame(clientFd, requestData, requestDeadline())) {
+			glsl::CompileRequest request{};
+			glsl::CompileResponse response{};
+			if (!glsl::DeserializeCompileRequest(requestData.data(), requestData.size(), request)) {
+				response.status = glsl::CompileResponseStatus::BAD_REQUEST;
+				response.errMsg = "Malformed request or unsupported protocol version!";
+			} else if (request.type == glsl::CompileRequestType::SHUTDOWN) {
+				if (IsPeerServerUser(clientFd)) {
+					Shutdown();
+				} else {
+					response.status = glsl::CompileResponseStatus::BAD_REQUEST;
+					response.errMsg = "Only the user running the server may shut it down!";
+				}
+			} else {
+				ProcessRequest(request, preprocessor, response);
+			}
+			responseData.clear();
+			glsl::SerializeCompileResponse(response, responseData);
+			if (!WriteFrame(clientFd, responseData)) {
+				break;
+			}
+		}
+		// Under the lock, so that 'Shutdown' never sees a closed descriptor.
+		std::lock_guard<std::mutex> connectionsLock{connectionsMutex};
+		clientFds.erase(clientFd);
+		::close(clientFd);
+	}
+
+	void CompileServer::Shutdown() {
+		std::lock_guard<std::mutex> connectionsLock{connectionsMutex};
+		if (shuttingDown) {
+			return;
+		}
+		shuttingDown = true;
+		// Idle connections stop waiting for requests. The requests already being processed are still answered.
+		for (int clientFd : clientFds) {
+			::shutdown(clientFd, SHUT_RD);
+		}
+		connectionsChanged.notify_all();
+		uint8_t wakeup{1};
+		WriteAll(wakeupFds[1], &wakeup, sizeof(wakeup));
+	}
+#endif
+
+	void CompileServer::ProcessRequest(const glsl::CompileRequest& request, glsl::Preprocessor& preprocessor,
+	                                   glsl::CompileResponse& response) {
+		glsl::CompilerConfig compilerConfig{};
+		compilerConfig.options = request.options;
+		compilerConfig.includeDirs = serverConfig.includeDirs;
+		compilerConfig.ppFileCache = serverConfig.ppFileCache;
+		compilerConfig.pch = serverConfig.pch;
+
+		// Like the compile cache, the key covers the included files, so a modified one isn't answered from memory.
+		// The same preprocessing is repeated by the compilation, the included files are scanned only once though.
+		const glsl::PrecompiledHeader* pch = serverConfig.pch;
+		std::string_view keySrcCode = request.srcCode;
+		bool cacheable{true};
+		if (glsl::Preprocessor::HasDirectives(request.srcCode.data(), request.srcCode.size()) ||
+			(pch && !pch->GetMacros().empty())) {
+			glsl::PreprocessorConfig ppConfig{};
+			ppConfig.includeDirs = &serverConfig.includeDirs;
+			ppConfig.ppFileCache = serverConfig.ppFileCache;
+			if (pch) {
+				ppConfig.predefinedMacros = &pch->GetMacros();
+				ppConfig.precompiledFiles = &pch->GetFiles();
+			}
+			try {
+				preprocessor.Process(request.srcCode.data(), request.srcCode.size(), ppConfig);
+				keySrcCode = preprocessor.GetOutput();
+			} catch (std::runtime_error&) {
+				// The compilation reports the error.
+				cacheable = false;
+			}
+		}
+		std::string key;
+		std::shared_ptr<const std::vector<uint8_t>> shaderProgramData;
+		if (cacheable) {
+			key = glsl::CompileCache::ComputeKey(keySrcCode.data(), keySrcCode.size(), request.options,
+			                                     pch ? pch->GetSrcCode() : std::string_view{});
+			shaderProgramData = FindCachedProgram(key);
+		}
+		bool cacheHit = shaderProgramData != nullptr;
+		if (!cacheHit) {
+			glsl::CompileResult result = compiler.CompileFromMemory(request.srcCode, compilerConfig);
+			if (result.success) {
+				std::vector<uint8_t> data;
+				SerializeShaderProgram(result.shaderProgram, data);
+				shaderProgramData = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+				if (cacheable) {
+					CacheProgram(key, shaderProgramData);
+				}
+			} else {
+				response.status = glsl::CompileResponseStatus::COMPILE_FAILED;
+				response.errMsg = std::move(result.errMsg);
+			}
+		}
+		if (shaderProgramData) {
+			response.status = glsl::CompileResponseStatus::OK;
+			response.shaderProgramData = *shaderProgramData;
+		}
+		if (serverConfig.verbose) {
+			std::ostringstream line;
+			line << (response.status == glsl::CompileResponseStatus::OK ? "[  OK  ] " : "[FAILED] ")
+			     << request.srcCode.size() << " byte(s)" << (cacheHit ? " (cached)" : "") << "\n";
+			std::cout << line.str() << std::flush;
+		}
+	}
+
+	std::shared_ptr<const std::vector<uint8_t>> CompileServer::FindCachedProgram(const std::string& key) {
+		std::lock_guard<std::mutex> memCacheLock{memCacheMutex};
+		auto searchRes = memCache.find(key);
+		if (searchRes == memCache.end()) {
+			return nullptr;
+		}
+		return searchRes->second;
+	}
+	void CompileServer::CacheProgram(const std::string& key, std::shared_ptr<const std::vector<uint8_t>> shaderProgramData) {
+		std::lock_guard<std::mutex> memCacheLock{memCacheMutex};
+		size_t dataSize = shaderProgramData->size();
+		if (dataSize > serverConfig.memCacheCapacity || memCache.count(key) != 0) {
+			return;
+		}
+		// Evict arbitrary entries until the new one fits.
+		while (memCacheSize + dataSize > serverConfig.memCacheCapacity) {
+			memCacheSize -= memCache.begin()->second->size();
+			memCache.erase(memCache.begin());
+		}
+		memCache.emplace(key, std::move(shaderProgramData));
+		memCacheSize += dataSize;
+	}
+
+}
@@ -1,8 +1,20 @@
+#include "BatchCompiler.h"
+#include "CompileServer.h"
+
 #include "CSL/Compiler.h"
 #include "GLSL/Compiler.h"
+#include "GLSL/CompileCache.h"
+#include "GLSL/PpFileCache.h"
+#include "GLSL/PrecompiledHeader.h"
+
+#include "CmdLine/CmdLine.h"
+
+#include "Trace.h"
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 
 using namespace crayon;
@@ -11,32 +23,142 @@ void PrintCmdLineArgs(int argc, char* argv[]);
 
 int main(int argc, char* argv[])  {
 	// PrintCmdLineArgs(argc, argv);
-	if (argc != 2) {
-		std::cerr << "Usage: cslc [source.csl]" << std::endl;
-		return EXIT_FAILURE;
-	}
-	
-	std::filesystem::path srcCodePath{argv[1]};
-	// csl::Compiler cslCompiler{};
-	glsl::Compiler glslCompiler{};
-
+	CmdLineArgs cmdLineArgs{};
+	std::vector<std::filesystem::path> srcCodePaths;
 	try {
-		// cslCompiler.Compile(srcCodePath);
-		glslCompiler.Compile(srcCodePath);
+		cmdLineArgs = ParseCmdLineArgs(argc, argv);
+		if (cmdLineArgs.help) {
+			PrintUsage(std::cout);
+			return EXIT_SUCCESS;
+		}
+		if (!cmdLineArgs.serveSocketPath.empty()) {
+			// Opened and scanned once for every request the server answers.
+			glsl::PrecompiledHeader pch{};
+			if (!cmdLineArgs.pchPath.empty()) {
+				pch.Open(cmdLineArgs.pchPath);
+			}
+			glsl::PpFileCache ppFileCache{};
+			CompileServerConfig serverConfig{};
+			serverConfig.socketPath = cmdLineArgs.serveSocketPath;
+			serverConfig.workerCount = cmdLineArgs.jobs;
+			serverConfig.idleTimeout = cmdLineArgs.idleTimeout;
+			serverConfig.includeDirs = cmdLineArgs.includeDirs;
+			serverConfig.ppFileCache = &ppFileCache;
+			serverConfig.pch = cmdLineArgs.pchPath.empty() ? nullptr : &pch;
+			serverConfig.verbose = cmdLineArgs.verbose;
+			CompileServer compileServer{serverConfig};
+			compileServer.Run();
+			return EXIT_SUCCESS;
+		}
+		if (!cmdLineArgs.precompileHeaderPath.empty()) {
+			// Next to the header, like GCC's ".gch" files.
+			std::filesystem::path pchPath = cmdLineArgs.precompileHeaderPath;
+			pchPath += ".pch";
+			glsl::CompilerConfig compilerConfig{};
+			compilerConfig.includeDirs = cmdLineArgs.includeDirs;
+			glsl::Compiler compiler{};
+			if (!compiler.PrecompileHeader(cmdLineArgs.precompileHeaderPath, pchPath, compilerConfig)) {
+				std::cerr << "Failed to precompile " << cmdLineArgs.precompileHeaderPath.string() << std::endl;
+				return EXIT_FAILURE;
+			}
+			return EXIT_SUCCESS;
+		}
+		srcCodePaths = CollectSrcFiles(cmdLineArgs);
 	}
 	catch (std::logic_error& le) {
-		std::cerr << "Logic error has occurred: " << le.what() << std::endl;
+		std::cerr << le.what() << "\n";
+		PrintUsage(std::cerr);
 		return EXIT_FAILURE;
 	}
 	catch (std::runtime_error& re) {
-		std::cerr << "Runtime error has occurred: " << re.what() << std::endl;
+		std::cerr << re.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (srcCodePaths.empty()) {
+		std::cerr << "No \".csl\" source files found." << std::endl;
 		return EXIT_FAILURE;
 	}
-	return EXIT_SUCCESS;
+
+	// A single file is compiled the same way as before the batch mode was introduced, without a report.
+	bool batchMode = srcCodePaths.size() > 1;
+
+	std::unique_ptr<glsl::CompileCache> compileCache;
+	if (!cmdLineArgs.cacheDir.empty()) {
+		try {
+			compileCache = std::make_unique<glsl::CompileCache>(cmdLineArgs.cacheDir);
+		}
+		catch (std::runtime_error& re) {
+			std::cerr << re.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Opened once, every session of the batch instantiates its declarations from the same mapping.
+	glsl::PrecompiledHeader pch{};
+	if (!cmdLineArgs.pchPath.empty()) {
+		try {
+			pch.Open(cmdLineArgs.pchPath);
+		}
+		catch (std::runtime_error& re) {
+			std::cerr << re.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	BatchCompilerConfig batchConfig{};
+	batchConfig.jobs = cmdLineArgs.jobs;
+	batchConfig.compilerConfig.debugDump.channels = cmdLineArgs.dumpChannels;
+	batchConfig.compilerConfig.debugDump.dumpDir = cmdLineArgs.dumpDir;
+	batchConfig.compilerConfig.cache = compileCache.get();
+	// Common includes are read and scanned once for the whole batch.
+	glsl::PpFileCache ppFileCache{};
+	batchConfig.compilerConfig.ppFileCache = &ppFileCache;
+	batchConfig.compilerConfig.includeDirs = cmdLineArgs.includeDirs;
+	batchConfig.compilerConfig.pch = cmdLineArgs.pchPath.empty() ? nullptr : &pch;
+	batchConfig.compilerConfig.pipelined = cmdLineArgs.pipeline;
+	batchConfig.compilerConfig.streaming = cmdLineArgs.stream;
+	std::unique_ptr<TraceRecorder> trace;
+	if (!cmdLineArgs.traceFile.empty()) {
+		trace = std::make_unique<TraceRecorder>();
+		batchConfig.compilerConfig.trace = trace.get();
+	}
+
+	// csl::Compiler cslCompiler{};
+	BatchCompiler batchCompiler{};
+	std::vector<BatchCompileResult> results = batchCompiler.Compile(srcCodePaths, batchConfig);
+
+	// The standard output is reserved for the statistics if they were requested.
+	std::ostream& reportOut = cmdLineArgs.statsJson ? std::cerr : std::cout;
+	if (batchMode) {
+		BatchCompiler::PrintReport(reportOut, results);
+		if (compileCache) {
+			reportOut << "Compile cache: " << compileCache->GetHitCount() << " hit(s), "
+			          << compileCache->GetMissCount() << " miss(es).\n";
+		}
+		if (ppFileCache.GetHitCount() + ppFileCache.GetMissCount() > 0) {
+			reportOut << "Scanned include files: " << ppFileCache.GetHitCount() << " hit(s), "
+			          << ppFileCache.GetMissCount() << " miss(es).\n";
+		}
+	} else if (!results[0].success) {
+		std::cerr << "Failed to compile " << results[0].srcCodePath.string()
+		          << ": " << results[0].errMsg << std::endl;
+	}
+	if (cmdLineArgs.statsJson) {
+		BatchCompiler::PrintStatsJson(std::cout, results);
+	}
+	if (trace) {
+		std::ofstream traceFile{cmdLineArgs.traceFile};
+		trace->Write(traceFile);
+		if (!traceFile) {
+			std::cerr << "Couldn't write the trace file: " << cmdLineArgs.traceFile.string() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	return BatchCompiler::AllSucceeded(results) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 void PrintCmdLineArgs(int argc, char* argv[]) {
 	for (int i = 0; i < argc; i++) {
 		std::cout << i << ": " << argv[i] << "\n";
 	}
-}
\ No newline at end of file
+}
@@ -13,4 +13,6 @@ include "dependencies.lua"
 -- include ( dev_path .. "/crayon" )
 
 include("dev/crayon-lib")
-include("dev/crayon")
\ No newline at end of file
+include("dev/crayon-alloc-tracking")
+include("dev/crayon")
+include("dev/crayon-bench")
\ No newline at end of file